@@ -15,6 +15,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "./vp9_rtcd.h"
 #include "../tools_common.h"
 #include "../vp9/encoder/vp9_resize.h"
 
@@ -56,6 +57,7 @@ int main(int argc, char *argv[]) {
   int width, height, target_width, target_height;
 
   exec_name = argv[0];
+  vp9_rtcd();
 
   if (argc < 5) {
     printf("Incorrect parameters:\n");
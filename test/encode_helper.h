@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef TEST_ENCODE_HELPER_H_
+#define TEST_ENCODE_HELPER_H_
+
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "test/video_source.h"
+#include "vpx/vpx_encoder.h"
+
+namespace libvpx_test {
+
+typedef std::vector<std::vector<uint8_t> > FrameList;
+
+// A gradient that moves a little each frame.
+class MovingGradientVideoSource : public DummyVideoSource {
+ protected:
+  virtual void FillFrame() {
+    if (img_ == NULL)
+      return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = plane ? (img_->d_w + img_->x_chroma_shift) >>
+                                img_->x_chroma_shift : img_->d_w;
+      const int h = plane ? (img_->d_h + img_->y_chroma_shift) >>
+                                img_->y_chroma_shift : img_->d_h;
+      for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+          img_->planes[plane][y * img_->stride[plane] + x] =
+              static_cast<uint8_t>(x + y + 4 * frame_ + 64 * plane);
+        }
+      }
+    }
+  }
+};
+
+// Encodes num_frames frames of a width x height MovingGradientVideoSource
+// with enc in real time, appending the compressed frames to frames. For the
+// tests that need an encoder created through the codec API, such as one
+// with its own allocator, which EncoderTest does not provide. Callers
+// should wrap the call in ASSERT_NO_FATAL_FAILURE().
+inline void EncodeMovingGradient(vpx_codec_ctx_t *enc, int width, int height,
+                                 int num_frames, FrameList *frames) {
+  MovingGradientVideoSource video;
+  video.SetSize(width, height);
+  video.set_limit(num_frames);
+  for (video.Begin(); video.img() != NULL; video.Next()) {
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_encode(enc, video.img(), video.pts(), video.duration(),
+                               0, VPX_DL_REALTIME));
+    vpx_codec_iter_t iter = NULL;
+    const vpx_codec_cx_pkt_t *pkt;
+    while ((pkt = vpx_codec_get_cx_data(enc, &iter)) != NULL) {
+      if (pkt->kind != VPX_CODEC_CX_FRAME_PKT)
+        continue;
+      const uint8_t *const buf =
+          static_cast<const uint8_t *>(pkt->data.frame.buf);
+      frames->push_back(std::vector<uint8_t>(buf, buf + pkt->data.frame.sz));
+    }
+  }
+}
+
+}  // namespace libvpx_test
+
+#endif  // TEST_ENCODE_HELPER_H_
@@ -651,6 +651,60 @@ TEST_P(InvTrans8x8DCT, CompareReference) {
   CompareInvReference(ref_txfm_, thresh_);
 }
 
+#if CONFIG_VP9_HIGHBITDEPTH
+typedef std::tr1::tuple<FdctFunc, FdctFunc, int, vpx_bit_depth_t>
+    PartialFdctParam;
+
+// Checks the DC only forward transforms of any size against their C
+// versions, over the full residual range of the bit depth.
+class PartialFdctTest : public ::testing::TestWithParam<PartialFdctParam> {
+ public:
+  virtual ~PartialFdctTest() {}
+
+  virtual void SetUp() {
+    ref_txfm_ = GET_PARAM(0);
+    fwd_txfm_ = GET_PARAM(1);
+    size_ = GET_PARAM(2);
+    bit_depth_ = GET_PARAM(3);
+    mask_ = (1 << bit_depth_) - 1;
+  }
+
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+ protected:
+  FdctFunc ref_txfm_;
+  FdctFunc fwd_txfm_;
+  int size_;
+  vpx_bit_depth_t bit_depth_;
+  int mask_;
+};
+
+TEST_P(PartialFdctTest, CompareReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  const int count_test_block = 1000;
+  const int stride = 32;
+  DECLARE_ALIGNED(16, int16_t, input[32 * 32]);
+  DECLARE_ALIGNED(16, tran_low_t, output_ref[2]);
+  DECLARE_ALIGNED(16, tran_low_t, output[2]);
+
+  for (int i = 0; i < count_test_block; ++i) {
+    for (int j = 0; j < size_ * stride; ++j) {
+      if (i == 0)
+        input[j] = mask_;
+      else if (i == 1)
+        input[j] = -mask_;
+      else
+        input[j] = (rnd.Rand16() & mask_) - (rnd.Rand16() & mask_);
+    }
+
+    ref_txfm_(input, output_ref, stride);
+    ASM_REGISTER_STATE_CHECK(fwd_txfm_(input, output, stride));
+    EXPECT_EQ(output_ref[0], output[0]) << "block " << i;
+    EXPECT_EQ(output_ref[1], output[1]) << "block " << i;
+  }
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
 using std::tr1::make_tuple;
 
 #if CONFIG_VP9_HIGHBITDEPTH
@@ -761,6 +815,22 @@ INSTANTIATE_TEST_CASE_P(
                    &idct8x8_10_add_12_sse2, 6225, VPX_BITS_12),
         make_tuple(&idct8x8_12,
                    &idct8x8_64_add_12_sse2, 6225, VPX_BITS_12)));
+
+INSTANTIATE_TEST_CASE_P(
+    SSE2, PartialFdctTest,
+    ::testing::Values(
+        make_tuple(&vp9_highbd_fdct8x8_1_c,
+                   &vp9_highbd_fdct8x8_1_sse2, 8, VPX_BITS_10),
+        make_tuple(&vp9_highbd_fdct8x8_1_c,
+                   &vp9_highbd_fdct8x8_1_sse2, 8, VPX_BITS_12),
+        make_tuple(&vp9_highbd_fdct16x16_1_c,
+                   &vp9_highbd_fdct16x16_1_sse2, 16, VPX_BITS_10),
+        make_tuple(&vp9_highbd_fdct16x16_1_c,
+                   &vp9_highbd_fdct16x16_1_sse2, 16, VPX_BITS_12),
+        make_tuple(&vp9_highbd_fdct32x32_1_c,
+                   &vp9_highbd_fdct32x32_1_sse2, 32, VPX_BITS_10),
+        make_tuple(&vp9_highbd_fdct32x32_1_c,
+                   &vp9_highbd_fdct32x32_1_sse2, 32, VPX_BITS_12)));
 #endif  // HAVE_SSE2 && CONFIG_VP9_HIGHBITDEPTH && !CONFIG_EMULATE_HARDWARE
 
 #if HAVE_SSSE3 && CONFIG_USE_X86INC && ARCH_X86_64 && \
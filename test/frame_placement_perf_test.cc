@@ -0,0 +1,151 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "./vpx_config.h"
+#include "./vpx_version.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_decoder.h"
+#include "vpx/vpx_encoder.h"
+#include "vpx_ports/vpx_timer.h"
+
+namespace {
+
+const double kUsecsInSec = 1000000.0;
+const int kWidth = 3840;
+const int kHeight = 2160;
+const int kFrames = 30;
+
+struct PlacementParam {
+  const char *name;
+  int placement;
+  int threads;
+};
+
+const PlacementParam kPlacementParams[] = {
+  { "default", 0, 1 },
+  { "huge_pages", VP9_FRAME_HUGE_PAGES, 1 },
+  { "huge_pages_numa_local", VP9_FRAME_HUGE_PAGES | VP9_FRAME_NUMA_LOCAL, 1 },
+  { "default", 0, 4 },
+  { "huge_pages", VP9_FRAME_HUGE_PAGES, 4 },
+  { "huge_pages_numa_local", VP9_FRAME_HUGE_PAGES | VP9_FRAME_NUMA_LOCAL, 4 },
+};
+
+/*
+ Times 4K realtime encoding and decoding with the frame buffers in each
+ placement. The source pans across a fixed texture so that motion
+ compensation reads the reference frames all over. Like the other perf tests
+ it does no correctness checks; vp9_frame_pool_test covers those.
+ */
+class FramePlacementPerfTest
+    : public ::testing::TestWithParam<PlacementParam> {
+};
+
+void FillFrame(vpx_image_t *img, int frame) {
+  for (int plane = 0; plane < 3; ++plane) {
+    const int w = plane ? (kWidth + 1) / 2 : kWidth;
+    const int h = plane ? (kHeight + 1) / 2 : kHeight;
+    const int shift = plane ? 2 * frame : 4 * frame;
+    for (int y = 0; y < h; ++y) {
+      uint8_t *const row = img->planes[plane] + y * img->stride[plane];
+      for (int x = 0; x < w; ++x) {
+        const int u = x + shift, v = y + frame;
+        row[x] = static_cast<uint8_t>((u * v >> 5) ^ (u + 3 * v));
+      }
+    }
+  }
+}
+
+TEST_P(FramePlacementPerfTest, PerfTest) {
+  const PlacementParam &param = GetParam();
+  vpx_codec_enc_cfg_t cfg;
+  vpx_codec_ctx_t enc;
+  vpx_image_t img;
+  std::vector<std::vector<uint8_t> > frames;
+
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_config_default(&vpx_codec_vp9_cx_algo, &cfg, 0));
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_threads = param.threads;
+  cfg.g_lag_in_frames = 0;
+  cfg.rc_end_usage = VPX_CBR;
+  cfg.rc_target_bitrate = 8000;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo, &cfg, 0));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP9_SET_FRAME_PLACEMENT, param.placement));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP8E_SET_CPUUSED, 6));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP9E_SET_TILE_COLUMNS, 2));
+  ASSERT_TRUE(vpx_img_alloc(&img, VPX_IMG_FMT_I420, kWidth, kHeight, 32) !=
+              NULL);
+
+  double encode_secs = 0;
+  for (int i = 0; i < kFrames; ++i) {
+    FillFrame(&img, i);
+    vpx_usec_timer t;
+    vpx_usec_timer_start(&t);
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_encode(&enc, &img, i, 1, 0,
+                                             VPX_DL_REALTIME));
+    vpx_usec_timer_mark(&t);
+    encode_secs += vpx_usec_timer_elapsed(&t) / kUsecsInSec;
+    vpx_codec_iter_t iter = NULL;
+    const vpx_codec_cx_pkt_t *pkt;
+    while ((pkt = vpx_codec_get_cx_data(&enc, &iter)) != NULL) {
+      if (pkt->kind != VPX_CODEC_CX_FRAME_PKT)
+        continue;
+      const uint8_t *const buf =
+          static_cast<const uint8_t *>(pkt->data.frame.buf);
+      frames.push_back(std::vector<uint8_t>(buf, buf + pkt->data.frame.sz));
+    }
+  }
+  vpx_img_free(&img);
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+
+  vpx_codec_dec_cfg_t dec_cfg = vpx_codec_dec_cfg_t();
+  vpx_codec_ctx_t dec;
+  dec_cfg.threads = param.threads;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_dec_init(&dec, &vpx_codec_vp9_dx_algo, &dec_cfg, 0));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&dec, VP9_SET_FRAME_PLACEMENT, param.placement));
+  vpx_usec_timer t;
+  vpx_usec_timer_start(&t);
+  for (size_t i = 0; i < frames.size(); ++i) {
+    const std::vector<uint8_t> &frame = frames[i];
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&dec, &frame[0],
+                               static_cast<unsigned int>(frame.size()),
+                               NULL, 0));
+    vpx_codec_iter_t iter = NULL;
+    while (vpx_codec_get_frame(&dec, &iter) != NULL) {
+    }
+  }
+  vpx_usec_timer_mark(&t);
+  const double decode_secs = vpx_usec_timer_elapsed(&t) / kUsecsInSec;
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+
+  printf("{\n");
+  printf("\t\"type\" : \"frame_placement_perf_test\",\n");
+  printf("\t\"version\" : \"%s\",\n", VERSION_STRING_NOSP);
+  printf("\t\"placement\" : \"%s\",\n", param.name);
+  printf("\t\"threads\" : %d,\n", param.threads);
+  printf("\t\"totalFrames\" : %d,\n", kFrames);
+  printf("\t\"encodeFramesPerSecond\" : %f,\n", kFrames / encode_secs);
+  printf("\t\"decodeFramesPerSecond\" : %f\n", kFrames / decode_secs);
+  printf("}\n");
+}
+
+INSTANTIATE_TEST_CASE_P(VP9, FramePlacementPerfTest,
+                        ::testing::ValuesIn(kPlacementParams));
+
+}  // namespace
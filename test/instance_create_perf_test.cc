@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "./vpx_config.h"
+#include "./vpx_version.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_decoder.h"
+#include "vpx/vpx_encoder.h"
+#include "vpx_ports/vpx_timer.h"
+
+namespace {
+
+const int kIterations = 100;
+
+struct InstanceParam {
+  int width;
+  int height;
+};
+
+const InstanceParam kInstanceParams[] = {
+  { 160, 90 },
+  { 640, 360 },
+  { 1920, 1080 },
+};
+
+/*
+ Times what a service that handles one image per request pays for its codec
+ instances: creating an encoder, creating a decoder, decoding one smooth key
+ frame and destroying it, and decoding the same frame with a decoder that is
+ reset instead of recreated. Like the other perf tests it does no correctness
+ checks; vp9_frame_pool_test covers VP9D_RESET.
+ */
+class InstanceCreatePerfTest
+    : public ::testing::TestWithParam<InstanceParam> {
+};
+
+void DecodeFrame(vpx_codec_ctx_t *dec, const std::vector<uint8_t> &frame) {
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_decode(dec, &frame[0],
+                             static_cast<unsigned int>(frame.size()),
+                             NULL, 0));
+  vpx_codec_iter_t iter = NULL;
+  ASSERT_TRUE(vpx_codec_get_frame(dec, &iter) != NULL);
+}
+
+TEST_P(InstanceCreatePerfTest, PerfTest) {
+  const InstanceParam &param = GetParam();
+  vpx_codec_enc_cfg_t cfg;
+  vpx_codec_ctx_t enc;
+  vpx_image_t img;
+  std::vector<uint8_t> frame;
+
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_config_default(&vpx_codec_vp9_cx_algo, &cfg, 0));
+  cfg.g_w = param.width;
+  cfg.g_h = param.height;
+  cfg.g_lag_in_frames = 0;
+
+  vpx_usec_timer t;
+  vpx_usec_timer_start(&t);
+  for (int i = 0; i < kIterations; ++i) {
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo, &cfg, 0));
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+  }
+  vpx_usec_timer_mark(&t);
+  const double encoder_create_usecs =
+      static_cast<double>(vpx_usec_timer_elapsed(&t)) / kIterations;
+
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo, &cfg, 0));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP8E_SET_CPUUSED, 8));
+  ASSERT_TRUE(vpx_img_alloc(&img, VPX_IMG_FMT_I420, param.width,
+                            param.height, 32) != NULL);
+  for (int plane = 0; plane < 3; ++plane) {
+    const int w = plane ? (param.width + 1) / 2 : param.width;
+    const int h = plane ? (param.height + 1) / 2 : param.height;
+    for (int y = 0; y < h; ++y)
+      for (int x = 0; x < w; ++x)
+        img.planes[plane][y * img.stride[plane] + x] =
+            static_cast<uint8_t>(x + y + 64 * plane);
+  }
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_encode(&enc, &img, 0, 1, 0,
+                                           VPX_DL_REALTIME));
+  vpx_codec_iter_t iter = NULL;
+  const vpx_codec_cx_pkt_t *pkt;
+  while ((pkt = vpx_codec_get_cx_data(&enc, &iter)) != NULL) {
+    if (pkt->kind != VPX_CODEC_CX_FRAME_PKT)
+      continue;
+    const uint8_t *const buf =
+        static_cast<const uint8_t *>(pkt->data.frame.buf);
+    frame.assign(buf, buf + pkt->data.frame.sz);
+  }
+  vpx_img_free(&img);
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+  ASSERT_FALSE(frame.empty());
+
+  vpx_codec_ctx_t dec;
+  vpx_usec_timer_start(&t);
+  for (int i = 0; i < kIterations; ++i) {
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_dec_init(&dec, &vpx_codec_vp9_dx_algo, NULL, 0));
+    DecodeFrame(&dec, frame);
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+  }
+  vpx_usec_timer_mark(&t);
+  const double decoder_create_usecs =
+      static_cast<double>(vpx_usec_timer_elapsed(&t)) / kIterations;
+
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_dec_init(&dec, &vpx_codec_vp9_dx_algo, NULL, 0));
+  DecodeFrame(&dec, frame);
+  vpx_usec_timer_start(&t);
+  for (int i = 0; i < kIterations; ++i) {
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_RESET, 0));
+    DecodeFrame(&dec, frame);
+  }
+  vpx_usec_timer_mark(&t);
+  const double decoder_reset_usecs =
+      static_cast<double>(vpx_usec_timer_elapsed(&t)) / kIterations;
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+
+  printf("{\n");
+  printf("\t\"type\" : \"instance_create_perf_test\",\n");
+  printf("\t\"version\" : \"%s\",\n", VERSION_STRING_NOSP);
+  printf("\t\"width\" : %d,\n", param.width);
+  printf("\t\"height\" : %d,\n", param.height);
+  printf("\t\"iterations\" : %d,\n", kIterations);
+  printf("\t\"encoderCreateDestroyUsecs\" : %f,\n", encoder_create_usecs);
+  printf("\t\"decoderCreateDecodeDestroyUsecs\" : %f,\n",
+         decoder_create_usecs);
+  printf("\t\"decoderResetDecodeUsecs\" : %f\n", decoder_reset_usecs);
+  printf("}\n");
+}
+
+INSTANTIATE_TEST_CASE_P(VP9, InstanceCreatePerfTest,
+                        ::testing::ValuesIn(kInstanceParams));
+
+}  // namespace
@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 #include <climits>
+#include <cmath>
+#include <cstring>
 #include <vector>
 #include "third_party/googletest/src/include/gtest/gtest.h"
 #include "test/codec_factory.h"
@@ -366,6 +368,99 @@ TEST_P(ResizeCspTest, TestResizeCspWorks) {
   ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
 }
 
+const unsigned int kSetRefStepDownFrame = 2;
+const unsigned int kSetRefFrame = 5;
+const int kSetRefShift = 16;
+
+// Fills img with one of two smooth luma patterns, moved left by shift pixels.
+void FillPattern(vpx_image_t *img, int pattern, int shift) {
+  for (unsigned int y = 0; y < img->d_h; ++y) {
+    uint8_t *const row =
+        img->planes[VPX_PLANE_Y] + y * img->stride[VPX_PLANE_Y];
+    for (unsigned int x = 0; x < img->d_w; ++x) {
+      const double u = x + shift;
+      const double val = pattern ? sin(u / 9.0) * cos(y / 7.0)
+                                 : cos(u / 5.0 + y / 11.0);
+      row[x] = static_cast<uint8_t>(128 + 100 * val);
+    }
+  }
+  for (int plane = VPX_PLANE_U; plane <= VPX_PLANE_V; ++plane) {
+    for (unsigned int y = 0; y < (img->d_h + 1) / 2; ++y)
+      memset(img->planes[plane] + y * img->stride[plane], 128,
+             (img->d_w + 1) / 2);
+  }
+}
+
+// The first pattern up to kSetRefFrame, then the second.
+class SetReferenceVideoSource : public ::libvpx_test::DummyVideoSource {
+ public:
+  SetReferenceVideoSource() {
+    SetSize(kInitialWidth, kInitialHeight);
+    limit_ = kSetRefFrame + 1;
+  }
+
+  virtual ~SetReferenceVideoSource() {}
+
+ protected:
+  virtual void FillFrame() {
+    if (img_)
+      FillPattern(img_, frame_ >= kSetRefFrame, 0);
+  }
+};
+
+// Codes frames at half size against a full size golden frame, so the
+// encoder keeps a scaled copy of it, then replaces the golden frame with
+// the next source moved by kSetRefShift pixels. The motion search has to
+// run on a fresh scaled copy to find the move.
+class ResizeSetReferenceTest : public ResizeTest {
+ protected:
+  ResizeSetReferenceTest() : ResizeTest() {}
+
+  virtual ~ResizeSetReferenceTest() {}
+
+  // The decoder does not see the replaced golden frame.
+  virtual bool DoDecode() const { return false; }
+
+  virtual void PreEncodeFrameHook(libvpx_test::VideoSource *video,
+                                  libvpx_test::Encoder *encoder) {
+    if (video->frame() > 0)
+      frame_flags_ = VP8_EFLAG_NO_UPD_GF | VP8_EFLAG_NO_UPD_ARF;
+    if (video->frame() == kSetRefStepDownFrame) {
+      struct vpx_scaling_mode mode = {VP8E_ONETWO, VP8E_ONETWO};
+      encoder->Control(VP8E_SET_SCALEMODE, &mode);
+    }
+    if (video->frame() == kSetRefFrame) {
+      vpx_ref_frame_t ref;
+      ASSERT_TRUE(vpx_img_alloc(&ref.img, VPX_IMG_FMT_I420, kInitialWidth,
+                                kInitialHeight, 32) != NULL);
+      FillPattern(&ref.img, 1, kSetRefShift);
+      ref.frame_type = VP8_GOLD_FRAME;
+      encoder->Control(VP8_SET_REFERENCE, &ref);
+      vpx_img_free(&ref.img);
+      frame_flags_ |= VP8_EFLAG_NO_REF_LAST | VP8_EFLAG_NO_REF_ARF;
+    }
+  }
+
+  virtual void FramePktHook(const vpx_codec_cx_pkt_t *pkt) {
+    frame_sizes_.push_back(pkt->data.frame.sz);
+  }
+
+  std::vector<size_t> frame_sizes_;
+};
+
+TEST_P(ResizeSetReferenceTest, TestSetReferenceAfterResize) {
+  SetReferenceVideoSource video;
+  cfg_.rc_min_quantizer = cfg_.rc_max_quantizer = 32;
+  cfg_.g_lag_in_frames = 0;
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+  // All of the last frame can be predicted from the new golden frame. With a
+  // stale scaled copy the motion search misses the move and the frame costs
+  // about four times as much.
+  ASSERT_EQ(kSetRefFrame + 1, frame_sizes_.size());
+  EXPECT_LT(frame_sizes_[kSetRefFrame] * 8, frame_sizes_[0]);
+}
+
 VP8_INSTANTIATE_TEST_CASE(ResizeTest, ONE_PASS_TEST_MODES);
 VP9_INSTANTIATE_TEST_CASE(ResizeTest,
                           ::testing::Values(::libvpx_test::kRealTime));
@@ -373,4 +468,7 @@ VP9_INSTANTIATE_TEST_CASE(ResizeInternalTest,
                           ::testing::Values(::libvpx_test::kOnePassBest));
 VP9_INSTANTIATE_TEST_CASE(ResizeCspTest,
                           ::testing::Values(::libvpx_test::kRealTime));
+VP9_INSTANTIATE_TEST_CASE(ResizeSetReferenceTest,
+                          ::testing::Values(::libvpx_test::kRealTime,
+                                            ::libvpx_test::kOnePassGood));
 }  // namespace
@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "./vpx_config.h"
+#include "./vp9_rtcd.h"
+
+using libvpx_test::ACMRandom;
+
+namespace {
+const int kNumIterations = 1000;
+const int kMaxBlocks = 70;
+const int kStride = 4 * kMaxBlocks + 8;
+
+// Brute force sums of a row of 4x4 blocks, in the order sum_s, sum_r,
+// sum_sq_s, sum_sq_r, sum_sxr.
+template <typename Pixel>
+void ReferenceSums(const Pixel *s, const Pixel *r, int stride, int blocks,
+                   uint32_t sums[5][kMaxBlocks]) {
+  for (int b = 0; b < blocks; ++b) {
+    for (int k = 0; k < 5; ++k)
+      sums[k][b] = 0;
+    for (int i = 0; i < 4; ++i) {
+      for (int j = 0; j < 4; ++j) {
+        const uint32_t a = s[i * stride + 4 * b + j];
+        const uint32_t c = r[i * stride + 4 * b + j];
+        sums[0][b] += a;
+        sums[1][b] += c;
+        sums[2][b] += a * a;
+        sums[3][b] += c * c;
+        sums[4][b] += a * c;
+      }
+    }
+  }
+}
+
+typedef void (*SsimParms4x4RowFunc)(const uint8_t *s, int sp, const uint8_t *r,
+                                    int rp, int blocks, uint32_t *sum_s,
+                                    uint32_t *sum_r, uint32_t *sum_sq_s,
+                                    uint32_t *sum_sq_r, uint32_t *sum_sxr);
+
+class SsimParmsTest : public ::testing::TestWithParam<SsimParms4x4RowFunc> {
+ public:
+  virtual ~SsimParmsTest() {}
+  virtual void SetUp() { parms_ = GetParam(); }
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+ protected:
+  SsimParms4x4RowFunc parms_;
+};
+
+TEST_P(SsimParmsTest, MatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  uint8_t s[4 * kStride], r[4 * kStride];
+  uint32_t ref[5][kMaxBlocks], out[5][kMaxBlocks];
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int blocks = rnd(kMaxBlocks + 1);
+    for (int j = 0; j < 4 * kStride; ++j) {
+      s[j] = (i & 1) ? 255 : rnd.Rand8();
+      r[j] = rnd.Rand8();
+    }
+
+    ReferenceSums(s, r, kStride, blocks, ref);
+    ASM_REGISTER_STATE_CHECK(parms_(s, kStride, r, kStride, blocks, out[0],
+                                    out[1], out[2], out[3], out[4]));
+    for (int k = 0; k < 5; ++k)
+      for (int b = 0; b < blocks; ++b)
+        ASSERT_EQ(ref[k][b], out[k][b])
+            << "iteration " << i << " sum " << k << " block " << b;
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(C, SsimParmsTest,
+                        ::testing::Values(&vp9_ssim_parms_4x4_row_c));
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(SSE2, SsimParmsTest,
+                        ::testing::Values(&vp9_ssim_parms_4x4_row_sse2));
+#endif  // HAVE_SSE2
+
+#if CONFIG_VP9_HIGHBITDEPTH
+typedef void (*HighbdSsimParms4x4RowFunc)(const uint16_t *s, int sp,
+                                          const uint16_t *r, int rp,
+                                          int blocks, uint32_t *sum_s,
+                                          uint32_t *sum_r, uint32_t *sum_sq_s,
+                                          uint32_t *sum_sq_r,
+                                          uint32_t *sum_sxr);
+
+class HighbdSsimParmsTest
+    : public ::testing::TestWithParam<HighbdSsimParms4x4RowFunc> {
+ public:
+  virtual ~HighbdSsimParmsTest() {}
+  virtual void SetUp() { parms_ = GetParam(); }
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+ protected:
+  HighbdSsimParms4x4RowFunc parms_;
+};
+
+TEST_P(HighbdSsimParmsTest, MatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  uint16_t s[4 * kStride], r[4 * kStride];
+  uint32_t ref[5][kMaxBlocks], out[5][kMaxBlocks];
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int blocks = rnd(kMaxBlocks + 1);
+    const int mask = (i & 2) ? 4095 : 1023;
+    for (int j = 0; j < 4 * kStride; ++j) {
+      s[j] = (i & 1) ? mask : rnd.Rand16() & mask;
+      r[j] = rnd.Rand16() & mask;
+    }
+
+    ReferenceSums(s, r, kStride, blocks, ref);
+    ASM_REGISTER_STATE_CHECK(parms_(s, kStride, r, kStride, blocks, out[0],
+                                    out[1], out[2], out[3], out[4]));
+    for (int k = 0; k < 5; ++k)
+      for (int b = 0; b < blocks; ++b)
+        ASSERT_EQ(ref[k][b], out[k][b])
+            << "iteration " << i << " sum " << k << " block " << b;
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(C, HighbdSsimParmsTest,
+                        ::testing::Values(&vp9_highbd_ssim_parms_4x4_row_c));
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(
+    SSE2, HighbdSsimParmsTest,
+    ::testing::Values(&vp9_highbd_ssim_parms_4x4_row_sse2));
+#endif  // HAVE_SSE2
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+}  // namespace
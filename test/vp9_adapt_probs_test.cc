@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "./vpx_config.h"
+#include "./vp9_rtcd.h"
+#include "vp9/common/vp9_prob.h"
+
+using libvpx_test::ACMRandom;
+
+namespace {
+const int kNumIterations = 10000;
+const int kMaxProbs = 96;
+
+unsigned int Rand31(ACMRandom *rnd) {
+  return (static_cast<unsigned int>(rnd->Rand16()) << 15) ^ rnd->Rand16();
+}
+
+typedef void (*AdaptProbsFunc)(const uint8_t *pre_probs,
+                               const unsigned int *counts, int n,
+                               unsigned int count_sat,
+                               unsigned int max_update_factor,
+                               uint8_t *probs);
+
+class AdaptProbsTest : public ::testing::TestWithParam<AdaptProbsFunc> {
+ public:
+  virtual ~AdaptProbsTest() {}
+  virtual void SetUp() { adapt_probs_ = GetParam(); }
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+ protected:
+  AdaptProbsFunc adapt_probs_;
+};
+
+TEST_P(AdaptProbsTest, MatchesMergeProbs) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  uint8_t pre_probs[kMaxProbs];
+  uint8_t probs[kMaxProbs];
+  unsigned int counts[kMaxProbs][2];
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int n = rnd(kMaxProbs + 1);
+    // Coefficient and mode/mv adaptation parameters.
+    const unsigned int count_sat = (i & 1) ? 24 : MODE_MV_COUNT_SAT;
+    const unsigned int update_factor =
+        (i & 1) ? ((i & 2) ? 112 : 128) : MODE_MV_MAX_UPDATE_FACTOR;
+    for (int j = 0; j < n; ++j) {
+      pre_probs[j] = 1 + rnd(255);
+      switch (i % 4) {
+        case 0:
+          counts[j][0] = rnd(3);
+          counts[j][1] = rnd(3);
+          break;
+        case 1:
+          counts[j][0] = rnd(64);
+          counts[j][1] = rnd(64);
+          break;
+        case 2:
+          counts[j][0] = Rand31(&rnd) >> 4;
+          counts[j][1] = Rand31(&rnd) >> 4;
+          break;
+        default:
+          counts[j][0] = Rand31(&rnd);
+          counts[j][1] = rnd(16);
+          break;
+      }
+    }
+
+    ASM_REGISTER_STATE_CHECK(adapt_probs_(pre_probs, counts[0], n, count_sat,
+                                          update_factor, probs));
+    for (int j = 0; j < n; ++j) {
+      ASSERT_EQ(merge_probs(pre_probs[j], counts[j], count_sat, update_factor),
+                probs[j]) << "iteration " << i << " prob " << j;
+      if (count_sat == MODE_MV_COUNT_SAT) {
+        ASSERT_EQ(mode_mv_merge_probs(pre_probs[j], counts[j]), probs[j]);
+      }
+    }
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(C, AdaptProbsTest,
+                        ::testing::Values(&vp9_adapt_probs_c));
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(SSE2, AdaptProbsTest,
+                        ::testing::Values(&vp9_adapt_probs_sse2));
+#endif  // HAVE_SSE2
+}  // namespace
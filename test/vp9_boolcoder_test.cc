@@ -9,6 +9,7 @@
  */
 
 #include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -19,6 +20,7 @@
 
 #include "test/acm_random.h"
 #include "vpx/vpx_integer.h"
+#include "vpx_ports/vpx_timer.h"
 
 using libvpx_test::ACMRandom;
 
@@ -87,3 +89,45 @@ TEST(VP9, TestBitIO) {
     }
   }
 }
+
+TEST(VP9, TestBitIOSpeed) {
+  const int kBitsToTest = 1 << 20;
+  const int kBufferSize = kBitsToTest / 4;
+  const int kNumPasses = 20;
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  uint8_t *const probas = new uint8_t[kBitsToTest];
+  uint8_t *const bits = new uint8_t[kBitsToTest];
+  uint8_t *const bw_buffer = new uint8_t[kBufferSize];
+
+  for (int i = 0; i < kBitsToTest; ++i) {
+    probas[i] = rnd.Rand8() | 1;
+    bits[i] = rnd(256) >= probas[i];
+  }
+
+  vp9_writer bw;
+  vp9_start_encode(&bw, bw_buffer);
+  for (int i = 0; i < kBitsToTest; ++i)
+    vp9_write(&bw, bits[i], probas[i]);
+  vp9_stop_encode(&bw);
+  ASSERT_LT(bw.pos, static_cast<unsigned int>(kBufferSize));
+
+  int errors = 0;
+  vpx_usec_timer timer;
+  vpx_usec_timer_start(&timer);
+  for (int pass = 0; pass < kNumPasses; ++pass) {
+    vp9_reader br;
+    vp9_reader_init(&br, bw_buffer, bw.pos, NULL, NULL);
+    for (int i = 0; i < kBitsToTest; ++i)
+      errors += vp9_read(&br, probas[i]) != bits[i];
+  }
+  vpx_usec_timer_mark(&timer);
+  const int elapsed_time =
+      static_cast<int>(vpx_usec_timer_elapsed(&timer) / 1000);
+  printf("vp9_read: %d bits x %d passes: %5d ms\n", kBitsToTest, kNumPasses,
+         elapsed_time);
+  EXPECT_EQ(0, errors);
+
+  delete[] probas;
+  delete[] bits;
+  delete[] bw_buffer;
+}
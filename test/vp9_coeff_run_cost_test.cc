@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstring>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "./vpx_config.h"
+#include "./vp9_rtcd.h"
+#include "vp9/common/vp9_scan.h"
+#include "vp9/encoder/vp9_tokenize.h"
+#include "vpx_ports/mem.h"
+
+using libvpx_test::ACMRandom;
+
+namespace {
+const int kNumIterations = 2000;
+
+typedef int (*CoeffRunCostFunc)(const tran_low_t *qcoeff, const int16_t *scan,
+                                int eob, uint8_t *tokens,
+                                const int16_t *cat6_high_cost);
+
+class CoeffRunCostTest : public ::testing::TestWithParam<CoeffRunCostFunc> {
+ public:
+  virtual ~CoeffRunCostTest() {}
+  static void SetUpTestCase() { vp9_tokenize_initialize(); }
+  virtual void SetUp() { run_cost_ = GetParam(); }
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+ protected:
+  CoeffRunCostFunc run_cost_;
+};
+
+TEST_P(CoeffRunCostTest, MatchesTokenExtraCost) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, tran_low_t, qcoeff[32 * 32]);
+  uint8_t tokens[32 * 32];
+  const int16_t *const cat6_high_cost = vp9_get_high_cost_table(8);
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const TX_SIZE tx_size = static_cast<TX_SIZE>(i % TX_SIZES);
+    const int n = 16 << (2 * tx_size);
+    const int16_t *const scan = vp9_default_scan_orders[tx_size].scan;
+    const int eob = rnd(n + 1);
+    // Mostly small values, with some in and around CATEGORY6_TOKEN.
+    const int range = (i & 3) == 0 ? 1 << 14 : (i & 3) == 1 ? 80 : 4;
+    for (int j = 0; j < n; ++j)
+      qcoeff[j] = rnd(2 * range + 1) - range;
+
+    int ref_cost = 0;
+    for (int c = 0; c < eob; ++c) {
+      int16_t token;
+      EXTRABIT extra;
+      vp9_get_token_extra(qcoeff[scan[c]], &token, &extra);
+      ref_cost += vp9_get_cost(token, extra, cat6_high_cost);
+      tokens[c] = 0xff;
+    }
+
+    int cost;
+    ASM_REGISTER_STATE_CHECK(
+        cost = run_cost_(qcoeff, scan, eob, tokens, cat6_high_cost));
+    ASSERT_EQ(ref_cost, cost) << "iteration " << i;
+    for (int c = 0; c < eob; ++c)
+      ASSERT_EQ(vp9_get_token(qcoeff[scan[c]]), tokens[c])
+          << "iteration " << i << " coefficient " << c;
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(C, CoeffRunCostTest,
+                        ::testing::Values(&vp9_coeff_run_cost_c));
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, CoeffRunCostTest,
+                        ::testing::Values(&vp9_coeff_run_cost_avx2));
+#endif  // HAVE_AVX2
+}  // namespace
@@ -15,6 +15,8 @@
 #include "third_party/googletest/src/include/gtest/gtest.h"
 #include "test/codec_factory.h"
 #include "test/ivf_video_source.h"
+#include "test/md5_helper.h"
+#include "vpx_ports/vpx_timer.h"
 
 namespace {
 // In a real use the 'decrypt_state' parameter will be a pointer to a struct
@@ -39,6 +41,20 @@ void test_decrypt_cb(void *decrypt_state, const uint8_t *input,
                  input - reinterpret_cast<uint8_t *>(decrypt_state));
 }
 
+// Same as test_decrypt_cb(), but also counts the callback invocations.
+struct CountingDecryptState {
+  const uint8_t *buffer_start;
+  int calls;
+};
+
+void counting_decrypt_cb(void *decrypt_state, const uint8_t *input,
+                         uint8_t *output, int count) {
+  CountingDecryptState *const state =
+      reinterpret_cast<CountingDecryptState *>(decrypt_state);
+  ++state->calls;
+  encrypt_buffer(input, output, count, input - state->buffer_start);
+}
+
 }  // namespace
 
 namespace libvpx_test {
@@ -68,4 +84,51 @@ TEST(TestDecrypt, DecryptWorksVp9) {
   ASSERT_EQ(VPX_CODEC_OK, res) << decoder.DecodeError();
 }
 
+// Decodes the whole clip in the clear and encrypted, reporting the time taken
+// and the number of decrypt callbacks. The output must be identical.
+TEST(TestDecrypt, DecryptSpeedVp9) {
+  std::string md5[2];
+  for (int encrypted = 0; encrypted < 2; ++encrypted) {
+    libvpx_test::IVFVideoSource video("vp90-2-05-resize.ivf");
+    video.Init();
+
+    vpx_codec_dec_cfg_t dec_cfg = vpx_codec_dec_cfg_t();
+    VP9Decoder decoder(dec_cfg, 0);
+    CountingDecryptState state = { NULL, 0 };
+    std::vector<uint8_t> buffer;
+    libvpx_test::MD5 frame_md5;
+    int frames = 0;
+
+    vpx_usec_timer timer;
+    vpx_usec_timer_start(&timer);
+    for (video.Begin(); video.cxdata() != NULL; video.Next(), ++frames) {
+      const uint8_t *data = video.cxdata();
+      if (encrypted) {
+        buffer.resize(video.frame_size());
+        encrypt_buffer(video.cxdata(), &buffer[0], video.frame_size(), 0);
+        state.buffer_start = &buffer[0];
+        vpx_decrypt_init di = { counting_decrypt_cb, &state };
+        decoder.Control(VPXD_SET_DECRYPTOR, &di);
+        data = &buffer[0];
+      }
+      const vpx_codec_err_t res = decoder.DecodeFrame(data,
+                                                      video.frame_size());
+      ASSERT_EQ(VPX_CODEC_OK, res) << decoder.DecodeError();
+
+      DxDataIterator dec_iter = decoder.GetDxData();
+      const vpx_image_t *img;
+      while ((img = dec_iter.Next()) != NULL)
+        frame_md5.Add(img);
+    }
+    vpx_usec_timer_mark(&timer);
+    const int elapsed_time =
+        static_cast<int>(vpx_usec_timer_elapsed(&timer) / 1000);
+    printf("%s: %d frames: %5d ms, %d decrypt calls\n",
+           encrypted ? "encrypted" : "clear", frames, elapsed_time,
+           state.calls);
+    md5[encrypted] = frame_md5.Get();
+  }
+  EXPECT_EQ(md5[0], md5[1]);
+}
+
 }  // namespace libvpx_test
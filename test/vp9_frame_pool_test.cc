@@ -0,0 +1,338 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vpx_config.h"
+#include "test/encode_helper.h"
+#include "test/md5_helper.h"
+#include "vp9/common/vp9_frame_buffers.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_decoder.h"
+#include "vpx/vpx_encoder.h"
+#include "vpx_mem/vpx_mem.h"
+
+namespace {
+
+using libvpx_test::FrameList;
+
+const int kNumFrames = 3;
+
+const size_t kHugePageSize = 2 << 20;
+
+bool IsPageAligned(const uint8_t *p) {
+  return (reinterpret_cast<size_t>(p) & 4095) == 0;
+}
+
+bool IsHugePageAligned(const uint8_t *p) {
+  return (reinterpret_cast<size_t>(p) & (kHugePageSize - 1)) == 0;
+}
+
+void ExpectCleared(const uint8_t *p, size_t size) {
+  for (size_t i = 0; i < size; ++i)
+    ASSERT_EQ(0, p[i]) << "offset " << i;
+}
+
+TEST(VP9FramePoolTest, LeaseAndReturn) {
+  size_t size_a = 1000000;
+  size_t size_b = 1000000;
+  uint8_t *const a = vp9_frame_pool_lease(&size_a, 0);
+  uint8_t *const b = vp9_frame_pool_lease(&size_b, 0);
+  ASSERT_TRUE(a != NULL);
+  ASSERT_TRUE(b != NULL);
+  EXPECT_TRUE(IsPageAligned(a));
+  EXPECT_TRUE(IsPageAligned(b));
+  // Sizes are rounded up by at most a quarter.
+  EXPECT_GE(size_a, 1000000u);
+  EXPECT_LE(size_a, 1250000u);
+  EXPECT_EQ(size_a, size_b);
+  ExpectCleared(a, size_a);
+
+  // A returned buffer is taken again for any size in its class, and is
+  // cleared again.
+  memset(a, 0xa5, size_a);
+  vp9_frame_pool_return(a, size_a);
+  size_t size_c = 999000;
+  uint8_t *const c = vp9_frame_pool_lease(&size_c, 0);
+  EXPECT_EQ(a, c);
+  EXPECT_EQ(size_a, size_c);
+  ExpectCleared(c, size_c);
+
+  vp9_frame_pool_return(b, size_b);
+  vp9_frame_pool_return(c, size_c);
+}
+
+TEST(VP9FramePoolTest, EmptiesWhenAllReturned) {
+  const int kNumBuffers = 10;
+  uint8_t *buffers[kNumBuffers];
+  size_t sizes[kNumBuffers];
+  size_t leased, idle;
+
+  vp9_frame_pool_usage(&leased, &idle);
+  ASSERT_EQ(0u, leased);
+  ASSERT_EQ(0u, idle);
+  for (int i = 0; i < kNumBuffers; ++i) {
+    // Two size classes, as with a decoder that changed resolution.
+    sizes[i] = (i % 2) ? 300000 : 700000;
+    buffers[i] = vp9_frame_pool_lease(&sizes[i], 0);
+    ASSERT_TRUE(buffers[i] != NULL);
+  }
+  for (int i = 0; i < kNumBuffers; ++i) {
+    vp9_frame_pool_return(buffers[i], sizes[i]);
+    vp9_frame_pool_usage(&leased, &idle);
+    EXPECT_LE(idle, leased);
+  }
+  EXPECT_EQ(0u, leased);
+  EXPECT_EQ(0u, idle);
+}
+
+// Frame buffers of a huge page or more are aligned to one when asked, both
+// the decoder's own and those from the pool.
+TEST(VP9FramePoolTest, HugePageAlignment) {
+  for (int pooled = 0; pooled < 2; ++pooled) {
+    InternalFrameBufferList list = InternalFrameBufferList();
+    vpx_codec_frame_buffer_t large, small;
+    ASSERT_EQ(0, vp9_alloc_internal_frame_buffers(&list));
+    list.frame_pool = pooled ? VP9D_FRAME_POOL_SHARED : 0;
+    list.placement = VPX_MEM_HUGE_PAGES;
+    ASSERT_EQ(0, vp9_get_frame_buffer(&list, kHugePageSize * 3 / 2, &large));
+    ASSERT_EQ(0, vp9_get_frame_buffer(&list, 100000, &small));
+    EXPECT_TRUE(IsHugePageAligned(large.data)) << "pooled " << pooled;
+    if (pooled) {
+      EXPECT_TRUE(IsPageAligned(small.data));
+    }
+    EXPECT_EQ(0, vp9_release_frame_buffer(&list, &large));
+    EXPECT_EQ(0, vp9_release_frame_buffer(&list, &small));
+    vp9_free_internal_frame_buffers(&list);
+  }
+}
+
+// Encodes kNumFrames frames at the given size, with the frame buffers placed
+// as placement asks. Callers should wrap the call in
+// ASSERT_NO_FATAL_FAILURE().
+void EncodeFrames(int width, int height, FrameList *frames,
+                  int placement = 0) {
+  vpx_codec_enc_cfg_t cfg;
+  vpx_codec_ctx_t enc;
+
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_config_default(&vpx_codec_vp9_cx_algo, &cfg, 0));
+  cfg.g_w = width;
+  cfg.g_h = height;
+  cfg.g_lag_in_frames = 0;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo, &cfg, 0));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP8E_SET_CPUUSED, 8));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP9_SET_FRAME_PLACEMENT, placement));
+  // Not asserted, so that the encoder is destroyed whatever happens.
+  libvpx_test::EncodeMovingGradient(&enc, width, height, kNumFrames, frames);
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+}
+
+// Decodes frames with dec and adds the output to md5.
+void DecodeFrames(vpx_codec_ctx_t *dec, const FrameList &frames,
+                  libvpx_test::MD5 *md5) {
+  for (size_t i = 0; i < frames.size(); ++i) {
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(dec, &frames[i][0],
+                               static_cast<unsigned int>(frames[i].size()),
+                               NULL, 0));
+    vpx_codec_iter_t iter = NULL;
+    const vpx_image_t *img;
+    while ((img = vpx_codec_get_frame(dec, &iter)) != NULL)
+      md5->Add(img);
+  }
+}
+
+class VP9FramePoolDecodeTest : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    large_ = new FrameList;
+    small_ = new FrameList;
+    EncodeFrames(352, 288, large_);
+    EncodeFrames(176, 144, small_);
+  }
+
+  // A failure to encode in SetUpTestCase() does not stop the tests, so check
+  // for the whole streams before each one.
+  virtual void SetUp() {
+    ASSERT_EQ(static_cast<size_t>(kNumFrames), large_->size());
+    ASSERT_EQ(static_cast<size_t>(kNumFrames), small_->size());
+  }
+
+  static void TearDownTestCase() {
+    delete large_;
+    delete small_;
+    large_ = NULL;
+    small_ = NULL;
+  }
+
+  // Decodes the large and then the small stream with one decoder and
+  // returns the md5 of the output.
+  std::string DecodeBoth(int frame_pool, int placement = 0) {
+    libvpx_test::MD5 md5;
+    vpx_codec_ctx_t dec;
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_dec_init(&dec, &vpx_codec_vp9_dx_algo, NULL, 0));
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&dec, VP9D_SET_FRAME_POOL, frame_pool));
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&dec, VP9_SET_FRAME_PLACEMENT, placement));
+    DecodeFrames(&dec, *large_, &md5);
+    DecodeFrames(&dec, *small_, &md5);
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+    return md5.Get();
+  }
+
+  static FrameList *large_;
+  static FrameList *small_;
+};
+
+FrameList *VP9FramePoolDecodeTest::large_ = NULL;
+FrameList *VP9FramePoolDecodeTest::small_ = NULL;
+
+TEST_F(VP9FramePoolDecodeTest, MatchesPrivateBuffers) {
+  const std::string expected = DecodeBoth(0);
+  EXPECT_EQ(expected, DecodeBoth(VP9D_FRAME_POOL_SHARED));
+  EXPECT_EQ(expected, DecodeBoth(VP9D_FRAME_POOL_SHARED,
+                                 VP9_FRAME_HUGE_PAGES | VP9_FRAME_NUMA_LOCAL));
+}
+
+TEST_F(VP9FramePoolDecodeTest, SharedBetweenDecoders) {
+  libvpx_test::MD5 expected_large, expected_small;
+  libvpx_test::MD5 md5_large, md5_small;
+  vpx_codec_ctx_t dec_large, dec_small;
+
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_dec_init(&dec_large, &vpx_codec_vp9_dx_algo, NULL, 0));
+  DecodeFrames(&dec_large, *large_, &expected_large);
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec_large));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_dec_init(&dec_small, &vpx_codec_vp9_dx_algo, NULL, 0));
+  DecodeFrames(&dec_small, *small_, &expected_small);
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec_small));
+
+  // Interleave two decoders on the pool, frame by frame.
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_dec_init(&dec_large, &vpx_codec_vp9_dx_algo, NULL, 0));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_dec_init(&dec_small, &vpx_codec_vp9_dx_algo, NULL, 0));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec_large, VP9D_SET_FRAME_POOL,
+                                            VP9D_FRAME_POOL_SHARED));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec_small, VP9D_SET_FRAME_POOL,
+                                            VP9D_FRAME_POOL_SHARED));
+  for (int i = 0; i < kNumFrames; ++i) {
+    DecodeFrames(&dec_large, FrameList(1, (*large_)[i]), &md5_large);
+    DecodeFrames(&dec_small, FrameList(1, (*small_)[i]), &md5_small);
+  }
+  // The pool only applies before the first frame.
+  EXPECT_EQ(VPX_CODEC_ERROR,
+            vpx_codec_control(&dec_large, VP9D_SET_FRAME_POOL, 0));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec_large));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec_small));
+
+  EXPECT_STREQ(expected_large.Get(), md5_large.Get());
+  EXPECT_STREQ(expected_small.Get(), md5_small.Get());
+}
+
+TEST_F(VP9FramePoolDecodeTest, FramePlacement) {
+  const int kPlacement = VP9_FRAME_HUGE_PAGES | VP9_FRAME_NUMA_LOCAL;
+  FrameList placed;
+  ASSERT_NO_FATAL_FAILURE(EncodeFrames(352, 288, &placed, kPlacement));
+  ASSERT_EQ(large_->size(), placed.size());
+  for (size_t i = 0; i < placed.size(); ++i)
+    EXPECT_TRUE(placed[i] == (*large_)[i]) << "frame " << i;
+
+  const std::string expected = DecodeBoth(0);
+  EXPECT_EQ(expected, DecodeBoth(0, kPlacement));
+  EXPECT_EQ(expected, DecodeBoth(0, VP9_FRAME_NUMA_LOCAL));
+}
+
+TEST_F(VP9FramePoolDecodeTest, ResetMatchesNewDecoder) {
+  libvpx_test::MD5 expected_large, expected_small;
+  vpx_codec_ctx_t dec;
+
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_dec_init(&dec, &vpx_codec_vp9_dx_algo, NULL, 0));
+  DecodeFrames(&dec, *large_, &expected_large);
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_dec_init(&dec, &vpx_codec_vp9_dx_algo, NULL, 0));
+  DecodeFrames(&dec, *small_, &expected_small);
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+
+  // A reset decoder decodes each stream like a new one, whatever size it
+  // decoded before.
+  libvpx_test::MD5 md5_large, md5_small, md5_large_again;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_dec_init(&dec, &vpx_codec_vp9_dx_algo, NULL, 0));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_RESET, 0));
+  DecodeFrames(&dec, *large_, &md5_large);
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_RESET, 0));
+  DecodeFrames(&dec, *small_, &md5_small);
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_RESET, 0));
+  DecodeFrames(&dec, *large_, &md5_large_again);
+
+  // Until the next key frame it refuses inter frames.
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_RESET, 0));
+  EXPECT_NE(VPX_CODEC_OK,
+            vpx_codec_decode(&dec, &(*large_)[1][0],
+                             static_cast<unsigned int>((*large_)[1].size()),
+                             NULL, 0));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+
+  EXPECT_STREQ(expected_large.Get(), md5_large.Get());
+  EXPECT_STREQ(expected_small.Get(), md5_small.Get());
+  EXPECT_STREQ(expected_large.Get(), md5_large_again.Get());
+}
+
+TEST_F(VP9FramePoolDecodeTest, ResetFrameParallel) {
+  vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+  vpx_codec_ctx_t dec;
+  cfg.threads = 2;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_dec_init(&dec, &vpx_codec_vp9_dx_algo, &cfg,
+                               VPX_CODEC_USE_FRAME_THREADING));
+  EXPECT_EQ(VPX_CODEC_INCAPABLE, vpx_codec_control(&dec, VP9D_RESET, 0));
+  libvpx_test::MD5 md5;
+  DecodeFrames(&dec, *large_, &md5);
+  EXPECT_EQ(VPX_CODEC_INCAPABLE, vpx_codec_control(&dec, VP9D_RESET, 0));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+}
+
+TEST(VP9FramePoolControlTest, InvalidFlags) {
+  vpx_codec_ctx_t dec;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_dec_init(&dec, &vpx_codec_vp9_dx_algo, NULL, 0));
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+            vpx_codec_control(&dec, VP9D_SET_FRAME_POOL, 2));
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+            vpx_codec_control(&dec, VP9_SET_FRAME_PLACEMENT, 4));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+
+  vpx_codec_enc_cfg_t cfg;
+  vpx_codec_ctx_t enc;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_config_default(&vpx_codec_vp9_cx_algo, &cfg, 0));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo, &cfg, 0));
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+            vpx_codec_control(&enc, VP9_SET_FRAME_PLACEMENT, -1));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+}
+
+}  // namespace
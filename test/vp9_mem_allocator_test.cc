@@ -0,0 +1,193 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <limits>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vpx_config.h"
+#include "test/encode_helper.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_decoder.h"
+#include "vpx/vpx_encoder.h"
+#include "vpx_mem/vpx_arena.h"
+
+namespace {
+
+const int kWidth = 352;
+const int kHeight = 288;
+const int kNumFrames = 4;
+
+// Allocator that keeps count of the blocks it hands out.
+class CountingAllocator {
+ public:
+  CountingAllocator() : num_allocs_(0), num_live_(0) {
+    allocator_.alloc = Alloc;
+    allocator_.free = Free;
+    allocator_.priv = this;
+  }
+
+  const vpx_codec_mem_allocator_t *get() const { return &allocator_; }
+  int num_allocs() const { return num_allocs_; }
+  int num_live() const { return num_live_; }
+
+ private:
+  static void *Alloc(void *priv, size_t align, size_t size) {
+    CountingAllocator *const self = static_cast<CountingAllocator *>(priv);
+    // Over-allocate to align, keeping the original pointer before the block.
+    uint8_t *const mem =
+        static_cast<uint8_t *>(malloc(size + align + sizeof(void *)));
+    if (mem == NULL)
+      return NULL;
+    const size_t start = reinterpret_cast<size_t>(mem + sizeof(void *));
+    uint8_t *const block =
+        reinterpret_cast<uint8_t *>((start + align - 1) & ~(align - 1));
+    reinterpret_cast<void **>(block)[-1] = mem;
+    ++self->num_allocs_;
+    ++self->num_live_;
+    return block;
+  }
+
+  static void Free(void *priv, void *mem) {
+    CountingAllocator *const self = static_cast<CountingAllocator *>(priv);
+    --self->num_live_;
+    free(static_cast<void **>(mem)[-1]);
+  }
+
+  vpx_codec_mem_allocator_t allocator_;
+  int num_allocs_;
+  int num_live_;
+};
+
+bool IsAligned(const void *mem, size_t align) {
+  return (reinterpret_cast<size_t>(mem) & (align - 1)) == 0;
+}
+
+TEST(VP9MemAllocatorTest, ArenaAlignment) {
+  static const size_t kAligns[] = { 1, 8, 16, 32, 64, 128, 256, 4096 };
+  static const size_t kSizes[] = { 1, 7, 100, 5000 };
+  CountingAllocator allocator;
+  vpx_arena_t *const arena = vpx_arena_create(allocator.get(), 8192);
+  ASSERT_TRUE(arena != NULL);
+
+  // The second pass reuses the slabs of the first after a reset.
+  for (int pass = 0; pass < 2; ++pass) {
+    for (size_t i = 0; i < sizeof(kAligns) / sizeof(kAligns[0]); ++i) {
+      for (size_t j = 0; j < sizeof(kSizes) / sizeof(kSizes[0]); ++j) {
+        uint8_t *const mem = static_cast<uint8_t *>(
+            vpx_arena_memalign(arena, kAligns[i], kSizes[j]));
+        ASSERT_TRUE(mem != NULL);
+        EXPECT_TRUE(IsAligned(mem, kAligns[i]))
+            << "align " << kAligns[i] << " size " << kSizes[j];
+        memset(mem, 0xff, kSizes[j]);
+      }
+    }
+    uint8_t *const mem =
+        static_cast<uint8_t *>(vpx_arena_calloc(arena, 3, 33));
+    ASSERT_TRUE(mem != NULL);
+    EXPECT_TRUE(IsAligned(mem, 16));
+    for (int k = 0; k < 3 * 33; ++k)
+      ASSERT_EQ(0, mem[k]);
+    vpx_arena_reset(arena);
+  }
+  vpx_arena_destroy(arena);
+  EXPECT_EQ(0, allocator.num_live());
+}
+
+TEST(VP9MemAllocatorTest, ArenaOverflow) {
+  const size_t kMaxSize = std::numeric_limits<size_t>::max();
+  CountingAllocator allocator;
+  vpx_arena_t *const arena = vpx_arena_create(allocator.get(), 8192);
+  ASSERT_TRUE(arena != NULL);
+  const int num_allocs = allocator.num_allocs();
+
+  EXPECT_TRUE(vpx_arena_calloc(arena, 2, kMaxSize / 2 + 1) == NULL);
+  EXPECT_TRUE(vpx_arena_calloc(arena, kMaxSize / 16 + 1, 16) == NULL);
+  EXPECT_TRUE(vpx_arena_memalign(arena, 64, kMaxSize - 32) == NULL);
+  EXPECT_TRUE(vpx_arena_memalign(arena, 4096, kMaxSize - 4096) == NULL);
+  // Nothing was requested from the allocator.
+  EXPECT_EQ(num_allocs, allocator.num_allocs());
+  vpx_arena_destroy(arena);
+  EXPECT_EQ(0, allocator.num_live());
+}
+
+TEST(VP9MemAllocatorTest, InvalidParams) {
+  vpx_codec_mem_allocator_t allocator;
+  vpx_codec_enc_cfg_t cfg;
+  vpx_codec_ctx_t enc;
+  memset(&allocator, 0, sizeof(allocator));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_config_default(&vpx_codec_vp9_cx_algo, &cfg, 0));
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+            vpx_codec_enc_init_mem(&enc, &vpx_codec_vp9_cx_algo, &cfg, 0,
+                                   &allocator));
+#if CONFIG_VP8_ENCODER
+  CountingAllocator counting;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_config_default(&vpx_codec_vp8_cx_algo, &cfg, 0));
+  EXPECT_EQ(VPX_CODEC_INCAPABLE,
+            vpx_codec_enc_init_mem(&enc, &vpx_codec_vp8_cx_algo, &cfg, 0,
+                                   counting.get()));
+  EXPECT_EQ(0, counting.num_allocs());
+#endif
+}
+
+TEST(VP9MemAllocatorTest, EncodeAndDecode) {
+  CountingAllocator enc_allocator, dec_allocator;
+  libvpx_test::FrameList frames;
+
+  vpx_codec_enc_cfg_t cfg;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_config_default(&vpx_codec_vp9_cx_algo, &cfg, 0));
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_lag_in_frames = 0;
+  cfg.rc_end_usage = VPX_CBR;
+
+  vpx_codec_ctx_t enc;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_init_mem(&enc, &vpx_codec_vp9_cx_algo, &cfg, 0,
+                                   enc_allocator.get()));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP8E_SET_CPUUSED, 8));
+  ASSERT_NO_FATAL_FAILURE(libvpx_test::EncodeMovingGradient(
+      &enc, kWidth, kHeight, kNumFrames, &frames));
+  // The encoder and its partition tree come from a handful of slabs.
+  EXPECT_GT(enc_allocator.num_allocs(), 0);
+  EXPECT_LT(enc_allocator.num_allocs(), 16);
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+  EXPECT_EQ(0, enc_allocator.num_live());
+  ASSERT_EQ(static_cast<size_t>(kNumFrames), frames.size());
+
+#if CONFIG_VP9_DECODER
+  vpx_codec_ctx_t dec;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_dec_init_mem(&dec, &vpx_codec_vp9_dx_algo, NULL, 0,
+                                   dec_allocator.get()));
+  for (size_t i = 0; i < frames.size(); ++i) {
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&dec, &frames[i][0],
+                               static_cast<unsigned int>(frames[i].size()),
+                               NULL, 0));
+    vpx_codec_iter_t iter = NULL;
+    const vpx_image_t *const img = vpx_codec_get_frame(&dec, &iter);
+    ASSERT_TRUE(img != NULL);
+    EXPECT_EQ(static_cast<unsigned int>(kWidth), img->d_w);
+  }
+  EXPECT_GT(dec_allocator.num_allocs(), 0);
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+  EXPECT_EQ(0, dec_allocator.num_live());
+#endif  // CONFIG_VP9_DECODER
+}
+
+}  // namespace
@@ -0,0 +1,234 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vpx_config.h"
+#include "test/encode_helper.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_decoder.h"
+#include "vpx/vpx_encoder.h"
+
+namespace {
+
+const int kWidth = 640;
+const int kHeight = 360;
+const int kNumFrames = 3;
+
+void ExpectConsistent(const vp9_mem_footprint_t &fp) {
+  EXPECT_EQ(fp.frame_buffers + fp.lookahead + fp.tokens + fp.thread_data +
+            fp.context, fp.total);
+  EXPECT_GT(fp.context, 0u);
+  EXPECT_GT(fp.thread_data, 0u);
+}
+
+class VP9MemFootprintTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_enc_config_default(&vpx_codec_vp9_cx_algo, &cfg_, 0));
+    cfg_.g_w = kWidth;
+    cfg_.g_h = kHeight;
+    cfg_.g_threads = 2;
+  }
+
+  // Encodes kNumFrames frames at the configured size with enc, keeping the
+  // compressed frames. Callers should wrap the call in
+  // ASSERT_NO_FATAL_FAILURE().
+  void EncodeFrames(vpx_codec_ctx_t *enc) {
+    libvpx_test::EncodeMovingGradient(enc, cfg_.g_w, cfg_.g_h, kNumFrames,
+                                      &frames_);
+  }
+
+  // Creates an encoder with the given budget, encodes with it and sets fp to
+  // its footprint. Callers should wrap the call in ASSERT_NO_FATAL_FAILURE().
+  void EncodeWithBudget(unsigned int budget_kb, vp9_mem_footprint_t *fp) {
+    vpx_codec_ctx_t enc;
+    *fp = vp9_mem_footprint_t();
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo, &cfg_, 0));
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP8E_SET_CPUUSED, 8));
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP9E_SET_TILE_COLUMNS, 1));
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&enc, VP9E_SET_MEM_BUDGET, budget_kb));
+    // Not asserted, so that the encoder is destroyed whatever happens.
+    EncodeFrames(&enc);
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&enc, VP9_GET_MEM_FOOTPRINT, fp));
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+  }
+
+  vpx_codec_enc_cfg_t cfg_;
+  libvpx_test::FrameList frames_;
+};
+
+TEST_F(VP9MemFootprintTest, Encoder) {
+  vpx_codec_ctx_t enc;
+  vp9_mem_footprint_t before, after;
+  cfg_.g_lag_in_frames = 0;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo, &cfg_, 0));
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+            vpx_codec_control(&enc, VP9_GET_MEM_FOOTPRINT,
+                              static_cast<vp9_mem_footprint_t *>(NULL)));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP9_GET_MEM_FOOTPRINT, &before));
+  ExpectConsistent(before);
+  // The frame buffers and the token store come with the first frame.
+  EXPECT_EQ(0u, before.frame_buffers);
+  EXPECT_EQ(0u, before.lookahead);
+  EXPECT_EQ(0u, before.tokens);
+
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP8E_SET_CPUUSED, 8));
+  ASSERT_NO_FATAL_FAILURE(EncodeFrames(&enc));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP9_GET_MEM_FOOTPRINT, &after));
+  ExpectConsistent(after);
+  EXPECT_GT(after.frame_buffers, 0u);
+  EXPECT_GT(after.lookahead, 0u);
+  EXPECT_GT(after.tokens, 0u);
+  EXPECT_GT(after.total, before.total);
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+  ASSERT_EQ(static_cast<size_t>(kNumFrames), frames_.size());
+
+#if CONFIG_VP9_DECODER
+  vpx_codec_ctx_t dec;
+  vp9_mem_footprint_t dec_fp;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_dec_init(&dec, &vpx_codec_vp9_dx_algo, NULL, 0));
+  for (size_t i = 0; i < frames_.size(); ++i) {
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&dec, &frames_[i][0],
+                               static_cast<unsigned int>(frames_[i].size()),
+                               NULL, 0));
+  }
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&dec, VP9_GET_MEM_FOOTPRINT, &dec_fp));
+  EXPECT_EQ(dec_fp.frame_buffers + dec_fp.thread_data + dec_fp.context,
+            dec_fp.total);
+  EXPECT_GT(dec_fp.frame_buffers, 0u);
+  EXPECT_GT(dec_fp.context, 0u);
+  EXPECT_EQ(0u, dec_fp.lookahead);
+  EXPECT_EQ(0u, dec_fp.tokens);
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+#endif  // CONFIG_VP9_DECODER
+}
+
+TEST_F(VP9MemFootprintTest, BudgetLimitsLag) {
+  vp9_mem_footprint_t full, fitted, smallest;
+  ASSERT_NO_FATAL_FAILURE(EncodeWithBudget(0, &full));
+  ExpectConsistent(full);
+
+  // Leave room for about half of the lag frames.
+  const size_t budget = full.total - full.lookahead / 2;
+  ASSERT_NO_FATAL_FAILURE(
+      EncodeWithBudget(static_cast<unsigned int>(budget >> 10), &fitted));
+  ExpectConsistent(fitted);
+  EXPECT_LT(fitted.lookahead, full.lookahead);
+  EXPECT_GT(fitted.lookahead, full.lookahead / 4);
+  EXPECT_LE(fitted.total, budget);
+
+  // A budget that cannot be met leaves the encoder at its smallest.
+  ASSERT_NO_FATAL_FAILURE(EncodeWithBudget(1, &smallest));
+  ExpectConsistent(smallest);
+  EXPECT_LT(smallest.lookahead, fitted.lookahead);
+}
+
+TEST_F(VP9MemFootprintTest, BudgetLimitsThreads) {
+  vp9_mem_footprint_t full, smallest;
+  cfg_.g_lag_in_frames = 0;
+  ASSERT_NO_FATAL_FAILURE(EncodeWithBudget(0, &full));
+  ASSERT_NO_FATAL_FAILURE(EncodeWithBudget(1, &smallest));
+  ExpectConsistent(full);
+  ExpectConsistent(smallest);
+  EXPECT_LT(smallest.thread_data, full.thread_data);
+  EXPECT_EQ(full.lookahead, smallest.lookahead);
+}
+
+TEST_F(VP9MemFootprintTest, MaxFrameSizeReusesContext) {
+  vpx_codec_ctx_t enc;
+  vpx_max_frame_size_t max_size;
+  vp9_mem_footprint_t small, large;
+  max_size.width = kWidth;
+  max_size.height = kHeight;
+  cfg_.g_w = kWidth / 2;
+  cfg_.g_h = kHeight / 2;
+  cfg_.g_lag_in_frames = 0;
+  // A second tile column, and its thread, would only come with the larger
+  // size.
+  cfg_.g_threads = 1;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo, &cfg_, 0));
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+            vpx_codec_control(&enc, VP9E_SET_MAX_FRAME_SIZE,
+                              static_cast<vpx_max_frame_size_t *>(NULL)));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP9E_SET_MAX_FRAME_SIZE, &max_size));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP8E_SET_CPUUSED, 8));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP9E_SET_TILE_COLUMNS, 0));
+  ASSERT_NO_FATAL_FAILURE(EncodeFrames(&enc));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP9_GET_MEM_FOOTPRINT, &small));
+
+  // Going up to the declared size reuses the state allocated for it.
+  cfg_.g_w = kWidth;
+  cfg_.g_h = kHeight;
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_enc_config_set(&enc, &cfg_));
+  ASSERT_NO_FATAL_FAILURE(EncodeFrames(&enc));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP9_GET_MEM_FOOTPRINT, &large));
+  ExpectConsistent(large);
+  EXPECT_EQ(small.context, large.context);
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+  EXPECT_EQ(static_cast<size_t>(2 * kNumFrames), frames_.size());
+}
+
+// Cyclic refresh and the active map keep per-block maps, which must also be
+// sized for the declared maximum when the frame grows.
+TEST_F(VP9MemFootprintTest, MaxFrameSizeCyclicRefresh) {
+  const int mb_rows = (kHeight + 15) / 16;
+  const int mb_cols = (kWidth + 15) / 16;
+  std::vector<unsigned char> active(mb_rows * mb_cols, 1);
+  vpx_active_map_t active_map;
+  vpx_codec_ctx_t enc;
+  vpx_max_frame_size_t max_size;
+  max_size.width = kWidth;
+  max_size.height = kHeight;
+  cfg_.g_w = kWidth / 2;
+  cfg_.g_h = kHeight / 2;
+  cfg_.g_lag_in_frames = 0;
+  cfg_.rc_end_usage = VPX_CBR;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo, &cfg_, 0));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP9E_SET_MAX_FRAME_SIZE, &max_size));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP8E_SET_CPUUSED, 8));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP9E_SET_AQ_MODE, 3));
+  ASSERT_NO_FATAL_FAILURE(EncodeFrames(&enc));
+
+  cfg_.g_w = kWidth;
+  cfg_.g_h = kHeight;
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_enc_config_set(&enc, &cfg_));
+  // Leave the bottom right macroblock out, so the whole map is read.
+  active[mb_rows * mb_cols - 1] = 0;
+  active_map.active_map = &active[0];
+  active_map.rows = mb_rows;
+  active_map.cols = mb_cols;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP8E_SET_ACTIVEMAP, &active_map));
+  ASSERT_NO_FATAL_FAILURE(EncodeFrames(&enc));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+  EXPECT_EQ(static_cast<size_t>(2 * kNumFrames), frames_.size());
+}
+
+}  // namespace
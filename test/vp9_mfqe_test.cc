@@ -0,0 +1,195 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vpx_config.h"
+#include "test/md5_helper.h"
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_decoder.h"
+
+namespace {
+
+const int kNumFrames = 6;
+
+// A fixed 72x40 stream, so that the test does not depend on the encoder.
+// Neither size is a multiple of 64, so MFQE also sees superblocks past the
+// frame edge. MFQE blends in the last frame when the quality drops, so the
+// quantizer alternates between 36 and 60. Frames 0 and 3 are key frames, and
+// MFQE takes the motion of the last frame for frame 3. The content is a
+// textured gradient moving right by a pixel a frame.
+const size_t kFrameSizes[kNumFrames] = { 427, 51, 235, 114, 377, 71 };
+const uint8_t kStream[] = {
+  // Frame 0, 427 bytes.
+  0x82, 0x49, 0x83, 0x42, 0x00, 0x04, 0x70, 0x02, 0x76, 0x00, 0x38, 0x24,
+  0x1c, 0x19, 0x20, 0x00, 0x00, 0xc0, 0x7b, 0x66, 0x65, 0xd1, 0x06, 0x9e,
+  0x28, 0xe2, 0xbb, 0xe9, 0x00, 0x00, 0x6a, 0xd0, 0xff, 0xbd, 0x65, 0x12,
+  0x66, 0x2a, 0x59, 0xfa, 0xf9, 0xe0, 0x3d, 0x99, 0x97, 0x9a, 0xaa, 0x13,
+  0x1c, 0xa7, 0x36, 0x1c, 0xb9, 0xfc, 0xa7, 0xab, 0xed, 0xd4, 0x25, 0x08,
+  0xb1, 0x3a, 0x65, 0x1d, 0xaa, 0x0b, 0x3f, 0x70, 0x00, 0x11, 0xe8, 0x46,
+  0x90, 0x03, 0x2c, 0x03, 0x0b, 0x20, 0x10, 0x89, 0xd6, 0xa9, 0x14, 0x3d,
+  0x92, 0x02, 0xff, 0xda, 0x2e, 0x4f, 0x72, 0x64, 0x00, 0x00, 0x05, 0xe4,
+  0x46, 0x43, 0x52, 0x80, 0x74, 0xbd, 0x50, 0x3e, 0xf5, 0x94, 0xa9, 0x76,
+  0x9b, 0x08, 0x31, 0xcb, 0xd8, 0x30, 0xea, 0x18, 0xaf, 0xfa, 0x06, 0x77,
+  0x4b, 0xa4, 0xb0, 0xd8, 0x05, 0x60, 0xbe, 0x93, 0xbc, 0x4b, 0x41, 0x06,
+  0x6a, 0xb5, 0x1c, 0x56, 0x05, 0xa7, 0x68, 0x38, 0x00, 0x00, 0x53, 0xbd,
+  0xde, 0x57, 0x83, 0x1b, 0x5c, 0x6d, 0x32, 0x96, 0x6a, 0xe8, 0x33, 0x39,
+  0x7a, 0xa5, 0xa8, 0x69, 0xe0, 0xee, 0xe0, 0x00, 0x15, 0x5a, 0x3d, 0xb2,
+  0xd8, 0x07, 0x96, 0xa4, 0x40, 0xeb, 0x01, 0xc1, 0x35, 0xb6, 0xd0, 0xa4,
+  0xff, 0x82, 0xc4, 0x00, 0x00, 0x30, 0x65, 0x91, 0xed, 0xb5, 0xcc, 0x78,
+  0x65, 0x45, 0xb6, 0x45, 0xd3, 0x0f, 0x8d, 0x3f, 0xc9, 0x46, 0xb1, 0x00,
+  0x00, 0x31, 0x00, 0x56, 0xbe, 0xa1, 0xbe, 0x74, 0x02, 0xec, 0x8e, 0x57,
+  0x69, 0x49, 0x25, 0xcc, 0x77, 0x7a, 0xf0, 0x98, 0xe9, 0x05, 0x00, 0x3c,
+  0x94, 0x87, 0xaf, 0x2f, 0xbd, 0xc9, 0x76, 0x95, 0xcb, 0x2d, 0x77, 0x87,
+  0x49, 0x7b, 0x9a, 0x7f, 0xc8, 0x0c, 0x00, 0xc4, 0xdf, 0x34, 0xa2, 0x75,
+  0x8b, 0x4b, 0x83, 0x74, 0x01, 0x36, 0x28, 0xf7, 0x09, 0x71, 0x1f, 0x27,
+  0x66, 0x93, 0x33, 0x55, 0x8f, 0x81, 0xaa, 0x84, 0x02, 0x6a, 0xdf, 0x45,
+  0xb6, 0xb2, 0x8f, 0x94, 0x16, 0x31, 0xbb, 0xd3, 0xfb, 0xac, 0xb1, 0x53,
+  0x12, 0x9e, 0x54, 0xf3, 0xad, 0x89, 0x4d, 0x4b, 0x11, 0x3d, 0x03, 0x7f,
+  0xac, 0x3d, 0xfa, 0xbf, 0x96, 0x10, 0x75, 0xbb, 0x9f, 0xdf, 0x18, 0xe6,
+  0x30, 0xce, 0x8f, 0x68, 0xe1, 0x12, 0xf5, 0x1b, 0x42, 0x3f, 0xad, 0x67,
+  0xfe, 0xbd, 0x9e, 0x9a, 0xdb, 0xe3, 0x0d, 0x70, 0x50, 0x56, 0xc5, 0xb1,
+  0x0f, 0x16, 0xa7, 0xad, 0x83, 0xbf, 0x01, 0xaf, 0xdf, 0x64, 0xd2, 0xb2,
+  0x99, 0x06, 0x2d, 0x3e, 0xec, 0x6a, 0x24, 0x8b, 0xf7, 0x93, 0xa8, 0xed,
+  0x40, 0xd3, 0xa4, 0x85, 0xf3, 0xdc, 0x15, 0x0f, 0x13, 0x04, 0x16, 0x61,
+  0xcd, 0xd5, 0x3c, 0x91, 0x98, 0x5d, 0xe2, 0xca, 0x57, 0x0d, 0x89, 0xae,
+  0x8a, 0xaf, 0x86, 0xe7, 0x77, 0x21, 0x87, 0x8f, 0x5f, 0xfa, 0x9c, 0x2f,
+  0x83, 0xe8, 0x5b, 0xa8, 0x88, 0x07, 0x8d, 0x59, 0x60, 0xb1, 0xc7, 0x15,
+  0xff, 0x5d, 0x54, 0xa1, 0x21, 0x1d, 0x15, 0x9f, 0x58, 0x88, 0xe4, 0xac,
+  0xfc, 0xaa, 0xac, 0xbc, 0x6c, 0x03, 0x00,
+  // Frame 1, 51 bytes.
+  0x86, 0x00, 0x40, 0x92, 0x70, 0x01, 0x78, 0x00, 0x00, 0x0c, 0x60, 0x00,
+  0x00, 0x73, 0xf3, 0xed, 0x3c, 0xa3, 0x6c, 0x85, 0x44, 0x95, 0x50, 0x34,
+  0x1f, 0x71, 0xe1, 0x48, 0xb4, 0x33, 0xfa, 0x6f, 0x9d, 0xab, 0x23, 0xeb,
+  0xe9, 0x69, 0x3f, 0x20, 0xaf, 0xfb, 0x32, 0x8a, 0x8f, 0x87, 0x34, 0xf4,
+  0x97, 0xd8, 0x00,
+  // Frame 2, 235 bytes.
+  0x86, 0x00, 0x40, 0x92, 0x9c, 0x00, 0x52, 0x00, 0x00, 0x03, 0x70, 0x00,
+  0x00, 0x76, 0xbb, 0x5c, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x1d,
+  0x40, 0xf8, 0x0b, 0x2a, 0xdb, 0xb2, 0xfa, 0xfb, 0xfa, 0x00, 0x17, 0x7a,
+  0x73, 0x22, 0x08, 0xa0, 0x3d, 0x5c, 0x5d, 0x00, 0x07, 0x5e, 0xc6, 0xb8,
+  0xd2, 0x82, 0x3c, 0x0f, 0x56, 0xdb, 0xee, 0xf2, 0xdc, 0x57, 0xd0, 0xb1,
+  0x97, 0xe6, 0xea, 0x13, 0x55, 0x3b, 0x0a, 0x18, 0xdc, 0x9f, 0xcf, 0x67,
+  0x17, 0x7d, 0x03, 0x40, 0xcb, 0x91, 0x0b, 0xff, 0x9b, 0x00, 0xee, 0x25,
+  0xbe, 0x2d, 0x16, 0x49, 0xef, 0xfb, 0xa4, 0x99, 0x85, 0x22, 0xd7, 0xf3,
+  0x88, 0xff, 0xdd, 0x75, 0xe3, 0xff, 0x13, 0x6d, 0x4d, 0x88, 0x47, 0x6b,
+  0x4d, 0xc5, 0x51, 0xc0, 0xaf, 0x36, 0x73, 0x40, 0x4a, 0x7b, 0x89, 0x60,
+  0xca, 0x7c, 0x0c, 0x7f, 0xe4, 0x96, 0x7e, 0x88, 0x9a, 0x3d, 0x11, 0x55,
+  0xf2, 0x1c, 0x73, 0x36, 0x2f, 0x9c, 0x2d, 0xf1, 0x75, 0x7e, 0x0b, 0x53,
+  0xd9, 0x21, 0x69, 0x15, 0x1a, 0xb1, 0xf0, 0x58, 0x55, 0x10, 0xee, 0x8e,
+  0xb2, 0x03, 0x36, 0x4b, 0x35, 0x54, 0x7d, 0x3e, 0x9b, 0xfb, 0xb8, 0xe1,
+  0xa3, 0x71, 0x2d, 0x11, 0x90, 0xec, 0xc0, 0x95, 0x7f, 0xbc, 0xdf, 0x6b,
+  0x69, 0xcc, 0x2e, 0xf3, 0x22, 0xe9, 0xd0, 0xf6, 0x02, 0x76, 0xc8, 0x9c,
+  0x29, 0x7c, 0x08, 0x57, 0x1c, 0x3c, 0x4d, 0x06, 0xf5, 0xa0, 0x6d, 0x41,
+  0xf1, 0x7f, 0x27, 0x91, 0xa7, 0xfd, 0x1b, 0xd3, 0x41, 0x34, 0x93, 0x33,
+  0x02, 0xc4, 0xb1, 0xb8, 0xc0, 0xd1, 0x29, 0x85, 0x81, 0xf0, 0xbc, 0xe2,
+  0xd9, 0x68, 0x9b, 0x05, 0x76, 0x62, 0x00,
+  // Frame 3, 114 bytes.
+  0x82, 0x49, 0x83, 0x42, 0x00, 0x04, 0x70, 0x02, 0x76, 0x00, 0x38, 0x24,
+  0x1c, 0x19, 0xe0, 0x00, 0x00, 0x30, 0x70, 0x00, 0x00, 0x69, 0x83, 0xf8,
+  0xa9, 0x0b, 0x27, 0x7c, 0x1f, 0x4e, 0x29, 0xa5, 0x61, 0x83, 0xdd, 0x4a,
+  0x99, 0x8b, 0xb2, 0x51, 0xad, 0x5a, 0x01, 0x06, 0x97, 0x21, 0x31, 0xb5,
+  0x45, 0x97, 0x7c, 0x3f, 0x6d, 0xe9, 0x38, 0xc0, 0x9a, 0x41, 0xfb, 0xda,
+  0x44, 0x2b, 0x13, 0xde, 0x71, 0x9d, 0x01, 0x37, 0xac, 0xc9, 0xfa, 0x67,
+  0x16, 0xa6, 0x97, 0x90, 0x9a, 0x10, 0x98, 0xcf, 0x8b, 0x2f, 0x01, 0xf6,
+  0x4d, 0xef, 0x0b, 0xb6, 0x05, 0x91, 0x6a, 0xcd, 0x7f, 0xe9, 0x17, 0x34,
+  0x56, 0x0c, 0x23, 0x00, 0x2f, 0x02, 0x36, 0xae, 0x72, 0xc5, 0x3a, 0x61,
+  0x44, 0x2e, 0x8b, 0x69, 0x40, 0x00,
+  // Frame 4, 377 bytes.
+  0x86, 0x00, 0x40, 0x92, 0xac, 0x00, 0x52, 0x00, 0x00, 0x03, 0x70, 0x00,
+  0x00, 0x76, 0xbb, 0xcf, 0x24, 0x75, 0x5b, 0x55, 0x12, 0x26, 0xa0, 0x70,
+  0xe8, 0xac, 0xb8, 0xcc, 0x81, 0xd2, 0x74, 0x12, 0xf8, 0xe3, 0x4c, 0x07,
+  0xb5, 0x7f, 0xce, 0x2e, 0x95, 0x7f, 0x9f, 0x58, 0x75, 0xd6, 0xc0, 0x06,
+  0x2a, 0xe5, 0x62, 0xc1, 0x16, 0xa4, 0x06, 0xde, 0x1a, 0x5a, 0xf7, 0x32,
+  0x4a, 0x28, 0x85, 0x17, 0x32, 0x91, 0x50, 0xb6, 0xb1, 0x65, 0x80, 0x00,
+  0x4f, 0x58, 0x68, 0x89, 0xac, 0x4c, 0x55, 0x70, 0xff, 0x29, 0xd8, 0x5d,
+  0x96, 0x27, 0x59, 0xc0, 0x6d, 0xc2, 0x2e, 0x69, 0x61, 0x97, 0x70, 0x1d,
+  0x27, 0x5e, 0x75, 0xc3, 0x99, 0x8b, 0x26, 0x31, 0x61, 0x81, 0x92, 0xf4,
+  0x72, 0x75, 0x96, 0xd5, 0x8c, 0xbe, 0x90, 0x80, 0x5c, 0x07, 0xc7, 0x2e,
+  0xac, 0x4e, 0x94, 0x75, 0x6e, 0x53, 0xb2, 0x02, 0xd8, 0x7c, 0x18, 0x08,
+  0x00, 0x23, 0x58, 0x19, 0x52, 0x3d, 0x5a, 0xd3, 0x22, 0x97, 0x9c, 0x7d,
+  0xb3, 0x90, 0x91, 0x79, 0xca, 0x51, 0x52, 0xd0, 0x85, 0x36, 0xca, 0xc0,
+  0x00, 0x4e, 0xd0, 0x95, 0xc2, 0xff, 0xfe, 0x8e, 0x8d, 0xb0, 0x9e, 0xf7,
+  0x6a, 0x9f, 0xa9, 0xbe, 0x37, 0x1f, 0x7a, 0x60, 0xca, 0x6c, 0x2f, 0xe2,
+  0x02, 0x05, 0x50, 0x52, 0xf1, 0x8a, 0x46, 0xbe, 0xb2, 0x88, 0x4d, 0xab,
+  0xba, 0xa8, 0x2a, 0xed, 0x15, 0x26, 0x53, 0x2b, 0x98, 0x28, 0x5d, 0xe6,
+  0x30, 0x22, 0xe2, 0x57, 0xdd, 0x58, 0xb8, 0xbe, 0x26, 0x2f, 0x9b, 0x12,
+  0x78, 0x1c, 0x26, 0x3d, 0x70, 0x40, 0x93, 0x88, 0xd9, 0x73, 0x05, 0xe0,
+  0x76, 0x5c, 0x00, 0x28, 0xb4, 0xfe, 0x6d, 0x60, 0x6d, 0xb4, 0x6a, 0x96,
+  0x95, 0x45, 0x6d, 0x79, 0xac, 0x1f, 0x68, 0xa9, 0x6f, 0xe0, 0x31, 0xb6,
+  0x94, 0xc4, 0x3b, 0x92, 0xd2, 0xa2, 0x55, 0x3b, 0xec, 0xdd, 0x75, 0x4a,
+  0xab, 0x32, 0x2b, 0xbf, 0x3f, 0x9e, 0x8c, 0xe9, 0x0a, 0x71, 0x2b, 0xcf,
+  0xf4, 0xf2, 0x93, 0xae, 0xe1, 0xeb, 0x5d, 0x23, 0x56, 0x14, 0x96, 0x87,
+  0x2f, 0x2c, 0x5c, 0x24, 0xcf, 0x90, 0x07, 0x72, 0x81, 0x8d, 0xf2, 0xf3,
+  0xb9, 0xb5, 0x5f, 0xe9, 0x31, 0x1b, 0xfb, 0xc3, 0x26, 0x42, 0x54, 0x4b,
+  0x97, 0xdc, 0xed, 0xda, 0x4e, 0x76, 0x96, 0xb8, 0x4d, 0x4f, 0xb0, 0xa7,
+  0x9e, 0x58, 0x9d, 0xd4, 0xb0, 0xa0, 0x76, 0xa9, 0x93, 0x9b, 0x79, 0x5a,
+  0xb0, 0xbf, 0x86, 0xf3, 0xbe, 0xb3, 0x25, 0x9c, 0xd5, 0x56, 0xb6, 0x6c,
+  0xc7, 0xf0, 0xd9, 0xfb, 0x30, 0xde, 0x18, 0xac, 0x0b, 0x06, 0x53, 0x66,
+  0xe4, 0x05, 0xa5, 0xfc, 0x02, 0xe4, 0xbf, 0x14, 0x12, 0x67, 0xee, 0xd4,
+  0x39, 0xa9, 0x8a, 0x82, 0x00,
+  // Frame 5, 71 bytes.
+  0x86, 0x00, 0x40, 0x92, 0x1c, 0x0c, 0x5e, 0x00, 0x00, 0x03, 0x70, 0x00,
+  0x00, 0x75, 0xd3, 0x8e, 0x59, 0x38, 0xa2, 0xd6, 0xb4, 0x56, 0x47, 0xd0,
+  0x2b, 0xca, 0xc0, 0x1f, 0x4a, 0xa1, 0x87, 0xdb, 0xa3, 0x5a, 0x30, 0xfd,
+  0xd8, 0x00, 0x6d, 0xcb, 0x14, 0x04, 0xc6, 0x0c, 0x40, 0x6b, 0x7d, 0x5e,
+  0xd5, 0x8e, 0x47, 0xd9, 0xfe, 0x8e, 0x3f, 0xd1, 0x24, 0x70, 0xa9, 0x17,
+  0x3a, 0xf0, 0x36, 0xb6, 0x58, 0xc5, 0x15, 0x10, 0x7c, 0xb3, 0xa0,
+};
+
+void InitDecoder(vpx_codec_ctx_t *dec) {
+  vp8_postproc_cfg_t pp_cfg = { VP8_MFQE, 0, 0 };
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_dec_init(dec, &vpx_codec_vp9_dx_algo, NULL,
+                               VPX_CODEC_USE_POSTPROC));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(dec, VP8_SET_POSTPROC, &pp_cfg));
+}
+
+// Decodes kStream with |dec|. Returns the md5 of the postprocessed frames.
+std::string DecodeStream(vpx_codec_ctx_t *dec) {
+  libvpx_test::MD5 md5;
+  const uint8_t *data = kStream;
+  for (int i = 0; i < kNumFrames; ++i) {
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(dec, data,
+                               static_cast<unsigned int>(kFrameSizes[i]),
+                               NULL, 0));
+    data += kFrameSizes[i];
+    vpx_codec_iter_t iter = NULL;
+    const vpx_image_t *img;
+    while ((img = vpx_codec_get_frame(dec, &iter)) != NULL)
+      md5.Add(img);
+  }
+  return std::string(md5.Get());
+}
+
+// The md5 of kStream decoded with MFQE before the decoder kept its mode info
+// in an arena. MFQE changes frames 1, 3 and 5.
+const char kExpectedMd5[] = "e5455903238f2e84942a423afe3cc2eb";
+
+TEST(VP9MfqeTest, DecodeMatchesReference) {
+  vpx_codec_ctx_t dec;
+  ASSERT_NO_FATAL_FAILURE(InitDecoder(&dec));
+  EXPECT_EQ(kExpectedMd5, DecodeStream(&dec));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+}
+
+TEST(VP9MfqeTest, DecodeAfterReset) {
+  vpx_codec_ctx_t dec;
+  ASSERT_NO_FATAL_FAILURE(InitDecoder(&dec));
+  DecodeStream(&dec);
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_RESET, 0));
+  EXPECT_EQ(kExpectedMd5, DecodeStream(&dec));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+}
+
+}  // namespace
@@ -0,0 +1,227 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+#include "./vpx_config.h"
+#include "./vp9_rtcd.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+
+using libvpx_test::ACMRandom;
+
+namespace {
+
+const int kNumIterations = 100;
+// Room for the 8 pixels the macroblock filters read and write past each edge.
+const int kBorder = 16;
+const int kMaxSize = 80;
+const int kStride = kMaxSize + 2 * kBorder;
+const int kBufSize = kStride * kStride;
+
+typedef void (*DownAndAcrossFunc)(const uint8_t *src_ptr, uint8_t *dst_ptr,
+                                  int src_pixels_per_line,
+                                  int dst_pixels_per_line, int rows, int cols,
+                                  int flimit);
+typedef void (*MbPostProcFunc)(uint8_t *src, int pitch, int rows, int cols,
+                               int flimit);
+typedef void (*BlockStatsFunc)(const uint8_t *src, int src_stride,
+                               const uint8_t *ref, int ref_stride, int size,
+                               unsigned int *sad, unsigned int *var);
+typedef std::tr1::tuple<DownAndAcrossFunc, DownAndAcrossFunc>
+    DownAndAcrossParam;
+typedef std::tr1::tuple<MbPostProcFunc, MbPostProcFunc> MbPostProcParam;
+typedef std::tr1::tuple<BlockStatsFunc, BlockStatsFunc> BlockStatsParam;
+
+// Fills |buf| with pixels around a base level that varies by at most
+// |range|, so that the filters have flat areas to smooth.
+void FillBlock(ACMRandom *rnd, uint8_t *buf, int size, int range) {
+  const int base = rnd->Rand8();
+  for (int i = 0; i < size; ++i) {
+    const int pixel = base - range / 2 + rnd->PseudoUniform(range + 1);
+    buf[i] = pixel < 0 ? 0 : pixel > 255 ? 255 : pixel;
+  }
+}
+
+int RandomSize(ACMRandom *rnd) {
+  return 8 + rnd->PseudoUniform(kMaxSize - 8 + 1);
+}
+
+class VP9PostProcDownAndAcrossTest
+    : public ::testing::TestWithParam<DownAndAcrossParam> {
+ public:
+  virtual ~VP9PostProcDownAndAcrossTest() {}
+
+  virtual void SetUp() {
+    ref_func_ = GET_PARAM(0);
+    func_ = GET_PARAM(1);
+  }
+
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+ protected:
+  DownAndAcrossFunc ref_func_;
+  DownAndAcrossFunc func_;
+};
+
+TEST_P(VP9PostProcDownAndAcrossTest, CompareReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, uint8_t, src[kBufSize]);
+  DECLARE_ALIGNED(16, uint8_t, dst_ref[kBufSize]);
+  DECLARE_ALIGNED(16, uint8_t, dst[kBufSize]);
+  const int offset = kBorder * kStride + kBorder;
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int rows = RandomSize(&rnd);
+    const int cols = RandomSize(&rnd);
+    const int flimit = rnd.PseudoUniform(64);
+
+    FillBlock(&rnd, src, kBufSize, i % 2 ? 255 : 16);
+    memset(dst_ref, 0, sizeof(dst_ref));
+    memset(dst, 0, sizeof(dst));
+
+    // The destination has the same stride as the source, as in vp9_deblock().
+    ref_func_(src + offset, dst_ref + offset, kStride, kStride, rows, cols,
+              flimit);
+    ASM_REGISTER_STATE_CHECK(func_(src + offset, dst + offset, kStride,
+                                   kStride, rows, cols, flimit));
+    for (int r = 0; r < rows; ++r) {
+      ASSERT_EQ(0, memcmp(dst_ref + offset + r * kStride,
+                          dst + offset + r * kStride, cols))
+          << "iteration " << i << " row " << r << " size " << cols << "x"
+          << rows << " flimit " << flimit;
+    }
+  }
+}
+
+class VP9MbPostProcTest : public ::testing::TestWithParam<MbPostProcParam> {
+ public:
+  virtual ~VP9MbPostProcTest() {}
+
+  virtual void SetUp() {
+    ref_func_ = GET_PARAM(0);
+    func_ = GET_PARAM(1);
+  }
+
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+ protected:
+  MbPostProcFunc ref_func_;
+  MbPostProcFunc func_;
+};
+
+TEST_P(VP9MbPostProcTest, CompareReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, uint8_t, buf_ref[kBufSize]);
+  DECLARE_ALIGNED(16, uint8_t, buf[kBufSize]);
+  const int offset = kBorder * kStride + kBorder;
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int rows = RandomSize(&rnd);
+    const int cols = RandomSize(&rnd);
+    // Covers the limits q2mbl() gives.
+    const int flimit = rnd.PseudoUniform(20000);
+    const unsigned int seed = rnd.Rand16();
+
+    FillBlock(&rnd, buf_ref, kBufSize, i % 2 ? 255 : 16);
+    memcpy(buf, buf_ref, sizeof(buf));
+
+    // vp9_mbpost_proc_down() takes its dither from rand().
+    srand(seed);
+    ref_func_(buf_ref + offset, kStride, rows, cols, flimit);
+    srand(seed);
+    ASM_REGISTER_STATE_CHECK(func_(buf + offset, kStride, rows, cols, flimit));
+    // Only the block itself is compared; the C versions leave garbage in the
+    // border they filter through.
+    for (int r = 0; r < rows; ++r) {
+      ASSERT_EQ(0, memcmp(buf_ref + offset + r * kStride,
+                          buf + offset + r * kStride, cols))
+          << "iteration " << i << " row " << r << " size " << cols << "x"
+          << rows << " flimit " << flimit;
+    }
+  }
+}
+
+class VP9MfqeBlockStatsTest
+    : public ::testing::TestWithParam<BlockStatsParam> {
+ public:
+  virtual ~VP9MfqeBlockStatsTest() {}
+
+  virtual void SetUp() {
+    ref_func_ = GET_PARAM(0);
+    func_ = GET_PARAM(1);
+  }
+
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+ protected:
+  BlockStatsFunc ref_func_;
+  BlockStatsFunc func_;
+};
+
+TEST_P(VP9MfqeBlockStatsTest, CompareReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, uint8_t, src[kBufSize]);
+  DECLARE_ALIGNED(16, uint8_t, ref[kBufSize]);
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int size = 16 << (i % 3);
+    // MFQE's blocks are at any alignment.
+    const int src_offset = rnd.PseudoUniform(kStride - size + 1);
+    const int ref_offset = rnd.PseudoUniform(kStride - size + 1);
+    unsigned int sad_ref, var_ref, sad, var;
+
+    if (i < 3) {
+      // The largest differences.
+      memset(src, 255, sizeof(src));
+      memset(ref, 0, sizeof(ref));
+    } else {
+      FillBlock(&rnd, src, kBufSize, i % 2 ? 255 : 16);
+      FillBlock(&rnd, ref, kBufSize, i % 2 ? 255 : 16);
+    }
+
+    ref_func_(src + src_offset, kStride, ref + ref_offset, kStride, size,
+              &sad_ref, &var_ref);
+    ASM_REGISTER_STATE_CHECK(func_(src + src_offset, kStride,
+                                   ref + ref_offset, kStride, size, &sad,
+                                   &var));
+    ASSERT_EQ(sad_ref, sad) << "iteration " << i << " size " << size;
+    ASSERT_EQ(var_ref, var) << "iteration " << i << " size " << size;
+  }
+}
+
+using std::tr1::make_tuple;
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, VP9PostProcDownAndAcrossTest,
+    ::testing::Values(make_tuple(&vp9_post_proc_down_and_across_c,
+                                 &vp9_post_proc_down_and_across_avx2)));
+
+INSTANTIATE_TEST_CASE_P(
+    AVX2, VP9MbPostProcTest,
+    ::testing::Values(make_tuple(&vp9_mbpost_proc_down_c,
+                                 &vp9_mbpost_proc_down_avx2),
+                      make_tuple(&vp9_mbpost_proc_across_ip_c,
+                                 &vp9_mbpost_proc_across_ip_avx2)));
+
+INSTANTIATE_TEST_CASE_P(
+    AVX2, VP9MfqeBlockStatsTest,
+    ::testing::Values(make_tuple(&vp9_mfqe_block_stats_c,
+                                 &vp9_mfqe_block_stats_avx2)));
+#endif  // HAVE_AVX2
+}  // namespace
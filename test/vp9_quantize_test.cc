@@ -346,6 +346,45 @@ INSTANTIATE_TEST_CASE_P(
                    &vp9_highbd_quantize_b_32x32_c, VPX_BITS_10),
         make_tuple(&vp9_highbd_quantize_b_32x32_sse2,
                    &vp9_highbd_quantize_b_32x32_c, VPX_BITS_12)));
+INSTANTIATE_TEST_CASE_P(
+    SSE2_FP, VP9QuantizeTest,
+    ::testing::Values(
+        make_tuple(&vp9_highbd_quantize_fp_sse2,
+                   &vp9_highbd_quantize_fp_c, VPX_BITS_8),
+        make_tuple(&vp9_highbd_quantize_fp_sse2,
+                   &vp9_highbd_quantize_fp_c, VPX_BITS_10),
+        make_tuple(&vp9_highbd_quantize_fp_sse2,
+                   &vp9_highbd_quantize_fp_c, VPX_BITS_12)));
+INSTANTIATE_TEST_CASE_P(
+    SSE2_FP, VP9Quantize32Test,
+    ::testing::Values(
+        make_tuple(&vp9_highbd_quantize_fp_32x32_sse2,
+                   &vp9_highbd_quantize_fp_32x32_c, VPX_BITS_8),
+        make_tuple(&vp9_highbd_quantize_fp_32x32_sse2,
+                   &vp9_highbd_quantize_fp_32x32_c, VPX_BITS_10),
+        make_tuple(&vp9_highbd_quantize_fp_32x32_sse2,
+                   &vp9_highbd_quantize_fp_32x32_c, VPX_BITS_12)));
 #endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2_FP, VP9QuantizeTest,
+    ::testing::Values(
+        make_tuple(&vp9_highbd_quantize_fp_avx2,
+                   &vp9_highbd_quantize_fp_c, VPX_BITS_8),
+        make_tuple(&vp9_highbd_quantize_fp_avx2,
+                   &vp9_highbd_quantize_fp_c, VPX_BITS_10),
+        make_tuple(&vp9_highbd_quantize_fp_avx2,
+                   &vp9_highbd_quantize_fp_c, VPX_BITS_12)));
+INSTANTIATE_TEST_CASE_P(
+    AVX2_FP, VP9Quantize32Test,
+    ::testing::Values(
+        make_tuple(&vp9_highbd_quantize_fp_32x32_avx2,
+                   &vp9_highbd_quantize_fp_32x32_c, VPX_BITS_8),
+        make_tuple(&vp9_highbd_quantize_fp_32x32_avx2,
+                   &vp9_highbd_quantize_fp_32x32_c, VPX_BITS_10),
+        make_tuple(&vp9_highbd_quantize_fp_32x32_avx2,
+                   &vp9_highbd_quantize_fp_32x32_c, VPX_BITS_12)));
+#endif  // HAVE_AVX2
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 }  // namespace
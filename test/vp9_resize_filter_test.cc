@@ -0,0 +1,227 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+#include "./vpx_config.h"
+#include "./vp9_rtcd.h"
+
+using libvpx_test::ACMRandom;
+
+namespace {
+const int kNumIterations = 1000;
+const int kTaps = 8;
+const int kMaxWidth = 80;
+const int kLineSize = 2 * kMaxWidth + 2 * kTaps;
+const int kNumFilters = 4;
+
+// Returns sum(filter[k] * px[k * step]) rounded and clipped to [0, max].
+template <typename Pixel>
+Pixel ReferenceFilter(const Pixel *px, int step, const int16_t *filter,
+                      int max) {
+  int sum = 0;
+  for (int k = 0; k < kTaps; ++k)
+    sum += filter[k] * px[k * step];
+  sum = (sum + 64) >> 7;
+  return static_cast<Pixel>(sum < 0 ? 0 : (sum > max ? max : sum));
+}
+
+// Random taps, with the first filter made to sum to 128 like the resize
+// filters, and the rest left free to exercise the clipping.
+void RandomFilters(ACMRandom *rnd, int16_t filters[kNumFilters][kTaps]) {
+  for (int i = 0; i < kNumFilters; ++i) {
+    int sum = 0;
+    for (int k = 0; k < kTaps; ++k) {
+      filters[i][k] = static_cast<int16_t>(rnd->Rand8() - 128);
+      sum += filters[i][k];
+    }
+    if (i == 0)
+      filters[i][3] = static_cast<int16_t>(filters[i][3] + 128 - sum);
+  }
+}
+
+template <typename Pixel>
+void RandomPixels(ACMRandom *rnd, Pixel *px, int n, int max, bool extremes) {
+  for (int i = 0; i < n; ++i)
+    px[i] = static_cast<Pixel>(extremes ? (rnd->Rand8() & 1) * max
+                                        : rnd->Rand16() % (max + 1));
+}
+
+typedef void (*ResizeFilterHorzFunc)(const uint8_t *src, uint8_t *dst, int w,
+                                     const int *offsets,
+                                     const int16_t *const *filters);
+typedef void (*ResizeFilterVertFunc)(const uint8_t *const *src, uint8_t *dst,
+                                     int w, const int16_t *filter);
+typedef std::tr1::tuple<ResizeFilterHorzFunc, ResizeFilterVertFunc>
+    ResizeFilterParam;
+
+class ResizeFilterTest : public ::testing::TestWithParam<ResizeFilterParam> {
+ public:
+  virtual ~ResizeFilterTest() {}
+  virtual void SetUp() {
+    horz_ = GET_PARAM(0);
+    vert_ = GET_PARAM(1);
+  }
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+ protected:
+  ResizeFilterHorzFunc horz_;
+  ResizeFilterVertFunc vert_;
+};
+
+TEST_P(ResizeFilterTest, HorzMatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  uint8_t src[kLineSize], ref[kMaxWidth], out[kMaxWidth];
+  int16_t filters[kNumFilters][kTaps];
+  int offsets[kMaxWidth];
+  const int16_t *filter_ptrs[kMaxWidth];
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int w = rnd(kMaxWidth + 1);
+    RandomFilters(&rnd, filters);
+    RandomPixels(&rnd, src, kLineSize, 255, (i & 1) != 0);
+    for (int x = 0; x < w; ++x) {
+      // Positions step by 1 or 2 with some jitter, as the resize passes do.
+      offsets[x] = (x * (1 + (i & 2) / 2)) + rnd(kTaps);
+      filter_ptrs[x] = filters[rnd(kNumFilters)];
+      ref[x] = ReferenceFilter(src + offsets[x], 1, filter_ptrs[x], 255);
+    }
+    ASM_REGISTER_STATE_CHECK(horz_(src, out, w, offsets, filter_ptrs));
+    for (int x = 0; x < w; ++x)
+      ASSERT_EQ(ref[x], out[x]) << "iteration " << i << " x " << x;
+  }
+}
+
+TEST_P(ResizeFilterTest, VertMatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  uint8_t src[kTaps * kMaxWidth], ref[kMaxWidth], out[kMaxWidth];
+  int16_t filters[kNumFilters][kTaps];
+  const uint8_t *rows[kTaps];
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int w = rnd(kMaxWidth + 1);
+    RandomFilters(&rnd, filters);
+    RandomPixels(&rnd, src, kTaps * kMaxWidth, 255, (i & 1) != 0);
+    for (int k = 0; k < kTaps; ++k)
+      rows[k] = src + kMaxWidth * k;
+    for (int x = 0; x < w; ++x)
+      ref[x] = ReferenceFilter(src + x, kMaxWidth, filters[i % kNumFilters],
+                               255);
+    ASM_REGISTER_STATE_CHECK(vert_(rows, out, w, filters[i % kNumFilters]));
+    for (int x = 0; x < w; ++x)
+      ASSERT_EQ(ref[x], out[x]) << "iteration " << i << " x " << x;
+  }
+}
+
+using std::tr1::make_tuple;
+
+INSTANTIATE_TEST_CASE_P(
+    C, ResizeFilterTest,
+    ::testing::Values(make_tuple(&vp9_resize_filter_horz_c,
+                                 &vp9_resize_filter_vert_c)));
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(
+    SSE2, ResizeFilterTest,
+    ::testing::Values(make_tuple(&vp9_resize_filter_horz_sse2,
+                                 &vp9_resize_filter_vert_sse2)));
+#endif  // HAVE_SSE2
+
+#if CONFIG_VP9_HIGHBITDEPTH
+typedef void (*HighbdResizeFilterHorzFunc)(const uint16_t *src, uint16_t *dst,
+                                           int w, const int *offsets,
+                                           const int16_t *const *filters,
+                                           int bd);
+typedef void (*HighbdResizeFilterVertFunc)(const uint16_t *const *src,
+                                           uint16_t *dst, int w,
+                                           const int16_t *filter, int bd);
+typedef std::tr1::tuple<HighbdResizeFilterHorzFunc, HighbdResizeFilterVertFunc>
+    HighbdResizeFilterParam;
+
+class HighbdResizeFilterTest
+    : public ::testing::TestWithParam<HighbdResizeFilterParam> {
+ public:
+  virtual ~HighbdResizeFilterTest() {}
+  virtual void SetUp() {
+    horz_ = GET_PARAM(0);
+    vert_ = GET_PARAM(1);
+  }
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+ protected:
+  HighbdResizeFilterHorzFunc horz_;
+  HighbdResizeFilterVertFunc vert_;
+};
+
+TEST_P(HighbdResizeFilterTest, HorzMatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  uint16_t src[kLineSize], ref[kMaxWidth], out[kMaxWidth];
+  int16_t filters[kNumFilters][kTaps];
+  int offsets[kMaxWidth];
+  const int16_t *filter_ptrs[kMaxWidth];
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int w = rnd(kMaxWidth + 1);
+    const int bd = (i & 4) ? 12 : 10;
+    const int max = (1 << bd) - 1;
+    RandomFilters(&rnd, filters);
+    RandomPixels(&rnd, src, kLineSize, max, (i & 1) != 0);
+    for (int x = 0; x < w; ++x) {
+      offsets[x] = (x * (1 + (i & 2) / 2)) + rnd(kTaps);
+      filter_ptrs[x] = filters[rnd(kNumFilters)];
+      ref[x] = ReferenceFilter(src + offsets[x], 1, filter_ptrs[x], max);
+    }
+    ASM_REGISTER_STATE_CHECK(horz_(src, out, w, offsets, filter_ptrs, bd));
+    for (int x = 0; x < w; ++x)
+      ASSERT_EQ(ref[x], out[x]) << "iteration " << i << " x " << x;
+  }
+}
+
+TEST_P(HighbdResizeFilterTest, VertMatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  uint16_t src[kTaps * kMaxWidth], ref[kMaxWidth], out[kMaxWidth];
+  int16_t filters[kNumFilters][kTaps];
+  const uint16_t *rows[kTaps];
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int w = rnd(kMaxWidth + 1);
+    const int bd = (i & 4) ? 12 : 10;
+    const int max = (1 << bd) - 1;
+    RandomFilters(&rnd, filters);
+    RandomPixels(&rnd, src, kTaps * kMaxWidth, max, (i & 1) != 0);
+    for (int k = 0; k < kTaps; ++k)
+      rows[k] = src + kMaxWidth * k;
+    for (int x = 0; x < w; ++x)
+      ref[x] = ReferenceFilter(src + x, kMaxWidth, filters[i % kNumFilters],
+                               max);
+    ASM_REGISTER_STATE_CHECK(
+        vert_(rows, out, w, filters[i % kNumFilters], bd));
+    for (int x = 0; x < w; ++x)
+      ASSERT_EQ(ref[x], out[x]) << "iteration " << i << " x " << x;
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(
+    C, HighbdResizeFilterTest,
+    ::testing::Values(make_tuple(&vp9_highbd_resize_filter_horz_c,
+                                 &vp9_highbd_resize_filter_vert_c)));
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(
+    SSE2, HighbdResizeFilterTest,
+    ::testing::Values(make_tuple(&vp9_highbd_resize_filter_horz_sse2,
+                                 &vp9_highbd_resize_filter_vert_sse2)));
+#endif  // HAVE_SSE2
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+}  // namespace
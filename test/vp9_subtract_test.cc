@@ -101,4 +101,71 @@ INSTANTIATE_TEST_CASE_P(NEON, VP9SubtractBlockTest,
                         ::testing::Values(vpx_subtract_block_neon));
 #endif
 
+#if CONFIG_VP9_HIGHBITDEPTH
+typedef void (*HBDSubtractFunc)(int rows, int cols,
+                                int16_t *diff_ptr, ptrdiff_t diff_stride,
+                                const uint8_t *src_ptr, ptrdiff_t src_stride,
+                                const uint8_t *pred_ptr, ptrdiff_t pred_stride,
+                                int bd);
+
+class VP9HBDSubtractBlockTest
+    : public ::testing::TestWithParam<HBDSubtractFunc> {
+ public:
+  virtual void TearDown() {
+    libvpx_test::ClearSystemState();
+  }
+};
+
+TEST_P(VP9HBDSubtractBlockTest, SimpleSubtract) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+
+  for (BLOCK_SIZE bsize = BLOCK_4X4; bsize < BLOCK_SIZES;
+       bsize = static_cast<BLOCK_SIZE>(static_cast<int>(bsize) + 1)) {
+    const int block_width = 4 * num_4x4_blocks_wide_lookup[bsize];
+    const int block_height = 4 * num_4x4_blocks_high_lookup[bsize];
+    const int stride = block_width * 2;
+    int16_t *diff = reinterpret_cast<int16_t *>(
+        vpx_memalign(16, sizeof(*diff) * block_height * stride));
+    uint16_t *pred = reinterpret_cast<uint16_t *>(
+        vpx_memalign(16, sizeof(*pred) * block_height * stride));
+    uint16_t *src  = reinterpret_cast<uint16_t *>(
+        vpx_memalign(16, sizeof(*src) * block_height * stride));
+
+    for (int n = 0; n < 100; n++) {
+      for (int r = 0; r < block_height; ++r) {
+        for (int c = 0; c < stride; ++c) {
+          src[r * stride + c] = rnd.Rand16() & 0xfff;
+          pred[r * stride + c] = rnd.Rand16() & 0xfff;
+        }
+      }
+
+      GetParam()(block_height, block_width, diff, stride,
+                 CONVERT_TO_BYTEPTR(src), stride,
+                 CONVERT_TO_BYTEPTR(pred), stride, 12);
+
+      for (int r = 0; r < block_height; ++r) {
+        for (int c = 0; c < block_width; ++c) {
+          EXPECT_EQ(diff[r * stride + c],
+                    (src[r * stride + c] -
+                     pred[r * stride + c])) << "r = " << r
+                                            << ", c = " << c
+                                            << ", bs = " << bsize;
+        }
+      }
+    }
+    vpx_free(diff);
+    vpx_free(pred);
+    vpx_free(src);
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(C, VP9HBDSubtractBlockTest,
+                        ::testing::Values(vpx_highbd_subtract_block_c));
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(SSE2, VP9HBDSubtractBlockTest,
+                        ::testing::Values(vpx_highbd_subtract_block_sse2));
+#endif
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
 }  // namespace vp9
@@ -0,0 +1,233 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+#include "./vpx_config.h"
+#include "./vp9_rtcd.h"
+#include "vpx/vpx_codec.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+
+extern "C" void vp9_temporal_filter_init(void);
+
+using libvpx_test::ACMRandom;
+
+namespace {
+
+const int kStride = 48;
+const int kMaxSize = 16 * 16;
+const int kNumIterations = 200;
+
+// The block sizes the temporal filter works on: luma and 4:2:0, 4:2:2 and
+// 4:4:4 chroma.
+const int kBlockSizes[][2] = { { 16, 16 }, { 8, 8 }, { 8, 16 }, { 16, 8 } };
+
+typedef void (*ApplyFunc)(uint8_t *frame1, unsigned int stride,
+                          uint8_t *frame2, unsigned int block_width,
+                          unsigned int block_height, int strength,
+                          int filter_weight, unsigned int *accumulator,
+                          uint16_t *count);
+typedef void (*NormalizeFunc)(const unsigned int *accumulator,
+                              const uint16_t *count, unsigned int block_width,
+                              unsigned int block_height, uint8_t *dst,
+                              int stride);
+typedef std::tr1::tuple<ApplyFunc, ApplyFunc, vpx_bit_depth_t> ApplyParam;
+typedef std::tr1::tuple<NormalizeFunc, NormalizeFunc, vpx_bit_depth_t>
+    NormalizeParam;
+
+class TemporalFilterApplyTest : public ::testing::TestWithParam<ApplyParam> {
+ public:
+  virtual ~TemporalFilterApplyTest() {}
+
+  virtual void SetUp() {
+    ref_func_ = GET_PARAM(0);
+    func_ = GET_PARAM(1);
+    bit_depth_ = GET_PARAM(2);
+    mask_ = (1 << bit_depth_) - 1;
+  }
+
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+ protected:
+  uint8_t *Pointer(uint16_t *buf) const {
+#if CONFIG_VP9_HIGHBITDEPTH
+    if (bit_depth_ != VPX_BITS_8)
+      return CONVERT_TO_BYTEPTR(buf);
+#endif
+    return reinterpret_cast<uint8_t *>(buf);
+  }
+
+  void Fill(ACMRandom *rnd, uint16_t *buf, int size) const {
+    uint8_t *const buf8 = reinterpret_cast<uint8_t *>(buf);
+    for (int i = 0; i < size; ++i) {
+      if (bit_depth_ == VPX_BITS_8)
+        buf8[i] = rnd->Rand8();
+      else
+        buf[i] = rnd->Rand16() & mask_;
+    }
+  }
+
+  ApplyFunc ref_func_;
+  ApplyFunc func_;
+  vpx_bit_depth_t bit_depth_;
+  int mask_;
+};
+
+TEST_P(TemporalFilterApplyTest, CompareReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, uint16_t, frame1[kStride * 16]);
+  DECLARE_ALIGNED(16, uint16_t, frame2[kMaxSize]);
+  DECLARE_ALIGNED(16, unsigned int, acc_ref[kMaxSize]);
+  DECLARE_ALIGNED(16, unsigned int, acc[kMaxSize]);
+  DECLARE_ALIGNED(16, uint16_t, count_ref[kMaxSize]);
+  DECLARE_ALIGNED(16, uint16_t, count[kMaxSize]);
+  // The encoder raises the strength by two per bit above 8.
+  const int max_strength = 6 + 2 * (bit_depth_ - 8);
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int *const size = kBlockSizes[i % 4];
+    const int strength = rnd(max_strength + 1);
+    const int filter_weight = rnd(3);
+
+    Fill(&rnd, frame1, kStride * 16);
+    Fill(&rnd, frame2, kMaxSize);
+    if (i % 2 == 0) {
+      // Make some pixels close enough to be filtered at any strength.
+      for (int j = 0; j < kMaxSize; j += 2) {
+        if (bit_depth_ == VPX_BITS_8)
+          reinterpret_cast<uint8_t *>(frame2)[j] =
+              reinterpret_cast<uint8_t *>(frame1)[j];
+        else
+          frame2[j] = frame1[j];
+      }
+    }
+    for (int j = 0; j < kMaxSize; ++j) {
+      acc_ref[j] = acc[j] = rnd.Rand16();
+      count_ref[j] = count[j] = rnd(256);
+    }
+
+    ref_func_(Pointer(frame1), kStride, Pointer(frame2), size[0], size[1],
+              strength, filter_weight, acc_ref, count_ref);
+    ASM_REGISTER_STATE_CHECK(
+        func_(Pointer(frame1), kStride, Pointer(frame2), size[0], size[1],
+              strength, filter_weight, acc, count));
+    for (int j = 0; j < kMaxSize; ++j) {
+      ASSERT_EQ(acc_ref[j], acc[j]) << "iteration " << i << " index " << j;
+      ASSERT_EQ(count_ref[j], count[j]) << "iteration " << i << " index " << j;
+    }
+  }
+}
+
+class TemporalFilterNormalizeTest
+    : public ::testing::TestWithParam<NormalizeParam> {
+ public:
+  virtual ~TemporalFilterNormalizeTest() {}
+
+  static void SetUpTestCase() {
+    // Sets up the reciprocals the C version divides with.
+    vp9_temporal_filter_init();
+  }
+
+  virtual void SetUp() {
+    ref_func_ = GET_PARAM(0);
+    func_ = GET_PARAM(1);
+    bit_depth_ = GET_PARAM(2);
+    mask_ = (1 << bit_depth_) - 1;
+  }
+
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+ protected:
+  uint8_t *Pointer(uint16_t *buf) const {
+#if CONFIG_VP9_HIGHBITDEPTH
+    if (bit_depth_ != VPX_BITS_8)
+      return CONVERT_TO_BYTEPTR(buf);
+#endif
+    return reinterpret_cast<uint8_t *>(buf);
+  }
+
+  NormalizeFunc ref_func_;
+  NormalizeFunc func_;
+  vpx_bit_depth_t bit_depth_;
+  int mask_;
+};
+
+TEST_P(TemporalFilterNormalizeTest, CompareReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, unsigned int, acc[kMaxSize]);
+  DECLARE_ALIGNED(16, uint16_t, count[kMaxSize]);
+  DECLARE_ALIGNED(16, uint16_t, dst_ref[kStride * 16]);
+  DECLARE_ALIGNED(16, uint16_t, dst[kStride * 16]);
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int *const size = kBlockSizes[i % 4];
+    // Every count below the fixed_divide[] table size, and an accumulator
+    // of at most count * mask_, as the filter produces them.
+    for (int j = 0; j < kMaxSize; ++j) {
+      const int pixel = rnd.Rand16() & mask_;
+      count[j] = (i == 0) ? j % 2 : rnd(512);
+      acc[j] = count[j] * pixel +
+               ((count[j] && pixel < mask_) ? rnd(count[j]) : 0);
+    }
+    memset(dst_ref, 0, sizeof(dst_ref));
+    memset(dst, 0, sizeof(dst));
+
+    ref_func_(acc, count, size[0], size[1], Pointer(dst_ref), kStride);
+    ASM_REGISTER_STATE_CHECK(
+        func_(acc, count, size[0], size[1], Pointer(dst), kStride));
+    ASSERT_EQ(0, memcmp(dst_ref, dst, sizeof(dst))) << "iteration " << i;
+  }
+}
+
+using std::tr1::make_tuple;
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(
+    SSE2, TemporalFilterApplyTest,
+    ::testing::Values(
+        make_tuple(&vp9_temporal_filter_apply_c,
+                   &vp9_temporal_filter_apply_sse2, VPX_BITS_8)));
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, TemporalFilterApplyTest,
+    ::testing::Values(
+        make_tuple(&vp9_temporal_filter_apply_c,
+                   &vp9_temporal_filter_apply_avx2, VPX_BITS_8)
+#if CONFIG_VP9_HIGHBITDEPTH
+        , make_tuple(&vp9_highbd_temporal_filter_apply_c,
+                     &vp9_highbd_temporal_filter_apply_avx2, VPX_BITS_10),
+        make_tuple(&vp9_highbd_temporal_filter_apply_c,
+                   &vp9_highbd_temporal_filter_apply_avx2, VPX_BITS_12)
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+        ));
+
+INSTANTIATE_TEST_CASE_P(
+    AVX2, TemporalFilterNormalizeTest,
+    ::testing::Values(
+        make_tuple(&vp9_temporal_filter_normalize_c,
+                   &vp9_temporal_filter_normalize_avx2, VPX_BITS_8)
+#if CONFIG_VP9_HIGHBITDEPTH
+        , make_tuple(&vp9_highbd_temporal_filter_normalize_c,
+                     &vp9_highbd_temporal_filter_normalize_avx2, VPX_BITS_10),
+        make_tuple(&vp9_highbd_temporal_filter_normalize_c,
+                   &vp9_highbd_temporal_filter_normalize_avx2, VPX_BITS_12)
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+        ));
+#endif  // HAVE_AVX2
+}  // namespace
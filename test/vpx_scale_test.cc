@@ -210,6 +210,20 @@ TEST_P(ExtendBorderTest, ExtendBorder) {
 INSTANTIATE_TEST_CASE_P(C, ExtendBorderTest,
                         ::testing::Values(vp8_yv12_extend_frame_borders_c));
 
+#if CONFIG_VP9
+// Extends the borders a band of rows at a time, as the VP9 encoder does on
+// its worker threads.
+void ExtendFrameBordersInBands(YV12_BUFFER_CONFIG *ybf) {
+  const int kNumBands = 5;
+  for (int band = 0; band < kNumBands; ++band)
+    vp9_extend_frame_borders_band(ybf, ybf->border, band, kNumBands);
+}
+
+INSTANTIATE_TEST_CASE_P(VP9, ExtendBorderTest,
+                        ::testing::Values(vp9_extend_frame_borders_c,
+                                          ExtendFrameBordersInBands));
+#endif  // CONFIG_VP9
+
 class CopyFrameTest
     : public VpxScaleBase,
       public ::testing::TestWithParam<CopyFrameFunc> {
@@ -643,10 +643,11 @@ static vpx_codec_err_t vp8e_mr_alloc_mem(const vpx_codec_enc_cfg_t *cfg,
 }
 
 static vpx_codec_err_t vp8e_init(vpx_codec_ctx_t *ctx,
-                                 vpx_codec_priv_enc_mr_cfg_t *mr_cfg)
+                                 vpx_codec_priv_enc_mr_cfg_t *mr_cfg,
+                                 const vpx_codec_mem_allocator_t *allocator)
 {
     vpx_codec_err_t        res = VPX_CODEC_OK;
-
+    (void) allocator;
 
     vp8_rtcd();
     vpx_dsp_rtcd();
@@ -101,11 +101,13 @@ static void vp8_init_ctx(vpx_codec_ctx_t *ctx)
 }
 
 static vpx_codec_err_t vp8_init(vpx_codec_ctx_t *ctx,
-                                vpx_codec_priv_enc_mr_cfg_t *data)
+                                vpx_codec_priv_enc_mr_cfg_t *data,
+                                const vpx_codec_mem_allocator_t *allocator)
 {
     vpx_codec_err_t res = VPX_CODEC_OK;
     vpx_codec_alg_priv_t *priv = NULL;
     (void) data;
+    (void) allocator;
 
     vp8_rtcd();
     vpx_dsp_rtcd();
@@ -104,6 +104,15 @@ void vp9_free_postproc_buffers(VP9_COMMON *cm) {
 #if CONFIG_VP9_POSTPROC
   vp9_free_frame_buffer(&cm->post_proc_buffer);
   vp9_free_frame_buffer(&cm->post_proc_buffer_int);
+  vpx_free(cm->postproc_state.prev_mip);
+  cm->postproc_state.prev_mip = NULL;
+  cm->postproc_state.prev_mi = NULL;
+  vpx_free(cm->postproc_state.prev_mi_arena);
+  cm->postproc_state.prev_mi_arena = NULL;
+  vpx_free(cm->postproc_state.prev_mi_index_base);
+  cm->postproc_state.prev_mi_index_base = NULL;
+  cm->postproc_state.prev_mi_index = NULL;
+  cm->postproc_state.prev_mi_alloc_size = 0;
 #else
   (void)cm;
 #endif
@@ -181,3 +190,37 @@ void vp9_swap_current_and_last_seg_map(VP9_COMMON *cm) {
   cm->current_frame_seg_map = cm->seg_map_array[cm->seg_map_idx];
   cm->last_frame_seg_map = cm->seg_map_array[cm->prev_seg_map_idx];
 }
+
+size_t vp9_frame_buffers_footprint(const BufferPool *pool) {
+  const InternalFrameBufferList *const list = &pool->int_frame_buffers;
+  size_t size = 0;
+  int i;
+
+  for (i = 0; i < FRAME_BUFFERS; ++i) {
+    const RefCntBuffer *const buf = &pool->frame_bufs[i];
+    size += buf->buf.buffer_alloc_sz;
+    if (buf->mvs != NULL)
+      size += buf->mi_rows * buf->mi_cols * sizeof(*buf->mvs);
+  }
+  for (i = 0; i < list->num_internal_frame_buffers; ++i)
+    size += list->int_fb[i].size;
+  return size;
+}
+
+size_t vp9_context_buffers_footprint(const VP9_COMMON *cm) {
+  const int num_mi = cm->prev_mip != NULL ? 2 : 1;
+  size_t size = cm->mi_arena != NULL ?
+      MI_ARENA_FIRST * MI_UNIT + cm->mi_alloc_size *
+          (MI_UNITS_SUB8X8 * MI_UNIT + sizeof(*cm->mi_index_base)) :
+      num_mi * cm->mi_alloc_size *
+          (sizeof(*cm->mip) + sizeof(*cm->mi_grid_base));
+
+  size += NUM_PING_PONG_BUFFERS * cm->seg_map_alloc_size;
+  if (cm->above_context != NULL)
+    size += mi_cols_aligned_to_sb(cm->above_context_alloc_cols) *
+            (2 * MAX_MB_PLANE * sizeof(*cm->above_context) +
+             sizeof(*cm->above_seg_context));
+  if (cm->frame_contexts != NULL)
+    size += (FRAME_CONTEXTS + 1) * sizeof(*cm->fc);
+  return size;
+}
@@ -12,6 +12,8 @@
 #ifndef VP9_COMMON_VP9_ALLOCCOMMON_H_
 #define VP9_COMMON_VP9_ALLOCCOMMON_H_
 
+#include "vpx/vpx_integer.h"
+
 #define INVALID_IDX -1  // Invalid buffer index.
 
 #ifdef __cplusplus
@@ -37,6 +39,14 @@ void vp9_set_mb_mi(struct VP9Common *cm, int width, int height);
 
 void vp9_swap_current_and_last_seg_map(struct VP9Common *cm);
 
+// Returns the bytes held by the frame buffers of pool, including the ones the
+// default frame buffer callbacks hand out, and their motion vectors.
+size_t vp9_frame_buffers_footprint(const struct BufferPool *pool);
+
+// Returns the bytes held by the mode info, segmentation map, above context
+// and frame context buffers of cm.
+size_t vp9_context_buffers_footprint(const struct VP9Common *cm);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -12,6 +12,8 @@
 #ifndef VP9_COMMON_VP9_BLOCKD_H_
 #define VP9_COMMON_VP9_BLOCKD_H_
 
+#include <stddef.h>
+
 #include "./vpx_config.h"
 
 #include "vpx_ports/mem.h"
@@ -88,6 +90,23 @@ typedef struct MODE_INFO {
   b_mode_info bmi[4];
 } MODE_INFO;
 
+// The decoder takes each block's MODE_INFO from an arena in decoding order
+// and maps the 8x8s to it with MI_INDEX offsets, in MI_UNIT bytes, instead
+// of pointers. Blocks of 8x8 and up only take the MB_MODE_INFO part, since
+// their bmi is never read; sub8x8 blocks take it all. Offset 0 is no block.
+typedef uint32_t MI_INDEX;
+#define MI_UNIT 4
+#define MI_UNITS_8X8 ((offsetof(MODE_INFO, bmi) + MI_UNIT - 1) / MI_UNIT)
+#define MI_UNITS_SUB8X8 ((sizeof(MODE_INFO) + MI_UNIT - 1) / MI_UNIT)
+// Superblocks start past the first cache line, each with room for 64 sub8x8
+// blocks.
+#define MI_ARENA_FIRST (64 / MI_UNIT)
+#define MI_UNITS_SB (MI_BLOCK_SIZE * MI_BLOCK_SIZE * MI_UNITS_SUB8X8)
+
+static INLINE MODE_INFO *get_mi_from_index(uint8_t *arena, MI_INDEX index) {
+  return index ? (MODE_INFO *)(arena + (size_t)index * MI_UNIT) : NULL;
+}
+
 static INLINE PREDICTION_MODE get_y_mode(const MODE_INFO *mi, int block) {
   return mi->mbmi.sb_type < BLOCK_8X8 ? mi->bmi[block].as_mode
                                       : mi->mbmi.mode;
@@ -158,6 +177,13 @@ typedef struct macroblockd {
   int mi_stride;
 
   MODE_INFO **mi;
+  // Decoder only: mi points at mi_block, the current block's MODE_INFO, and
+  // the other 8x8s are found through mi_index, see get_neighbor_mi().
+  // mi_arena_next is where the next block's MODE_INFO goes.
+  MI_INDEX *mi_index;
+  uint8_t *mi_arena;
+  MODE_INFO *mi_block;
+  MI_INDEX mi_arena_next;
   MODE_INFO *left_mi;
   MODE_INFO *above_mi;
   MB_MODE_INFO *left_mbmi;
@@ -177,6 +203,10 @@ typedef struct macroblockd {
   FRAME_CONTEXT *fc;
   int frame_parallel_decoding_mode;
 
+  // Decoder only: the frame's coefficient probabilities with the model
+  // nodes expanded, indexed by [tx_size][plane_type].
+  const vp9_coeff_probs (*coef_probs_full)[PLANE_TYPES];
+
   /* pointers to reference frames */
   RefBuffer *block_refs[2];
 
@@ -200,6 +230,12 @@ typedef struct macroblockd {
   struct vpx_internal_error_info *error_info;
 } MACROBLOCKD;
 
+// Returns the MODE_INFO of the 8x8 at offset from the current block.
+static INLINE MODE_INFO *get_neighbor_mi(const MACROBLOCKD *xd, int offset) {
+  return xd->mi_index ? get_mi_from_index(xd->mi_arena, xd->mi_index[offset])
+                      : xd->mi[offset];
+}
+
 static INLINE BLOCK_SIZE get_subsize(BLOCK_SIZE bsize,
                                      PARTITION_TYPE partition) {
   return subsize_lookup[partition][bsize];
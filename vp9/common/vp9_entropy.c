@@ -776,26 +776,49 @@ static void adapt_coef_probs(VP9_COMMON *cm, TX_SIZE tx_size,
   vp9_coeff_count_model *counts = cm->counts.coef[tx_size];
   unsigned int (*eob_counts)[REF_TYPES][COEF_BANDS][COEFF_CONTEXTS] =
       cm->counts.eob_branch[tx_size];
-  int i, j, k, l, m;
+  int i, j, k, l;
 
   for (i = 0; i < PLANE_TYPES; ++i)
-    for (j = 0; j < REF_TYPES; ++j)
+    for (j = 0; j < REF_TYPES; ++j) {
+      unsigned int branch_ct[COEF_BANDS][COEFF_CONTEXTS]
+                            [UNCONSTRAINED_NODES][2];
+      unsigned int used = 0;
+
       for (k = 0; k < COEF_BANDS; ++k)
         for (l = 0; l < BAND_COEFF_CONTEXTS(k); ++l) {
           const int n0 = counts[i][j][k][l][ZERO_TOKEN];
           const int n1 = counts[i][j][k][l][ONE_TOKEN];
           const int n2 = counts[i][j][k][l][TWO_TOKEN];
           const int neob = counts[i][j][k][l][EOB_MODEL_TOKEN];
-          const unsigned int branch_ct[UNCONSTRAINED_NODES][2] = {
-            { neob, eob_counts[i][j][k][l] - neob },
-            { n0, n1 + n2 },
-            { n1, n2 }
-          };
-          for (m = 0; m < UNCONSTRAINED_NODES; ++m)
-            probs[i][j][k][l][m] = merge_probs(pre_probs[i][j][k][l][m],
-                                               branch_ct[m],
-                                               count_sat, update_factor);
+          unsigned int (*const ct)[2] = branch_ct[k][l];
+          ct[0][0] = neob;
+          ct[0][1] = eob_counts[i][j][k][l] - neob;
+          ct[1][0] = n0;
+          ct[1][1] = n1 + n2;
+          ct[2][0] = n1;
+          ct[2][1] = n2;
+          used |= eob_counts[i][j][k][l] | n0 | n1 | n2;
         }
+
+      // Without any counts every probability falls back to its previous
+      // value. This is the common case for the larger transforms of small
+      // frames.
+      if (!used) {
+        memcpy(probs[i][j][0], pre_probs[i][j][0],
+               3 * sizeof(probs[i][j][0][0]));
+        memcpy(probs[i][j][1], pre_probs[i][j][1],
+               (COEF_BANDS - 1) * sizeof(probs[i][j][1]));
+        continue;
+      }
+
+      // Band 0 only has 3 contexts.
+      vp9_adapt_probs(pre_probs[i][j][0][0], branch_ct[0][0][0],
+                      3 * UNCONSTRAINED_NODES, count_sat, update_factor,
+                      probs[i][j][0][0]);
+      vp9_adapt_probs(pre_probs[i][j][1][0], branch_ct[1][0][0],
+                      (COEF_BANDS - 1) * COEFF_CONTEXTS * UNCONSTRAINED_NODES,
+                      count_sat, update_factor, probs[i][j][1][0]);
+    }
 }
 
 void vp9_adapt_coef_probs(VP9_COMMON *cm) {
@@ -166,6 +166,9 @@ extern const vp9_prob vp9_pareto8_full[COEFF_PROB_MODELS][MODEL_NODES];
 typedef vp9_prob vp9_coeff_probs_model[REF_TYPES][COEF_BANDS]
                                       [COEFF_CONTEXTS][UNCONSTRAINED_NODES];
 
+typedef vp9_prob vp9_coeff_probs[REF_TYPES][COEF_BANDS][COEFF_CONTEXTS]
+                                [ENTROPY_NODES];
+
 typedef unsigned int vp9_coeff_count_model[REF_TYPES][COEF_BANDS]
                                           [COEFF_CONTEXTS]
                                           [UNCONSTRAINED_NODES + 1];
@@ -335,24 +335,25 @@ const vp9_tree_index vp9_switchable_interp_tree
 };
 
 void vp9_adapt_mode_probs(VP9_COMMON *cm) {
-  int i, j;
+  int i;
   FRAME_CONTEXT *fc = cm->fc;
   const FRAME_CONTEXT *pre_fc = &cm->frame_contexts[cm->frame_context_idx];
   const FRAME_COUNTS *counts = &cm->counts;
 
-  for (i = 0; i < INTRA_INTER_CONTEXTS; i++)
-    fc->intra_inter_prob[i] = mode_mv_merge_probs(pre_fc->intra_inter_prob[i],
-                                                  counts->intra_inter[i]);
-  for (i = 0; i < COMP_INTER_CONTEXTS; i++)
-    fc->comp_inter_prob[i] = mode_mv_merge_probs(pre_fc->comp_inter_prob[i],
-                                                 counts->comp_inter[i]);
-  for (i = 0; i < REF_CONTEXTS; i++)
-    fc->comp_ref_prob[i] = mode_mv_merge_probs(pre_fc->comp_ref_prob[i],
-                                               counts->comp_ref[i]);
-  for (i = 0; i < REF_CONTEXTS; i++)
-    for (j = 0; j < 2; j++)
-      fc->single_ref_prob[i][j] = mode_mv_merge_probs(
-          pre_fc->single_ref_prob[i][j], counts->single_ref[i][j]);
+  // The binary probabilities are laid out next to their counts, so each
+  // table is adapted in one pass.
+  vp9_adapt_probs(pre_fc->intra_inter_prob, counts->intra_inter[0],
+                  INTRA_INTER_CONTEXTS, MODE_MV_COUNT_SAT,
+                  MODE_MV_MAX_UPDATE_FACTOR, fc->intra_inter_prob);
+  vp9_adapt_probs(pre_fc->comp_inter_prob, counts->comp_inter[0],
+                  COMP_INTER_CONTEXTS, MODE_MV_COUNT_SAT,
+                  MODE_MV_MAX_UPDATE_FACTOR, fc->comp_inter_prob);
+  vp9_adapt_probs(pre_fc->comp_ref_prob, counts->comp_ref[0],
+                  REF_CONTEXTS, MODE_MV_COUNT_SAT,
+                  MODE_MV_MAX_UPDATE_FACTOR, fc->comp_ref_prob);
+  vp9_adapt_probs(pre_fc->single_ref_prob[0], counts->single_ref[0][0],
+                  REF_CONTEXTS * 2, MODE_MV_COUNT_SAT,
+                  MODE_MV_MAX_UPDATE_FACTOR, fc->single_ref_prob[0]);
 
   for (i = 0; i < INTER_MODE_CONTEXTS; i++)
     vp9_tree_merge_probs(vp9_inter_mode_tree, pre_fc->inter_mode_probs[i],
@@ -379,32 +380,31 @@ void vp9_adapt_mode_probs(VP9_COMMON *cm) {
   }
 
   if (cm->tx_mode == TX_MODE_SELECT) {
-    int j;
     unsigned int branch_ct_8x8p[TX_SIZES - 3][2];
     unsigned int branch_ct_16x16p[TX_SIZES - 2][2];
     unsigned int branch_ct_32x32p[TX_SIZES - 1][2];
 
     for (i = 0; i < TX_SIZE_CONTEXTS; ++i) {
       tx_counts_to_branch_counts_8x8(counts->tx.p8x8[i], branch_ct_8x8p);
-      for (j = 0; j < TX_SIZES - 3; ++j)
-        fc->tx_probs.p8x8[i][j] = mode_mv_merge_probs(
-            pre_fc->tx_probs.p8x8[i][j], branch_ct_8x8p[j]);
+      vp9_adapt_probs(pre_fc->tx_probs.p8x8[i], branch_ct_8x8p[0],
+                      TX_SIZES - 3, MODE_MV_COUNT_SAT,
+                      MODE_MV_MAX_UPDATE_FACTOR, fc->tx_probs.p8x8[i]);
 
       tx_counts_to_branch_counts_16x16(counts->tx.p16x16[i], branch_ct_16x16p);
-      for (j = 0; j < TX_SIZES - 2; ++j)
-        fc->tx_probs.p16x16[i][j] = mode_mv_merge_probs(
-            pre_fc->tx_probs.p16x16[i][j], branch_ct_16x16p[j]);
+      vp9_adapt_probs(pre_fc->tx_probs.p16x16[i], branch_ct_16x16p[0],
+                      TX_SIZES - 2, MODE_MV_COUNT_SAT,
+                      MODE_MV_MAX_UPDATE_FACTOR, fc->tx_probs.p16x16[i]);
 
       tx_counts_to_branch_counts_32x32(counts->tx.p32x32[i], branch_ct_32x32p);
-      for (j = 0; j < TX_SIZES - 1; ++j)
-        fc->tx_probs.p32x32[i][j] = mode_mv_merge_probs(
-            pre_fc->tx_probs.p32x32[i][j], branch_ct_32x32p[j]);
+      vp9_adapt_probs(pre_fc->tx_probs.p32x32[i], branch_ct_32x32p[0],
+                      TX_SIZES - 1, MODE_MV_COUNT_SAT,
+                      MODE_MV_MAX_UPDATE_FACTOR, fc->tx_probs.p32x32[i]);
     }
   }
 
-  for (i = 0; i < SKIP_CONTEXTS; ++i)
-    fc->skip_probs[i] = mode_mv_merge_probs(
-        pre_fc->skip_probs[i], counts->skip[i]);
+  vp9_adapt_probs(pre_fc->skip_probs, counts->skip[0], SKIP_CONTEXTS,
+                  MODE_MV_COUNT_SAT, MODE_MV_MAX_UPDATE_FACTOR,
+                  fc->skip_probs);
 }
 
 static void set_default_lf_deltas(struct loopfilter *lf) {
@@ -197,8 +197,8 @@ void vp9_adapt_mv_probs(VP9_COMMON *cm, int allow_hp) {
     vp9_tree_merge_probs(vp9_mv_class0_tree, pre_comp->class0, c->class0,
                          comp->class0);
 
-    for (j = 0; j < MV_OFFSET_BITS; ++j)
-      comp->bits[j] = mode_mv_merge_probs(pre_comp->bits[j], c->bits[j]);
+    vp9_adapt_probs(pre_comp->bits, c->bits[0], MV_OFFSET_BITS,
+                    MODE_MV_COUNT_SAT, MODE_MV_MAX_UPDATE_FACTOR, comp->bits);
 
     for (j = 0; j < CLASS0_SIZE; ++j)
       vp9_tree_merge_probs(vp9_mv_fp_tree, pre_comp->class0_fp[j],
@@ -10,8 +10,152 @@
 
 #include <assert.h>
 
+#include "./vpx_config.h"
 #include "vp9/common/vp9_frame_buffers.h"
 #include "vpx_mem/vpx_mem.h"
+#include "vpx_ports/vpx_once.h"
+#include "vpx_util/vpx_thread.h"
+
+#define FRAME_POOL_PAGE_SIZE 4096
+#define FRAME_POOL_MIN_CLASS_SIZE (64 << 10)
+#define FRAME_POOL_CLASSES 128
+
+// Idle buffers keep their size and the link to the next one of their class in
+// their first bytes.
+typedef struct FramePoolBlock {
+  struct FramePoolBlock *next;
+  size_t size;
+} FramePoolBlock;
+
+static struct {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t mutex;
+#endif
+  FramePoolBlock *idle[FRAME_POOL_CLASSES];
+  size_t leased_bytes;
+  size_t idle_bytes;
+} frame_pool;
+
+static void frame_pool_init(void) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_init(&frame_pool.mutex, NULL);
+#endif
+}
+
+static void frame_pool_lock(void) {
+  once(frame_pool_init);
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&frame_pool.mutex);
+#endif
+}
+
+static void frame_pool_unlock(void) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&frame_pool.mutex);
+#endif
+}
+
+// Returns the class of buffers of size bytes and sets *class_size to the size
+// of the buffers in it. Returns -1 for sizes past the last class, which are
+// not kept.
+static int frame_pool_class(size_t size, size_t *class_size) {
+  size_t base = FRAME_POOL_MIN_CLASS_SIZE;
+  size_t step;
+  int c = 0;
+
+  if (size <= base) {
+    *class_size = base;
+    return 0;
+  }
+
+  // Find base < size <= 2 * base and round up to a quarter of base.
+  while (size > 2 * base) {
+    base *= 2;
+    c += 4;
+  }
+  step = base / 4;
+  c += (int)((size - base + step - 1) / step);
+  *class_size = base + (size - base + step - 1) / step * step;
+  return c < FRAME_POOL_CLASSES ? c : -1;
+}
+
+uint8_t *vp9_frame_pool_lease(size_t *size, int placement) {
+  const int c = frame_pool_class(*size, size);
+  uint8_t *data = NULL;
+
+  frame_pool_lock();
+  if (c >= 0 && frame_pool.idle[c] != NULL) {
+    FramePoolBlock *const block = frame_pool.idle[c];
+    frame_pool.idle[c] = block->next;
+    frame_pool.idle_bytes -= *size;
+    data = (uint8_t *)block;
+  }
+  frame_pool.leased_bytes += *size;
+  frame_pool_unlock();
+
+  if (data != NULL) {
+    // A buffer taken again holds another frame, possibly another decoder's.
+    // Clear it like a new one, as the C loop filter reads the frame border.
+    memset(data, 0, *size);
+  } else {
+    data = (uint8_t *)vpx_memalign_frame(FRAME_POOL_PAGE_SIZE, *size,
+                                         placement);
+    if (data == NULL) {
+      frame_pool_lock();
+      frame_pool.leased_bytes -= *size;
+      frame_pool_unlock();
+    }
+  }
+  return data;
+}
+
+void vp9_frame_pool_return(uint8_t *data, size_t size) {
+  size_t class_size;
+  const int c = frame_pool_class(size, &class_size);
+  FramePoolBlock *trimmed = NULL;
+  int i;
+
+  assert(c < 0 || class_size == size);
+  frame_pool_lock();
+  frame_pool.leased_bytes -= size;
+  if (c >= 0) {
+    FramePoolBlock *const block = (FramePoolBlock *)data;
+    block->next = frame_pool.idle[c];
+    block->size = size;
+    frame_pool.idle[c] = block;
+    frame_pool.idle_bytes += size;
+    data = NULL;
+  }
+
+  // Keep no more idle bytes than are leased, freeing the largest buffers
+  // first, so the pool empties once no decoder uses it.
+  for (i = FRAME_POOL_CLASSES - 1;
+       i >= 0 && frame_pool.idle_bytes > frame_pool.leased_bytes; --i) {
+    while (frame_pool.idle[i] != NULL &&
+           frame_pool.idle_bytes > frame_pool.leased_bytes) {
+      FramePoolBlock *const block = frame_pool.idle[i];
+      frame_pool.idle[i] = block->next;
+      frame_pool.idle_bytes -= block->size;
+      block->next = trimmed;
+      trimmed = block;
+    }
+  }
+  frame_pool_unlock();
+
+  vpx_free(data);
+  while (trimmed != NULL) {
+    FramePoolBlock *const next = trimmed->next;
+    vpx_free(trimmed);
+    trimmed = next;
+  }
+}
+
+void vp9_frame_pool_usage(size_t *leased_bytes, size_t *idle_bytes) {
+  frame_pool_lock();
+  *leased_bytes = frame_pool.leased_bytes;
+  *idle_bytes = frame_pool.idle_bytes;
+  frame_pool_unlock();
+}
 
 int vp9_alloc_internal_frame_buffers(InternalFrameBufferList *list) {
   assert(list != NULL);
@@ -31,8 +175,12 @@ void vp9_free_internal_frame_buffers(InternalFrameBufferList *list) {
   assert(list != NULL);
 
   for (i = 0; i < list->num_internal_frame_buffers; ++i) {
-    vpx_free(list->int_fb[i].data);
+    if (list->frame_pool && list->int_fb[i].data != NULL)
+      vp9_frame_pool_return(list->int_fb[i].data, list->int_fb[i].size);
+    else
+      vpx_free(list->int_fb[i].data);
     list->int_fb[i].data = NULL;
+    list->int_fb[i].size = 0;
   }
   vpx_free(list->int_fb);
   list->int_fb = NULL;
@@ -55,7 +203,23 @@ int vp9_get_frame_buffer(void *cb_priv, size_t min_size,
   if (i == int_fb_list->num_internal_frame_buffers)
     return -1;
 
-  if (int_fb_list->int_fb[i].size < min_size) {
+  if (int_fb_list->frame_pool) {
+    size_t size = min_size;
+    int_fb_list->int_fb[i].data =
+        vp9_frame_pool_lease(&size, int_fb_list->placement);
+    if (!int_fb_list->int_fb[i].data)
+      return -1;
+    int_fb_list->int_fb[i].size = size;
+  } else if (int_fb_list->int_fb[i].size < min_size &&
+             int_fb_list->placement) {
+    vpx_free(int_fb_list->int_fb[i].data);
+    int_fb_list->int_fb[i].size = 0;
+    int_fb_list->int_fb[i].data = (uint8_t *)vpx_memalign_frame(
+        32, min_size, int_fb_list->placement);
+    if (!int_fb_list->int_fb[i].data)
+      return -1;
+    int_fb_list->int_fb[i].size = min_size;
+  } else if (int_fb_list->int_fb[i].size < min_size) {
     int_fb_list->int_fb[i].data =
         (uint8_t *)vpx_realloc(int_fb_list->int_fb[i].data, min_size);
     if (!int_fb_list->int_fb[i].data)
@@ -78,9 +242,17 @@ int vp9_get_frame_buffer(void *cb_priv, size_t min_size,
 }
 
 int vp9_release_frame_buffer(void *cb_priv, vpx_codec_frame_buffer_t *fb) {
+  const InternalFrameBufferList *const int_fb_list =
+      (const InternalFrameBufferList *)cb_priv;
   InternalFrameBuffer *const int_fb = (InternalFrameBuffer *)fb->priv;
-  (void)cb_priv;
-  if (int_fb)
+  if (int_fb) {
+    // Pooled buffers go back to the pool at once, for any decoder to take.
+    if (int_fb_list != NULL && int_fb_list->frame_pool) {
+      vp9_frame_pool_return(int_fb->data, int_fb->size);
+      int_fb->data = NULL;
+      int_fb->size = 0;
+    }
     int_fb->in_use = 0;
+  }
   return 0;
 }
@@ -27,6 +27,11 @@ typedef struct InternalFrameBuffer {
 typedef struct InternalFrameBufferList {
   int num_internal_frame_buffers;
   InternalFrameBuffer *int_fb;
+  // VP9D_FRAME_POOL_* flags. When non-zero the buffers are leased from the
+  // shared frame pool and returned to it on release.
+  int frame_pool;
+  // VPX_MEM_* placement flags for new buffers, pooled or not.
+  int placement;
 } InternalFrameBufferList;
 
 // Initializes |list|. Returns 0 on success.
@@ -43,9 +48,30 @@ int vp9_get_frame_buffer(void *cb_priv, size_t min_size,
                          vpx_codec_frame_buffer_t *fb);
 
 // Callback used by libvpx when there are no references to the frame buffer.
-// |cb_priv| is not used. |fb| pointer to the frame buffer.
+// |cb_priv| points to the InternalFrameBufferList. |fb| pointer to the frame
+// buffer.
 int vp9_release_frame_buffer(void *cb_priv, vpx_codec_frame_buffer_t *fb);
 
+// The shared frame pool holds frame buffers for all the decoders in the
+// process that use it. Buffers are rounded up to size classes a quarter of a
+// power of two apart and are kept by class when returned, so a decoder that
+// switches resolution, or another decoder, takes them again instead of
+// allocating new ones. Idle buffers are freed, largest first, whenever they
+// would outnumber the leased ones in bytes, so the pool empties once no
+// decoder uses it. The pool is thread safe.
+
+// Leases a page aligned buffer of at least *size bytes from the shared pool
+// and sets *size to its actual size. The buffer is cleared. New buffers are
+// placed as the VPX_MEM_* flags in placement ask; buffers taken again keep
+// the placement they were allocated with. Returns NULL on failure.
+uint8_t *vp9_frame_pool_lease(size_t *size, int placement);
+
+// Returns a buffer leased with vp9_frame_pool_lease() and its actual size.
+void vp9_frame_pool_return(uint8_t *data, size_t size);
+
+// Sets the bytes the pool has leased out and holds idle.
+void vp9_frame_pool_usage(size_t *leased_bytes, size_t *idle_bytes);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -95,7 +95,6 @@ struct VP9LfSyncData;
 // by mi_row, mi_col.
 void vp9_setup_mask(struct VP9Common *const cm,
                     const int mi_row, const int mi_col,
-                    MODE_INFO **mi_8x8, const int mode_info_stride,
                     LOOP_FILTER_MASK *lfm);
 
 void vp9_filter_block_plane_ss00(struct VP9Common *const cm,
@@ -110,7 +109,6 @@ void vp9_filter_block_plane_ss11(struct VP9Common *const cm,
 
 void vp9_filter_block_plane_non420(struct VP9Common *cm,
                                    struct macroblockd_plane *plane,
-                                   MODE_INFO **mi_8x8,
                                    int mi_row, int mi_col);
 
 void vp9_loop_filter_init(struct VP9Common *cm);
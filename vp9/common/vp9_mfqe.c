@@ -47,8 +47,8 @@ void vp9_filter_by_weight16x16_c(const uint8_t *src, int src_stride,
   filter_by_weight(src, src_stride, dst, dst_stride, 16, src_weight);
 }
 
-static void filter_by_weight32x32(const uint8_t *src, int src_stride,
-                                  uint8_t *dst, int dst_stride, int weight) {
+void vp9_filter_by_weight32x32_c(const uint8_t *src, int src_stride,
+                                 uint8_t *dst, int dst_stride, int weight) {
   vp9_filter_by_weight16x16(src, src_stride, dst, dst_stride, weight);
   vp9_filter_by_weight16x16(src + 16, src_stride, dst + 16, dst_stride,
                             weight);
@@ -58,15 +58,34 @@ static void filter_by_weight32x32(const uint8_t *src, int src_stride,
                             dst + dst_stride * 16 + 16, dst_stride, weight);
 }
 
-static void filter_by_weight64x64(const uint8_t *src, int src_stride,
-                                  uint8_t *dst, int dst_stride, int weight) {
-  filter_by_weight32x32(src, src_stride, dst, dst_stride, weight);
-  filter_by_weight32x32(src + 32, src_stride, dst + 32,
-                        dst_stride, weight);
-  filter_by_weight32x32(src + src_stride * 32, src_stride,
-                        dst + dst_stride * 32, dst_stride, weight);
-  filter_by_weight32x32(src + src_stride * 32 + 32, src_stride,
-                        dst + dst_stride * 32 + 32, dst_stride, weight);
+void vp9_filter_by_weight64x64_c(const uint8_t *src, int src_stride,
+                                 uint8_t *dst, int dst_stride, int weight) {
+  vp9_filter_by_weight32x32(src, src_stride, dst, dst_stride, weight);
+  vp9_filter_by_weight32x32(src + 32, src_stride, dst + 32,
+                            dst_stride, weight);
+  vp9_filter_by_weight32x32(src + src_stride * 32, src_stride,
+                            dst + dst_stride * 32, dst_stride, weight);
+  vp9_filter_by_weight32x32(src + src_stride * 32 + 32, src_stride,
+                            dst + dst_stride * 32 + 32, dst_stride, weight);
+}
+
+// Computes the SAD and the variance of a size x size block. The C version
+// takes them from the SAD and variance functions, which are SIMD on most
+// targets; AVX2 computes both in a single pass.
+void vp9_mfqe_block_stats_c(const uint8_t *src, int src_stride,
+                            const uint8_t *ref, int ref_stride, int size,
+                            unsigned int *sad, unsigned int *var) {
+  unsigned int sse;
+  if (size == 16) {
+    *var = vpx_variance16x16(src, src_stride, ref, ref_stride, &sse);
+    *sad = vpx_sad16x16(src, src_stride, ref, ref_stride);
+  } else if (size == 32) {
+    *var = vpx_variance32x32(src, src_stride, ref, ref_stride, &sse);
+    *sad = vpx_sad32x32(src, src_stride, ref, ref_stride);
+  } else /* if (size == 64) */ {
+    *var = vpx_variance64x64(src, src_stride, ref, ref_stride, &sse);
+    *sad = vpx_sad64x64(src, src_stride, ref, ref_stride);
+  }
 }
 
 static void apply_ifactor(const uint8_t *y, int y_stride, uint8_t *yd,
@@ -79,74 +98,30 @@ static void apply_ifactor(const uint8_t *y, int y_stride, uint8_t *yd,
     vp9_filter_by_weight8x8(u, uv_stride, ud, uvd_stride, weight);
     vp9_filter_by_weight8x8(v, uv_stride, vd, uvd_stride, weight);
   } else if (block_size == BLOCK_32X32) {
-    filter_by_weight32x32(y, y_stride, yd, yd_stride, weight);
+    vp9_filter_by_weight32x32(y, y_stride, yd, yd_stride, weight);
     vp9_filter_by_weight16x16(u, uv_stride, ud, uvd_stride, weight);
     vp9_filter_by_weight16x16(v, uv_stride, vd, uvd_stride, weight);
   } else if (block_size == BLOCK_64X64) {
-    filter_by_weight64x64(y, y_stride, yd, yd_stride, weight);
-    filter_by_weight32x32(u, uv_stride, ud, uvd_stride, weight);
-    filter_by_weight32x32(v, uv_stride, vd, uvd_stride, weight);
-  }
-}
-
-// TODO(jackychen): Determine whether replace it with assembly code.
-static void copy_mem8x8(const uint8_t *src, int src_stride,
-                        uint8_t *dst, int dst_stride) {
-  int r;
-  for (r = 0; r < 8; r++) {
-    memcpy(dst, src, 8);
-    src += src_stride;
-    dst += dst_stride;
+    vp9_filter_by_weight64x64(y, y_stride, yd, yd_stride, weight);
+    vp9_filter_by_weight32x32(u, uv_stride, ud, uvd_stride, weight);
+    vp9_filter_by_weight32x32(v, uv_stride, vd, uvd_stride, weight);
   }
 }
 
-static void copy_mem16x16(const uint8_t *src, int src_stride,
-                          uint8_t *dst, int dst_stride) {
-  int r;
-  for (r = 0; r < 16; r++) {
-    memcpy(dst, src, 16);
-    src += src_stride;
-    dst += dst_stride;
-  }
-}
-
-static void copy_mem32x32(const uint8_t *src, int src_stride,
-                          uint8_t *dst, int dst_stride) {
-  copy_mem16x16(src, src_stride, dst, dst_stride);
-  copy_mem16x16(src + 16, src_stride, dst + 16, dst_stride);
-  copy_mem16x16(src + src_stride * 16, src_stride,
-                dst + dst_stride * 16, dst_stride);
-  copy_mem16x16(src + src_stride * 16 + 16, src_stride,
-                dst + dst_stride * 16 + 16, dst_stride);
-}
-
-void copy_mem64x64(const uint8_t *src, int src_stride,
-                   uint8_t *dst, int dst_stride) {
-  copy_mem32x32(src, src_stride, dst, dst_stride);
-  copy_mem32x32(src + 32, src_stride, dst + 32, dst_stride);
-  copy_mem32x32(src + src_stride * 32, src_stride,
-                dst + src_stride * 32, dst_stride);
-  copy_mem32x32(src + src_stride * 32 + 32, src_stride,
-                dst + src_stride * 32 + 32, dst_stride);
+static void copy_mem(const uint8_t *src, int src_stride,
+                     uint8_t *dst, int dst_stride, int size) {
+  vp9_convolve_copy(src, src_stride, dst, dst_stride, NULL, 0, NULL, 0,
+                    size, size);
 }
 
 static void copy_block(const uint8_t *y, const uint8_t *u, const uint8_t *v,
                        int y_stride, int uv_stride, uint8_t *yd, uint8_t *ud,
                        uint8_t *vd, int yd_stride, int uvd_stride,
                        BLOCK_SIZE bs) {
-  if (bs == BLOCK_16X16) {
-    copy_mem16x16(y, y_stride, yd, yd_stride);
-    copy_mem8x8(u, uv_stride, ud, uvd_stride);
-    copy_mem8x8(v, uv_stride, vd, uvd_stride);
-  } else if (bs == BLOCK_32X32) {
-    copy_mem32x32(y, y_stride, yd, yd_stride);
-    copy_mem16x16(u, uv_stride, ud, uvd_stride);
-    copy_mem16x16(v, uv_stride, vd, uvd_stride);
-  } else {
-    copy_mem64x64(y, y_stride, yd, yd_stride);
-    copy_mem32x32(u, uv_stride, ud, uvd_stride);
-    copy_mem32x32(v, uv_stride, vd, uvd_stride);
-  }
+  const int size = 4 << b_width_log2_lookup[bs];
+  copy_mem(y, y_stride, yd, yd_stride, size);
+  copy_mem(u, uv_stride, ud, uvd_stride, size >> 1);
+  copy_mem(v, uv_stride, vd, uvd_stride, size >> 1);
 }
 
 static void get_thr(BLOCK_SIZE bs, int qdiff, int *sad_thr, int *vdiff_thr) {
@@ -165,21 +140,17 @@ static void mfqe_block(BLOCK_SIZE bs, const uint8_t *y, const uint8_t *u,
                        const uint8_t *v, int y_stride, int uv_stride,
                        uint8_t *yd, uint8_t *ud, uint8_t *vd, int yd_stride,
                        int uvd_stride, int qdiff) {
+  // The SAD and variance are normalized by the number of pixels.
+  const int size = 4 << b_width_log2_lookup[bs];
+  const int shift = 2 * b_width_log2_lookup[bs] + 4;
   int sad, sad_thr, vdiff, vdiff_thr;
-  uint32_t sse;
+  unsigned int block_sad, var;
 
   get_thr(bs, qdiff, &sad_thr, &vdiff_thr);
 
-  if (bs == BLOCK_16X16) {
-    vdiff = (vpx_variance16x16(y, y_stride, yd, yd_stride, &sse) + 128) >> 8;
-    sad = (vpx_sad16x16(y, y_stride, yd, yd_stride) + 128) >> 8;
-  } else if (bs == BLOCK_32X32) {
-    vdiff = (vpx_variance32x32(y, y_stride, yd, yd_stride, &sse) + 512) >> 10;
-    sad = (vpx_sad32x32(y, y_stride, yd, yd_stride) + 512) >> 10;
-  } else /* if (bs == BLOCK_64X64) */ {
-    vdiff = (vpx_variance64x64(y, y_stride, yd, yd_stride, &sse) + 2048) >> 12;
-    sad = (vpx_sad64x64(y, y_stride, yd, yd_stride) + 2048) >> 12;
-  }
+  vp9_mfqe_block_stats(y, y_stride, yd, yd_stride, size, &block_sad, &var);
+  vdiff = (var + (1 << (shift - 1))) >> shift;
+  sad = (block_sad + (1 << (shift - 1))) >> shift;
 
   // vdiff > sad * 3 means vdiff should not be too small, otherwise,
   // it might be a lighting change in smooth area. When there is a
@@ -200,27 +171,42 @@ static void mfqe_block(BLOCK_SIZE bs, const uint8_t *y, const uint8_t *u,
   }
 }
 
-static int mfqe_decision(MODE_INFO *mi, BLOCK_SIZE cur_bs) {
+// Returns the block at the mode info grid offset, or NULL if there is none.
+// Intra only frames take the motion from the same place in the last frame.
+static const MODE_INFO *get_mfqe_mi(const VP9_COMMON *cm, int offset) {
+  const struct postproc_state *const ppstate = &cm->postproc_state;
+  if (!frame_is_intra_only(cm))
+    return get_grid_mi(cm, offset);
+  if (ppstate->prev_mi_index != NULL)
+    return get_mi_from_index(ppstate->prev_mi_arena,
+                             ppstate->prev_mi_index[offset]);
+  return ppstate->prev_mi + offset;
+}
+
+static int mfqe_decision(const MODE_INFO *mi, BLOCK_SIZE cur_bs) {
   // Check the motion in current block(for inter frame),
   // or check the motion in the correlated block in last frame (for keyframe).
-  const int mv_len_square = mi->mbmi.mv[0].as_mv.row *
-                            mi->mbmi.mv[0].as_mv.row +
-                            mi->mbmi.mv[0].as_mv.col *
-                            mi->mbmi.mv[0].as_mv.col;
   const int mv_threshold = 100;
+  int mv_len_square;
+  if (mi == NULL)
+    return 0;
+  mv_len_square = mi->mbmi.mv[0].as_mv.row * mi->mbmi.mv[0].as_mv.row +
+                  mi->mbmi.mv[0].as_mv.col * mi->mbmi.mv[0].as_mv.col;
   return mi->mbmi.mode >= NEARESTMV &&  // Not an intra block
          cur_bs >= BLOCK_16X16 &&
          mv_len_square <= mv_threshold;
 }
 
 // Process each partiton in a super block, recursively.
-static void mfqe_partition(VP9_COMMON *cm, MODE_INFO *mi, BLOCK_SIZE bs,
+static void mfqe_partition(VP9_COMMON *cm, int offset, BLOCK_SIZE bs,
                            const uint8_t *y, const uint8_t *u,
                            const uint8_t *v, int y_stride, int uv_stride,
                            uint8_t *yd, uint8_t *ud, uint8_t *vd,
                            int yd_stride, int uvd_stride) {
+  const MODE_INFO *const mi = get_mfqe_mi(cm, offset);
   int mi_offset, y_offset, uv_offset;
-  const BLOCK_SIZE cur_bs = mi->mbmi.sb_type;
+  // Past the frame edge there is no block; skip it like a sub8x8 one.
+  const BLOCK_SIZE cur_bs = mi ? mi->mbmi.sb_type : BLOCK_4X4;
   const int qdiff = cm->base_qindex - cm->postproc_state.last_base_qindex;
   const int bsl = b_width_log2_lookup[bs];
   PARTITION_TYPE partition = partition_lookup[bsl][cur_bs];
@@ -262,7 +248,8 @@ static void mfqe_partition(VP9_COMMON *cm, MODE_INFO *mi, BLOCK_SIZE bs,
                    y_stride, uv_stride, yd + y_offset, ud + uv_offset,
                    vd + uv_offset, yd_stride, uvd_stride, qdiff);
       }
-      if (mfqe_decision(mi + mi_offset * cm->mi_stride, mfqe_bs)) {
+      if (mfqe_decision(get_mfqe_mi(cm, offset + mi_offset * cm->mi_stride),
+                        mfqe_bs)) {
         // Do mfqe on the first square partition.
         mfqe_block(bs_tmp, y + y_offset * y_stride, u + uv_offset * uv_stride,
                    v + uv_offset * uv_stride, y_stride, uv_stride,
@@ -296,7 +283,7 @@ static void mfqe_partition(VP9_COMMON *cm, MODE_INFO *mi, BLOCK_SIZE bs,
                    yd + y_offset * yd_stride, ud + uv_offset * uvd_stride,
                    vd + uv_offset * uvd_stride, yd_stride, uvd_stride, qdiff);
       }
-      if (mfqe_decision(mi + mi_offset, mfqe_bs)) {
+      if (mfqe_decision(get_mfqe_mi(cm, offset + mi_offset), mfqe_bs)) {
         // Do mfqe on the first square partition.
         mfqe_block(bs_tmp, y + y_offset, u + uv_offset, v + uv_offset,
                    y_stride, uv_stride, yd + y_offset, ud + uv_offset,
@@ -325,17 +312,18 @@ static void mfqe_partition(VP9_COMMON *cm, MODE_INFO *mi, BLOCK_SIZE bs,
     case PARTITION_SPLIT:
       // Recursion on four square partitions, e.g. if bs is 64X64,
       // then look into four 32X32 blocks in it.
-      mfqe_partition(cm, mi, subsize, y, u, v, y_stride, uv_stride, yd, ud, vd,
-                     yd_stride, uvd_stride);
-      mfqe_partition(cm, mi + mi_offset, subsize, y + y_offset, u + uv_offset,
-                     v + uv_offset, y_stride, uv_stride, yd + y_offset,
-                     ud + uv_offset, vd + uv_offset, yd_stride, uvd_stride);
-      mfqe_partition(cm, mi + mi_offset * cm->mi_stride, subsize,
+      mfqe_partition(cm, offset, subsize, y, u, v, y_stride, uv_stride, yd, ud,
+                     vd, yd_stride, uvd_stride);
+      mfqe_partition(cm, offset + mi_offset, subsize, y + y_offset,
+                     u + uv_offset, v + uv_offset, y_stride, uv_stride,
+                     yd + y_offset, ud + uv_offset, vd + uv_offset, yd_stride,
+                     uvd_stride);
+      mfqe_partition(cm, offset + mi_offset * cm->mi_stride, subsize,
                      y + y_offset * y_stride, u + uv_offset * uv_stride,
                      v + uv_offset * uv_stride, y_stride, uv_stride,
                      yd + y_offset * yd_stride, ud + uv_offset * uvd_stride,
                      vd + uv_offset * uvd_stride, yd_stride, uvd_stride);
-      mfqe_partition(cm, mi + mi_offset * cm->mi_stride + mi_offset,
+      mfqe_partition(cm, offset + mi_offset * cm->mi_stride + mi_offset,
                      subsize, y + y_offset * y_stride + y_offset,
                      u + uv_offset * uv_stride + uv_offset,
                      v + uv_offset * uv_stride + uv_offset, y_stride,
@@ -358,11 +346,6 @@ void vp9_mfqe(VP9_COMMON *cm) {
   // Loop through each super block.
   for (mi_row = 0; mi_row < cm->mi_rows; mi_row += MI_BLOCK_SIZE) {
     for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE) {
-      MODE_INFO *mi;
-      MODE_INFO *mi_local = cm->mi + (mi_row * cm->mi_stride + mi_col);
-      // Motion Info in last frame.
-      MODE_INFO *mi_prev = cm->postproc_state.prev_mi +
-                           (mi_row * cm->mi_stride + mi_col);
       const uint32_t y_stride = show->y_stride;
       const uint32_t uv_stride = show->uv_stride;
       const uint32_t yd_stride = dest->y_stride;
@@ -382,13 +365,9 @@ void vp9_mfqe(VP9_COMMON *cm) {
                     col_offset_uv;
       uint8_t *vd = dest->v_buffer + row_offset_uv * uvd_stride +
                     col_offset_uv;
-      if (frame_is_intra_only(cm)) {
-        mi = mi_prev;
-      } else {
-        mi = mi_local;
-      }
-      mfqe_partition(cm, mi, BLOCK_64X64, y, u, v, y_stride, uv_stride, yd, ud,
-                     vd, yd_stride, uvd_stride);
+      mfqe_partition(cm, mi_row * cm->mi_stride + mi_col, BLOCK_64X64, y, u,
+                     v, y_stride, uv_stride, yd, ud, vd, yd_stride,
+                     uvd_stride);
     }
   }
 }
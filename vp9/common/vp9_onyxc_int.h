@@ -212,6 +212,13 @@ typedef struct VP9Common {
   MODE_INFO **prev_mi_grid_base;
   MODE_INFO **prev_mi_grid_visible;
 
+  // The decoder uses these in place of mip and mi_grid_base, see MI_INDEX.
+  // Each superblock has its own part of the arena, so tiles decoded in
+  // parallel never share one.
+  uint8_t *mi_arena;
+  MI_INDEX *mi_index_base;
+  MI_INDEX *mi_index_visible;
+
   // Whether to use previous frame's motion vectors for prediction.
   int use_prev_frame_mvs;
 
@@ -389,6 +396,13 @@ static INLINE void set_skip_context(MACROBLOCKD *xd, int mi_row, int mi_col) {
   }
 }
 
+// Returns the MODE_INFO of the 8x8 at offset in the visible grid.
+static INLINE MODE_INFO *get_grid_mi(const VP9_COMMON *cm, int offset) {
+  return cm->mi_index_visible
+      ? get_mi_from_index(cm->mi_arena, cm->mi_index_visible[offset])
+      : cm->mi_grid_visible[offset];
+}
+
 static INLINE int calc_mi_size(int len) {
   // len is in mi units.
   return len + MI_BLOCK_SIZE;
@@ -407,7 +421,7 @@ static INLINE void set_mi_row_col(MACROBLOCKD *xd, const TileInfo *const tile,
   xd->up_available    = (mi_row != 0);
   xd->left_available  = (mi_col > tile->mi_col_start);
   if (xd->up_available) {
-    xd->above_mi = xd->mi[-xd->mi_stride];
+    xd->above_mi = get_neighbor_mi(xd, -xd->mi_stride);
     // above_mi may be NULL in VP9 encoder's first pass.
     xd->above_mbmi = xd->above_mi ? &xd->above_mi->mbmi : NULL;
   } else {
@@ -416,7 +430,7 @@ static INLINE void set_mi_row_col(MACROBLOCKD *xd, const TileInfo *const tile,
   }
 
   if (xd->left_available) {
-    xd->left_mi = xd->mi[-1];
+    xd->left_mi = get_neighbor_mi(xd, -1);
     // left_mi may be NULL in VP9 encoder's first pass.
     xd->left_mbmi = xd->left_mi ? &xd->left_mi->mbmi : NULL;
   } else {
@@ -612,15 +612,49 @@ void vp9_plane_add_noise_c(uint8_t *start, char *noise,
   }
 }
 
+static int alloc_prev_mi_arena(VP9_COMMON *cm) {
+  struct postproc_state *const ppstate = &cm->postproc_state;
+  vpx_free(ppstate->prev_mi_arena);
+  vpx_free(ppstate->prev_mi_index_base);
+  ppstate->prev_mi_index = NULL;
+  ppstate->prev_mi_alloc_size = 0;
+  ppstate->prev_mi_arena = (uint8_t *)vpx_memalign(
+      64, MI_ARENA_FIRST * MI_UNIT +
+          cm->mi_alloc_size * MI_UNITS_SUB8X8 * MI_UNIT);
+  ppstate->prev_mi_index_base =
+      (MI_INDEX *)vpx_calloc(cm->mi_alloc_size,
+                             sizeof(*ppstate->prev_mi_index_base));
+  if (!ppstate->prev_mi_arena || !ppstate->prev_mi_index_base)
+    return 1;
+  ppstate->prev_mi_index = ppstate->prev_mi_index_base + cm->mi_stride + 1;
+  ppstate->prev_mi_alloc_size = cm->mi_alloc_size;
+  return 0;
+}
+
 static void swap_mi_and_prev_mi(VP9_COMMON *cm) {
-  // Current mip will be the prev_mip for the next frame.
-  MODE_INFO *temp = cm->postproc_state.prev_mip;
-  cm->postproc_state.prev_mip = cm->mip;
-  cm->mip = temp;
-
-  // Update the upper left visible macroblock ptrs.
-  cm->mi = cm->mip + cm->mi_stride + 1;
-  cm->postproc_state.prev_mi = cm->postproc_state.prev_mip + cm->mi_stride + 1;
+  struct postproc_state *const ppstate = &cm->postproc_state;
+  if (cm->mi_arena != NULL) {
+    // Current arena and index grid will be the previous ones for the next
+    // frame.
+    uint8_t *const arena = ppstate->prev_mi_arena;
+    MI_INDEX *const index = ppstate->prev_mi_index_base;
+    ppstate->prev_mi_arena = cm->mi_arena;
+    ppstate->prev_mi_index_base = cm->mi_index_base;
+    cm->mi_arena = arena;
+    cm->mi_index_base = index;
+
+    cm->mi_index_visible = cm->mi_index_base + cm->mi_stride + 1;
+    ppstate->prev_mi_index = ppstate->prev_mi_index_base + cm->mi_stride + 1;
+  } else {
+    // Current mip will be the prev_mip for the next frame.
+    MODE_INFO *temp = ppstate->prev_mip;
+    ppstate->prev_mip = cm->mip;
+    cm->mip = temp;
+
+    // Update the upper left visible macroblock ptrs.
+    cm->mi = cm->mip + cm->mi_stride + 1;
+    ppstate->prev_mi = ppstate->prev_mip + cm->mi_stride + 1;
+  }
 }
 
 int vp9_post_proc_frame(struct VP9Common *cm,
@@ -644,13 +678,25 @@ int vp9_post_proc_frame(struct VP9Common *cm,
   if (cm->current_video_frame == 1) {
     cm->postproc_state.last_base_qindex = cm->base_qindex;
     cm->postproc_state.last_frame_valid = 1;
-    ppstate->prev_mip = vpx_calloc(cm->mi_alloc_size, sizeof(*cm->mip));
-    if (!ppstate->prev_mip) {
-      return 1;
+    if (cm->mi_arena == NULL) {
+      vpx_free(ppstate->prev_mip);
+      ppstate->prev_mip = vpx_calloc(cm->mi_alloc_size, sizeof(*cm->mip));
+      if (!ppstate->prev_mip) {
+        return 1;
+      }
+      ppstate->prev_mi = ppstate->prev_mip + cm->mi_stride + 1;
+      memset(ppstate->prev_mip, 0,
+             cm->mi_stride * (cm->mi_rows + 1) * sizeof(*cm->mip));
     }
-    ppstate->prev_mi = ppstate->prev_mip + cm->mi_stride + 1;
-    memset(ppstate->prev_mip, 0,
-           cm->mi_stride * (cm->mi_rows + 1) * sizeof(*cm->mip));
+  }
+
+  // The decoder's arena is swapped with the previous one, so they have to be
+  // the same size. Its old contents are useless once it is resized.
+  if (cm->mi_arena != NULL &&
+      ppstate->prev_mi_alloc_size != cm->mi_alloc_size) {
+    if (alloc_prev_mi_arena(cm))
+      return 1;
+    ppstate->last_frame_valid = 0;
   }
 
   // Allocate post_proc_buffer_int if needed.
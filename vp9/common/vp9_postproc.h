@@ -30,6 +30,12 @@ struct postproc_state {
   int last_frame_valid;
   MODE_INFO *prev_mip;
   MODE_INFO *prev_mi;
+  // The decoder keeps the last frame's mode info arena and index grid
+  // instead, see vp9_blockd.h.
+  uint8_t *prev_mi_arena;
+  MI_INDEX *prev_mi_index_base;
+  MI_INDEX *prev_mi_index;
+  int prev_mi_alloc_size;
   DECLARE_ALIGNED(16, char, blackclamp[16]);
   DECLARE_ALIGNED(16, char, whiteclamp[16]);
   DECLARE_ALIGNED(16, char, bothclamp[16]);
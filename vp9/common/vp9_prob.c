@@ -8,6 +8,9 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <assert.h>
+
+#include "./vp9_rtcd.h"
 #include "vp9/common/vp9_prob.h"
 
 const uint8_t vp9_norm[256] = {
@@ -29,25 +32,43 @@ const uint8_t vp9_norm[256] = {
   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
 };
 
-static unsigned int tree_merge_probs_impl(unsigned int i,
-                                          const vp9_tree_index *tree,
-                                          const vp9_prob *pre_probs,
-                                          const unsigned int *counts,
-                                          vp9_prob *probs) {
+void vp9_adapt_probs_c(const vp9_prob *pre_probs, const unsigned int *counts,
+                       int n, unsigned int count_sat,
+                       unsigned int max_update_factor, vp9_prob *probs) {
+  int i;
+  for (i = 0; i < n; ++i)
+    probs[i] = merge_probs(pre_probs[i], counts + 2 * i, count_sat,
+                           max_update_factor);
+}
+
+// Largest tree is vp9_mv_class_tree, with 10 nodes.
+#define MAX_TREE_NODES 16
+
+static unsigned int tree_branch_counts(unsigned int i,
+                                       const vp9_tree_index *tree,
+                                       const unsigned int *counts,
+                                       unsigned int (*branch_ct)[2],
+                                       int *num_nodes) {
   const int l = tree[i];
   const unsigned int left_count = (l <= 0)
                  ? counts[-l]
-                 : tree_merge_probs_impl(l, tree, pre_probs, counts, probs);
+                 : tree_branch_counts(l, tree, counts, branch_ct, num_nodes);
   const int r = tree[i + 1];
   const unsigned int right_count = (r <= 0)
                  ? counts[-r]
-                 : tree_merge_probs_impl(r, tree, pre_probs, counts, probs);
-  const unsigned int ct[2] = { left_count, right_count };
-  probs[i >> 1] = mode_mv_merge_probs(pre_probs[i >> 1], ct);
+                 : tree_branch_counts(r, tree, counts, branch_ct, num_nodes);
+  branch_ct[i >> 1][0] = left_count;
+  branch_ct[i >> 1][1] = right_count;
+  ++*num_nodes;
   return left_count + right_count;
 }
 
 void vp9_tree_merge_probs(const vp9_tree_index *tree, const vp9_prob *pre_probs,
                           const unsigned int *counts, vp9_prob *probs) {
-  tree_merge_probs_impl(0, tree, pre_probs, counts, probs);
+  unsigned int branch_ct[MAX_TREE_NODES][2];
+  int num_nodes = 0;
+  tree_branch_counts(0, tree, counts, branch_ct, &num_nodes);
+  assert(num_nodes <= MAX_TREE_NODES);
+  vp9_adapt_probs(pre_probs, branch_ct[0], num_nodes, MODE_MV_COUNT_SAT,
+                  MODE_MV_MAX_UPDATE_FACTOR, probs);
 }
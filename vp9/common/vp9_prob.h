@@ -34,6 +34,7 @@ typedef int8_t vp9_tree_index;
 #define vp9_complement(x) (255 - x)
 
 #define MODE_MV_COUNT_SAT 20
+#define MODE_MV_MAX_UPDATE_FACTOR 128
 
 /* We build coding trees compactly in arrays.
    Each node of the tree is a pair of vp9_tree_indices.
@@ -71,7 +72,8 @@ static INLINE vp9_prob merge_probs(vp9_prob pre_prob,
   return weighted_prob(pre_prob, prob, factor);
 }
 
-// MODE_MV_MAX_UPDATE_FACTOR (128) * count / MODE_MV_COUNT_SAT;
+// MODE_MV_MAX_UPDATE_FACTOR * count / MODE_MV_COUNT_SAT, so that
+// mode_mv_merge_probs() matches merge_probs() with those two parameters.
 static const int count_to_update_factor[MODE_MV_COUNT_SAT + 1] = {
   0, 6, 12, 19, 25, 32, 38, 44, 51, 57, 64,
   70, 76, 83, 89, 96, 102, 108, 115, 121, 128
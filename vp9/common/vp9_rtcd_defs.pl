@@ -224,26 +224,35 @@ specialize qw/vp9_dc_128_predictor_32x32 msa neon/, "$sse2_x86inc";
 #
 if (vpx_config("CONFIG_VP9_POSTPROC") eq "yes") {
 add_proto qw/void vp9_mbpost_proc_down/, "uint8_t *dst, int pitch, int rows, int cols, int flimit";
-specialize qw/vp9_mbpost_proc_down sse2/;
+specialize qw/vp9_mbpost_proc_down sse2 avx2/;
 $vp9_mbpost_proc_down_sse2=vp9_mbpost_proc_down_xmm;
 
 add_proto qw/void vp9_mbpost_proc_across_ip/, "uint8_t *src, int pitch, int rows, int cols, int flimit";
-specialize qw/vp9_mbpost_proc_across_ip sse2/;
+specialize qw/vp9_mbpost_proc_across_ip sse2 avx2/;
 $vp9_mbpost_proc_across_ip_sse2=vp9_mbpost_proc_across_ip_xmm;
 
 add_proto qw/void vp9_post_proc_down_and_across/, "const uint8_t *src_ptr, uint8_t *dst_ptr, int src_pixels_per_line, int dst_pixels_per_line, int rows, int cols, int flimit";
-specialize qw/vp9_post_proc_down_and_across sse2/;
+specialize qw/vp9_post_proc_down_and_across sse2 avx2/;
 $vp9_post_proc_down_and_across_sse2=vp9_post_proc_down_and_across_xmm;
 
 add_proto qw/void vp9_plane_add_noise/, "uint8_t *Start, char *noise, char blackclamp[16], char whiteclamp[16], char bothclamp[16], unsigned int Width, unsigned int Height, int Pitch";
 specialize qw/vp9_plane_add_noise sse2/;
 $vp9_plane_add_noise_sse2=vp9_plane_add_noise_wmt;
 
+add_proto qw/void vp9_filter_by_weight64x64/, "const uint8_t *src, int src_stride, uint8_t *dst, int dst_stride, int src_weight";
+specialize qw/vp9_filter_by_weight64x64 avx2/;
+
+add_proto qw/void vp9_filter_by_weight32x32/, "const uint8_t *src, int src_stride, uint8_t *dst, int dst_stride, int src_weight";
+specialize qw/vp9_filter_by_weight32x32 avx2/;
+
 add_proto qw/void vp9_filter_by_weight16x16/, "const uint8_t *src, int src_stride, uint8_t *dst, int dst_stride, int src_weight";
-specialize qw/vp9_filter_by_weight16x16 sse2 msa/;
+specialize qw/vp9_filter_by_weight16x16 sse2 msa avx2/;
 
 add_proto qw/void vp9_filter_by_weight8x8/, "const uint8_t *src, int src_stride, uint8_t *dst, int dst_stride, int src_weight";
 specialize qw/vp9_filter_by_weight8x8 sse2 msa/;
+
+add_proto qw/void vp9_mfqe_block_stats/, "const uint8_t *src, int src_stride, const uint8_t *ref, int ref_stride, int size, unsigned int *sad, unsigned int *var";
+specialize qw/vp9_mfqe_block_stats avx2/;
 }
 
 #
@@ -718,6 +727,12 @@ if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") eq "yes") {
   }
 }
 
+#
+# Probability adaptation
+#
+add_proto qw/void vp9_adapt_probs/, "const uint8_t *pre_probs, const unsigned int *counts, int n, unsigned int count_sat, unsigned int max_update_factor, uint8_t *probs";
+specialize qw/vp9_adapt_probs sse2/;
+
 #
 # Encoder functions below this point.
 #
@@ -750,6 +765,12 @@ specialize qw/vp9_int_pro_col sse2 neon/;
 add_proto qw/int vp9_vector_var/, "int16_t const *ref, int16_t const *src, const int bwl";
 specialize qw/vp9_vector_var sse2/;
 
+add_proto qw/void vp9_resize_filter_horz/, "const uint8_t *src, uint8_t *dst, int w, const int *offsets, const int16_t *const *filters";
+specialize qw/vp9_resize_filter_horz sse2/;
+
+add_proto qw/void vp9_resize_filter_vert/, "const uint8_t *const *src, uint8_t *dst, int w, const int16_t *filter";
+specialize qw/vp9_resize_filter_vert sse2/;
+
 if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") eq "yes") {
   add_proto qw/unsigned int vp9_highbd_avg_8x8/, "const uint8_t *, int p";
   specialize qw/vp9_highbd_avg_8x8/;
@@ -757,6 +778,10 @@ if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") eq "yes") {
   specialize qw/vp9_highbd_avg_4x4/;
   add_proto qw/void vp9_highbd_minmax_8x8/, "const uint8_t *s, int p, const uint8_t *d, int dp, int *min, int *max";
   specialize qw/vp9_highbd_minmax_8x8/;
+  add_proto qw/void vp9_highbd_resize_filter_horz/, "const uint16_t *src, uint16_t *dst, int w, const int *offsets, const int16_t *const *filters, int bd";
+  specialize qw/vp9_highbd_resize_filter_horz sse2/;
+  add_proto qw/void vp9_highbd_resize_filter_vert/, "const uint16_t *const *src, uint16_t *dst, int w, const int16_t *filter, int bd";
+  specialize qw/vp9_highbd_resize_filter_vert sse2/;
 }
 
 # ENCODEMB INVOKE
@@ -812,6 +837,12 @@ if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") eq "yes") {
   specialize qw/vp9_fdct8x8_quant sse2 ssse3 neon/;
 }
 
+#
+# Coefficient costing
+#
+add_proto qw/int vp9_coeff_run_cost/, "const tran_low_t *qcoeff, const int16_t *scan, int eob, uint8_t *tokens, const int16_t *cat6_high_cost";
+specialize qw/vp9_coeff_run_cost avx2/;
+
 #
 # Structured Similarity (SSIM)
 #
@@ -821,6 +852,9 @@ if (vpx_config("CONFIG_INTERNAL_STATS") eq "yes") {
 
     add_proto qw/void vp9_ssim_parms_16x16/, "uint8_t *s, int sp, uint8_t *r, int rp, unsigned long *sum_s, unsigned long *sum_r, unsigned long *sum_sq_s, unsigned long *sum_sq_r, unsigned long *sum_sxr";
     specialize qw/vp9_ssim_parms_16x16/, "$sse2_x86_64";
+
+    add_proto qw/void vp9_ssim_parms_4x4_row/, "const uint8_t *s, int sp, const uint8_t *r, int rp, int blocks, uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s, uint32_t *sum_sq_r, uint32_t *sum_sxr";
+    specialize qw/vp9_ssim_parms_4x4_row sse2/;
 }
 
 # fdct functions
@@ -909,9 +943,10 @@ if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") eq "yes") {
 # Motion search
 #
 add_proto qw/int vp9_full_search_sad/, "const struct macroblock *x, const struct mv *ref_mv, int sad_per_bit, int distance, const struct vp9_variance_vtable *fn_ptr, const struct mv *center_mv, struct mv *best_mv";
-specialize qw/vp9_full_search_sad sse3 sse4_1/;
+specialize qw/vp9_full_search_sad sse3 sse4_1 avx2/;
 $vp9_full_search_sad_sse3=vp9_full_search_sadx3;
 $vp9_full_search_sad_sse4_1=vp9_full_search_sadx8;
+$vp9_full_search_sad_avx2=vp9_full_search_sadx4;
 
 add_proto qw/int vp9_diamond_search_sad/, "const struct macroblock *x, const struct search_site_config *cfg,  struct mv *ref_mv, struct mv *best_mv, int search_param, int sad_per_bit, int *num00, const struct vp9_variance_vtable *fn_ptr, const struct mv *center_mv";
 specialize qw/vp9_diamond_search_sad/;
@@ -920,7 +955,10 @@ add_proto qw/int vp9_full_range_search/, "const struct macroblock *x, const stru
 specialize qw/vp9_full_range_search/;
 
 add_proto qw/void vp9_temporal_filter_apply/, "uint8_t *frame1, unsigned int stride, uint8_t *frame2, unsigned int block_width, unsigned int block_height, int strength, int filter_weight, unsigned int *accumulator, uint16_t *count";
-specialize qw/vp9_temporal_filter_apply sse2 msa/;
+specialize qw/vp9_temporal_filter_apply sse2 avx2 msa/;
+
+add_proto qw/void vp9_temporal_filter_normalize/, "const unsigned int *accumulator, const uint16_t *count, unsigned int block_width, unsigned int block_height, uint8_t *dst, int stride";
+specialize qw/vp9_temporal_filter_normalize avx2/;
 
 if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") eq "yes") {
 
@@ -930,10 +968,10 @@ if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") eq "yes") {
   specialize qw/vp9_highbd_block_error sse2/;
 
   add_proto qw/void vp9_highbd_quantize_fp/, "const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block, const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr, const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr, const int16_t *scan, const int16_t *iscan";
-  specialize qw/vp9_highbd_quantize_fp/;
+  specialize qw/vp9_highbd_quantize_fp sse2 avx2/;
 
   add_proto qw/void vp9_highbd_quantize_fp_32x32/, "const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block, const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr, const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr, const int16_t *scan, const int16_t *iscan";
-  specialize qw/vp9_highbd_quantize_fp_32x32/;
+  specialize qw/vp9_highbd_quantize_fp_32x32 sse2 avx2/;
 
   add_proto qw/void vp9_highbd_quantize_b/, "const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block, const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr, const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr, const int16_t *scan, const int16_t *iscan";
   specialize qw/vp9_highbd_quantize_b sse2/;
@@ -947,6 +985,9 @@ if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") eq "yes") {
   if (vpx_config("CONFIG_INTERNAL_STATS") eq "yes") {
     add_proto qw/void vp9_highbd_ssim_parms_8x8/, "uint16_t *s, int sp, uint16_t *r, int rp, uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s, uint32_t *sum_sq_r, uint32_t *sum_sxr";
     specialize qw/vp9_highbd_ssim_parms_8x8/;
+
+    add_proto qw/void vp9_highbd_ssim_parms_4x4_row/, "const uint16_t *s, int sp, const uint16_t *r, int rp, int blocks, uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s, uint32_t *sum_sq_r, uint32_t *sum_sxr";
+    specialize qw/vp9_highbd_ssim_parms_4x4_row sse2/;
   }
 
   # fdct functions
@@ -960,25 +1001,25 @@ if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") eq "yes") {
   specialize qw/vp9_highbd_fht16x16 sse2/;
 
   add_proto qw/void vp9_highbd_fwht4x4/, "const int16_t *input, tran_low_t *output, int stride";
-  specialize qw/vp9_highbd_fwht4x4/;
+  specialize qw/vp9_highbd_fwht4x4 sse2/;
 
   add_proto qw/void vp9_highbd_fdct4x4/, "const int16_t *input, tran_low_t *output, int stride";
   specialize qw/vp9_highbd_fdct4x4 sse2/;
 
   add_proto qw/void vp9_highbd_fdct8x8_1/, "const int16_t *input, tran_low_t *output, int stride";
-  specialize qw/vp9_highbd_fdct8x8_1/;
+  specialize qw/vp9_highbd_fdct8x8_1 sse2/;
 
   add_proto qw/void vp9_highbd_fdct8x8/, "const int16_t *input, tran_low_t *output, int stride";
   specialize qw/vp9_highbd_fdct8x8 sse2/;
 
   add_proto qw/void vp9_highbd_fdct16x16_1/, "const int16_t *input, tran_low_t *output, int stride";
-  specialize qw/vp9_highbd_fdct16x16_1/;
+  specialize qw/vp9_highbd_fdct16x16_1 sse2/;
 
   add_proto qw/void vp9_highbd_fdct16x16/, "const int16_t *input, tran_low_t *output, int stride";
   specialize qw/vp9_highbd_fdct16x16 sse2/;
 
   add_proto qw/void vp9_highbd_fdct32x32_1/, "const int16_t *input, tran_low_t *output, int stride";
-  specialize qw/vp9_highbd_fdct32x32_1/;
+  specialize qw/vp9_highbd_fdct32x32_1 sse2/;
 
   add_proto qw/void vp9_highbd_fdct32x32/, "const int16_t *input, tran_low_t *output, int stride";
   specialize qw/vp9_highbd_fdct32x32 sse2/;
@@ -987,7 +1028,10 @@ if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") eq "yes") {
   specialize qw/vp9_highbd_fdct32x32_rd sse2/;
 
   add_proto qw/void vp9_highbd_temporal_filter_apply/, "uint8_t *frame1, unsigned int stride, uint8_t *frame2, unsigned int block_width, unsigned int block_height, int strength, int filter_weight, unsigned int *accumulator, uint16_t *count";
-  specialize qw/vp9_highbd_temporal_filter_apply/;
+  specialize qw/vp9_highbd_temporal_filter_apply avx2/;
+
+  add_proto qw/void vp9_highbd_temporal_filter_normalize/, "const unsigned int *accumulator, const uint16_t *count, unsigned int block_width, unsigned int block_height, uint8_t *dst, int stride";
+  specialize qw/vp9_highbd_temporal_filter_normalize avx2/;
 
 }
 # End vp9_high encoder functions
@@ -0,0 +1,153 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vp9_rtcd.h"
+#include "vp9/common/vp9_postproc.h"
+#include "vpx/vpx_integer.h"
+
+// Returns (src * src_weight + dst * dst_weight + rounding) >> MFQE_PRECISION
+// for 32 pixels. weights holds the byte pairs {src_weight, dst_weight}.
+static INLINE __m256i blend_32(__m256i src, __m256i dst, __m256i weights) {
+  const __m256i rounding = _mm256_set1_epi16(1 << (MFQE_PRECISION - 1));
+  __m256i lo = _mm256_maddubs_epi16(_mm256_unpacklo_epi8(src, dst), weights);
+  __m256i hi = _mm256_maddubs_epi16(_mm256_unpackhi_epi8(src, dst), weights);
+  lo = _mm256_srli_epi16(_mm256_add_epi16(lo, rounding), MFQE_PRECISION);
+  hi = _mm256_srli_epi16(_mm256_add_epi16(hi, rounding), MFQE_PRECISION);
+  return _mm256_packus_epi16(lo, hi);
+}
+
+static INLINE __m256i get_weights(int src_weight) {
+  const int dst_weight = (1 << MFQE_PRECISION) - src_weight;
+  return _mm256_set1_epi16((int16_t)(src_weight | (dst_weight << 8)));
+}
+
+void vp9_filter_by_weight16x16_avx2(const uint8_t *src, int src_stride,
+                                    uint8_t *dst, int dst_stride,
+                                    int src_weight) {
+  const __m256i weights = get_weights(src_weight);
+  int r;
+
+  // Two rows per register.
+  for (r = 0; r < 16; r += 2) {
+    const __m256i s = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)src)),
+        _mm_loadu_si128((const __m128i *)(src + src_stride)), 1);
+    const __m256i d = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)dst)),
+        _mm_loadu_si128((const __m128i *)(dst + dst_stride)), 1);
+    const __m256i out = blend_32(s, d, weights);
+    _mm_storeu_si128((__m128i *)dst, _mm256_castsi256_si128(out));
+    _mm_storeu_si128((__m128i *)(dst + dst_stride),
+                     _mm256_extracti128_si256(out, 1));
+    src += 2 * src_stride;
+    dst += 2 * dst_stride;
+  }
+}
+
+static INLINE void filter_by_weight_wide(const uint8_t *src, int src_stride,
+                                         uint8_t *dst, int dst_stride,
+                                         int size, int src_weight) {
+  const __m256i weights = get_weights(src_weight);
+  int r, c;
+
+  for (r = 0; r < size; ++r) {
+    for (c = 0; c < size; c += 32) {
+      const __m256i s = _mm256_loadu_si256((const __m256i *)(src + c));
+      const __m256i d = _mm256_loadu_si256((const __m256i *)(dst + c));
+      _mm256_storeu_si256((__m256i *)(dst + c), blend_32(s, d, weights));
+    }
+    src += src_stride;
+    dst += dst_stride;
+  }
+}
+
+void vp9_filter_by_weight32x32_avx2(const uint8_t *src, int src_stride,
+                                    uint8_t *dst, int dst_stride,
+                                    int src_weight) {
+  filter_by_weight_wide(src, src_stride, dst, dst_stride, 32, src_weight);
+}
+
+void vp9_filter_by_weight64x64_avx2(const uint8_t *src, int src_stride,
+                                    uint8_t *dst, int dst_stride,
+                                    int src_weight) {
+  filter_by_weight_wide(src, src_stride, dst, dst_stride, 64, src_weight);
+}
+
+// Accumulates the SAD, sum and sum of squares of src - ref for 32 pixels.
+// The sums are kept as 32-bit lanes; the SAD as 64-bit lanes.
+static INLINE void accumulate_32(__m256i src, __m256i ref, __m256i *sad,
+                                 __m256i *sum, __m256i *sse) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i one = _mm256_set1_epi16(1);
+  const __m256i diff_lo = _mm256_sub_epi16(_mm256_unpacklo_epi8(src, zero),
+                                           _mm256_unpacklo_epi8(ref, zero));
+  const __m256i diff_hi = _mm256_sub_epi16(_mm256_unpackhi_epi8(src, zero),
+                                           _mm256_unpackhi_epi8(ref, zero));
+
+  *sad = _mm256_add_epi64(*sad, _mm256_sad_epu8(src, ref));
+  *sum = _mm256_add_epi32(*sum, _mm256_madd_epi16(diff_lo, one));
+  *sum = _mm256_add_epi32(*sum, _mm256_madd_epi16(diff_hi, one));
+  *sse = _mm256_add_epi32(*sse, _mm256_madd_epi16(diff_lo, diff_lo));
+  *sse = _mm256_add_epi32(*sse, _mm256_madd_epi16(diff_hi, diff_hi));
+}
+
+static INLINE int hadd_epi32(__m256i v) {
+  __m128i t = _mm_add_epi32(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  t = _mm_add_epi32(t, _mm_srli_si128(t, 8));
+  t = _mm_add_epi32(t, _mm_srli_si128(t, 4));
+  return _mm_cvtsi128_si32(t);
+}
+
+void vp9_mfqe_block_stats_avx2(const uint8_t *src, int src_stride,
+                               const uint8_t *ref, int ref_stride, int size,
+                               unsigned int *sad, unsigned int *var) {
+  // log2 of the number of pixels.
+  const int shift = size == 16 ? 8 : size == 32 ? 10 : 12;
+  __m256i sad_acc = _mm256_setzero_si256();
+  __m256i sum_acc = _mm256_setzero_si256();
+  __m256i sse_acc = _mm256_setzero_si256();
+  __m128i sad128;
+  int r, c, sum;
+
+  if (size == 16) {
+    for (r = 0; r < 16; r += 2) {
+      const __m256i s = _mm256_inserti128_si256(
+          _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)src)),
+          _mm_loadu_si128((const __m128i *)(src + src_stride)), 1);
+      const __m256i d = _mm256_inserti128_si256(
+          _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)ref)),
+          _mm_loadu_si128((const __m128i *)(ref + ref_stride)), 1);
+      accumulate_32(s, d, &sad_acc, &sum_acc, &sse_acc);
+      src += 2 * src_stride;
+      ref += 2 * ref_stride;
+    }
+  } else {
+    for (r = 0; r < size; ++r) {
+      for (c = 0; c < size; c += 32) {
+        accumulate_32(_mm256_loadu_si256((const __m256i *)(src + c)),
+                      _mm256_loadu_si256((const __m256i *)(ref + c)),
+                      &sad_acc, &sum_acc, &sse_acc);
+      }
+      src += src_stride;
+      ref += ref_stride;
+    }
+  }
+
+  sad128 = _mm_add_epi64(_mm256_castsi256_si128(sad_acc),
+                         _mm256_extracti128_si256(sad_acc, 1));
+  sad128 = _mm_add_epi64(sad128, _mm_srli_si128(sad128, 8));
+  *sad = (unsigned int)_mm_cvtsi128_si32(sad128);
+  sum = hadd_epi32(sum_acc);
+  *var = (unsigned int)hadd_epi32(sse_acc) -
+         (unsigned int)(((int64_t)sum * sum) >> shift);
+}
@@ -0,0 +1,377 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <immintrin.h>  // AVX2
+
+#include "./vp9_rtcd.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+
+extern const short vp9_rv[];
+
+// Applies the 5-tap {1, 1, 4, 1, 1} / 8 filter to the 32 pixels in c, with
+// m2 .. p2 holding the neighbours. Pixels whose neighbours differ from them
+// by more than flimit are left untouched.
+static INLINE __m256i filter5(__m256i m2, __m256i m1, __m256i c, __m256i p1,
+                              __m256i p2, __m256i flimit) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i four = _mm256_set1_epi16(4);
+  __m256i diff, skip, lo, hi;
+
+  diff = _mm256_max_epu8(
+      _mm256_max_epu8(_mm256_or_si256(_mm256_subs_epu8(c, m2),
+                                      _mm256_subs_epu8(m2, c)),
+                      _mm256_or_si256(_mm256_subs_epu8(c, m1),
+                                      _mm256_subs_epu8(m1, c))),
+      _mm256_max_epu8(_mm256_or_si256(_mm256_subs_epu8(c, p1),
+                                      _mm256_subs_epu8(p1, c)),
+                      _mm256_or_si256(_mm256_subs_epu8(c, p2),
+                                      _mm256_subs_epu8(p2, c))));
+  // diff > flimit
+  skip = _mm256_xor_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(diff, flimit),
+                                            flimit),
+                          _mm256_set1_epi8(-1));
+
+  lo = _mm256_add_epi16(_mm256_unpacklo_epi8(m2, zero),
+                        _mm256_unpacklo_epi8(m1, zero));
+  lo = _mm256_add_epi16(lo, _mm256_unpacklo_epi8(p1, zero));
+  lo = _mm256_add_epi16(lo, _mm256_unpacklo_epi8(p2, zero));
+  lo = _mm256_add_epi16(lo, _mm256_slli_epi16(_mm256_unpacklo_epi8(c, zero),
+                                              2));
+  lo = _mm256_srli_epi16(_mm256_add_epi16(lo, four), 3);
+  hi = _mm256_add_epi16(_mm256_unpackhi_epi8(m2, zero),
+                        _mm256_unpackhi_epi8(m1, zero));
+  hi = _mm256_add_epi16(hi, _mm256_unpackhi_epi8(p1, zero));
+  hi = _mm256_add_epi16(hi, _mm256_unpackhi_epi8(p2, zero));
+  hi = _mm256_add_epi16(hi, _mm256_slli_epi16(_mm256_unpackhi_epi8(c, zero),
+                                              2));
+  hi = _mm256_srli_epi16(_mm256_add_epi16(hi, four), 3);
+
+  return _mm256_blendv_epi8(_mm256_packus_epi16(lo, hi), c, skip);
+}
+
+static INLINE int filter5_c(const uint8_t *p, int step, int flimit) {
+  static const int kernel5[5] = { 1, 1, 4, 1, 1 };
+  const int v = p[0];
+  int kernel = 4;
+  int i;
+
+  for (i = -2; i <= 2; i++) {
+    if (abs(v - p[i * step]) > flimit)
+      return v;
+    kernel += kernel5[2 + i] * p[i * step];
+  }
+  return kernel >> 3;
+}
+
+void vp9_post_proc_down_and_across_avx2(const uint8_t *src_ptr,
+                                        uint8_t *dst_ptr,
+                                        int src_pixels_per_line,
+                                        int dst_pixels_per_line,
+                                        int rows,
+                                        int cols,
+                                        int flimit) {
+  const int pitch = src_pixels_per_line;
+  const int vec_cols = cols & ~31;
+  const __m256i limit = _mm256_set1_epi8((char)(flimit > 255 ? 255 : flimit));
+  const __m256i zero = _mm256_setzero_si256();
+  int row, col;
+  (void)dst_pixels_per_line;
+
+  // Leave the corner cases, where the C version's delay line spills outside
+  // the row, to the C version.
+  if (flimit < 0 || cols < 2) {
+    vp9_post_proc_down_and_across_c(src_ptr, dst_ptr, src_pixels_per_line,
+                                    dst_pixels_per_line, rows, cols, flimit);
+    return;
+  }
+
+  for (row = 0; row < rows; row++) {
+    __m256i prev;
+    uint8_t tail[32 + 4];
+
+    // Down.
+    for (col = 0; col < vec_cols; col += 32) {
+      const uint8_t *const s = src_ptr + col;
+      const __m256i out = filter5(
+          _mm256_loadu_si256((const __m256i *)(s - 2 * pitch)),
+          _mm256_loadu_si256((const __m256i *)(s - pitch)),
+          _mm256_loadu_si256((const __m256i *)s),
+          _mm256_loadu_si256((const __m256i *)(s + pitch)),
+          _mm256_loadu_si256((const __m256i *)(s + 2 * pitch)), limit);
+      _mm256_storeu_si256((__m256i *)(dst_ptr + col), out);
+    }
+    for (; col < cols; col++)
+      dst_ptr[col] = filter5_c(src_ptr + col, pitch, flimit);
+
+    // Across, in place. The filter reads the unfiltered row, so the last
+    // two pixels of each block are carried over in prev.
+    prev = _mm256_insert_epi16(zero, *(const uint16_t *)(dst_ptr - 2), 15);
+    for (col = 0; col < vec_cols; col += 32) {
+      const __m256i cur = _mm256_loadu_si256((const __m256i *)(dst_ptr + col));
+      const __m256i next =
+          _mm256_insert_epi16(zero, *(const uint16_t *)(dst_ptr + col + 32), 0);
+      const __m256i lo = _mm256_permute2x128_si256(prev, cur, 0x21);
+      const __m256i hi = _mm256_permute2x128_si256(cur, next, 0x21);
+      const __m256i out = filter5(_mm256_alignr_epi8(cur, lo, 14),
+                                  _mm256_alignr_epi8(cur, lo, 15), cur,
+                                  _mm256_alignr_epi8(hi, cur, 1),
+                                  _mm256_alignr_epi8(hi, cur, 2), limit);
+      _mm256_storeu_si256((__m256i *)(dst_ptr + col), out);
+      prev = cur;
+    }
+    if (col < cols) {
+      tail[0] = (uint8_t)_mm256_extract_epi8(prev, 30);
+      tail[1] = (uint8_t)_mm256_extract_epi8(prev, 31);
+      memcpy(tail + 2, dst_ptr + col, cols - col + 2);
+      for (; col < cols; col++)
+        dst_ptr[col] = filter5_c(tail + 2 + col - vec_cols, 1, flimit);
+    }
+
+    src_ptr += pitch;
+    dst_ptr += pitch;
+  }
+}
+
+// Transposes the 8x8 block at s into columns, widened to 32 bits: col[j]
+// holds column j of the 8 rows.
+static INLINE void load_columns_8x8(const uint8_t *s, int pitch,
+                                    __m256i *col) {
+  const __m128i t0 = _mm_unpacklo_epi8(
+      _mm_loadl_epi64((const __m128i *)s),
+      _mm_loadl_epi64((const __m128i *)(s + pitch)));
+  const __m128i t1 = _mm_unpacklo_epi8(
+      _mm_loadl_epi64((const __m128i *)(s + 2 * pitch)),
+      _mm_loadl_epi64((const __m128i *)(s + 3 * pitch)));
+  const __m128i t2 = _mm_unpacklo_epi8(
+      _mm_loadl_epi64((const __m128i *)(s + 4 * pitch)),
+      _mm_loadl_epi64((const __m128i *)(s + 5 * pitch)));
+  const __m128i t3 = _mm_unpacklo_epi8(
+      _mm_loadl_epi64((const __m128i *)(s + 6 * pitch)),
+      _mm_loadl_epi64((const __m128i *)(s + 7 * pitch)));
+  const __m128i u0 = _mm_unpacklo_epi16(t0, t1);
+  const __m128i u1 = _mm_unpackhi_epi16(t0, t1);
+  const __m128i u2 = _mm_unpacklo_epi16(t2, t3);
+  const __m128i u3 = _mm_unpackhi_epi16(t2, t3);
+  __m128i v[4];
+  int j;
+
+  v[0] = _mm_unpacklo_epi32(u0, u2);
+  v[1] = _mm_unpackhi_epi32(u0, u2);
+  v[2] = _mm_unpacklo_epi32(u1, u3);
+  v[3] = _mm_unpackhi_epi32(u1, u3);
+  for (j = 0; j < 4; ++j) {
+    col[2 * j] = _mm256_cvtepu8_epi32(v[j]);
+    col[2 * j + 1] = _mm256_cvtepu8_epi32(_mm_srli_si128(v[j], 8));
+  }
+}
+
+// Inverse of load_columns_8x8(), storing the first n columns.
+static INLINE void store_columns_8x8(const __m256i *col, uint8_t *s,
+                                     int pitch, int n) {
+  const __m256i shuffle = _mm256_setr_epi8(
+      0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+      0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+  // b0 holds columns 0-3 and b1 columns 4-7, rows 0-3 in the low lane and
+  // rows 4-7 in the high lane.
+  __m256i b0 = _mm256_packus_epi16(_mm256_packs_epi32(col[0], col[1]),
+                                   _mm256_packs_epi32(col[2], col[3]));
+  __m256i b1 = _mm256_packus_epi16(_mm256_packs_epi32(col[4], col[5]),
+                                   _mm256_packs_epi32(col[6], col[7]));
+  __m256i r0, r1;
+  DECLARE_ALIGNED(32, uint8_t, rows[4][32]);
+  int i;
+
+  b0 = _mm256_shuffle_epi8(b0, shuffle);
+  b1 = _mm256_shuffle_epi8(b1, shuffle);
+  // r0: rows 0, 1 | rows 4, 5. r1: rows 2, 3 | rows 6, 7.
+  r0 = _mm256_unpacklo_epi32(b0, b1);
+  r1 = _mm256_unpackhi_epi32(b0, b1);
+
+  if (n == 8) {
+    const __m128i r0_lo = _mm256_castsi256_si128(r0);
+    const __m128i r0_hi = _mm256_extracti128_si256(r0, 1);
+    const __m128i r1_lo = _mm256_castsi256_si128(r1);
+    const __m128i r1_hi = _mm256_extracti128_si256(r1, 1);
+    _mm_storel_epi64((__m128i *)s, r0_lo);
+    _mm_storel_epi64((__m128i *)(s + pitch), _mm_srli_si128(r0_lo, 8));
+    _mm_storel_epi64((__m128i *)(s + 2 * pitch), r1_lo);
+    _mm_storel_epi64((__m128i *)(s + 3 * pitch), _mm_srli_si128(r1_lo, 8));
+    _mm_storel_epi64((__m128i *)(s + 4 * pitch), r0_hi);
+    _mm_storel_epi64((__m128i *)(s + 5 * pitch), _mm_srli_si128(r0_hi, 8));
+    _mm_storel_epi64((__m128i *)(s + 6 * pitch), r1_hi);
+    _mm_storel_epi64((__m128i *)(s + 7 * pitch), _mm_srli_si128(r1_hi, 8));
+    return;
+  }
+
+  _mm256_store_si256((__m256i *)rows[0], r0);
+  _mm256_store_si256((__m256i *)rows[1], r1);
+  for (i = 0; i < 8; ++i) {
+    // Row i sits in rows[(i >> 1) & 1] at byte 16 * (i >> 2) + 8 * (i & 1).
+    memcpy(s + i * pitch, &rows[(i >> 1) & 1][16 * (i >> 2) + 8 * (i & 1)],
+           n);
+  }
+}
+
+void vp9_mbpost_proc_across_ip_avx2(uint8_t *src, int pitch,
+                                    int rows, int cols, int flimit) {
+  const __m256i fifteen = _mm256_set1_epi32(15);
+  const __m256i eight = _mm256_set1_epi32(8);
+  const __m256i limit = _mm256_set1_epi32(flimit);
+  int r, c, i, j;
+
+  for (r = 0; r + 8 <= rows; r += 8) {
+    uint8_t *const s = src + r * pitch;
+    __m256i sum = _mm256_setzero_si256();
+    __m256i sumsq = _mm256_setzero_si256();
+    __m256i sub[8], cur[8], add[8];
+
+    load_columns_8x8(s - 8, pitch, sub);
+    load_columns_8x8(s, pitch, cur);
+    // Window of columns -8 .. 6.
+    for (j = 0; j < 8; ++j) {
+      sum = _mm256_add_epi32(sum, sub[j]);
+      sumsq = _mm256_add_epi32(sumsq, _mm256_mullo_epi32(sub[j], sub[j]));
+    }
+    for (j = 0; j < 7; ++j) {
+      sum = _mm256_add_epi32(sum, cur[j]);
+      sumsq = _mm256_add_epi32(sumsq, _mm256_mullo_epi32(cur[j], cur[j]));
+    }
+
+    for (c = 0; c < cols; c += 8) {
+      __m256i out[8];
+      load_columns_8x8(s + c, pitch, cur);
+      load_columns_8x8(s + c + 7, pitch, add);
+
+      for (j = 0; j < 8; ++j) {
+        const __m256i x = _mm256_sub_epi32(add[j], sub[j]);
+        const __m256i y = _mm256_add_epi32(add[j], sub[j]);
+        __m256i var, filtered;
+        sum = _mm256_add_epi32(sum, x);
+        sumsq = _mm256_add_epi32(sumsq, _mm256_mullo_epi32(x, y));
+        var = _mm256_sub_epi32(_mm256_mullo_epi32(sumsq, fifteen),
+                               _mm256_mullo_epi32(sum, sum));
+        filtered = _mm256_srai_epi32(
+            _mm256_add_epi32(_mm256_add_epi32(sum, cur[j]), eight), 4);
+        out[j] = _mm256_blendv_epi8(cur[j], filtered,
+                                    _mm256_cmpgt_epi32(limit, var));
+      }
+      // The outputs only replace columns whose last use was in this block.
+      store_columns_8x8(out, s + c, pitch, cols - c < 8 ? cols - c : 8);
+      for (j = 0; j < 8; ++j)
+        sub[j] = cur[j];
+    }
+
+    // The C version flushes its zeroed delay line into the left border.
+    for (i = 0; i < 8; ++i)
+      memset(s + i * pitch - 8, 0, 8);
+  }
+
+  if (r < rows)
+    vp9_mbpost_proc_across_ip_c(src + r * pitch, pitch, rows - r, cols,
+                                flimit);
+}
+
+void vp9_mbpost_proc_down_avx2(uint8_t *dst, int pitch,
+                               int rows, int cols, int flimit) {
+  const short *rv3 = &vp9_rv[63 & rand()];  // NOLINT
+  const __m256i fifteen = _mm256_set1_epi32(15);
+  const __m256i limit = _mm256_set1_epi32(flimit);
+  const __m256i word_mask = _mm256_set1_epi32(0xffff);
+  const __m128i pack_order = _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1,
+                                           -1, -1, -1, -1, -1, -1, -1, -1);
+  int r, c, i;
+
+  for (c = 0; c + 8 <= cols; c += 8) {
+    uint8_t *s = &dst[c];
+    __m256i sum = _mm256_setzero_si256();
+    __m256i sumsq = _mm256_setzero_si256();
+    // The per-column offsets into vp9_rv, as in rv2 of the C version.
+    const __m256i rv_offset = _mm256_setr_epi32(
+        (c * 17) & 127, ((c + 1) * 17) & 127, ((c + 2) * 17) & 127,
+        ((c + 3) * 17) & 127, ((c + 4) * 17) & 127, ((c + 5) * 17) & 127,
+        ((c + 6) * 17) & 127, ((c + 7) * 17) & 127);
+    int64_t d[16];
+
+    for (i = -8; i <= 6; i++) {
+      const __m256i v = _mm256_cvtepu8_epi32(
+          _mm_loadl_epi64((const __m128i *)(s + i * pitch)));
+      sum = _mm256_add_epi32(sum, v);
+      sumsq = _mm256_add_epi32(sumsq, _mm256_mullo_epi32(v, v));
+    }
+
+    for (r = 0; r < rows + 8; r++) {
+      const __m256i add = _mm256_cvtepu8_epi32(
+          _mm_loadl_epi64((const __m128i *)(s + 7 * pitch)));
+      const __m256i sub = _mm256_cvtepu8_epi32(
+          _mm_loadl_epi64((const __m128i *)(s - 8 * pitch)));
+      const __m256i cur = _mm256_cvtepu8_epi32(
+          _mm_loadl_epi64((const __m128i *)s));
+      // vp9_rv has room for the extra element read by the 32-bit gather.
+      const __m256i rv = _mm256_and_si256(
+          _mm256_i32gather_epi32(
+              (const int *)rv3,
+              _mm256_add_epi32(rv_offset, _mm256_set1_epi32(r & 127)), 2),
+          word_mask);
+      __m256i var, filtered, out;
+      __m128i packed;
+
+      sum = _mm256_add_epi32(sum, _mm256_sub_epi32(add, sub));
+      sumsq = _mm256_add_epi32(sumsq, _mm256_sub_epi32(
+          _mm256_mullo_epi32(add, add), _mm256_mullo_epi32(sub, sub)));
+      var = _mm256_sub_epi32(_mm256_mullo_epi32(sumsq, fifteen),
+                             _mm256_mullo_epi32(sum, sum));
+      filtered = _mm256_srai_epi32(
+          _mm256_add_epi32(_mm256_add_epi32(rv, sum), cur), 4);
+      out = _mm256_blendv_epi8(cur, filtered, _mm256_cmpgt_epi32(limit, var));
+
+      packed = _mm_or_si128(
+          _mm_shuffle_epi8(_mm256_castsi256_si128(out), pack_order),
+          _mm_slli_si128(_mm_shuffle_epi8(_mm256_extracti128_si256(out, 1),
+                                          pack_order), 4));
+      _mm_storel_epi64((__m128i *)&d[r & 15], packed);
+
+      // The C version writes its uninitialized delay line above the first
+      // row; those border rows are left alone here.
+      if (r >= 8)
+        memcpy(s - 8 * pitch, &d[(r - 8) & 15], 8);
+      s += pitch;
+    }
+  }
+
+  for (; c < cols; c++) {
+    uint8_t *s = &dst[c];
+    int sumsq = 0;
+    int sum = 0;
+    uint8_t d[16];
+    const short *rv2 = rv3 + ((c * 17) & 127);
+
+    for (i = -8; i <= 6; i++) {
+      sumsq += s[i * pitch] * s[i * pitch];
+      sum += s[i * pitch];
+    }
+
+    for (r = 0; r < rows + 8; r++) {
+      sumsq += s[7 * pitch] * s[7 * pitch] - s[-8 * pitch] * s[-8 * pitch];
+      sum += s[7 * pitch] - s[-8 * pitch];
+      d[r & 15] = s[0];
+
+      if (sumsq * 15 - sum * sum < flimit) {
+        d[r & 15] = (rv2[r & 127] + sum + s[0]) >> 4;
+      }
+
+      if (r >= 8)
+        s[-8 * pitch] = d[(r - 8) & 15];
+      s += pitch;
+    }
+  }
+}
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>  // SSE2
+#include <string.h>
+
+#include "./vp9_rtcd.h"
+#include "vp9/common/vp9_prob.h"
+
+// Byte arrays carry no alignment, so the 4-byte moves go through memcpy.
+static INLINE __m128i load_u8x4(const uint8_t *p) {
+  int v;
+  memcpy(&v, p, sizeof(v));
+  return _mm_cvtsi32_si128(v);
+}
+
+static INLINE void store_u8x4(uint8_t *p, __m128i x) {
+  const int v = _mm_cvtsi128_si32(x);
+  memcpy(p, &v, sizeof(v));
+}
+
+// Converts the two low unsigned 32-bit lanes of x to double.
+static INLINE __m128d cvt_epu32_pd(__m128i x) {
+  const __m128i sign = _mm_set1_epi32((int)0x80000000);
+  return _mm_add_pd(_mm_cvtepi32_pd(_mm_xor_si128(x, sign)),
+                    _mm_set1_pd(2147483648.0));
+}
+
+// Returns (int)(num / den) for four lanes, with den > 0. num and den stay
+// below 2^41, so the quotient is exact before truncation.
+static INLINE __m128i div_epu32(__m128d num_lo, __m128d num_hi,
+                                __m128d den_lo, __m128d den_hi) {
+  return _mm_unpacklo_epi64(_mm_cvttpd_epi32(_mm_div_pd(num_lo, den_lo)),
+                            _mm_cvttpd_epi32(_mm_div_pd(num_hi, den_hi)));
+}
+
+// Four lanes of merge_probs(). The 64-bit divide in get_prob() is done in
+// double precision, which is exact for 32-bit counts.
+void vp9_adapt_probs_sse2(const uint8_t *pre_probs, const unsigned int *counts,
+                          int n, unsigned int count_sat,
+                          unsigned int max_update_factor, uint8_t *probs) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i sign = _mm_set1_epi32((int)0x80000000);
+  const __m128i sat = _mm_set1_epi32(count_sat);
+  const __m128i sat_signed = _mm_xor_si128(sat, sign);
+  const __m128i update_factor = _mm_set1_epi32(max_update_factor);
+  const __m128d sat_pd = _mm_set1_pd(count_sat);
+  const __m128d scale = _mm_set1_pd(256.0);
+  int i;
+
+  for (i = 0; i + 4 <= n; i += 4) {
+    const __m128i a = _mm_loadu_si128((const __m128i *)(counts + 2 * i));
+    const __m128i b = _mm_loadu_si128((const __m128i *)(counts + 2 * i + 4));
+    const __m128i ct0 = _mm_unpacklo_epi64(
+        _mm_shuffle_epi32(a, _MM_SHUFFLE(2, 0, 2, 0)),
+        _mm_shuffle_epi32(b, _MM_SHUFFLE(2, 0, 2, 0)));
+    const __m128i ct1 = _mm_unpacklo_epi64(
+        _mm_shuffle_epi32(a, _MM_SHUFFLE(3, 1, 3, 1)),
+        _mm_shuffle_epi32(b, _MM_SHUFFLE(3, 1, 3, 1)));
+    const __m128i den = _mm_add_epi32(ct0, ct1);
+    // An empty context gets a zero factor, so any non-zero divisor will do.
+    const __m128i den_nz = _mm_or_si128(
+        den, _mm_srli_epi32(_mm_cmpeq_epi32(den, zero), 31));
+    const __m128i over = _mm_cmpgt_epi32(_mm_xor_si128(den, sign), sat_signed);
+    const __m128i count = _mm_or_si128(_mm_and_si128(over, sat),
+                                       _mm_andnot_si128(over, den));
+    // count and max_update_factor both fit in 16 bits.
+    const __m128i product = _mm_madd_epi16(count, update_factor);
+    const __m128i factor = div_epu32(
+        _mm_cvtepi32_pd(product), _mm_cvtepi32_pd(_mm_srli_si128(product, 8)),
+        sat_pd, sat_pd);
+    const __m128i half = _mm_srli_epi32(den, 1);
+    const __m128i ct0_hi = _mm_srli_si128(ct0, 8);
+    const __m128i half_hi = _mm_srli_si128(half, 8);
+    const __m128i den_hi = _mm_srli_si128(den_nz, 8);
+    const __m128i quot = div_epu32(
+        _mm_add_pd(_mm_mul_pd(cvt_epu32_pd(ct0), scale), cvt_epu32_pd(half)),
+        _mm_add_pd(_mm_mul_pd(cvt_epu32_pd(ct0_hi), scale),
+                   cvt_epu32_pd(half_hi)),
+        cvt_epu32_pd(den_nz), cvt_epu32_pd(den_hi));
+    // clip_prob(), then weighted_prob() on interleaved (pre, prob) pairs.
+    const __m128i prob = _mm_max_epi16(
+        _mm_min_epi16(_mm_packs_epi32(quot, quot), _mm_set1_epi16(255)),
+        _mm_set1_epi16(1));
+    const __m128i pre = _mm_unpacklo_epi8(load_u8x4(pre_probs + i), zero);
+    const __m128i factor16 = _mm_packs_epi32(factor, factor);
+    const __m128i weights = _mm_unpacklo_epi16(
+        _mm_sub_epi16(_mm_set1_epi16(256), factor16), factor16);
+    __m128i sum = _mm_madd_epi16(_mm_unpacklo_epi16(pre, prob), weights);
+    sum = _mm_srli_epi32(_mm_add_epi32(sum, _mm_set1_epi32(128)), 8);
+    sum = _mm_packs_epi32(sum, sum);
+    store_u8x4(probs + i, _mm_packus_epi16(sum, sum));
+  }
+
+  vp9_adapt_probs_c(pre_probs + i, counts + 2 * i, n - i, count_sat,
+                    max_update_factor, probs + i);
+}
@@ -785,17 +785,32 @@ static MB_MODE_INFO *set_offsets(VP9_COMMON *const cm, MACROBLOCKD *const xd,
                                  int bw, int bh, int x_mis, int y_mis,
                                  int bwl, int bhl) {
   const int offset = mi_row * cm->mi_stride + mi_col;
+  MI_INDEX index = xd->mi_arena_next;
   int x, y;
   const TileInfo *const tile = &xd->tile;
 
-  xd->mi = cm->mi_grid_visible + offset;
-  xd->mi[0] = &cm->mi[offset];
+  // The first block of a superblock is at its top left corner and starts
+  // the superblock's part of the arena.
+  if (!((mi_row | mi_col) & MI_MASK)) {
+    const int sb_cols =
+        mi_cols_aligned_to_sb(cm->mi_cols) >> MI_BLOCK_SIZE_LOG2;
+    const int sb = (mi_row >> MI_BLOCK_SIZE_LOG2) * sb_cols +
+                   (mi_col >> MI_BLOCK_SIZE_LOG2);
+    index = MI_ARENA_FIRST + sb * MI_UNITS_SB;
+  }
+  xd->mi_arena_next =
+      index + (bsize < BLOCK_8X8 ? MI_UNITS_SUB8X8 : MI_UNITS_8X8);
+
+  xd->mi_arena = cm->mi_arena;
+  xd->mi_index = cm->mi_index_visible + offset;
+  xd->mi_block = get_mi_from_index(cm->mi_arena, index);
+  xd->mi = &xd->mi_block;
   // TODO(slavarnway): Generate sb_type based on bwl and bhl, instead of
   // passing bsize from decode_partition().
   xd->mi[0]->mbmi.sb_type = bsize;
   for (y = 0; y < y_mis; ++y)
-    for (x = !y; x < x_mis; ++x) {
-      xd->mi[y * cm->mi_stride + x] = xd->mi[0];
+    for (x = 0; x < x_mis; ++x) {
+      xd->mi_index[y * cm->mi_stride + x] = index;
     }
 
   set_plane_n4(xd, bw, bh, bwl, bhl);
@@ -1004,13 +1019,19 @@ static void decode_partition(VP9Decoder *const pbi, MACROBLOCKD *const xd,
     dec_update_partition_context(xd, mi_row, mi_col, subsize, num_8x8_wh);
 }
 
+// Returns 1 if the symbol counts of the frame feed backward adaptation. They
+// are not gathered when adaptation is off or its result is discarded, which
+// lets the tile decoders take their count-free paths.
+static INLINE int frame_needs_counts(const VP9_COMMON *cm) {
+  return cm->refresh_frame_context && !cm->error_resilient_mode &&
+         !cm->frame_parallel_decoding_mode;
+}
+
 static void setup_token_decoder(const uint8_t *data,
                                 const uint8_t *data_end,
                                 size_t read_size,
                                 struct vpx_internal_error_info *error_info,
-                                vp9_reader *r,
-                                vpx_decrypt_cb decrypt_cb,
-                                void *decrypt_state) {
+                                vp9_reader *r) {
   // Validate the calculated partition length. If the buffer
   // described by the partition can't be fully read, then restrict
   // it to the portion that can be (for EC mode) or throw an error.
@@ -1018,7 +1039,7 @@ static void setup_token_decoder(const uint8_t *data,
     vpx_internal_error(error_info, VPX_CODEC_CORRUPT_FRAME,
                        "Truncated packet or corrupt tile length");
 
-  if (vp9_reader_init(r, data, read_size, decrypt_cb, decrypt_state))
+  if (vp9_reader_init(r, data, read_size, NULL, NULL))
     vpx_internal_error(error_info, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate bool decoder %d", 1);
 }
@@ -1369,7 +1390,6 @@ static void get_tile_buffer(const uint8_t *const data_end,
                             int is_last,
                             struct vpx_internal_error_info *error_info,
                             const uint8_t **data,
-                            vpx_decrypt_cb decrypt_cb, void *decrypt_state,
                             TileBuffer *buf) {
   size_t size;
 
@@ -1378,13 +1398,7 @@ static void get_tile_buffer(const uint8_t *const data_end,
       vpx_internal_error(error_info, VPX_CODEC_CORRUPT_FRAME,
                          "Truncated packet or corrupt tile length");
 
-    if (decrypt_cb) {
-      uint8_t be_data[4];
-      decrypt_cb(decrypt_state, *data, be_data, 4);
-      size = mem_get_be32(be_data);
-    } else {
-      size = mem_get_be32(*data);
-    }
+    size = mem_get_be32(*data);
     *data += 4;
 
     if (size > (size_t)(data_end - *data))
@@ -1411,8 +1425,7 @@ static void get_tile_buffers(VP9Decoder *pbi,
       const int is_last = (r == tile_rows - 1) && (c == tile_cols - 1);
       TileBuffer *const buf = &tile_buffers[r][c];
       buf->col = c;
-      get_tile_buffer(data_end, is_last, &pbi->common.error, &data,
-                      pbi->decrypt_cb, pbi->decrypt_state, buf);
+      get_tile_buffer(data_end, is_last, &pbi->common.error, &data, buf);
     }
   }
 }
@@ -1480,13 +1493,11 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi,
       tile_data->cm = cm;
       tile_data->xd = pbi->mb;
       tile_data->xd.corrupted = 0;
-      tile_data->xd.counts = cm->frame_parallel_decoding_mode ?
-                             NULL : &cm->counts;
+      tile_data->xd.counts = frame_needs_counts(cm) ? &cm->counts : NULL;
       vp9_zero(tile_data->dqcoeff);
       vp9_tile_init(&tile_data->xd.tile, tile_data->cm, tile_row, tile_col);
       setup_token_decoder(buf->data, data_end, buf->size, &cm->error,
-                          &tile_data->bit_reader, pbi->decrypt_cb,
-                          pbi->decrypt_state);
+                          &tile_data->bit_reader);
       vp9_init_macroblockd(cm, &tile_data->xd, tile_data->dqcoeff);
     }
   }
@@ -1678,7 +1689,7 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi,
   }
 
   // Initialize thread frame counts.
-  if (!cm->frame_parallel_decoding_mode) {
+  if (frame_needs_counts(cm)) {
     int i;
 
     for (i = 0; i < num_workers; ++i) {
@@ -1700,14 +1711,13 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi,
       tile_data->pbi = pbi;
       tile_data->xd = pbi->mb;
       tile_data->xd.corrupted = 0;
-      tile_data->xd.counts = cm->frame_parallel_decoding_mode ?
-                             0 : &tile_data->counts;
+      tile_data->xd.counts = frame_needs_counts(cm) ? &tile_data->counts
+                                                    : NULL;
       vp9_zero(tile_data->dqcoeff);
       vp9_tile_init(tile, cm, 0, buf->col);
       vp9_tile_init(&tile_data->xd.tile, cm, 0, buf->col);
       setup_token_decoder(buf->data, data_end, buf->size, &cm->error,
-                          &tile_data->bit_reader, pbi->decrypt_cb,
-                          pbi->decrypt_state);
+                          &tile_data->bit_reader);
       vp9_init_macroblockd(cm, &tile_data->xd, tile_data->dqcoeff);
 
       worker->had_error = 0;
@@ -1740,7 +1750,7 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi,
     }
 
     // Accumulate thread frame counts.
-    if (n >= tile_cols && !cm->frame_parallel_decoding_mode) {
+    if (n >= tile_cols && frame_needs_counts(cm)) {
       for (i = 0; i < num_workers; ++i) {
         TileWorkerData *const tile_data =
             (TileWorkerData*)pbi->tile_workers[i].data1;
@@ -2005,8 +2015,7 @@ static int read_compressed_header(VP9Decoder *pbi, const uint8_t *data,
   vp9_reader r;
   int k;
 
-  if (vp9_reader_init(&r, data, partition_size, pbi->decrypt_cb,
-                      pbi->decrypt_state))
+  if (vp9_reader_init(&r, data, partition_size, NULL, NULL))
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate bool decoder 0");
 
@@ -2107,6 +2116,25 @@ static struct vp9_read_bit_buffer *init_read_bit_buffer(
   return rb;
 }
 
+// Decrypts the compressed header and all the tile data of a frame in one call,
+// so the bool decoders can read clear data instead of invoking the decrypt
+// callback on every refill.
+static const uint8_t *decrypt_frame_data(VP9Decoder *pbi,
+                                         const uint8_t *data,
+                                         const uint8_t *data_end) {
+  VP9_COMMON *const cm = &pbi->common;
+  const size_t size = data_end - data;
+
+  if (size > pbi->clear_data_size) {
+    vpx_free(pbi->clear_data);
+    pbi->clear_data_size = 0;
+    CHECK_MEM_ERROR(cm, pbi->clear_data, vpx_malloc(size));
+    pbi->clear_data_size = size;
+  }
+  pbi->decrypt_cb(pbi->decrypt_state, data, pbi->clear_data, (int)size);
+  return pbi->clear_data;
+}
+
 //------------------------------------------------------------------------------
 
 int vp9_read_sync_code(struct vp9_read_bit_buffer *const rb) {
@@ -2137,6 +2165,7 @@ void vp9_decode_frame(VP9Decoder *pbi,
   struct vp9_read_bit_buffer rb;
   int context_updated = 0;
   uint8_t clear_data[MAX_VP9_HEADER_SIZE];
+  const uint8_t *encrypted_data = NULL;
   const size_t first_partition_size = read_uncompressed_header(pbi,
       init_read_bit_buffer(pbi, &rb, data, data_end, clear_data));
   const int tile_rows = 1 << cm->log2_tile_rows;
@@ -2155,6 +2184,13 @@ void vp9_decode_frame(VP9Decoder *pbi,
     vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
                        "Truncated packet or corrupt header length");
 
+  if (pbi->decrypt_cb) {
+    const uint8_t *const clear_data = decrypt_frame_data(pbi, data, data_end);
+    encrypted_data = data;
+    data_end = clear_data + (data_end - data);
+    data = clear_data;
+  }
+
   cm->use_prev_frame_mvs = !cm->error_resilient_mode &&
                            cm->width == cm->last_width &&
                            cm->height == cm->last_height &&
@@ -2177,6 +2213,10 @@ void vp9_decode_frame(VP9Decoder *pbi,
     vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
                        "Decode failed. Frame data header is corrupted.");
 
+  vp9_expand_coef_probs(cm->fc, pbi->coef_probs_full);
+  xd->coef_probs_full =
+      (const vp9_coeff_probs (*)[PLANE_TYPES])pbi->coef_probs_full;
+
   if (cm->lf.filter_level && !cm->skip_loop_filter) {
     vp9_loop_filter_frame_init(cm, cm->lf.filter_level);
   }
@@ -2219,8 +2259,12 @@ void vp9_decode_frame(VP9Decoder *pbi,
     *p_data_end = decode_tiles(pbi, data + first_partition_size, data_end);
   }
 
+  // Report the end of the frame relative to the caller's buffer.
+  if (encrypted_data)
+    *p_data_end = encrypted_data + (*p_data_end - data);
+
   if (!xd->corrupted) {
-    if (!cm->error_resilient_mode && !cm->frame_parallel_decoding_mode) {
+    if (frame_needs_counts(cm)) {
       vp9_adapt_coef_probs(cm);
 
       if (!frame_is_intra_only(cm)) {
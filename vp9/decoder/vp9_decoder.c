@@ -49,32 +49,44 @@ static void initialize_dec(void) {
 }
 
 static void vp9_dec_setup_mi(VP9_COMMON *cm) {
-  cm->mi = cm->mip + cm->mi_stride + 1;
-  cm->mi_grid_visible = cm->mi_grid_base + cm->mi_stride + 1;
-  memset(cm->mi_grid_base, 0,
-         cm->mi_stride * (cm->mi_rows + 1) * sizeof(*cm->mi_grid_base));
+  cm->mi_index_visible = cm->mi_index_base + cm->mi_stride + 1;
+  memset(cm->mi_index_base, 0,
+         cm->mi_stride * (cm->mi_rows + 1) * sizeof(*cm->mi_index_base));
+#if CONFIG_VP9_POSTPROC
+  // Postproc swaps its index grid in for the next frame.
+  if (cm->postproc_state.prev_mi_alloc_size == cm->mi_alloc_size) {
+    cm->postproc_state.prev_mi_index =
+        cm->postproc_state.prev_mi_index_base + cm->mi_stride + 1;
+    memset(cm->postproc_state.prev_mi_index_base, 0,
+           cm->mi_stride * (cm->mi_rows + 1) * sizeof(*cm->mi_index_base));
+  }
+#endif
 }
 
 static int vp9_dec_alloc_mi(VP9_COMMON *cm, int mi_size) {
-  cm->mip = vpx_calloc(mi_size, sizeof(*cm->mip));
-  if (!cm->mip)
+  cm->mi_arena = (uint8_t *)vpx_memalign(
+      64, MI_ARENA_FIRST * MI_UNIT + mi_size * MI_UNITS_SUB8X8 * MI_UNIT);
+  if (!cm->mi_arena)
     return 1;
   cm->mi_alloc_size = mi_size;
-  cm->mi_grid_base = (MODE_INFO **)vpx_calloc(mi_size, sizeof(MODE_INFO*));
-  if (!cm->mi_grid_base)
+  cm->mi_index_base =
+      (MI_INDEX *)vpx_calloc(mi_size, sizeof(*cm->mi_index_base));
+  if (!cm->mi_index_base)
     return 1;
   return 0;
 }
 
 static void vp9_dec_free_mi(VP9_COMMON *cm) {
-  vpx_free(cm->mip);
-  cm->mip = NULL;
-  vpx_free(cm->mi_grid_base);
-  cm->mi_grid_base = NULL;
+  vpx_free(cm->mi_arena);
+  cm->mi_arena = NULL;
+  vpx_free(cm->mi_index_base);
+  cm->mi_index_base = NULL;
+  cm->mi_index_visible = NULL;
 }
 
-VP9Decoder *vp9_decoder_create(BufferPool *const pool) {
-  VP9Decoder *volatile const pbi = vpx_memalign(32, sizeof(*pbi));
+VP9Decoder *vp9_decoder_create(BufferPool *const pool, vpx_arena_t *arena) {
+  VP9Decoder *volatile const pbi = vpx_arena_memalign(arena, 32,
+                                                      sizeof(*pbi));
   VP9_COMMON *volatile const cm = pbi ? &pbi->common : NULL;
 
   if (!cm)
@@ -129,6 +141,7 @@ void vp9_decoder_remove(VP9Decoder *pbi) {
   vpx_get_worker_interface()->end(&pbi->lf_worker);
   vpx_free(pbi->lf_worker.data1);
   vpx_free(pbi->tile_data);
+  vpx_free(pbi->clear_data);
   for (i = 0; i < pbi->num_tile_workers; ++i) {
     VPxWorker *const worker = &pbi->tile_workers[i];
     vpx_get_worker_interface()->end(worker);
@@ -140,8 +153,83 @@ void vp9_decoder_remove(VP9Decoder *pbi) {
   if (pbi->num_tile_workers > 0) {
     vp9_loop_filter_dealloc(&pbi->lf_row_sync);
   }
+}
+
+void vp9_decoder_reset(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  BufferPool *const pool = cm->buffer_pool;
+  RefCntBuffer *const frame_bufs = pool->frame_bufs;
+  int i;
+
+  lock_buffer_pool(pool);
+  // A frame nothing refers to is only released when the next one starts.
+  if (cm->new_fb_idx >= 0 && frame_bufs[cm->new_fb_idx].ref_count == 0 &&
+      frame_bufs[cm->new_fb_idx].raw_frame_buffer.priv)
+    pool->release_fb_cb(pool->cb_priv,
+                        &frame_bufs[cm->new_fb_idx].raw_frame_buffer);
+  for (i = 0; i < REF_FRAMES; ++i)
+    decrease_ref_count(cm->ref_frame_map[i], frame_bufs, pool);
+  unlock_buffer_pool(pool);
+
+  memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
+  memset(&cm->next_ref_frame_map, -1, sizeof(cm->next_ref_frame_map));
+  for (i = 0; i < REFS_PER_FRAME; ++i) {
+    cm->frame_refs[i].idx = -1;
+    cm->frame_refs[i].buf = NULL;
+  }
+  cm->new_fb_idx = INVALID_IDX;
+  cm->cur_frame = NULL;
+  cm->prev_frame = NULL;
+  cm->frame_to_show = NULL;
+
+  // The next frame has to be a key frame, which sets up the probabilities,
+  // segmentation and loop filter deltas again. Zeroing the size makes it
+  // re-initialize the context buffers without reallocating them.
+  cm->width = 0;
+  cm->height = 0;
+  cm->last_width = 0;
+  cm->last_height = 0;
+  cm->last_show_frame = 0;
+  cm->last_intra_only = 0;
+  cm->last_frame_type = KEY_FRAME;
+  cm->show_existing_frame = 0;
+  cm->current_video_frame = 0;
+#if CONFIG_VP9_POSTPROC
+  // Postproc starts over on frame 1 as well. Its previous mode info arena is
+  // kept for the next stream, and cleared when the key frame sets its size.
+  vpx_free(cm->postproc_state.prev_mip);
+  cm->postproc_state.prev_mip = NULL;
+  cm->postproc_state.prev_mi = NULL;
+  cm->postproc_state.last_base_qindex = 0;
+  cm->postproc_state.last_frame_valid = 0;
+#endif
+
+  pbi->refresh_frame_flags = 0;
+  pbi->hold_ref_buf = 0;
+  pbi->need_resync = 1;
+  pbi->ready_for_new_data = 1;
+}
+
+void vp9_decoder_mem_footprint(const VP9Decoder *pbi,
+                               vp9_mem_footprint_t *fp) {
+  const VP9LfSync *const lf_sync = &pbi->lf_row_sync;
+
+  fp->thread_data += pbi->num_tile_workers *
+                     (sizeof(*pbi->tile_workers) +
+                      sizeof(*pbi->tile_worker_data) +
+                      sizeof(*pbi->tile_worker_info));
+  if (pbi->lf_worker.data1 != NULL)
+    fp->thread_data += sizeof(LFWorkerData);
+  fp->thread_data += lf_sync->num_workers * sizeof(*lf_sync->lfdata) +
+                     lf_sync->rows * sizeof(*lf_sync->cur_sb_col);
+#if CONFIG_MULTITHREAD
+  fp->thread_data += lf_sync->rows *
+                     (sizeof(*lf_sync->mutex_) + sizeof(*lf_sync->cond_));
+#endif
 
-  vpx_free(pbi);
+  fp->context += vp9_context_buffers_footprint(&pbi->common) +
+                 pbi->total_tiles * sizeof(*pbi->tile_data) +
+                 pbi->clear_data_size;
 }
 
 static int equal_dimensions(const YV12_BUFFER_CONFIG *a,
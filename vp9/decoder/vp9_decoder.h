@@ -13,7 +13,9 @@
 
 #include "./vpx_config.h"
 
+#include "vpx/vp8.h"
 #include "vpx/vpx_codec.h"
+#include "vpx_mem/vpx_arena.h"
 #include "vpx_scale/yv12config.h"
 #include "vpx_util/vpx_thread.h"
 
@@ -71,10 +73,14 @@ typedef struct VP9Decoder {
   TileData *tile_data;
   int total_tiles;
 
+  vp9_coeff_probs coef_probs_full[TX_SIZES][PLANE_TYPES];
+
   VP9LfSync lf_row_sync;
 
   vpx_decrypt_cb decrypt_cb;
   void *decrypt_state;
+  uint8_t *clear_data;  // Decrypted copy of the current frame's data.
+  size_t clear_data_size;
 
   int max_threads;
   int inv_tile_order;
@@ -115,10 +121,21 @@ vpx_codec_err_t vp9_parse_superframe_index(const uint8_t *data,
                                            vpx_decrypt_cb decrypt_cb,
                                            void *decrypt_state);
 
-struct VP9Decoder *vp9_decoder_create(BufferPool *const pool);
+// Creates a decoder that lives in arena. The arena must outlive it.
+struct VP9Decoder *vp9_decoder_create(BufferPool *const pool,
+                                      vpx_arena_t *arena);
 
 void vp9_decoder_remove(struct VP9Decoder *pbi);
 
+// Returns pbi to the state of a new decoder, dropping its references, while
+// keeping its buffers and threads for the next stream.
+void vp9_decoder_reset(struct VP9Decoder *pbi);
+
+// Adds the bytes pbi holds outside of its arena and the frame buffer pool to
+// the thread_data and context fields of fp.
+void vp9_decoder_mem_footprint(const struct VP9Decoder *pbi,
+                               vp9_mem_footprint_t *fp);
+
 static INLINE void decrease_ref_count(int idx, RefCntBuffer *const frame_bufs,
                                       BufferPool *const pool) {
   if (idx >= 0) {
@@ -23,40 +23,90 @@
 #define EOB_CONTEXT_NODE            0
 #define ZERO_CONTEXT_NODE           1
 #define ONE_CONTEXT_NODE            2
-#define LOW_VAL_CONTEXT_NODE        0
-#define TWO_CONTEXT_NODE            1
-#define THREE_CONTEXT_NODE          2
-#define HIGH_LOW_CONTEXT_NODE       3
-#define CAT_ONE_CONTEXT_NODE        4
-#define CAT_THREEFOUR_CONTEXT_NODE  5
-#define CAT_THREE_CONTEXT_NODE      6
-#define CAT_FIVE_CONTEXT_NODE       7
+#define LOW_VAL_CONTEXT_NODE        3
+#define TWO_CONTEXT_NODE            4
+#define THREE_CONTEXT_NODE          5
+#define HIGH_LOW_CONTEXT_NODE       6
+#define CAT_ONE_CONTEXT_NODE        7
+#define CAT_THREEFOUR_CONTEXT_NODE  8
+#define CAT_THREE_CONTEXT_NODE      9
+#define CAT_FIVE_CONTEXT_NODE       10
 
 #define INCREMENT_COUNT(token)                              \
   do {                                                      \
-     if (counts)                                            \
+     if (update_counts)                                     \
        ++coef_counts[band][ctx][token];                     \
   } while (0)
 
+void vp9_expand_coef_probs(const FRAME_CONTEXT *fc,
+                           vp9_coeff_probs (*coef_probs_full)[PLANE_TYPES]) {
+  int t, i, j, k, l;
+
+  for (t = TX_4X4; t < TX_SIZES; ++t)
+    for (i = 0; i < PLANE_TYPES; ++i)
+      for (j = 0; j < REF_TYPES; ++j)
+        for (k = 0; k < COEF_BANDS; ++k)
+          for (l = 0; l < BAND_COEFF_CONTEXTS(k); ++l)
+            vp9_model_to_full_probs(fc->coef_probs[t][i][j][k][l],
+                                    coef_probs_full[t][i][j][k][l]);
+}
+
+// Reads the n extra bits of a category token, most significant first. The
+// bool decoder state is kept in locals for the whole run of bits, and only
+// written back to refill.
 static INLINE int read_coeff(const vp9_prob *probs, int n, vp9_reader *r) {
+  BD_VALUE value = r->value;
+  int count = r->count;
+  unsigned int range = r->range;
   int i, val = 0;
-  for (i = 0; i < n; ++i)
-    val = (val << 1) | vp9_read(r, probs[i]);
+
+  for (i = 0; i < n; ++i) {
+    const unsigned int split = (range * probs[i] + (256 - probs[i])) >>
+                               CHAR_BIT;
+    BD_VALUE bigsplit;
+    int shift;
+
+    if (count < 0) {
+      r->value = value;
+      r->count = count;
+      vp9_reader_fill(r);
+      value = r->value;
+      count = r->count;
+    }
+
+    bigsplit = (BD_VALUE)split << (BD_VALUE_SIZE - CHAR_BIT);
+    if (value >= bigsplit) {
+      range = range - split;
+      value = value - bigsplit;
+      val = (val << 1) | 1;
+    } else {
+      range = split;
+      val <<= 1;
+    }
+    shift = vp9_norm[range];
+    range <<= shift;
+    value <<= shift;
+    count -= shift;
+  }
+
+  r->value = value;
+  r->count = count;
+  r->range = range;
   return val;
 }
 
-static int decode_coefs(const MACROBLOCKD *xd,
-                        PLANE_TYPE type,
-                        tran_low_t *dqcoeff, TX_SIZE tx_size, const int16_t *dq,
-                        int ctx, const int16_t *scan, const int16_t *nb,
-                        vp9_reader *r) {
+static INLINE int decode_coefs_internal(const MACROBLOCKD *xd,
+                                        PLANE_TYPE type,
+                                        tran_low_t *dqcoeff, TX_SIZE tx_size,
+                                        const int16_t *dq, int ctx,
+                                        const int16_t *scan, const int16_t *nb,
+                                        vp9_reader *r, int update_counts) {
   FRAME_COUNTS *counts = xd->counts;
   const int max_eob = 16 << (tx_size << 1);
-  const FRAME_CONTEXT *const fc = xd->fc;
   const int ref = is_inter_block(&xd->mi[0]->mbmi);
   int band, c = 0;
-  const vp9_prob (*coef_probs)[COEFF_CONTEXTS][UNCONSTRAINED_NODES] =
-      fc->coef_probs[tx_size][type][ref];
+  const vp9_prob (*coef_probs)[COEFF_CONTEXTS][ENTROPY_NODES] =
+      xd->coef_probs_full[tx_size][type][ref];
   const vp9_prob *prob;
   unsigned int (*coef_counts)[COEFF_CONTEXTS][UNCONSTRAINED_NODES + 1];
   unsigned int (*eob_branch_count)[COEFF_CONTEXTS];
@@ -71,8 +121,9 @@ static int decode_coefs(const MACROBLOCKD *xd,
   const uint8_t *cat4_prob;
   const uint8_t *cat5_prob;
   const uint8_t *cat6_prob;
+  int cat6_bits;
 
-  if (counts) {
+  if (update_counts) {
     coef_counts = counts->coef[tx_size][type][ref];
     eob_branch_count = counts->eob_branch[tx_size][type][ref];
   }
@@ -86,6 +137,7 @@ static int decode_coefs(const MACROBLOCKD *xd,
       cat4_prob = vp9_cat4_prob_high10;
       cat5_prob = vp9_cat5_prob_high10;
       cat6_prob = vp9_cat6_prob_high10;
+      cat6_bits = 16;
     } else {
       cat1_prob = vp9_cat1_prob_high12;
       cat2_prob = vp9_cat2_prob_high12;
@@ -93,6 +145,7 @@ static int decode_coefs(const MACROBLOCKD *xd,
       cat4_prob = vp9_cat4_prob_high12;
       cat5_prob = vp9_cat5_prob_high12;
       cat6_prob = vp9_cat6_prob_high12;
+      cat6_bits = 18;
     }
   } else {
     cat1_prob = vp9_cat1_prob;
@@ -101,6 +154,7 @@ static int decode_coefs(const MACROBLOCKD *xd,
     cat4_prob = vp9_cat4_prob;
     cat5_prob = vp9_cat5_prob;
     cat6_prob = vp9_cat6_prob;
+    cat6_bits = 14;
   }
 #else
   cat1_prob = vp9_cat1_prob;
@@ -109,13 +163,14 @@ static int decode_coefs(const MACROBLOCKD *xd,
   cat4_prob = vp9_cat4_prob;
   cat5_prob = vp9_cat5_prob;
   cat6_prob = vp9_cat6_prob;
+  cat6_bits = 14;
 #endif
 
   while (c < max_eob) {
     int val = -1;
     band = *band_translate++;
     prob = coef_probs[band][ctx];
-    if (counts)
+    if (update_counts)
       ++eob_branch_count[band][ctx];
     if (!vp9_read(r, prob[EOB_CONTEXT_NODE])) {
       INCREMENT_COUNT(EOB_MODEL_TOKEN);
@@ -134,55 +189,44 @@ static int decode_coefs(const MACROBLOCKD *xd,
       prob = coef_probs[band][ctx];
     }
 
+    // Walk vp9_coef_con_tree with explicit branches.
     if (!vp9_read(r, prob[ONE_CONTEXT_NODE])) {
       INCREMENT_COUNT(ONE_TOKEN);
       token = ONE_TOKEN;
       val = 1;
     } else {
       INCREMENT_COUNT(TWO_TOKEN);
-      token = vp9_read_tree(r, vp9_coef_con_tree,
-                            vp9_pareto8_full[prob[PIVOT_NODE] - 1]);
-      switch (token) {
-        case TWO_TOKEN:
-        case THREE_TOKEN:
-        case FOUR_TOKEN:
+      if (!vp9_read(r, prob[LOW_VAL_CONTEXT_NODE])) {
+        if (!vp9_read(r, prob[TWO_CONTEXT_NODE])) {
+          token = TWO_TOKEN;
+          val = 2;
+        } else {
+          token = vp9_read(r, prob[THREE_CONTEXT_NODE]) ? FOUR_TOKEN
+                                                        : THREE_TOKEN;
           val = token;
-          break;
-        case CATEGORY1_TOKEN:
+        }
+      } else if (!vp9_read(r, prob[HIGH_LOW_CONTEXT_NODE])) {
+        if (!vp9_read(r, prob[CAT_ONE_CONTEXT_NODE])) {
+          token = CATEGORY1_TOKEN;
           val = CAT1_MIN_VAL + read_coeff(cat1_prob, 1, r);
-          break;
-        case CATEGORY2_TOKEN:
+        } else {
+          token = CATEGORY2_TOKEN;
           val = CAT2_MIN_VAL + read_coeff(cat2_prob, 2, r);
-          break;
-        case CATEGORY3_TOKEN:
+        }
+      } else if (!vp9_read(r, prob[CAT_THREEFOUR_CONTEXT_NODE])) {
+        if (!vp9_read(r, prob[CAT_THREE_CONTEXT_NODE])) {
+          token = CATEGORY3_TOKEN;
           val = CAT3_MIN_VAL + read_coeff(cat3_prob, 3, r);
-          break;
-        case CATEGORY4_TOKEN:
+        } else {
+          token = CATEGORY4_TOKEN;
           val = CAT4_MIN_VAL + read_coeff(cat4_prob, 4, r);
-          break;
-        case CATEGORY5_TOKEN:
-          val = CAT5_MIN_VAL + read_coeff(cat5_prob, 5, r);
-          break;
-        case CATEGORY6_TOKEN:
-#if CONFIG_VP9_HIGHBITDEPTH
-          switch (xd->bd) {
-            case VPX_BITS_8:
-              val = CAT6_MIN_VAL + read_coeff(cat6_prob, 14, r);
-              break;
-            case VPX_BITS_10:
-              val = CAT6_MIN_VAL + read_coeff(cat6_prob, 16, r);
-              break;
-            case VPX_BITS_12:
-              val = CAT6_MIN_VAL + read_coeff(cat6_prob, 18, r);
-              break;
-            default:
-              assert(0);
-              return -1;
-          }
-#else
-          val = CAT6_MIN_VAL + read_coeff(cat6_prob, 14, r);
-#endif
-          break;
+        }
+      } else if (!vp9_read(r, prob[CAT_FIVE_CONTEXT_NODE])) {
+        token = CATEGORY5_TOKEN;
+        val = CAT5_MIN_VAL + read_coeff(cat5_prob, 5, r);
+      } else {
+        token = CATEGORY6_TOKEN;
+        val = CAT6_MIN_VAL + read_coeff(cat6_prob, cat6_bits, r);
       }
     }
     v = (val * dqv) >> dq_shift;
@@ -205,6 +249,20 @@ static int decode_coefs(const MACROBLOCKD *xd,
   return c;
 }
 
+// Separate instances with and without count updates keep the counting
+// branches out of the token loop.
+static int decode_coefs(const MACROBLOCKD *xd,
+                        PLANE_TYPE type,
+                        tran_low_t *dqcoeff, TX_SIZE tx_size, const int16_t *dq,
+                        int ctx, const int16_t *scan, const int16_t *nb,
+                        vp9_reader *r) {
+  if (xd->counts)
+    return decode_coefs_internal(xd, type, dqcoeff, tx_size, dq, ctx, scan,
+                                 nb, r, 1);
+  return decode_coefs_internal(xd, type, dqcoeff, tx_size, dq, ctx, scan, nb,
+                               r, 0);
+}
+
 // TODO(slavarnway): Decode version of vp9_set_context.  Modify vp9_set_context
 // after testing is complete, then delete this version.
 static
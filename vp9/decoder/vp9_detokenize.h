@@ -20,6 +20,11 @@
 extern "C" {
 #endif
 
+// Expands the coefficient probability model of fc into full per-context
+// node probabilities, so token decoding does not look up the Pareto table.
+void vp9_expand_coef_probs(const FRAME_CONTEXT *fc,
+                           vp9_coeff_probs (*coef_probs_full)[PLANE_TYPES]);
+
 int vp9_decode_block_tokens(MACROBLOCKD *xd,
                             int plane, const scan_order *sc,
                             int x, int y,
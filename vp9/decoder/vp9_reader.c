@@ -9,6 +9,7 @@
  */
 
 #include "vpx_ports/mem.h"
+#include "vpx_ports/mem_ops.h"
 #include "vpx_mem/vpx_mem.h"
 
 #include "vp9/decoder/vp9_reader.h"
@@ -57,7 +58,21 @@ void vp9_reader_fill(vp9_reader *r) {
     loop_end = x;
   }
 
-  if (x < 0 || bits_left) {
+  if (x < 0 && bits_left >= BD_VALUE_SIZE) {
+    // Enough data remains to fill the value with a single big-endian load.
+    const int bits = (shift & ~(CHAR_BIT - 1)) + CHAR_BIT;
+    BD_VALUE big_endian_value;
+#if SIZE_MAX == 0xffffffffffffffffULL
+    big_endian_value = ((BD_VALUE)mem_get_be32(buffer) << 32) |
+                       mem_get_be32(buffer + 4);
+#else
+    big_endian_value = mem_get_be32(buffer);
+#endif
+    count += bits;
+    buffer += bits / CHAR_BIT;
+    value |= (big_endian_value >> (BD_VALUE_SIZE - bits)) <<
+             (shift & (CHAR_BIT - 1));
+  } else if (x < 0 || bits_left) {
     while (shift >= loop_end) {
       count += CHAR_BIT;
       value |= (BD_VALUE)*buffer++ << shift;
@@ -121,15 +121,17 @@ static void update_switchable_interp_probs(VP9_COMMON *cm, vp9_writer *w,
 
 static void pack_mb_tokens(vp9_writer *w,
                            TOKENEXTRA **tp, const TOKENEXTRA *const stop,
+                           const vp9_prob (*coef_probs)[UNCONSTRAINED_NODES],
                            vpx_bit_depth_t bit_depth) {
   TOKENEXTRA *p = *tp;
-
-  while (p < stop && p->token != EOSB_TOKEN) {
-    const int t = p->token;
-    const struct vp9_token *const a = &vp9_coef_encodings[t];
-    int i = 0;
-    int v = a->value;
-    int n = a->len;
+  // Work on a local copy of the writer so its state can stay in registers
+  // across the token loop.
+  vp9_writer local_w = *w;
+  vp9_writer *const lw = &local_w;
+
+  while (p < stop && VP9_TOKEN(p->packed) != EOSB_TOKEN) {
+    const int t = VP9_TOKEN(p->packed);
+    const vp9_prob *const probs = coef_probs[VP9_TOKEN_CTX(p->packed)];
 #if CONFIG_VP9_HIGHBITDEPTH
     const vp9_extra_bit *b;
     if (bit_depth == VPX_BITS_12)
@@ -143,29 +145,25 @@ static void pack_mb_tokens(vp9_writer *w,
     (void) bit_depth;
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
-    /* skip one or two nodes */
-    if (p->skip_eob_node) {
-      n -= p->skip_eob_node;
-      i = 2 * p->skip_eob_node;
-    }
+    // Write the unconstrained nodes of vp9_coef_tree directly. The EOB node
+    // is skipped after a ZERO_TOKEN.
+    if (!VP9_TOKEN_SKIP_EOB_NODE(p->packed))
+      vp9_write(lw, t != EOB_TOKEN, probs[0]);
 
-    // TODO(jbb): expanding this can lead to big gains.  It allows
-    // much better branch prediction and would enable us to avoid numerous
-    // lookups and compares.
-
-    // If we have a token that's in the constrained set, the coefficient tree
-    // is split into two treed writes.  The first treed write takes care of the
-    // unconstrained nodes.  The second treed write takes care of the
-    // constrained nodes.
-    if (t >= TWO_TOKEN && t < EOB_TOKEN) {
-      int len = UNCONSTRAINED_NODES - p->skip_eob_node;
-      int bits = v >> (n - len);
-      vp9_write_tree(w, vp9_coef_tree, p->context_tree, bits, len, i);
-      vp9_write_tree(w, vp9_coef_con_tree,
-                     vp9_pareto8_full[p->context_tree[PIVOT_NODE] - 1],
-                     v, n - len, 0);
-    } else {
-      vp9_write_tree(w, vp9_coef_tree, p->context_tree, v, n, i);
+    if (t != EOB_TOKEN) {
+      vp9_write(lw, t != ZERO_TOKEN, probs[1]);
+
+      if (t != ZERO_TOKEN) {
+        vp9_write(lw, t != ONE_TOKEN, probs[2]);
+
+        if (t != ONE_TOKEN) {
+          // The constrained nodes come from the Pareto model.
+          const struct vp9_token *const a = &vp9_coef_encodings[t];
+          vp9_write_tree(lw, vp9_coef_con_tree,
+                         vp9_pareto8_full[probs[PIVOT_NODE] - 1],
+                         a->value, a->len - UNCONSTRAINED_NODES, 0);
+        }
+      }
     }
 
     if (b->base_val) {
@@ -179,17 +177,18 @@ static void pack_mb_tokens(vp9_writer *w,
 
         do {
           const int bb = (v >> --n) & 1;
-          vp9_write(w, bb, pb[i >> 1]);
+          vp9_write(lw, bb, pb[i >> 1]);
           i = b->tree[i + bb];
         } while (n);
       }
 
-      vp9_write_bit(w, e & 1);
+      vp9_write_bit(lw, e & 1);
     }
     ++p;
   }
 
-  *tp = p + (p->token == EOSB_TOKEN);
+  *w = local_w;
+  *tp = p + (VP9_TOKEN(p->packed) == EOSB_TOKEN);
 }
 
 static void write_segment_id(vp9_writer *w, const struct segmentation *seg,
@@ -399,7 +398,10 @@ static void write_modes_b(VP9_COMP *cpi, const TileInfo *const tile,
   }
 
   assert(*tok < tok_end);
-  pack_mb_tokens(w, tok, tok_end, cm->bit_depth);
+  pack_mb_tokens(w, tok, tok_end,
+                 (const vp9_prob (*)[UNCONSTRAINED_NODES])
+                     cm->fc->coef_probs,
+                 cm->bit_depth);
 }
 
 static void write_partition(const VP9_COMMON *const cm,
@@ -484,9 +486,10 @@ static void write_modes_sb(VP9_COMP *cpi,
 
 static void write_modes(VP9_COMP *cpi,
                         const TileInfo *const tile, vp9_writer *w,
-                        TOKENEXTRA **tok, const TOKENEXTRA *const tok_end) {
+                        TokenChunk *chunk) {
   const VP9_COMMON *const cm = &cpi->common;
   MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
+  TOKENEXTRA *tok = chunk->tokens;
   int mi_row, mi_col;
 
   set_partition_probs(cm, xd);
@@ -495,10 +498,18 @@ static void write_modes(VP9_COMP *cpi,
        mi_row += MI_BLOCK_SIZE) {
     vp9_zero(xd->left_seg_context);
     for (mi_col = tile->mi_col_start; mi_col < tile->mi_col_end;
-         mi_col += MI_BLOCK_SIZE)
-      write_modes_sb(cpi, tile, w, tok, tok_end, mi_row, mi_col,
+         mi_col += MI_BLOCK_SIZE) {
+      // Every superblock has at least one token, so a used up chunk means
+      // the encoder moved on to the next one here.
+      if (tok == chunk->stop) {
+        chunk = chunk->next;
+        tok = chunk->tokens;
+      }
+      write_modes_sb(cpi, tile, w, &tok, chunk->stop, mi_row, mi_col,
                      BLOCK_64X64);
+    }
   }
+  assert(tok == chunk->stop);
 }
 
 static void build_tree_distribution(VP9_COMP *cpi, TX_SIZE tx_size,
@@ -930,7 +941,6 @@ static size_t encode_tiles(VP9_COMP *cpi, uint8_t *data_ptr) {
   VP9_COMMON *const cm = &cpi->common;
   vp9_writer residual_bc;
   int tile_row, tile_col;
-  TOKENEXTRA *tok_end;
   size_t total_size = 0;
   const int tile_cols = 1 << cm->log2_tile_cols;
   const int tile_rows = 1 << cm->log2_tile_rows;
@@ -941,10 +951,6 @@ static size_t encode_tiles(VP9_COMP *cpi, uint8_t *data_ptr) {
   for (tile_row = 0; tile_row < tile_rows; tile_row++) {
     for (tile_col = 0; tile_col < tile_cols; tile_col++) {
       int tile_idx = tile_row * tile_cols + tile_col;
-      TOKENEXTRA *tok = cpi->tile_tok[tile_row][tile_col];
-
-      tok_end = cpi->tile_tok[tile_row][tile_col] +
-          cpi->tok_count[tile_row][tile_col];
 
       if (tile_col < tile_cols - 1 || tile_row < tile_rows - 1)
         vp9_start_encode(&residual_bc, data_ptr + total_size + 4);
@@ -952,8 +958,7 @@ static size_t encode_tiles(VP9_COMP *cpi, uint8_t *data_ptr) {
         vp9_start_encode(&residual_bc, data_ptr + total_size);
 
       write_modes(cpi, &cpi->tile_data[tile_idx].tile_info,
-                  &residual_bc, &tok, tok_end);
-      assert(tok == tok_end);
+                  &residual_bc, cpi->tile_tok[tile_row][tile_col]);
       vp9_stop_encode(&residual_bc);
       if (tile_col < tile_cols - 1 || tile_row < tile_rows - 1) {
         // size of this tile
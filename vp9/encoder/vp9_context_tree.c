@@ -8,9 +8,15 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <assert.h>
+
 #include "vp9/encoder/vp9_context_tree.h"
 #include "vp9/encoder/vp9_encoder.h"
 
+// Size of the slabs the partition tree is built from. A tree takes a few of
+// them.
+#define PC_ARENA_SLAB_SIZE (2 << 20)
+
 static const BLOCK_SIZE square[] = {
   BLOCK_8X8,
   BLOCK_16X16,
@@ -18,76 +24,129 @@ static const BLOCK_SIZE square[] = {
   BLOCK_64X64,
 };
 
-static void alloc_mode_context(VP9_COMMON *cm, int num_4x4_blk,
-                               PICK_MODE_CONTEXT *ctx) {
+// Buffer sets in a coefficient slot: two for luma and three for each chroma
+// plane, which also keeps the best intra uv mode.
+#define SLOT_BUFS (3 * MAX_MB_PLANE - 1)
+
+static void alloc_mode_context(VP9_COMMON *cm, vpx_arena_t *arena,
+                               int num_4x4_blk, PICK_MODE_CONTEXT *ctx) {
   const int num_blk = (num_4x4_blk < 4 ? 4 : num_4x4_blk);
-  const int num_pix = num_blk << 4;
-  int i, k;
   ctx->num_4x4_blk = num_blk;
 
   CHECK_MEM_ERROR(cm, ctx->zcoeff_blk,
-                  vpx_calloc(num_4x4_blk, sizeof(uint8_t)));
-  for (i = 0; i < MAX_MB_PLANE; ++i) {
-    for (k = 0; k < 3; ++k) {
-      CHECK_MEM_ERROR(cm, ctx->coeff[i][k],
-                      vpx_memalign(16, num_pix * sizeof(*ctx->coeff[i][k])));
-      CHECK_MEM_ERROR(cm, ctx->qcoeff[i][k],
-                      vpx_memalign(16, num_pix * sizeof(*ctx->qcoeff[i][k])));
-      CHECK_MEM_ERROR(cm, ctx->dqcoeff[i][k],
-                      vpx_memalign(16, num_pix * sizeof(*ctx->dqcoeff[i][k])));
-      CHECK_MEM_ERROR(cm, ctx->eobs[i][k],
-                      vpx_memalign(16, num_pix * sizeof(*ctx->eobs[i][k])));
-      ctx->coeff_pbuf[i][k]   = ctx->coeff[i][k];
-      ctx->qcoeff_pbuf[i][k]  = ctx->qcoeff[i][k];
-      ctx->dqcoeff_pbuf[i][k] = ctx->dqcoeff[i][k];
-      ctx->eobs_pbuf[i][k]    = ctx->eobs[i][k];
+                  vpx_arena_calloc(arena, num_4x4_blk, sizeof(uint8_t)));
+}
+
+static void alloc_tree_contexts(VP9_COMMON *cm, vpx_arena_t *arena,
+                                PC_TREE *tree, int num_4x4_blk) {
+  alloc_mode_context(cm, arena, num_4x4_blk, &tree->none);
+  alloc_mode_context(cm, arena, num_4x4_blk/2, &tree->horizontal[0]);
+  alloc_mode_context(cm, arena, num_4x4_blk/2, &tree->vertical[0]);
+
+  /* TODO(Jbb): for 4x8 and 8x4 these allocated values are not used.
+   * Figure out a better way to do this. */
+  alloc_mode_context(cm, arena, num_4x4_blk/2, &tree->horizontal[1]);
+  alloc_mode_context(cm, arena, num_4x4_blk/2, &tree->vertical[1]);
+}
+
+// Gives each of the nodes of one level of the tree its two coefficient slots,
+// all carved from a single block.
+static void alloc_coeff_slots(VP9_COMMON *cm, vpx_arena_t *arena,
+                              PC_TREE *tree, int nodes) {
+  const int num_pix = 1 << num_pels_log2_lookup[tree->block_size];
+  const int coeff_size = SLOT_BUFS * 3 * num_pix;
+  const int eobs_size = SLOT_BUFS * (num_pix >> 4);
+  tran_low_t *coeff;
+  uint16_t *eobs;
+  int i, j;
+
+  CHECK_MEM_ERROR(cm, coeff,
+                  vpx_arena_memalign(arena, 16, nodes * 2 * coeff_size *
+                                     sizeof(*coeff)));
+  CHECK_MEM_ERROR(cm, eobs,
+                  vpx_arena_memalign(arena, 16, nodes * 2 * eobs_size *
+                                     sizeof(*eobs)));
+  for (i = 0; i < nodes; ++i) {
+    for (j = 0; j < 2; ++j) {
+      tree[i].coeff_slot[j] = coeff;
+      tree[i].eobs_slot[j] = eobs;
+      coeff += coeff_size;
+      eobs += eobs_size;
     }
+    // Keep every context on valid buffers for the searches that do not pick
+    // slots themselves.
+    vp9_pc_tree_use_coeff_slot(&tree[i], PARTITION_NONE, 0);
+    vp9_pc_tree_use_coeff_slot(&tree[i], PARTITION_HORZ, 1);
+    vp9_pc_tree_use_coeff_slot(&tree[i], PARTITION_VERT, 1);
+    vp9_pc_tree_use_coeff_slot(&tree[i], PARTITION_SPLIT, 1);
   }
 }
 
-static void free_mode_context(PICK_MODE_CONTEXT *ctx) {
-  int i, k;
-  vpx_free(ctx->zcoeff_blk);
-  ctx->zcoeff_blk = 0;
+// Points ctx at the buffers of a slot sized for num_pix pixels, starting
+// offset pixels in.
+static void set_mode_context_buffers(PICK_MODE_CONTEXT *ctx,
+                                     tran_low_t *coeff, uint16_t *eobs,
+                                     int num_pix, int offset) {
+  int i, k, buf = 0;
+
   for (i = 0; i < MAX_MB_PLANE; ++i) {
     for (k = 0; k < 3; ++k) {
-      vpx_free(ctx->coeff[i][k]);
-      ctx->coeff[i][k] = 0;
-      vpx_free(ctx->qcoeff[i][k]);
-      ctx->qcoeff[i][k] = 0;
-      vpx_free(ctx->dqcoeff[i][k]);
-      ctx->dqcoeff[i][k] = 0;
-      vpx_free(ctx->eobs[i][k]);
-      ctx->eobs[i][k] = 0;
+      // Luma never stores an intra uv mode.
+      if (i == 0 && k == 2) {
+        ctx->coeff_pbuf[i][k] = NULL;
+        ctx->qcoeff_pbuf[i][k] = NULL;
+        ctx->dqcoeff_pbuf[i][k] = NULL;
+        ctx->eobs_pbuf[i][k] = NULL;
+        continue;
+      }
+      ctx->coeff_pbuf[i][k]   = coeff + (3 * buf + 0) * num_pix + offset;
+      ctx->qcoeff_pbuf[i][k]  = coeff + (3 * buf + 1) * num_pix + offset;
+      ctx->dqcoeff_pbuf[i][k] = coeff + (3 * buf + 2) * num_pix + offset;
+      ctx->eobs_pbuf[i][k]    = eobs + ((buf * num_pix + offset) >> 4);
+      ++buf;
     }
   }
 }
 
-static void alloc_tree_contexts(VP9_COMMON *cm, PC_TREE *tree,
-                                int num_4x4_blk) {
-  alloc_mode_context(cm, num_4x4_blk, &tree->none);
-  alloc_mode_context(cm, num_4x4_blk/2, &tree->horizontal[0]);
-  alloc_mode_context(cm, num_4x4_blk/2, &tree->vertical[0]);
-
-  /* TODO(Jbb): for 4x8 and 8x4 these allocated values are not used.
-   * Figure out a better way to do this. */
-  alloc_mode_context(cm, num_4x4_blk/2, &tree->horizontal[1]);
-  alloc_mode_context(cm, num_4x4_blk/2, &tree->vertical[1]);
-}
-
-static void free_tree_contexts(PC_TREE *tree) {
-  free_mode_context(&tree->none);
-  free_mode_context(&tree->horizontal[0]);
-  free_mode_context(&tree->horizontal[1]);
-  free_mode_context(&tree->vertical[0]);
-  free_mode_context(&tree->vertical[1]);
+void vp9_pc_tree_use_coeff_slot(PC_TREE *tree, PARTITION_TYPE partition,
+                                int slot) {
+  const int num_pix = 1 << num_pels_log2_lookup[tree->block_size];
+  tran_low_t *const coeff = tree->coeff_slot[slot];
+  uint16_t *const eobs = tree->eobs_slot[slot];
+  // Blocks below 8x8 are coded over the whole 8x8 area, so the two halves of
+  // an 8x8 node share the slot. Their coefficients are always recomputed.
+  const int half = tree->block_size > BLOCK_8X8 ? num_pix / 2 : 0;
+
+  switch (partition) {
+    case PARTITION_NONE:
+      set_mode_context_buffers(&tree->none, coeff, eobs, num_pix, 0);
+      break;
+    case PARTITION_HORZ:
+      set_mode_context_buffers(&tree->horizontal[0], coeff, eobs, num_pix, 0);
+      set_mode_context_buffers(&tree->horizontal[1], coeff, eobs, num_pix,
+                               half);
+      break;
+    case PARTITION_VERT:
+      set_mode_context_buffers(&tree->vertical[0], coeff, eobs, num_pix, 0);
+      set_mode_context_buffers(&tree->vertical[1], coeff, eobs, num_pix,
+                               half);
+      break;
+    case PARTITION_SPLIT:
+      if (tree->block_size == BLOCK_8X8)
+        set_mode_context_buffers(tree->leaf_split[0], coeff, eobs, num_pix, 0);
+      break;
+    default:
+      assert(0 && "Invalid partition type.");
+      break;
+  }
 }
 
 // This function sets up a tree of contexts such that at each square
 // partition level. There are contexts for none, horizontal, vertical, and
 // split.  Along with a block_size value and a selected block_size which
 // represents the state of our search.
-void vp9_setup_pc_tree(VP9_COMMON *cm, ThreadData *td) {
+void vp9_setup_pc_tree(VP9_COMP *cpi, ThreadData *td) {
+  VP9_COMMON *const cm = &cpi->common;
   int i, j;
   const int leaf_nodes = 64;
   const int tree_nodes = 64 + 16 + 4 + 1;
@@ -97,12 +156,21 @@ void vp9_setup_pc_tree(VP9_COMMON *cm, ThreadData *td) {
   int square_index = 1;
   int nodes;
 
-  vpx_free(td->leaf_tree);
-  CHECK_MEM_ERROR(cm, td->leaf_tree, vpx_calloc(leaf_nodes,
-                                                sizeof(*td->leaf_tree)));
-  vpx_free(td->pc_tree);
-  CHECK_MEM_ERROR(cm, td->pc_tree, vpx_calloc(tree_nodes,
-                                              sizeof(*td->pc_tree)));
+  // The whole tree lives in td->pc_arena, so setting it up again reuses the
+  // slabs of the previous tree.
+  if (td->pc_arena != NULL)
+    vpx_arena_reset(td->pc_arena);
+  else
+    CHECK_MEM_ERROR(cm, td->pc_arena,
+                    vpx_arena_create(vpx_arena_allocator(cpi->arena),
+                                     PC_ARENA_SLAB_SIZE));
+
+  CHECK_MEM_ERROR(cm, td->leaf_tree,
+                  vpx_arena_calloc(td->pc_arena, leaf_nodes,
+                                   sizeof(*td->leaf_tree)));
+  CHECK_MEM_ERROR(cm, td->pc_tree,
+                  vpx_arena_calloc(td->pc_arena, tree_nodes,
+                                   sizeof(*td->pc_tree)));
 
   this_pc = &td->pc_tree[0];
   this_leaf = &td->leaf_tree[0];
@@ -110,13 +178,13 @@ void vp9_setup_pc_tree(VP9_COMMON *cm, ThreadData *td) {
   // 4x4 blocks smaller than 8x8 but in the same 8x8 block share the same
   // context so we only need to allocate 1 for each 8x8 block.
   for (i = 0; i < leaf_nodes; ++i)
-    alloc_mode_context(cm, 1, &td->leaf_tree[i]);
+    alloc_mode_context(cm, td->pc_arena, 1, &td->leaf_tree[i]);
 
   // Sets up all the leaf nodes in the tree.
   for (pc_tree_index = 0; pc_tree_index < leaf_nodes; ++pc_tree_index) {
     PC_TREE *const tree = &td->pc_tree[pc_tree_index];
     tree->block_size = square[0];
-    alloc_tree_contexts(cm, tree, 4);
+    alloc_tree_contexts(cm, td->pc_arena, tree, 4);
     tree->leaf_split[0] = this_leaf++;
     for (j = 1; j < 4; j++)
       tree->leaf_split[j] = tree->leaf_split[0];
@@ -127,7 +195,7 @@ void vp9_setup_pc_tree(VP9_COMMON *cm, ThreadData *td) {
   for (nodes = 16; nodes > 0; nodes >>= 2) {
     for (i = 0; i < nodes; ++i) {
       PC_TREE *const tree = &td->pc_tree[pc_tree_index];
-      alloc_tree_contexts(cm, tree, 4 << (2 * square_index));
+      alloc_tree_contexts(cm, td->pc_arena, tree, 4 << (2 * square_index));
       tree->block_size = square[square_index];
       for (j = 0; j < 4; j++)
         tree->split[j] = this_pc++;
@@ -137,22 +205,20 @@ void vp9_setup_pc_tree(VP9_COMMON *cm, ThreadData *td) {
   }
   td->pc_root = &td->pc_tree[tree_nodes - 1];
   td->pc_root[0].none.best_mode_index = 2;
+
+  // Coefficients are only kept per level of the tree, for the best
+  // partitioning of each node and the one being searched next to it.
+  pc_tree_index = 0;
+  for (nodes = leaf_nodes; nodes > 0; nodes >>= 2) {
+    alloc_coeff_slots(cm, td->pc_arena, &td->pc_tree[pc_tree_index], nodes);
+    pc_tree_index += nodes;
+  }
 }
 
 void vp9_free_pc_tree(ThreadData *td) {
-  const int tree_nodes = 64 + 16 + 4 + 1;
-  int i;
-
-  // Set up all 4x4 mode contexts
-  for (i = 0; i < 64; ++i)
-    free_mode_context(&td->leaf_tree[i]);
-
-  // Sets up all the leaf nodes in the tree.
-  for (i = 0; i < tree_nodes; ++i)
-    free_tree_contexts(&td->pc_tree[i]);
-
-  vpx_free(td->pc_tree);
+  vpx_arena_destroy(td->pc_arena);
+  td->pc_arena = NULL;
   td->pc_tree = NULL;
-  vpx_free(td->leaf_tree);
   td->leaf_tree = NULL;
+  td->pc_root = NULL;
 }
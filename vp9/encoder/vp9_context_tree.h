@@ -23,12 +23,9 @@ typedef struct {
   MODE_INFO mic;
   MB_MODE_INFO_EXT mbmi_ext;
   uint8_t *zcoeff_blk;
-  tran_low_t *coeff[MAX_MB_PLANE][3];
-  tran_low_t *qcoeff[MAX_MB_PLANE][3];
-  tran_low_t *dqcoeff[MAX_MB_PLANE][3];
-  uint16_t *eobs[MAX_MB_PLANE][3];
 
-  // dual buffer pointers, 0: in use, 1: best in store
+  // dual buffer pointers, 0: in use, 1: best in store, 2: best intra uv
+  // store. They point into a coefficient slot of the owning PC_TREE node.
   tran_low_t *coeff_pbuf[MAX_MB_PLANE][3];
   tran_low_t *qcoeff_pbuf[MAX_MB_PLANE][3];
   tran_low_t *dqcoeff_pbuf[MAX_MB_PLANE][3];
@@ -80,9 +77,18 @@ typedef struct PC_TREE {
     struct PC_TREE *split[4];
     PICK_MODE_CONTEXT *leaf_split[4];
   };
+  // Coefficient storage for the partitionings searched at this node. One
+  // slot holds the best candidate so far and the other the one being
+  // searched, so a node never keeps more than two sets of coefficients.
+  tran_low_t *coeff_slot[2];
+  uint16_t *eobs_slot[2];
 } PC_TREE;
 
-void vp9_setup_pc_tree(struct VP9Common *cm, struct ThreadData *td);
+void vp9_setup_pc_tree(struct VP9_COMP *cpi, struct ThreadData *td);
+// Points the mode contexts that code the given partitioning of tree at the
+// coefficient buffers of slot.
+void vp9_pc_tree_use_coeff_slot(PC_TREE *tree, PARTITION_TYPE partition,
+                                int slot);
 void vp9_free_pc_tree(struct ThreadData *td);
 
 #endif /* VP9_ENCODER_VP9_CONTEXT_TREE_H_ */
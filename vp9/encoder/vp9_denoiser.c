@@ -433,32 +433,40 @@ int vp9_denoiser_alloc(VP9_DENOISER *denoiser, int width, int height,
   const int legacy_byte_alignment = 0;
   assert(denoiser != NULL);
 
+  // The buffers are reused when they are large enough, so that the encoder
+  // can resize them for a new frame size without allocating.
   for (i = 0; i < MAX_REF_FRAMES; ++i) {
-    fail = vp9_alloc_frame_buffer(&denoiser->running_avg_y[i], width, height,
-                                  ssx, ssy,
+    fail = vp9_realloc_frame_buffer(&denoiser->running_avg_y[i], width, height,
+                                    ssx, ssy,
 #if CONFIG_VP9_HIGHBITDEPTH
-                                  use_highbitdepth,
+                                    use_highbitdepth,
 #endif
-                                  border, legacy_byte_alignment);
+                                    border, legacy_byte_alignment,
+                                    NULL, NULL, NULL);
     if (fail) {
       vp9_denoiser_free(denoiser);
       return 1;
     }
+    memset(denoiser->running_avg_y[i].buffer_alloc, 0,
+           denoiser->running_avg_y[i].frame_size);
 #ifdef OUTPUT_YUV_DENOISED
     make_grayscale(&denoiser->running_avg_y[i]);
 #endif
   }
 
-  fail = vp9_alloc_frame_buffer(&denoiser->mc_running_avg_y, width, height,
-                                ssx, ssy,
+  fail = vp9_realloc_frame_buffer(&denoiser->mc_running_avg_y, width, height,
+                                  ssx, ssy,
 #if CONFIG_VP9_HIGHBITDEPTH
-                                use_highbitdepth,
+                                  use_highbitdepth,
 #endif
-                                border, legacy_byte_alignment);
+                                  border, legacy_byte_alignment,
+                                  NULL, NULL, NULL);
   if (fail) {
     vp9_denoiser_free(denoiser);
     return 1;
   }
+  memset(denoiser->mc_running_avg_y.buffer_alloc, 0,
+         denoiser->mc_running_avg_y.frame_size);
 #ifdef OUTPUT_YUV_DENOISED
   make_grayscale(&denoiser->running_avg_y[i]);
 #endif
@@ -1422,7 +1422,7 @@ static void encode_b(VP9_COMP *cpi, const TileInfo *const tile,
   if (output_enabled) {
     update_stats(&cpi->common, td);
 
-    (*tp)->token = EOSB_TOKEN;
+    (*tp)->packed = EOSB_TOKEN;
     (*tp)++;
   }
 }
@@ -1760,7 +1760,7 @@ static void encode_b_rt(VP9_COMP *cpi, ThreadData *td,
   encode_superblock(cpi, td, tp, output_enabled, mi_row, mi_col, bsize, ctx);
   update_stats(&cpi->common, td);
 
-  (*tp)->token = EOSB_TOKEN;
+  (*tp)->packed = EOSB_TOKEN;
   (*tp)++;
 }
 
@@ -1880,6 +1880,10 @@ static void rd_use_partition(VP9_COMP *cpi,
   pc_tree->partitioning = partition;
   save_context(x, mi_row, mi_col, a, l, sa, sl, bsize);
 
+  // PARTITION_NONE and the given partitioning may both be searched here.
+  vp9_pc_tree_use_coeff_slot(pc_tree, PARTITION_NONE, 0);
+  vp9_pc_tree_use_coeff_slot(pc_tree, partition, 1);
+
   if (bsize == BLOCK_16X16 && cpi->oxcf.aq_mode) {
     set_offsets(cpi, tile_info, x, mi_row, mi_col, bsize);
     x->mb_energy = vp9_block_energy(cpi, x, bsize);
@@ -2045,6 +2049,7 @@ static void rd_use_partition(VP9_COMP *cpi,
 
       save_context(x, mi_row, mi_col, a, l, sa, sl, bsize);
       pc_tree->split[i]->partitioning = PARTITION_NONE;
+      vp9_pc_tree_use_coeff_slot(pc_tree->split[i], PARTITION_NONE, 0);
       rd_pick_sb_modes(cpi, tile_data, x,
                        mi_row + y_idx, mi_col + x_idx, &tmp_rdc,
                        split_subsize, &pc_tree->split[i]->none, INT64_MAX);
@@ -2368,6 +2373,9 @@ static void rd_pick_partition(VP9_COMP *cpi, ThreadData *td,
   RD_COST this_rdc, sum_rdc, best_rdc;
   int do_split = bsize >= BLOCK_8X8;
   int do_rect = 1;
+  // Coefficient slot for the next candidate, the other one holds the best
+  // candidate so far. They trade places when the candidate wins.
+  int coeff_slot = 0;
 
   // Override skipping rectangular partition operations for edge blocks
   const int force_horz_split = (mi_row + mi_step >= cm->mi_rows);
@@ -2489,6 +2497,7 @@ static void rd_pick_partition(VP9_COMP *cpi, ThreadData *td,
 
   // PARTITION_NONE
   if (partition_none_allowed) {
+    vp9_pc_tree_use_coeff_slot(pc_tree, PARTITION_NONE, coeff_slot);
     rd_pick_sb_modes(cpi, tile_data, x, mi_row, mi_col,
                      &this_rdc, bsize, ctx, best_rdc.rdcost);
     if (this_rdc.rate != INT_MAX) {
@@ -2504,6 +2513,7 @@ static void rd_pick_partition(VP9_COMP *cpi, ThreadData *td,
         int rate_breakout_thr = cpi->sf.partition_search_breakout_rate_thr;
 
         best_rdc = this_rdc;
+        coeff_slot ^= 1;
         if (bsize >= BLOCK_8X8)
           pc_tree->partitioning = PARTITION_NONE;
 
@@ -2589,6 +2599,7 @@ static void rd_pick_partition(VP9_COMP *cpi, ThreadData *td,
       if (cpi->sf.adaptive_pred_interp_filter && partition_none_allowed)
         pc_tree->leaf_split[0]->pred_interp_filter =
             ctx->mic.mbmi.interp_filter;
+      vp9_pc_tree_use_coeff_slot(pc_tree, PARTITION_SPLIT, coeff_slot);
       rd_pick_sb_modes(cpi, tile_data, x, mi_row, mi_col, &sum_rdc, subsize,
                        pc_tree->leaf_split[0], best_rdc.rdcost);
       if (sum_rdc.rate == INT_MAX)
@@ -2629,6 +2640,7 @@ static void rd_pick_partition(VP9_COMP *cpi, ThreadData *td,
 
       if (sum_rdc.rdcost < best_rdc.rdcost) {
         best_rdc = sum_rdc;
+        coeff_slot ^= 1;
         pc_tree->partitioning = PARTITION_SPLIT;
       }
     } else {
@@ -2650,6 +2662,7 @@ static void rd_pick_partition(VP9_COMP *cpi, ThreadData *td,
         partition_none_allowed)
       pc_tree->horizontal[0].pred_interp_filter =
           ctx->mic.mbmi.interp_filter;
+    vp9_pc_tree_use_coeff_slot(pc_tree, PARTITION_HORZ, coeff_slot);
     rd_pick_sb_modes(cpi, tile_data, x, mi_row, mi_col, &sum_rdc, subsize,
                      &pc_tree->horizontal[0], best_rdc.rdcost);
 
@@ -2683,6 +2696,7 @@ static void rd_pick_partition(VP9_COMP *cpi, ThreadData *td,
       sum_rdc.rdcost = RDCOST(x->rdmult, x->rddiv, sum_rdc.rate, sum_rdc.dist);
       if (sum_rdc.rdcost < best_rdc.rdcost) {
         best_rdc = sum_rdc;
+        coeff_slot ^= 1;
         pc_tree->partitioning = PARTITION_HORZ;
       }
     }
@@ -2699,6 +2713,7 @@ static void rd_pick_partition(VP9_COMP *cpi, ThreadData *td,
         partition_none_allowed)
       pc_tree->vertical[0].pred_interp_filter =
           ctx->mic.mbmi.interp_filter;
+    vp9_pc_tree_use_coeff_slot(pc_tree, PARTITION_VERT, coeff_slot);
     rd_pick_sb_modes(cpi, tile_data, x, mi_row, mi_col, &sum_rdc, subsize,
                      &pc_tree->vertical[0], best_rdc.rdcost);
     if (sum_rdc.rdcost < best_rdc.rdcost && mi_col + mi_step < cm->mi_cols &&
@@ -2732,6 +2747,7 @@ static void rd_pick_partition(VP9_COMP *cpi, ThreadData *td,
                               sum_rdc.rate, sum_rdc.dist);
       if (sum_rdc.rdcost < best_rdc.rdcost) {
         best_rdc = sum_rdc;
+        coeff_slot ^= 1;
         pc_tree->partitioning = PARTITION_VERT;
       }
     }
@@ -2762,11 +2778,11 @@ static void rd_pick_partition(VP9_COMP *cpi, ThreadData *td,
   }
 }
 
-static void encode_rd_sb_row(VP9_COMP *cpi,
-                             ThreadData *td,
-                             TileDataEnc *tile_data,
-                             int mi_row,
-                             TOKENEXTRA **tp) {
+static int encode_rd_sb_row(VP9_COMP *cpi,
+                            ThreadData *td,
+                            TileDataEnc *tile_data,
+                            int mi_row,
+                            TOKENEXTRA **tp) {
   VP9_COMMON *const cm = &cpi->common;
   TileInfo *const tile_info = &tile_data->tile_info;
   MACROBLOCK *const x = &td->mb;
@@ -2791,6 +2807,9 @@ static void encode_rd_sb_row(VP9_COMP *cpi,
     const int idx_str = cm->mi_stride * mi_row + mi_col;
     MODE_INFO **mi = cm->mi_grid_visible + idx_str;
 
+    if (!vp9_reserve_sb_tokens(&tile_data->tok_chunk, tp))
+      return 0;
+
     if (sf->adaptive_pred_interp_filter) {
       for (i = 0; i < 64; ++i)
         td->leaf_tree[i].pred_interp_filter = SWITCHABLE;
@@ -2845,6 +2864,7 @@ static void encode_rd_sb_row(VP9_COMP *cpi,
                         &dummy_rdc, INT64_MAX, td->pc_root);
     }
   }
+  return 1;
 }
 
 static void init_encode_frame_mb_context(VP9_COMP *cpi) {
@@ -3548,11 +3568,11 @@ static void nonrd_use_partition(VP9_COMP *cpi,
     update_partition_context(xd, mi_row, mi_col, subsize, bsize);
 }
 
-static void encode_nonrd_sb_row(VP9_COMP *cpi,
-                                ThreadData *td,
-                                TileDataEnc *tile_data,
-                                int mi_row,
-                                TOKENEXTRA **tp) {
+static int encode_nonrd_sb_row(VP9_COMP *cpi,
+                               ThreadData *td,
+                               TileDataEnc *tile_data,
+                               int mi_row,
+                               TOKENEXTRA **tp) {
   SPEED_FEATURES *const sf = &cpi->sf;
   VP9_COMMON *const cm = &cpi->common;
   TileInfo *const tile_info = &tile_data->tile_info;
@@ -3574,6 +3594,9 @@ static void encode_nonrd_sb_row(VP9_COMP *cpi,
     PARTITION_SEARCH_TYPE partition_search_type = sf->partition_search_type;
     BLOCK_SIZE bsize = BLOCK_64X64;
     int seg_skip = 0;
+
+    if (!vp9_reserve_sb_tokens(&tile_data->tok_chunk, tp))
+      return 0;
     x->source_variance = UINT_MAX;
     vp9_zero(x->pred_mv);
     vp9_rd_cost_init(&dummy_rdc);
@@ -3645,6 +3668,7 @@ static void encode_nonrd_sb_row(VP9_COMP *cpi,
         break;
     }
   }
+  return 1;
 }
 // end RTC play code
 
@@ -3779,8 +3803,6 @@ void vp9_init_tile_data(VP9_COMP *cpi) {
   const int tile_cols = 1 << cm->log2_tile_cols;
   const int tile_rows = 1 << cm->log2_tile_rows;
   int tile_col, tile_row;
-  TOKENEXTRA *pre_tok = cpi->tile_tok[0][0];
-  int tile_tok = 0;
 
   if (cpi->tile_data == NULL || cpi->allocated_tiles < tile_cols * tile_rows) {
     if (cpi->tile_data != NULL)
@@ -3809,34 +3831,44 @@ void vp9_init_tile_data(VP9_COMP *cpi) {
           &cpi->tile_data[tile_row * tile_cols + tile_col].tile_info;
       vp9_tile_init(tile_info, cm, tile_row, tile_col);
 
-      cpi->tile_tok[tile_row][tile_col] = pre_tok + tile_tok;
-      pre_tok = cpi->tile_tok[tile_row][tile_col];
-      tile_tok = allocated_tokens(*tile_info);
+      if (cpi->tile_tok[tile_row][tile_col] == NULL) {
+        TokenChunk *chunk;
+        CHECK_MEM_ERROR(cm, chunk, vpx_malloc(sizeof(*chunk)));
+        chunk->next = NULL;
+        cpi->tile_tok[tile_row][tile_col] = chunk;
+      }
     }
   }
+
+  // Drop the tokens of tiles the frame no longer has.
+  for (tile_row = 0; tile_row < 4; ++tile_row)
+    for (tile_col = 0; tile_col < (1 << 6); ++tile_col)
+      if (tile_row >= tile_rows || tile_col >= tile_cols)
+        vp9_free_token_chunks(&cpi->tile_tok[tile_row][tile_col]);
 }
 
-void vp9_encode_tile(VP9_COMP *cpi, ThreadData *td,
-                     int tile_row, int tile_col) {
+int vp9_encode_tile(VP9_COMP *cpi, ThreadData *td,
+                    int tile_row, int tile_col) {
   VP9_COMMON *const cm = &cpi->common;
   const int tile_cols = 1 << cm->log2_tile_cols;
   TileDataEnc *this_tile =
       &cpi->tile_data[tile_row * tile_cols + tile_col];
   const TileInfo * const tile_info = &this_tile->tile_info;
-  TOKENEXTRA *tok = cpi->tile_tok[tile_row][tile_col];
+  TOKENEXTRA *tok = cpi->tile_tok[tile_row][tile_col]->tokens;
   int mi_row;
+  int ok = 1;
+
+  this_tile->tok_chunk = cpi->tile_tok[tile_row][tile_col];
 
-  for (mi_row = tile_info->mi_row_start; mi_row < tile_info->mi_row_end;
-       mi_row += MI_BLOCK_SIZE) {
+  for (mi_row = tile_info->mi_row_start;
+       ok && mi_row < tile_info->mi_row_end; mi_row += MI_BLOCK_SIZE) {
     if (cpi->sf.use_nonrd_pick_mode)
-      encode_nonrd_sb_row(cpi, td, this_tile, mi_row, &tok);
+      ok = encode_nonrd_sb_row(cpi, td, this_tile, mi_row, &tok);
     else
-      encode_rd_sb_row(cpi, td, this_tile, mi_row, &tok);
+      ok = encode_rd_sb_row(cpi, td, this_tile, mi_row, &tok);
   }
-  cpi->tok_count[tile_row][tile_col] =
-      (unsigned int)(tok - cpi->tile_tok[tile_row][tile_col]);
-  assert(tok - cpi->tile_tok[tile_row][tile_col] <=
-      allocated_tokens(*tile_info));
+  this_tile->tok_chunk->stop = tok;
+  return ok;
 }
 
 static void encode_tiles(VP9_COMP *cpi) {
@@ -3849,7 +3881,9 @@ static void encode_tiles(VP9_COMP *cpi) {
 
   for (tile_row = 0; tile_row < tile_rows; ++tile_row)
     for (tile_col = 0; tile_col < tile_cols; ++tile_col)
-      vp9_encode_tile(cpi, &cpi->td, tile_row, tile_col);
+      if (!vp9_encode_tile(cpi, &cpi->td, tile_row, tile_col))
+        vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                           "Failed to allocate token chunk");
 }
 
 #if CONFIG_FP_MB_STATS
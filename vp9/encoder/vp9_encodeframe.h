@@ -37,8 +37,9 @@ void vp9_setup_src_planes(struct macroblock *x,
 void vp9_encode_frame(struct VP9_COMP *cpi);
 
 void vp9_init_tile_data(struct VP9_COMP *cpi);
-void vp9_encode_tile(struct VP9_COMP *cpi, struct ThreadData *td,
-                     int tile_row, int tile_col);
+// Returns 0 if the tile's tokens could not be stored.
+int vp9_encode_tile(struct VP9_COMP *cpi, struct ThreadData *td,
+                    int tile_row, int tile_col);
 
 void vp9_set_variance_partition_thresholds(struct VP9_COMP *cpi, int q);
 
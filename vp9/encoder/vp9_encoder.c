@@ -55,6 +55,7 @@
 #endif
 #include "vp9/encoder/vp9_svc_layercontext.h"
 #include "vp9/encoder/vp9_temporal_filter.h"
+#include "vp9/encoder/vp9_tokenize.h"
 
 #define AM_SEGMENT_ID_INACTIVE 7
 #define AM_SEGMENT_ID_ACTIVE 0
@@ -316,6 +317,35 @@ static void vp9_swap_mi_and_prev_mi(VP9_COMMON *cm) {
   cm->prev_mi_grid_visible = cm->prev_mi_grid_base + cm->mi_stride + 1;
 }
 
+#ifndef M_LOG2_E
+#define M_LOG2_E 0.693147180559945309417
+#endif
+#define log2f(x) (log (x) / (float) M_LOG2_E)
+
+// Motion vector costs for the SAD based searches. They do not depend on the
+// coded data, so every encoder in the process shares one table, centered on
+// MV_MAX, for both components and both precisions.
+static int nmvsadcosts[MV_VALS];
+
+static void cal_nmvjointsadcost(int *mvjointsadcost) {
+  mvjointsadcost[0] = 600;
+  mvjointsadcost[1] = 300;
+  mvjointsadcost[2] = 300;
+  mvjointsadcost[3] = 300;
+}
+
+static void cal_nmvsadcosts(int *mvsadcost) {
+  int i = 1;
+
+  mvsadcost[0] = 0;
+
+  do {
+    double z = 256 * (2 * (log2f(8 * i) + .6));
+    mvsadcost[i] = (int)z;
+    mvsadcost[-i] = (int)z;
+  } while (++i <= MV_MAX);
+}
+
 void vp9_initialize_enc(void) {
   static volatile int init_done = 0;
 
@@ -326,8 +356,11 @@ void vp9_initialize_enc(void) {
     vp9_init_intra_predictors();
     vp9_init_me_luts();
     vp9_rc_init_minq_luts();
+    vp9_init_quant_tables();
+    cal_nmvsadcosts(&nmvsadcosts[MV_MAX]);
     vp9_entropy_mv_init();
     vp9_temporal_filter_init();
+    vp9_tokenize_initialize();
     init_done = 1;
   }
 }
@@ -348,26 +381,6 @@ static void dealloc_compressor_data(VP9_COMP *cpi) {
   vpx_free(cpi->coding_context.last_frame_seg_map_copy);
   cpi->coding_context.last_frame_seg_map_copy = NULL;
 
-  vpx_free(cpi->nmvcosts[0]);
-  vpx_free(cpi->nmvcosts[1]);
-  cpi->nmvcosts[0] = NULL;
-  cpi->nmvcosts[1] = NULL;
-
-  vpx_free(cpi->nmvcosts_hp[0]);
-  vpx_free(cpi->nmvcosts_hp[1]);
-  cpi->nmvcosts_hp[0] = NULL;
-  cpi->nmvcosts_hp[1] = NULL;
-
-  vpx_free(cpi->nmvsadcosts[0]);
-  vpx_free(cpi->nmvsadcosts[1]);
-  cpi->nmvsadcosts[0] = NULL;
-  cpi->nmvsadcosts[1] = NULL;
-
-  vpx_free(cpi->nmvsadcosts_hp[0]);
-  vpx_free(cpi->nmvsadcosts_hp[1]);
-  cpi->nmvsadcosts_hp[0] = NULL;
-  cpi->nmvsadcosts_hp[1] = NULL;
-
   vp9_cyclic_refresh_free(cpi->cyclic_refresh);
   cpi->cyclic_refresh = NULL;
 
@@ -386,8 +399,11 @@ static void dealloc_compressor_data(VP9_COMP *cpi) {
   vp9_free_frame_buffer(&cpi->alt_ref_buffer);
   vp9_lookahead_destroy(cpi->lookahead);
 
-  vpx_free(cpi->tile_tok[0][0]);
-  cpi->tile_tok[0][0] = 0;
+  for (i = 0; i < 4; ++i) {
+    int j;
+    for (j = 0; j < (1 << 6); ++j)
+      vp9_free_token_chunks(&cpi->tile_tok[i][j]);
+  }
 
   vp9_free_pc_tree(&cpi->td);
 
@@ -421,17 +437,11 @@ static void save_coding_context(VP9_COMP *cpi) {
   // restored with a call to vp9_restore_coding_context. These functions are
   // intended for use in a re-code loop in vp9_compress_frame where the
   // quantizer value is adjusted between loop iterations.
+  // The motion vector cost tables are left out of the snapshot. Only
+  // vp9_initialize_rd_consts() writes them, so packing the bitstream leaves
+  // them as they were.
   vp9_copy(cc->nmvjointcost,  cpi->td.mb.nmvjointcost);
 
-  memcpy(cc->nmvcosts[0], cpi->nmvcosts[0],
-         MV_VALS * sizeof(*cpi->nmvcosts[0]));
-  memcpy(cc->nmvcosts[1], cpi->nmvcosts[1],
-         MV_VALS * sizeof(*cpi->nmvcosts[1]));
-  memcpy(cc->nmvcosts_hp[0], cpi->nmvcosts_hp[0],
-         MV_VALS * sizeof(*cpi->nmvcosts_hp[0]));
-  memcpy(cc->nmvcosts_hp[1], cpi->nmvcosts_hp[1],
-         MV_VALS * sizeof(*cpi->nmvcosts_hp[1]));
-
   vp9_copy(cc->segment_pred_probs, cm->seg.pred_probs);
 
   memcpy(cpi->coding_context.last_frame_seg_map_copy,
@@ -451,13 +461,6 @@ static void restore_coding_context(VP9_COMP *cpi) {
   // previous call to vp9_save_coding_context.
   vp9_copy(cpi->td.mb.nmvjointcost, cc->nmvjointcost);
 
-  memcpy(cpi->nmvcosts[0], cc->nmvcosts[0], MV_VALS * sizeof(*cc->nmvcosts[0]));
-  memcpy(cpi->nmvcosts[1], cc->nmvcosts[1], MV_VALS * sizeof(*cc->nmvcosts[1]));
-  memcpy(cpi->nmvcosts_hp[0], cc->nmvcosts_hp[0],
-         MV_VALS * sizeof(*cc->nmvcosts_hp[0]));
-  memcpy(cpi->nmvcosts_hp[1], cc->nmvcosts_hp[1],
-         MV_VALS * sizeof(*cc->nmvcosts_hp[1]));
-
   vp9_copy(cm->seg.pred_probs, cc->segment_pred_probs);
 
   memcpy(cm->last_frame_seg_map,
@@ -610,6 +613,42 @@ static void update_reference_segmentation_map(VP9_COMP *cpi) {
   }
 }
 
+// Returns the frame size the encoder keeps its buffers allocated for: the
+// current one, or the maximum frame size declared with
+// VP9E_SET_MAX_FRAME_SIZE when that is larger.
+static void get_alloc_size(const VP9_COMP *cpi, int *width, int *height) {
+  const VP9_COMMON *const cm = &cpi->common;
+  *width = MAX(cm->width, (int)cpi->oxcf.max_frame_width);
+  *height = MAX(cm->height, (int)cpi->oxcf.max_frame_height);
+}
+
+// Sizes fb for a width x height frame. With a declared maximum frame size
+// the buffer is first grown to that size, so that later resolution changes
+// within it only move the plane pointers.
+static int realloc_frame_buffer(VP9_COMP *cpi, YV12_BUFFER_CONFIG *fb,
+                                int width, int height) {
+  VP9_COMMON *const cm = &cpi->common;
+  const int max_width = MAX(width, (int)cpi->oxcf.max_frame_width);
+  const int max_height = MAX(height, (int)cpi->oxcf.max_frame_height);
+
+  if ((max_width != width || max_height != height) &&
+      vp9_realloc_frame_buffer(fb, max_width, max_height,
+                               cm->subsampling_x, cm->subsampling_y,
+#if CONFIG_VP9_HIGHBITDEPTH
+                               cm->use_highbitdepth,
+#endif
+                               VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
+                               NULL, NULL, NULL))
+    return -1;
+  return vp9_realloc_frame_buffer(fb, width, height,
+                                  cm->subsampling_x, cm->subsampling_y,
+#if CONFIG_VP9_HIGHBITDEPTH
+                                  cm->use_highbitdepth,
+#endif
+                                  VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
+                                  NULL, NULL, NULL);
+}
+
 static void alloc_raw_frame_buffers(VP9_COMP *cpi) {
   VP9_COMMON *cm = &cpi->common;
   const VP9EncoderConfig *oxcf = &cpi->oxcf;
@@ -626,50 +665,24 @@ static void alloc_raw_frame_buffers(VP9_COMP *cpi) {
                        "Failed to allocate lag buffers");
 
   // TODO(agrange) Check if ARF is enabled and skip allocation if not.
-  if (vp9_realloc_frame_buffer(&cpi->alt_ref_buffer,
-                               oxcf->width, oxcf->height,
-                               cm->subsampling_x, cm->subsampling_y,
-#if CONFIG_VP9_HIGHBITDEPTH
-                               cm->use_highbitdepth,
-#endif
-                               VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
-                               NULL, NULL, NULL))
+  if (realloc_frame_buffer(cpi, &cpi->alt_ref_buffer,
+                           oxcf->width, oxcf->height))
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate altref buffer");
 }
 
 static void alloc_util_frame_buffers(VP9_COMP *cpi) {
   VP9_COMMON *const cm = &cpi->common;
-  if (vp9_realloc_frame_buffer(&cpi->last_frame_uf,
-                               cm->width, cm->height,
-                               cm->subsampling_x, cm->subsampling_y,
-#if CONFIG_VP9_HIGHBITDEPTH
-                               cm->use_highbitdepth,
-#endif
-                               VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
-                               NULL, NULL, NULL))
+  if (realloc_frame_buffer(cpi, &cpi->last_frame_uf, cm->width, cm->height))
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate last frame buffer");
 
-  if (vp9_realloc_frame_buffer(&cpi->scaled_source,
-                               cm->width, cm->height,
-                               cm->subsampling_x, cm->subsampling_y,
-#if CONFIG_VP9_HIGHBITDEPTH
-                               cm->use_highbitdepth,
-#endif
-                               VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
-                               NULL, NULL, NULL))
+  if (realloc_frame_buffer(cpi, &cpi->scaled_source, cm->width, cm->height))
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate scaled source buffer");
 
-  if (vp9_realloc_frame_buffer(&cpi->scaled_last_source,
-                               cm->width, cm->height,
-                               cm->subsampling_x, cm->subsampling_y,
-#if CONFIG_VP9_HIGHBITDEPTH
-                               cm->use_highbitdepth,
-#endif
-                               VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
-                               NULL, NULL, NULL))
+  if (realloc_frame_buffer(cpi, &cpi->scaled_last_source,
+                           cm->width, cm->height))
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate scaled last source buffer");
 }
@@ -679,6 +692,7 @@ static int alloc_context_buffers_ext(VP9_COMP *cpi) {
   VP9_COMMON *cm = &cpi->common;
   int mi_size = cm->mi_cols * cm->mi_rows;
 
+  vpx_free(cpi->mbmi_ext_base);
   cpi->mbmi_ext_base = vpx_calloc(mi_size, sizeof(*cpi->mbmi_ext_base));
   if (!cpi->mbmi_ext_base)
     return 1;
@@ -689,19 +703,13 @@ static int alloc_context_buffers_ext(VP9_COMP *cpi) {
 void vp9_alloc_compressor_data(VP9_COMP *cpi) {
   VP9_COMMON *cm = &cpi->common;
 
-  vp9_alloc_context_buffers(cm, cm->width, cm->height);
+  // The mode info size is set back to the frame's in update_frame_size().
+  get_alloc_size(cpi, &cpi->alloc_width, &cpi->alloc_height);
+  vp9_alloc_context_buffers(cm, cpi->alloc_width, cpi->alloc_height);
 
   alloc_context_buffers_ext(cpi);
 
-  vpx_free(cpi->tile_tok[0][0]);
-
-  {
-    unsigned int tokens = get_token_alloc(cm->mb_rows, cm->mb_cols);
-    CHECK_MEM_ERROR(cm, cpi->tile_tok[0][0],
-        vpx_calloc(tokens, sizeof(*cpi->tile_tok[0][0])));
-  }
-
-  vp9_setup_pc_tree(&cpi->common, &cpi->td);
+  vp9_setup_pc_tree(cpi, &cpi->td);
 }
 
 void vp9_new_framerate(VP9_COMP *cpi, double framerate) {
@@ -741,14 +749,8 @@ static void update_frame_size(VP9_COMP *cpi) {
   set_tile_limits(cpi);
 
   if (is_two_pass_svc(cpi)) {
-    if (vp9_realloc_frame_buffer(&cpi->alt_ref_buffer,
-                                 cm->width, cm->height,
-                                 cm->subsampling_x, cm->subsampling_y,
-#if CONFIG_VP9_HIGHBITDEPTH
-                                 cm->use_highbitdepth,
-#endif
-                                 VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
-                                 NULL, NULL, NULL))
+    if (realloc_frame_buffer(cpi, &cpi->alt_ref_buffer,
+                             cm->width, cm->height))
       vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                          "Failed to reallocate alt_ref_buffer");
   }
@@ -762,6 +764,7 @@ static void init_buffer_indices(VP9_COMP *cpi) {
 
 static void init_config(struct VP9_COMP *cpi, VP9EncoderConfig *oxcf) {
   VP9_COMMON *const cm = &cpi->common;
+  int i;
 
   cpi->oxcf = *oxcf;
   cpi->framerate = oxcf->init_framerate;
@@ -801,6 +804,11 @@ static void init_config(struct VP9_COMP *cpi, VP9EncoderConfig *oxcf) {
   cpi->ref_frame_flags = 0;
 
   init_buffer_indices(cpi);
+
+  for (i = 0; i < REFS_PER_FRAME; ++i) {
+    cpi->scaled_ref_cache[i].src_idx = INVALID_IDX;
+    cpi->scaled_ref_cache[i].scaled_idx = INVALID_IDX;
+  }
 }
 
 static void set_rc_buffer_sizes(RATE_CONTROL *rc,
@@ -1423,35 +1431,185 @@ static void  highbd_set_var_fns(VP9_COMP *const cpi) {
 }
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
+// Returns the mode info rows and columns of a frame of the allocated size.
+static void get_alloc_mi_dims(const VP9_COMP *cpi, int *mi_rows,
+                              int *mi_cols) {
+  *mi_rows =
+      ALIGN_POWER_OF_TWO(cpi->alloc_height, MI_SIZE_LOG2) >> MI_SIZE_LOG2;
+  *mi_cols =
+      ALIGN_POWER_OF_TWO(cpi->alloc_width, MI_SIZE_LOG2) >> MI_SIZE_LOG2;
+}
+
 static void realloc_segmentation_maps(VP9_COMP *cpi) {
   VP9_COMMON *const cm = &cpi->common;
+  int mi_rows, mi_cols;
+
+  get_alloc_mi_dims(cpi, &mi_rows, &mi_cols);
 
   // Create the encoder segmentation map and set all entries to 0
   vpx_free(cpi->segmentation_map);
   CHECK_MEM_ERROR(cm, cpi->segmentation_map,
-                  vpx_calloc(cm->mi_rows * cm->mi_cols, 1));
+                  vpx_calloc(mi_rows * mi_cols, 1));
 
   // Create a map used for cyclic background refresh.
   if (cpi->cyclic_refresh)
     vp9_cyclic_refresh_free(cpi->cyclic_refresh);
   CHECK_MEM_ERROR(cm, cpi->cyclic_refresh,
-                  vp9_cyclic_refresh_alloc(cm->mi_rows, cm->mi_cols));
+                  vp9_cyclic_refresh_alloc(mi_rows, mi_cols));
 
   // Create a map used to mark inactive areas.
   vpx_free(cpi->active_map.map);
   CHECK_MEM_ERROR(cm, cpi->active_map.map,
-                  vpx_calloc(cm->mi_rows * cm->mi_cols, 1));
+                  vpx_calloc(mi_rows * mi_cols, 1));
 
   // And a place holder structure is the coding context
   // for use if we want to save and restore it
   vpx_free(cpi->coding_context.last_frame_seg_map_copy);
   CHECK_MEM_ERROR(cm, cpi->coding_context.last_frame_seg_map_copy,
-                  vpx_calloc(cm->mi_rows * cm->mi_cols, 1));
+                  vpx_calloc(mi_rows * mi_cols, 1));
+}
+
+// Returns about how many bytes a frame buffer with the encoder's border takes.
+static size_t frame_buffer_bytes(int width, int height, int ss_x, int ss_y,
+                                 int use_highbitdepth) {
+  const int border = VP9_ENC_BORDER_IN_PIXELS;
+  const size_t y_stride =
+      ALIGN_POWER_OF_TWO(ALIGN_POWER_OF_TWO(width, 3) + 2 * border, 5);
+  const size_t y_size =
+      (ALIGN_POWER_OF_TWO(height, 3) + 2 * border) * y_stride;
+  return (y_size + 2 * (y_size >> (ss_x + ss_y))) << use_highbitdepth;
+}
+
+void vp9_get_mem_footprint(const VP9_COMP *cpi, vp9_mem_footprint_t *fp) {
+  const VP9_COMMON *const cm = &cpi->common;
+  const struct lookahead_ctx *const lookahead = cpi->lookahead;
+  size_t worker_data = 0;
+  int i, mi_rows, mi_cols;
+
+  memset(fp, 0, sizeof(*fp));
+
+  fp->frame_buffers = vp9_frame_buffers_footprint(cm->buffer_pool) +
+                      cpi->last_frame_uf.buffer_alloc_sz +
+                      cpi->scaled_source.buffer_alloc_sz +
+                      cpi->scaled_last_source.buffer_alloc_sz +
+                      cpi->alt_ref_buffer.buffer_alloc_sz +
+                      cpi->svc.empty_frame.img.buffer_alloc_sz;
+  for (i = 0; i < MAX_LAG_BUFFERS; ++i)
+    fp->frame_buffers += cpi->svc.scaled_frames[i].buffer_alloc_sz;
+#if CONFIG_VP9_POSTPROC
+  fp->frame_buffers += cm->post_proc_buffer.buffer_alloc_sz +
+                       cm->post_proc_buffer_int.buffer_alloc_sz;
+#endif
+
+  if (lookahead != NULL) {
+    fp->lookahead = lookahead->max_sz * sizeof(*lookahead->buf);
+    for (i = 0; i < (int)lookahead->max_sz; ++i)
+      fp->lookahead += lookahead->buf[i].img.buffer_alloc_sz;
+  }
+
+  for (i = 0; i < 4; ++i) {
+    int j;
+    for (j = 0; j < (1 << 6); ++j)
+      fp->tokens += vp9_token_chunks_footprint(cpi->tile_tok[i][j]);
+  }
+
+  // The main thread's ThreadData is part of cpi. The other workers' come
+  // from cpi->arena, so they are moved over from the context.
+  fp->thread_data = vpx_arena_footprint(cpi->td.pc_arena);
+  for (i = 0; i < cpi->num_workers - 1; ++i) {
+    const ThreadData *const td = cpi->tile_thr_data[i].td;
+    worker_data += sizeof(*td) + sizeof(*td->counts);
+    fp->thread_data += vpx_arena_footprint(td->pc_arena);
+  }
+  fp->thread_data += worker_data;
+
+  fp->context = vpx_arena_footprint(cpi->arena) - worker_data +
+                vp9_context_buffers_footprint(cm) +
+                cpi->allocated_tiles * sizeof(*cpi->tile_data);
+  get_alloc_mi_dims(cpi, &mi_rows, &mi_cols);
+  if (cpi->mbmi_ext_base != NULL)
+    fp->context += mi_rows * mi_cols * sizeof(*cpi->mbmi_ext_base);
+  // Segmentation map, its recode copy and the active map.
+  if (cpi->segmentation_map != NULL)
+    fp->context += 3 * mi_rows * mi_cols;
+
+  fp->total = fp->frame_buffers + fp->lookahead + fp->tokens +
+              fp->thread_data + fp->context;
+}
+
+// Sets where the encoder's frame buffers are placed when next allocated.
+void vp9_set_frame_placement(VP9_COMP *cpi, int placement) {
+  BufferPool *const pool = cpi->common.buffer_pool;
+  int i;
+
+  for (i = 0; i < FRAME_BUFFERS; ++i)
+    pool->frame_bufs[i].buf.placement = placement;
+  cpi->last_frame_uf.placement = placement;
+  cpi->scaled_source.placement = placement;
+  cpi->scaled_last_source.placement = placement;
+  cpi->alt_ref_buffer.placement = placement;
+}
+
+// Lowers the thread count and then the lag in frames until the encoder's
+// projected footprint fits in the memory budget. Threads go first because
+// they only cost speed. Buffers that are already allocated are measured and
+// can no longer be reduced, the others are projected from the config.
+static void fit_mem_budget(VP9_COMP *cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  VP9EncoderConfig *const oxcf = &cpi->oxcf;
+  const size_t budget = (size_t)oxcf->mem_budget << 10;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const size_t worker_size = sizeof(ThreadData) + sizeof(FRAME_COUNTS) +
+                             vpx_arena_footprint(cpi->td.pc_arena);
+  int ss_x = cm->subsampling_x;
+  int ss_y = cm->subsampling_y;
+  size_t frame_size;
+  vp9_mem_footprint_t fp;
+  size_t allocated;
+
+  if (budget == 0)
+    return;
+
+  // The subsampling is known with the first frame. Profiles 0 and 2 are
+  // 4:2:0 only, the others are taken to be 4:4:4.
+  if (!cpi->initial_width)
+    ss_x = ss_y = cm->profile == PROFILE_0 || cm->profile == PROFILE_2;
+#if CONFIG_VP9_HIGHBITDEPTH
+  frame_size = frame_buffer_bytes(oxcf->width, oxcf->height, ss_x, ss_y,
+                                  cm->use_highbitdepth);
+#else
+  frame_size = frame_buffer_bytes(oxcf->width, oxcf->height, ss_x, ss_y, 0);
+#endif
+
+  vp9_get_mem_footprint(cpi, &fp);
+  allocated = fp.total;
+  // The reference frames and the scratch frames come with the first frame.
+  if (fp.frame_buffers == 0)
+    allocated += (REFS_PER_FRAME + 5) * frame_size;
+
+  for (;;) {
+    size_t projected = allocated;
+    if (cpi->num_workers == 0 && oxcf->max_threads > 1)
+      projected += (MIN(oxcf->max_threads, tile_cols) - 1) * worker_size;
+    if (cpi->lookahead == NULL)
+      projected += (clamp(oxcf->lag_in_frames, 1, MAX_LAG_BUFFERS) +
+                    MAX_PRE_FRAMES) * frame_size;
+    if (projected <= budget)
+      break;
+
+    if (cpi->num_workers == 0 && MIN(oxcf->max_threads, tile_cols) > 1)
+      oxcf->max_threads = MIN(oxcf->max_threads, tile_cols) - 1;
+    else if (cpi->lookahead == NULL && oxcf->lag_in_frames > 0)
+      --oxcf->lag_in_frames;
+    else
+      break;
+  }
 }
 
 void vp9_change_config(struct VP9_COMP *cpi, const VP9EncoderConfig *oxcf) {
   VP9_COMMON *const cm = &cpi->common;
   RATE_CONTROL *const rc = &cpi->rc;
+  int alloc_width, alloc_height;
 
   if (cm->profile != oxcf->profile)
     cm->profile = oxcf->profile;
@@ -1507,13 +1665,15 @@ void vp9_change_config(struct VP9_COMP *cpi, const VP9EncoderConfig *oxcf) {
   cm->width = cpi->oxcf.width;
   cm->height = cpi->oxcf.height;
 
+  get_alloc_size(cpi, &alloc_width, &alloc_height);
+  if (alloc_width > cpi->alloc_width || alloc_height > cpi->alloc_height) {
+    vp9_free_context_buffers(cm);
+    vp9_alloc_compressor_data(cpi);
+    realloc_segmentation_maps(cpi);
+  }
   if (cpi->initial_width) {
-    if (cm->width > cpi->initial_width || cm->height > cpi->initial_height) {
-      vp9_free_context_buffers(cm);
-      vp9_alloc_compressor_data(cpi);
-      realloc_segmentation_maps(cpi);
+    if (cm->width > cpi->initial_width || cm->height > cpi->initial_height)
       cpi->initial_width = cpi->initial_height = 0;
-    }
   }
   update_frame_size(cpi);
 
@@ -1536,6 +1696,7 @@ void vp9_change_config(struct VP9_COMP *cpi, const VP9EncoderConfig *oxcf) {
 #endif
 
   set_tile_limits(cpi);
+  fit_mem_budget(cpi);
 
   cpi->ext_refresh_frame_flags_pending = 0;
   cpi->ext_refresh_frame_context_pending = 0;
@@ -1545,59 +1706,17 @@ void vp9_change_config(struct VP9_COMP *cpi, const VP9EncoderConfig *oxcf) {
 #endif
 }
 
-#ifndef M_LOG2_E
-#define M_LOG2_E 0.693147180559945309417
-#endif
-#define log2f(x) (log (x) / (float) M_LOG2_E)
-
-static void cal_nmvjointsadcost(int *mvjointsadcost) {
-  mvjointsadcost[0] = 600;
-  mvjointsadcost[1] = 300;
-  mvjointsadcost[2] = 300;
-  mvjointsadcost[3] = 300;
-}
-
-static void cal_nmvsadcosts(int *mvsadcost[2]) {
-  int i = 1;
-
-  mvsadcost[0][0] = 0;
-  mvsadcost[1][0] = 0;
-
-  do {
-    double z = 256 * (2 * (log2f(8 * i) + .6));
-    mvsadcost[0][i] = (int)z;
-    mvsadcost[1][i] = (int)z;
-    mvsadcost[0][-i] = (int)z;
-    mvsadcost[1][-i] = (int)z;
-  } while (++i <= MV_MAX);
-}
-
-static void cal_nmvsadcosts_hp(int *mvsadcost[2]) {
-  int i = 1;
-
-  mvsadcost[0][0] = 0;
-  mvsadcost[1][0] = 0;
-
-  do {
-    double z = 256 * (2 * (log2f(8 * i) + .6));
-    mvsadcost[0][i] = (int)z;
-    mvsadcost[1][i] = (int)z;
-    mvsadcost[0][-i] = (int)z;
-    mvsadcost[1][-i] = (int)z;
-  } while (++i <= MV_MAX);
-}
-
-
 VP9_COMP *vp9_create_compressor(VP9EncoderConfig *oxcf,
-                                BufferPool *const pool) {
-  unsigned int i;
-  VP9_COMP *volatile const cpi = vpx_memalign(32, sizeof(VP9_COMP));
+                                BufferPool *const pool, vpx_arena_t *arena) {
+  VP9_COMP *volatile const cpi = vpx_arena_memalign(arena, 32,
+                                                    sizeof(VP9_COMP));
   VP9_COMMON *volatile const cm = cpi != NULL ? &cpi->common : NULL;
 
   if (!cm)
     return NULL;
 
   vp9_zero(*cpi);
+  cpi->arena = arena;
 
   if (setjmp(cm->error.jmp)) {
     cm->error.setjmp = 0;
@@ -1632,28 +1751,17 @@ VP9_COMP *vp9_create_compressor(VP9EncoderConfig *oxcf,
   realloc_segmentation_maps(cpi);
 
   CHECK_MEM_ERROR(cm, cpi->nmvcosts[0],
-                  vpx_calloc(MV_VALS, sizeof(*cpi->nmvcosts[0])));
+                  vpx_arena_calloc(arena, MV_VALS,
+                                   sizeof(*cpi->nmvcosts[0])));
   CHECK_MEM_ERROR(cm, cpi->nmvcosts[1],
-                  vpx_calloc(MV_VALS, sizeof(*cpi->nmvcosts[1])));
+                  vpx_arena_calloc(arena, MV_VALS,
+                                   sizeof(*cpi->nmvcosts[1])));
   CHECK_MEM_ERROR(cm, cpi->nmvcosts_hp[0],
-                  vpx_calloc(MV_VALS, sizeof(*cpi->nmvcosts_hp[0])));
+                  vpx_arena_calloc(arena, MV_VALS,
+                                   sizeof(*cpi->nmvcosts_hp[0])));
   CHECK_MEM_ERROR(cm, cpi->nmvcosts_hp[1],
-                  vpx_calloc(MV_VALS, sizeof(*cpi->nmvcosts_hp[1])));
-  CHECK_MEM_ERROR(cm, cpi->nmvsadcosts[0],
-                  vpx_calloc(MV_VALS, sizeof(*cpi->nmvsadcosts[0])));
-  CHECK_MEM_ERROR(cm, cpi->nmvsadcosts[1],
-                  vpx_calloc(MV_VALS, sizeof(*cpi->nmvsadcosts[1])));
-  CHECK_MEM_ERROR(cm, cpi->nmvsadcosts_hp[0],
-                  vpx_calloc(MV_VALS, sizeof(*cpi->nmvsadcosts_hp[0])));
-  CHECK_MEM_ERROR(cm, cpi->nmvsadcosts_hp[1],
-                  vpx_calloc(MV_VALS, sizeof(*cpi->nmvsadcosts_hp[1])));
-
-  for (i = 0; i < (sizeof(cpi->mbgraph_stats) /
-                   sizeof(cpi->mbgraph_stats[0])); i++) {
-    CHECK_MEM_ERROR(cm, cpi->mbgraph_stats[i].mb_stats,
-                    vpx_calloc(cm->MBs *
-                               sizeof(*cpi->mbgraph_stats[i].mb_stats), 1));
-  }
+                  vpx_arena_calloc(arena, MV_VALS,
+                                   sizeof(*cpi->nmvcosts_hp[1])));
 
 #if CONFIG_FP_MB_STATS
   cpi->use_fp_mb_stats = 0;
@@ -1719,15 +1827,13 @@ VP9_COMP *vp9_create_compressor(VP9EncoderConfig *oxcf,
   cal_nmvjointsadcost(cpi->td.mb.nmvjointsadcost);
   cpi->td.mb.nmvcost[0] = &cpi->nmvcosts[0][MV_MAX];
   cpi->td.mb.nmvcost[1] = &cpi->nmvcosts[1][MV_MAX];
-  cpi->td.mb.nmvsadcost[0] = &cpi->nmvsadcosts[0][MV_MAX];
-  cpi->td.mb.nmvsadcost[1] = &cpi->nmvsadcosts[1][MV_MAX];
-  cal_nmvsadcosts(cpi->td.mb.nmvsadcost);
+  cpi->td.mb.nmvsadcost[0] = &nmvsadcosts[MV_MAX];
+  cpi->td.mb.nmvsadcost[1] = &nmvsadcosts[MV_MAX];
 
   cpi->td.mb.nmvcost_hp[0] = &cpi->nmvcosts_hp[0][MV_MAX];
   cpi->td.mb.nmvcost_hp[1] = &cpi->nmvcosts_hp[1][MV_MAX];
-  cpi->td.mb.nmvsadcost_hp[0] = &cpi->nmvsadcosts_hp[0][MV_MAX];
-  cpi->td.mb.nmvsadcost_hp[1] = &cpi->nmvsadcosts_hp[1][MV_MAX];
-  cal_nmvsadcosts_hp(cpi->td.mb.nmvsadcost_hp);
+  cpi->td.mb.nmvsadcost_hp[0] = &nmvsadcosts[MV_MAX];
+  cpi->td.mb.nmvsadcost_hp[1] = &nmvsadcosts[MV_MAX];
 
 #if CONFIG_VP9_TEMPORAL_DENOISING
 #ifdef OUTPUT_YUV_DENOISED
@@ -2020,15 +2126,10 @@ void vp9_remove_compressor(VP9_COMP *cpi) {
     // Deallocate allocated threads.
     vpx_get_worker_interface()->end(worker);
 
-    // Deallocate allocated thread data.
-    if (t < cpi->num_workers - 1) {
-      vpx_free(thread_data->td->counts);
+    // Deallocate allocated thread data. The rest of it is in cpi->arena.
+    if (t < cpi->num_workers - 1)
       vp9_free_pc_tree(thread_data->td);
-      vpx_free(thread_data->td);
-    }
   }
-  vpx_free(cpi->tile_thr_data);
-  vpx_free(cpi->workers);
 
   if (cpi->num_workers > 1)
     vp9_loop_filter_dealloc(&cpi->lf_row_sync);
@@ -2052,7 +2153,6 @@ void vp9_remove_compressor(VP9_COMP *cpi) {
 #if CONFIG_VP9_POSTPROC
   vp9_free_postproc_buffers(cm);
 #endif
-  vpx_free(cpi);
 
 #if CONFIG_VP9_TEMPORAL_DENOISING
 #ifdef OUTPUT_YUV_DENOISED
@@ -2244,28 +2344,79 @@ typedef struct {
   uint32_t samples[4];  // total/y/u/v
 } PSNR_STATS;
 
-static void calc_psnr(const YV12_BUFFER_CONFIG *a, const YV12_BUFFER_CONFIG *b,
-                      PSNR_STATS *psnr) {
-  static const double peak = 255.0;
+// The rows of each plane are split into this many bands, so that the sum of
+// squared errors can be gathered on the encoder's worker threads.
+#define PSNR_BANDS 8
+
+typedef struct {
+  const YV12_BUFFER_CONFIG *a;
+  const YV12_BUFFER_CONFIG *b;
+  unsigned int input_shift;
+  uint64_t sse[3][PSNR_BANDS];
+} PSNR_JOB_DATA;
+
+static void psnr_band_job(void *data, int job) {
+  PSNR_JOB_DATA *const d = (PSNR_JOB_DATA *)data;
+  const YV12_BUFFER_CONFIG *const a = d->a;
+  const YV12_BUFFER_CONFIG *const b = d->b;
+  const int plane = job / PSNR_BANDS;
+  const int band = job % PSNR_BANDS;
+  const int w = plane ? a->uv_crop_width : a->y_crop_width;
+  const int h = plane ? a->uv_crop_height : a->y_crop_height;
+  const int a_stride = plane ? a->uv_stride : a->y_stride;
+  const int b_stride = plane ? b->uv_stride : b->y_stride;
+  const uint8_t *const a_planes[3] = {a->y_buffer, a->u_buffer, a->v_buffer};
+  const uint8_t *const b_planes[3] = {b->y_buffer, b->u_buffer, b->v_buffer};
+  // Bands start on 16 row boundaries to keep to whole 16x16 blocks.
+  const int band_h = ALIGN_POWER_OF_TWO((h + PSNR_BANDS - 1) / PSNR_BANDS, 4);
+  const int y0 = MIN(h, band * band_h);
+  const int rows = MIN(h, y0 + band_h) - y0;
+  const uint8_t *const pa = a_planes[plane] + y0 * a_stride;
+  const uint8_t *const pb = b_planes[plane] + y0 * b_stride;
+  uint64_t sse = 0;
+
+  if (rows > 0) {
+#if CONFIG_VP9_HIGHBITDEPTH
+    if (a->flags & YV12_FLAG_HIGHBITDEPTH) {
+      if (d->input_shift)
+        sse = highbd_get_sse_shift(pa, a_stride, pb, b_stride, w, rows,
+                                   d->input_shift);
+      else
+        sse = highbd_get_sse(pa, a_stride, pb, b_stride, w, rows);
+    } else {
+      sse = get_sse(pa, a_stride, pb, b_stride, w, rows);
+    }
+#else
+    sse = get_sse(pa, a_stride, pb, b_stride, w, rows);
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  }
+  d->sse[plane][band] = sse;
+}
+
+static void calc_psnr_stats(VP9_COMP *cpi, const YV12_BUFFER_CONFIG *a,
+                            const YV12_BUFFER_CONFIG *b, double peak,
+                            unsigned int input_shift, PSNR_STATS *psnr) {
   const int widths[3]        = {
       a->y_crop_width, a->uv_crop_width, a->uv_crop_width};
   const int heights[3]       = {
       a->y_crop_height, a->uv_crop_height, a->uv_crop_height};
-  const uint8_t *a_planes[3] = {a->y_buffer, a->u_buffer, a->v_buffer};
-  const int a_strides[3]     = {a->y_stride, a->uv_stride, a->uv_stride};
-  const uint8_t *b_planes[3] = {b->y_buffer, b->u_buffer, b->v_buffer};
-  const int b_strides[3]     = {b->y_stride, b->uv_stride, b->uv_stride};
-  int i;
+  PSNR_JOB_DATA job_data;
+  int i, j;
   uint64_t total_sse = 0;
   uint32_t total_samples = 0;
 
+  job_data.a = a;
+  job_data.b = b;
+  job_data.input_shift = input_shift;
+  vp9_run_jobs_mt(cpi, psnr_band_job, &job_data, 3 * PSNR_BANDS);
+
   for (i = 0; i < 3; ++i) {
     const int w = widths[i];
     const int h = heights[i];
     const uint32_t samples = w * h;
-    const uint64_t sse = get_sse(a_planes[i], a_strides[i],
-                                 b_planes[i], b_strides[i],
-                                 w, h);
+    uint64_t sse = 0;
+    for (j = 0; j < PSNR_BANDS; ++j)
+      sse += job_data.sse[i][j];
     psnr->sse[1 + i] = sse;
     psnr->samples[1 + i] = samples;
     psnr->psnr[1 + i] = vpx_sse_to_psnr(samples, peak, (double)sse);
@@ -2280,75 +2431,36 @@ static void calc_psnr(const YV12_BUFFER_CONFIG *a, const YV12_BUFFER_CONFIG *b,
                                   (double)total_sse);
 }
 
+static void calc_psnr(VP9_COMP *cpi, const YV12_BUFFER_CONFIG *a,
+                      const YV12_BUFFER_CONFIG *b, PSNR_STATS *psnr) {
+  calc_psnr_stats(cpi, a, b, 255.0, 0, psnr);
+}
+
 #if CONFIG_VP9_HIGHBITDEPTH
-static void calc_highbd_psnr(const YV12_BUFFER_CONFIG *a,
+static void calc_highbd_psnr(VP9_COMP *cpi, const YV12_BUFFER_CONFIG *a,
                              const YV12_BUFFER_CONFIG *b,
                              PSNR_STATS *psnr,
                              unsigned int bit_depth,
                              unsigned int in_bit_depth) {
-  const int widths[3] =
-      {a->y_crop_width,  a->uv_crop_width,  a->uv_crop_width };
-  const int heights[3] =
-      {a->y_crop_height, a->uv_crop_height, a->uv_crop_height};
-  const uint8_t *a_planes[3] = {a->y_buffer, a->u_buffer,  a->v_buffer };
-  const int a_strides[3] = {a->y_stride, a->uv_stride, a->uv_stride};
-  const uint8_t *b_planes[3] = {b->y_buffer, b->u_buffer,  b->v_buffer };
-  const int b_strides[3] = {b->y_stride, b->uv_stride, b->uv_stride};
-  int i;
-  uint64_t total_sse = 0;
-  uint32_t total_samples = 0;
-  const double peak = (double)((1 << in_bit_depth) - 1);
-  const unsigned int input_shift = bit_depth - in_bit_depth;
-
-  for (i = 0; i < 3; ++i) {
-    const int w = widths[i];
-    const int h = heights[i];
-    const uint32_t samples = w * h;
-    uint64_t sse;
-    if (a->flags & YV12_FLAG_HIGHBITDEPTH) {
-      if (input_shift) {
-        sse = highbd_get_sse_shift(a_planes[i], a_strides[i],
-                                   b_planes[i], b_strides[i], w, h,
-                                   input_shift);
-      } else {
-        sse = highbd_get_sse(a_planes[i], a_strides[i],
-                             b_planes[i], b_strides[i], w, h);
-      }
-    } else {
-      sse = get_sse(a_planes[i], a_strides[i],
-                    b_planes[i], b_strides[i],
-                    w, h);
-    }
-    psnr->sse[1 + i] = sse;
-    psnr->samples[1 + i] = samples;
-    psnr->psnr[1 + i] = vpx_sse_to_psnr(samples, peak, (double)sse);
-
-    total_sse += sse;
-    total_samples += samples;
-  }
-
-  psnr->sse[0] = total_sse;
-  psnr->samples[0] = total_samples;
-  psnr->psnr[0] = vpx_sse_to_psnr((double)total_samples, peak,
-                                  (double)total_sse);
+  calc_psnr_stats(cpi, a, b, (double)((1 << in_bit_depth) - 1),
+                  bit_depth - in_bit_depth, psnr);
 }
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
-static void generate_psnr_packet(VP9_COMP *cpi) {
+static void generate_psnr_packet(VP9_COMP *cpi, PSNR_STATS *psnr) {
   struct vpx_codec_cx_pkt pkt;
   int i;
-  PSNR_STATS psnr;
 #if CONFIG_VP9_HIGHBITDEPTH
-  calc_highbd_psnr(cpi->Source, cpi->common.frame_to_show, &psnr,
+  calc_highbd_psnr(cpi, cpi->Source, cpi->common.frame_to_show, psnr,
                    cpi->td.mb.e_mbd.bd, cpi->oxcf.input_bit_depth);
 #else
-  calc_psnr(cpi->Source, cpi->common.frame_to_show, &psnr);
+  calc_psnr(cpi, cpi->Source, cpi->common.frame_to_show, psnr);
 #endif
 
   for (i = 0; i < 4; ++i) {
-    pkt.data.psnr.samples[i] = psnr.samples[i];
-    pkt.data.psnr.sse[i] = psnr.sse[i];
-    pkt.data.psnr.psnr[i] = psnr.psnr[i];
+    pkt.data.psnr.samples[i] = psnr->samples[i];
+    pkt.data.psnr.sse[i] = psnr->sse[i];
+    pkt.data.psnr.psnr[i] = psnr->psnr[i];
   }
   pkt.kind = VPX_CODEC_PSNR_PKT;
   if (cpi->use_svc)
@@ -2386,6 +2498,27 @@ static YV12_BUFFER_CONFIG *get_vp9_ref_frame_buffer(VP9_COMP *cpi,
   return ref_frame == NONE ? NULL : get_ref_frame_buffer(cpi, ref_frame);
 }
 
+static void release_scaled_ref_cache_entry(BufferPool *pool,
+                                           SCALED_REF_CACHE *entry) {
+  --pool->frame_bufs[entry->src_idx].ref_count;
+  --pool->frame_bufs[entry->scaled_idx].ref_count;
+  entry->src_idx = INVALID_IDX;
+  entry->scaled_idx = INVALID_IDX;
+}
+
+// Drops the cached copies of buffers that nothing but the cache still
+// references, or every cached copy if flush is set.
+static void prune_scaled_ref_cache(VP9_COMP *cpi, int flush) {
+  BufferPool *const pool = cpi->common.buffer_pool;
+  int i;
+  for (i = 0; i < REFS_PER_FRAME; ++i) {
+    SCALED_REF_CACHE *const entry = &cpi->scaled_ref_cache[i];
+    if (entry->src_idx != INVALID_IDX &&
+        (flush || pool->frame_bufs[entry->src_idx].ref_count == 1))
+      release_scaled_ref_cache_entry(pool, entry);
+  }
+}
+
 int vp9_copy_reference_enc(VP9_COMP *cpi, VP9_REFFRAME ref_frame_flag,
                            YV12_BUFFER_CONFIG *sd) {
   YV12_BUFFER_CONFIG *cfg = get_vp9_ref_frame_buffer(cpi, ref_frame_flag);
@@ -2402,6 +2535,8 @@ int vp9_set_reference_enc(VP9_COMP *cpi, VP9_REFFRAME ref_frame_flag,
   YV12_BUFFER_CONFIG *cfg = get_vp9_ref_frame_buffer(cpi, ref_frame_flag);
   if (cfg) {
     vp8_yv12_copy_frame(sd, cfg);
+    // The scaled copies are keyed by buffer, not by content.
+    prune_scaled_ref_cache(cpi, 1);
     return 0;
   } else {
     return -1;
@@ -2507,54 +2642,169 @@ void vp9_write_yuv_rec_frame(VP9_COMMON *cm) {
 }
 #endif
 
+typedef struct {
+  YV12_BUFFER_CONFIG *buf;
+  int ext_size;
+  int num_bands;
+} EXTEND_JOB_DATA;
+
+static void extend_band_job(void *data, int job) {
+  const EXTEND_JOB_DATA *const d = (const EXTEND_JOB_DATA *)data;
+  vp9_extend_frame_borders_band(d->buf, d->ext_size, job, d->num_bands);
+}
+
+// Extends the frame borders, or only the inner part of them, with one band
+// of rows per worker thread when there are workers.
+static void extend_frame_borders_mt(VP9_COMP *cpi, YV12_BUFFER_CONFIG *buf,
+                                    int inner) {
+  if (cpi->num_workers > 1) {
+    EXTEND_JOB_DATA job_data;
+    job_data.buf = buf;
+    job_data.ext_size = inner ? MIN(buf->border, VP9INNERBORDERINPIXELS)
+                              : buf->border;
+    job_data.num_bands = cpi->num_workers;
+    vp9_run_jobs_mt(cpi, extend_band_job, &job_data, job_data.num_bands);
+  } else if (inner) {
+    vp9_extend_frame_inner_borders(buf);
+  } else {
+    vp9_extend_frame_borders(buf);
+  }
+}
+
+// Splits length into num_bands bands starting on multiples of 16, and
+// returns the extent of the given band. Trailing bands may be empty.
+static void get_band_extent(int length, int band, int num_bands, int *start,
+                            int *end) {
+  const int band_size =
+      ALIGN_POWER_OF_TWO((length + num_bands - 1) / num_bands, 4);
+  *start = MIN(length, band * band_size);
+  *end = MIN(length, *start + band_size);
+}
+
+// Non-normative scaling runs each plane through the two phases of
+// vp9_resize_plane(), bands of input rows and then strips of output columns,
+// with one job per band or strip of each plane.
+typedef struct {
+  const YV12_BUFFER_CONFIG *src;
+  YV12_BUFFER_CONFIG *dst;
+  uint8_t *intbufs[MAX_MB_PLANE];
+  int num_bands;
+  int bd;
+} RESIZE_JOB_DATA;
+
+static void resize_rows_job(void *data, int job) {
+  const RESIZE_JOB_DATA *const d = (const RESIZE_JOB_DATA *)data;
+  const YV12_BUFFER_CONFIG *const src = d->src;
+  const int plane = job / d->num_bands;
+  const uint8_t *const srcs[3] = {src->y_buffer, src->u_buffer, src->v_buffer};
+  const int src_stride = plane ? src->uv_stride : src->y_stride;
+  const int src_w = plane ? src->uv_crop_width : src->y_crop_width;
+  const int src_h = plane ? src->uv_crop_height : src->y_crop_height;
+  const int dst_w = plane ? d->dst->uv_crop_width : d->dst->y_crop_width;
+  int start, end;
+
+  get_band_extent(src_h, job % d->num_bands, d->num_bands, &start, &end);
+  if (start == end)
+    return;
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
+    vp9_highbd_resize_plane_rows(srcs[plane], src_w, src_stride,
+                                 (uint16_t *)d->intbufs[plane], dst_w, start,
+                                 end, d->bd);
+  } else {
+    vp9_resize_plane_rows(srcs[plane], src_w, src_stride, d->intbufs[plane],
+                          dst_w, start, end);
+  }
+#else
+  vp9_resize_plane_rows(srcs[plane], src_w, src_stride, d->intbufs[plane],
+                        dst_w, start, end);
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+}
+
+static void resize_cols_job(void *data, int job) {
+  const RESIZE_JOB_DATA *const d = (const RESIZE_JOB_DATA *)data;
+  const YV12_BUFFER_CONFIG *const dst = d->dst;
+  const int plane = job / d->num_bands;
+  uint8_t *const dsts[3] = {dst->y_buffer, dst->u_buffer, dst->v_buffer};
+  const int dst_stride = plane ? dst->uv_stride : dst->y_stride;
+  const int dst_w = plane ? dst->uv_crop_width : dst->y_crop_width;
+  const int dst_h = plane ? dst->uv_crop_height : dst->y_crop_height;
+  const int src_h = plane ? d->src->uv_crop_height : d->src->y_crop_height;
+  int start, end;
+
+  get_band_extent(dst_w, job % d->num_bands, d->num_bands, &start, &end);
+  if (start == end)
+    return;
 #if CONFIG_VP9_HIGHBITDEPTH
-static void scale_and_extend_frame_nonnormative(const YV12_BUFFER_CONFIG *src,
+  if (dst->flags & YV12_FLAG_HIGHBITDEPTH) {
+    vp9_highbd_resize_plane_cols((const uint16_t *)d->intbufs[plane], src_h,
+                                 dst_w, dsts[plane], dst_h, dst_stride, start,
+                                 end, d->bd);
+  } else {
+    vp9_resize_plane_cols(d->intbufs[plane], src_h, dst_w, dsts[plane], dst_h,
+                          dst_stride, start, end);
+  }
+#else
+  vp9_resize_plane_cols(d->intbufs[plane], src_h, dst_w, dsts[plane], dst_h,
+                        dst_stride, start, end);
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+static void scale_and_extend_frame_nonnormative(VP9_COMP *cpi,
+                                                const YV12_BUFFER_CONFIG *src,
                                                 YV12_BUFFER_CONFIG *dst,
                                                 int bd) {
 #else
-static void scale_and_extend_frame_nonnormative(const YV12_BUFFER_CONFIG *src,
+static void scale_and_extend_frame_nonnormative(VP9_COMP *cpi,
+                                                const YV12_BUFFER_CONFIG *src,
                                                 YV12_BUFFER_CONFIG *dst) {
 #endif  // CONFIG_VP9_HIGHBITDEPTH
   // TODO(dkovalev): replace YV12_BUFFER_CONFIG with vpx_image_t
-  int i;
-  const uint8_t *const srcs[3] = {src->y_buffer, src->u_buffer, src->v_buffer};
-  const int src_strides[3] = {src->y_stride, src->uv_stride, src->uv_stride};
-  const int src_widths[3] = {src->y_crop_width, src->uv_crop_width,
-                             src->uv_crop_width };
-  const int src_heights[3] = {src->y_crop_height, src->uv_crop_height,
-                              src->uv_crop_height};
-  uint8_t *const dsts[3] = {dst->y_buffer, dst->u_buffer, dst->v_buffer};
-  const int dst_strides[3] = {dst->y_stride, dst->uv_stride, dst->uv_stride};
+  VP9_COMMON *const cm = &cpi->common;
   const int dst_widths[3] = {dst->y_crop_width, dst->uv_crop_width,
                              dst->uv_crop_width};
-  const int dst_heights[3] = {dst->y_crop_height, dst->uv_crop_height,
-                              dst->uv_crop_height};
+  const int src_heights[3] = {src->y_crop_height, src->uv_crop_height,
+                              src->uv_crop_height};
+  size_t sample_size = sizeof(uint8_t);
+  RESIZE_JOB_DATA job_data;
+  int i;
 
-  for (i = 0; i < MAX_MB_PLANE; ++i) {
+  job_data.src = src;
+  job_data.dst = dst;
+  job_data.num_bands = MAX(1, cpi->num_workers);
 #if CONFIG_VP9_HIGHBITDEPTH
-    if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
-      vp9_highbd_resize_plane(srcs[i], src_heights[i], src_widths[i],
-                              src_strides[i], dsts[i], dst_heights[i],
-                              dst_widths[i], dst_strides[i], bd);
-    } else {
-      vp9_resize_plane(srcs[i], src_heights[i], src_widths[i], src_strides[i],
-                       dsts[i], dst_heights[i], dst_widths[i], dst_strides[i]);
-    }
+  job_data.bd = bd;
+  if (src->flags & YV12_FLAG_HIGHBITDEPTH)
+    sample_size = sizeof(uint16_t);
 #else
-    vp9_resize_plane(srcs[i], src_heights[i], src_widths[i], src_strides[i],
-                     dsts[i], dst_heights[i], dst_widths[i], dst_strides[i]);
+  job_data.bd = 8;
 #endif  // CONFIG_VP9_HIGHBITDEPTH
-  }
-  vp9_extend_frame_borders(dst);
+  for (i = 0; i < MAX_MB_PLANE; ++i)
+    CHECK_MEM_ERROR(cm, job_data.intbufs[i],
+                    vpx_malloc(sample_size * dst_widths[i] * src_heights[i]));
+
+  vp9_run_jobs_mt(cpi, resize_rows_job, &job_data,
+                  MAX_MB_PLANE * job_data.num_bands);
+  vp9_run_jobs_mt(cpi, resize_cols_job, &job_data,
+                  MAX_MB_PLANE * job_data.num_bands);
+
+  for (i = 0; i < MAX_MB_PLANE; ++i)
+    vpx_free(job_data.intbufs[i]);
+  extend_frame_borders_mt(cpi, dst, 0);
 }
 
-#if CONFIG_VP9_HIGHBITDEPTH
-static void scale_and_extend_frame(const YV12_BUFFER_CONFIG *src,
-                                   YV12_BUFFER_CONFIG *dst, int bd) {
-#else
-static void scale_and_extend_frame(const YV12_BUFFER_CONFIG *src,
-                                   YV12_BUFFER_CONFIG *dst) {
-#endif  // CONFIG_VP9_HIGHBITDEPTH
+typedef struct {
+  const YV12_BUFFER_CONFIG *src;
+  YV12_BUFFER_CONFIG *dst;
+  int bd;
+} SCALE_JOB_DATA;
+
+// Scales one row of 16x16 blocks of the destination frame.
+static void scale_block_row_job(void *data, int job) {
+  const SCALE_JOB_DATA *const d = (const SCALE_JOB_DATA *)data;
+  const YV12_BUFFER_CONFIG *const src = d->src;
+  YV12_BUFFER_CONFIG *const dst = d->dst;
   const int src_w = src->y_crop_width;
   const int src_h = src->y_crop_height;
   const int dst_w = dst->y_crop_width;
@@ -2564,43 +2814,62 @@ static void scale_and_extend_frame(const YV12_BUFFER_CONFIG *src,
   uint8_t *const dsts[3] = {dst->y_buffer, dst->u_buffer, dst->v_buffer};
   const int dst_strides[3] = {dst->y_stride, dst->uv_stride, dst->uv_stride};
   const InterpKernel *const kernel = vp9_filter_kernels[EIGHTTAP];
-  int x, y, i;
-
-  for (y = 0; y < dst_h; y += 16) {
-    for (x = 0; x < dst_w; x += 16) {
-      for (i = 0; i < MAX_MB_PLANE; ++i) {
-        const int factor = (i == 0 || i == 3 ? 1 : 2);
-        const int x_q4 = x * (16 / factor) * src_w / dst_w;
-        const int y_q4 = y * (16 / factor) * src_h / dst_h;
-        const int src_stride = src_strides[i];
-        const int dst_stride = dst_strides[i];
-        const uint8_t *src_ptr = srcs[i] + (y / factor) * src_h / dst_h *
-                                     src_stride + (x / factor) * src_w / dst_w;
-        uint8_t *dst_ptr = dsts[i] + (y / factor) * dst_stride + (x / factor);
+  const int y = job * 16;
+  int x, i;
+
+  for (x = 0; x < dst_w; x += 16) {
+    for (i = 0; i < MAX_MB_PLANE; ++i) {
+      const int factor = (i == 0 || i == 3 ? 1 : 2);
+      const int x_q4 = x * (16 / factor) * src_w / dst_w;
+      const int y_q4 = y * (16 / factor) * src_h / dst_h;
+      const int src_stride = src_strides[i];
+      const int dst_stride = dst_strides[i];
+      const uint8_t *src_ptr = srcs[i] + (y / factor) * src_h / dst_h *
+                                   src_stride + (x / factor) * src_w / dst_w;
+      uint8_t *dst_ptr = dsts[i] + (y / factor) * dst_stride + (x / factor);
 
 #if CONFIG_VP9_HIGHBITDEPTH
-        if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
-          vp9_highbd_convolve8(src_ptr, src_stride, dst_ptr, dst_stride,
-                               kernel[x_q4 & 0xf], 16 * src_w / dst_w,
-                               kernel[y_q4 & 0xf], 16 * src_h / dst_h,
-                               16 / factor, 16 / factor, bd);
-        } else {
-          vp9_convolve8(src_ptr, src_stride, dst_ptr, dst_stride,
-                        kernel[x_q4 & 0xf], 16 * src_w / dst_w,
-                        kernel[y_q4 & 0xf], 16 * src_h / dst_h,
-                        16 / factor, 16 / factor);
-        }
-#else
+      if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
+        vp9_highbd_convolve8(src_ptr, src_stride, dst_ptr, dst_stride,
+                             kernel[x_q4 & 0xf], 16 * src_w / dst_w,
+                             kernel[y_q4 & 0xf], 16 * src_h / dst_h,
+                             16 / factor, 16 / factor, d->bd);
+      } else {
         vp9_convolve8(src_ptr, src_stride, dst_ptr, dst_stride,
                       kernel[x_q4 & 0xf], 16 * src_w / dst_w,
                       kernel[y_q4 & 0xf], 16 * src_h / dst_h,
                       16 / factor, 16 / factor);
-#endif  // CONFIG_VP9_HIGHBITDEPTH
       }
+#else
+      vp9_convolve8(src_ptr, src_stride, dst_ptr, dst_stride,
+                    kernel[x_q4 & 0xf], 16 * src_w / dst_w,
+                    kernel[y_q4 & 0xf], 16 * src_h / dst_h,
+                    16 / factor, 16 / factor);
+#endif  // CONFIG_VP9_HIGHBITDEPTH
     }
   }
+}
 
-  vp9_extend_frame_borders(dst);
+#if CONFIG_VP9_HIGHBITDEPTH
+static void scale_and_extend_frame(VP9_COMP *cpi,
+                                   const YV12_BUFFER_CONFIG *src,
+                                   YV12_BUFFER_CONFIG *dst, int bd) {
+#else
+static void scale_and_extend_frame(VP9_COMP *cpi,
+                                   const YV12_BUFFER_CONFIG *src,
+                                   YV12_BUFFER_CONFIG *dst) {
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  SCALE_JOB_DATA job_data;
+  job_data.src = src;
+  job_data.dst = dst;
+#if CONFIG_VP9_HIGHBITDEPTH
+  job_data.bd = bd;
+#else
+  job_data.bd = 8;
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  vp9_run_jobs_mt(cpi, scale_block_row_job, &job_data,
+                  (dst->y_crop_height + 15) >> 4);
+  extend_frame_borders_mt(cpi, dst, 0);
 }
 
 static int scale_down(VP9_COMP *cpi, int q) {
@@ -2766,22 +3035,70 @@ static void loopfilter_frame(VP9_COMP *cpi, VP9_COMMON *cm) {
       vp9_loop_filter_frame(cm->frame_to_show, cm, xd, lf->filter_level, 0, 0);
   }
 
-  vp9_extend_frame_inner_borders(cm->frame_to_show);
+  extend_frame_borders_mt(cpi, cm->frame_to_show, 1);
 }
 
-static INLINE void alloc_frame_mvs(const VP9_COMMON *cm,
-                                   int buffer_idx) {
+static INLINE void alloc_frame_mvs(const VP9_COMP *cpi, int buffer_idx) {
+  const VP9_COMMON *const cm = &cpi->common;
   RefCntBuffer *const new_fb_ptr = &cm->buffer_pool->frame_bufs[buffer_idx];
   if (new_fb_ptr->mvs == NULL ||
       new_fb_ptr->mi_rows < cm->mi_rows ||
       new_fb_ptr->mi_cols < cm->mi_cols) {
+    int mi_rows = cm->mi_rows, mi_cols = cm->mi_cols;
+    // With a declared maximum frame size take room for that size at once.
+    if (cpi->oxcf.max_frame_width || cpi->oxcf.max_frame_height) {
+      get_alloc_mi_dims(cpi, &mi_rows, &mi_cols);
+      mi_rows = MAX(mi_rows, cm->mi_rows);
+      mi_cols = MAX(mi_cols, cm->mi_cols);
+    }
     vpx_free(new_fb_ptr->mvs);
     new_fb_ptr->mvs =
-      (MV_REF *)vpx_calloc(cm->mi_rows * cm->mi_cols,
-                           sizeof(*new_fb_ptr->mvs));
-    new_fb_ptr->mi_rows = cm->mi_rows;
-    new_fb_ptr->mi_cols = cm->mi_cols;
+      (MV_REF *)vpx_calloc(mi_rows * mi_cols, sizeof(*new_fb_ptr->mvs));
+    new_fb_ptr->mi_rows = mi_rows;
+    new_fb_ptr->mi_cols = mi_cols;
+  }
+}
+
+// Returns the cached copy of buffer src_idx at the current frame size.
+static int get_cached_scaled_ref(const VP9_COMP *cpi, int src_idx) {
+  const VP9_COMMON *const cm = &cpi->common;
+  int i;
+  for (i = 0; i < REFS_PER_FRAME; ++i) {
+    const SCALED_REF_CACHE *const entry = &cpi->scaled_ref_cache[i];
+    if (entry->src_idx == src_idx) {
+      const YV12_BUFFER_CONFIG *const buf =
+          &cm->buffer_pool->frame_bufs[entry->scaled_idx].buf;
+      if (buf->y_crop_width == cm->width && buf->y_crop_height == cm->height)
+        return entry->scaled_idx;
+    }
+  }
+  return INVALID_IDX;
+}
+
+// Keeps scaled_idx as the copy of src_idx, replacing any copy of src_idx at
+// another size, else taking a free entry, else evicting the oldest entry.
+static void cache_scaled_ref(VP9_COMP *cpi, int src_idx, int scaled_idx) {
+  BufferPool *const pool = cpi->common.buffer_pool;
+  SCALED_REF_CACHE *const cache = cpi->scaled_ref_cache;
+  int i;
+
+  for (i = 0; i < REFS_PER_FRAME; ++i) {
+    if (cache[i].src_idx == src_idx)
+      release_scaled_ref_cache_entry(pool, &cache[i]);
+  }
+  for (i = 0; i < REFS_PER_FRAME; ++i) {
+    if (cache[i].src_idx == INVALID_IDX)
+      break;
   }
+  if (i == REFS_PER_FRAME) {
+    release_scaled_ref_cache_entry(pool, &cache[0]);
+    memmove(cache, cache + 1, sizeof(*cache) * (REFS_PER_FRAME - 1));
+    i = REFS_PER_FRAME - 1;
+  }
+  cache[i].src_idx = src_idx;
+  cache[i].scaled_idx = scaled_idx;
+  ++pool->frame_bufs[src_idx].ref_count;
+  ++pool->frame_bufs[scaled_idx].ref_count;
 }
 
 void vp9_scale_references(VP9_COMP *cpi) {
@@ -2789,52 +3106,48 @@ void vp9_scale_references(VP9_COMP *cpi) {
   MV_REFERENCE_FRAME ref_frame;
   const VP9_REFFRAME ref_mask[3] = {VP9_LAST_FLAG, VP9_GOLD_FLAG, VP9_ALT_FLAG};
 
+  prune_scaled_ref_cache(cpi, 0);
+
   for (ref_frame = LAST_FRAME; ref_frame <= ALTREF_FRAME; ++ref_frame) {
     // Need to convert from VP9_REFFRAME to index into ref_mask (subtract 1).
     if (cpi->ref_frame_flags & ref_mask[ref_frame - 1]) {
       BufferPool *const pool = cm->buffer_pool;
       const YV12_BUFFER_CONFIG *const ref = get_ref_frame_buffer(cpi,
                                                                  ref_frame);
+      const int buf_idx = get_ref_frame_buf_idx(cpi, ref_frame);
 
       if (ref == NULL) {
         cpi->scaled_ref_idx[ref_frame - 1] = INVALID_IDX;
         continue;
       }
 
-#if CONFIG_VP9_HIGHBITDEPTH
       if (ref->y_crop_width != cm->width || ref->y_crop_height != cm->height) {
-        const int new_fb = get_free_fb(cm);
-        RefCntBuffer *new_fb_ptr = NULL;
-        if (cm->new_fb_idx == INVALID_IDX)
-          return;
-        new_fb_ptr = &pool->frame_bufs[new_fb];
-        cm->cur_frame = &pool->frame_bufs[new_fb];
-        vp9_realloc_frame_buffer(&pool->frame_bufs[new_fb].buf,
-                                 cm->width, cm->height,
-                                 cm->subsampling_x, cm->subsampling_y,
-                                 cm->use_highbitdepth,
-                                 VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
-                                 NULL, NULL, NULL);
-        scale_and_extend_frame(ref, &new_fb_ptr->buf, (int)cm->bit_depth);
+        int new_fb = get_cached_scaled_ref(cpi, buf_idx);
+        if (new_fb != INVALID_IDX) {
+          ++pool->frame_bufs[new_fb].ref_count;
+        } else {
+          RefCntBuffer *new_fb_ptr = NULL;
+          new_fb = get_free_fb(cm);
+          if (new_fb == INVALID_IDX) {
+            prune_scaled_ref_cache(cpi, 1);
+            new_fb = get_free_fb(cm);
+          }
+          if (new_fb == INVALID_IDX)
+            return;
+          new_fb_ptr = &pool->frame_bufs[new_fb];
+          realloc_frame_buffer(cpi, &new_fb_ptr->buf, cm->width, cm->height);
+#if CONFIG_VP9_HIGHBITDEPTH
+          scale_and_extend_frame(cpi, ref, &new_fb_ptr->buf,
+                                 (int)cm->bit_depth);
 #else
-      if (ref->y_crop_width != cm->width || ref->y_crop_height != cm->height) {
-        const int new_fb = get_free_fb(cm);
-        RefCntBuffer *new_fb_ptr = NULL;
-        if (cm->new_fb_idx == INVALID_IDX)
-          return;
-        new_fb_ptr = &pool->frame_bufs[new_fb];
-        vp9_realloc_frame_buffer(&new_fb_ptr->buf,
-                                 cm->width, cm->height,
-                                 cm->subsampling_x, cm->subsampling_y,
-                                 VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
-                                 NULL, NULL, NULL);
-        scale_and_extend_frame(ref, &new_fb_ptr->buf);
+          scale_and_extend_frame(cpi, ref, &new_fb_ptr->buf);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
+          cache_scaled_ref(cpi, buf_idx, new_fb);
+        }
         cpi->scaled_ref_idx[ref_frame - 1] = new_fb;
 
-        alloc_frame_mvs(cm, new_fb);
+        alloc_frame_mvs(cpi, new_fb);
       } else {
-        const int buf_idx = get_ref_frame_buf_idx(cpi, ref_frame);
         cpi->scaled_ref_idx[ref_frame - 1] = buf_idx;
         ++pool->frame_bufs[buf_idx].ref_count;
       }
@@ -3089,17 +3402,10 @@ static void set_frame_size(VP9_COMP *cpi) {
     vp9_set_target_rate(cpi);
   }
 
-  alloc_frame_mvs(cm, cm->new_fb_idx);
+  alloc_frame_mvs(cpi, cm->new_fb_idx);
 
   // Reset the frame pointers to the current frame size.
-  vp9_realloc_frame_buffer(get_frame_new_buffer(cm),
-                           cm->width, cm->height,
-                           cm->subsampling_x, cm->subsampling_y,
-#if CONFIG_VP9_HIGHBITDEPTH
-                           cm->use_highbitdepth,
-#endif
-                           VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
-                           NULL, NULL, NULL);
+  realloc_frame_buffer(cpi, get_frame_new_buffer(cm), cm->width, cm->height);
 
   alloc_util_frame_buffers(cpi);
   init_motion_estimation(cpi);
@@ -3125,7 +3431,7 @@ static void set_frame_size(VP9_COMP *cpi) {
                                         cm->width, cm->height);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
       if (vp9_is_scaled(&ref_buf->sf))
-        vp9_extend_frame_borders(buf);
+        extend_frame_borders_mt(cpi, buf, 0);
     } else {
       ref_buf->buf = NULL;
     }
@@ -3149,18 +3455,19 @@ static void encode_without_recode_loop(VP9_COMP *cpi) {
       cpi->oxcf.resize_mode == RESIZE_DYNAMIC &&
       cpi->un_scaled_source->y_width == (cm->width << 1) &&
       cpi->un_scaled_source->y_height == (cm->height << 1)) {
-    cpi->Source = vp9_scale_if_required_fast(cm,
+    cpi->Source = vp9_scale_if_required_fast(cpi,
                                              cpi->un_scaled_source,
                                              &cpi->scaled_source);
     if (cpi->unscaled_last_source != NULL)
-       cpi->Last_Source = vp9_scale_if_required_fast(cm,
+       cpi->Last_Source = vp9_scale_if_required_fast(cpi,
                                                      cpi->unscaled_last_source,
                                                      &cpi->scaled_last_source);
   } else {
-    cpi->Source = vp9_scale_if_required(cm, cpi->un_scaled_source,
+    cpi->Source = vp9_scale_if_required(cpi, cpi->un_scaled_source,
                                         &cpi->scaled_source);
     if (cpi->unscaled_last_source != NULL)
-      cpi->Last_Source = vp9_scale_if_required(cm, cpi->unscaled_last_source,
+      cpi->Last_Source = vp9_scale_if_required(cpi,
+                                               cpi->unscaled_last_source,
                                                &cpi->scaled_last_source);
   }
 
@@ -3253,11 +3560,12 @@ static void encode_with_recode_loop(VP9_COMP *cpi,
                                        &frame_over_shoot_limit);
     }
 
-    cpi->Source = vp9_scale_if_required(cm, cpi->un_scaled_source,
+    cpi->Source = vp9_scale_if_required(cpi, cpi->un_scaled_source,
                                       &cpi->scaled_source);
 
     if (cpi->unscaled_last_source != NULL)
-      cpi->Last_Source = vp9_scale_if_required(cm, cpi->unscaled_last_source,
+      cpi->Last_Source = vp9_scale_if_required(cpi,
+                                               cpi->unscaled_last_source,
                                                &cpi->scaled_last_source);
 
     if (frame_is_intra_only(cm) == 0) {
@@ -3508,30 +3816,33 @@ static void set_ext_overrides(VP9_COMP *cpi) {
   }
 }
 
-YV12_BUFFER_CONFIG *vp9_scale_if_required_fast(VP9_COMMON *cm,
+YV12_BUFFER_CONFIG *vp9_scale_if_required_fast(VP9_COMP *cpi,
                                                YV12_BUFFER_CONFIG *unscaled,
                                                YV12_BUFFER_CONFIG *scaled) {
+  const VP9_COMMON *const cm = &cpi->common;
   if (cm->mi_cols * MI_SIZE != unscaled->y_width ||
       cm->mi_rows * MI_SIZE != unscaled->y_height) {
     // For 2x2 scaling down.
     vpx_scale_frame(unscaled, scaled, unscaled->y_buffer, 9, 2, 1,
                     2, 1, 0);
-    vp9_extend_frame_borders(scaled);
+    extend_frame_borders_mt(cpi, scaled, 0);
     return scaled;
   } else {
     return unscaled;
   }
 }
 
-YV12_BUFFER_CONFIG *vp9_scale_if_required(VP9_COMMON *cm,
+YV12_BUFFER_CONFIG *vp9_scale_if_required(VP9_COMP *cpi,
                                           YV12_BUFFER_CONFIG *unscaled,
                                           YV12_BUFFER_CONFIG *scaled) {
+  const VP9_COMMON *const cm = &cpi->common;
   if (cm->mi_cols * MI_SIZE != unscaled->y_width ||
       cm->mi_rows * MI_SIZE != unscaled->y_height) {
 #if CONFIG_VP9_HIGHBITDEPTH
-    scale_and_extend_frame_nonnormative(unscaled, scaled, (int)cm->bit_depth);
+    scale_and_extend_frame_nonnormative(cpi, unscaled, scaled,
+                                        (int)cm->bit_depth);
 #else
-    scale_and_extend_frame_nonnormative(unscaled, scaled);
+    scale_and_extend_frame_nonnormative(cpi, unscaled, scaled);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
     return scaled;
   } else {
@@ -3744,6 +4055,7 @@ static void encode_frame_to_data_rate(VP9_COMP *cpi,
     release_scaled_references(cpi);
   }
   vp9_update_reference_frames(cpi);
+  prune_scaled_ref_cache(cpi, 0);
 
   for (t = TX_4X4; t <= TX_32X32; t++)
     full_to_model_counts(cpi->td.counts->coef[t],
@@ -3887,9 +4199,30 @@ static void check_initial_width(VP9_COMP *cpi,
 #if CONFIG_VP9_TEMPORAL_DENOISING
 static void setup_denoiser_buffer(VP9_COMP *cpi) {
   VP9_COMMON *const cm = &cpi->common;
-  if (cpi->oxcf.noise_sensitivity > 0 &&
-      !cpi->denoiser.frame_buffer_initialized) {
-    vp9_denoiser_alloc(&(cpi->denoiser), cm->width, cm->height,
+  VP9_DENOISER *const denoiser = &cpi->denoiser;
+  const int reserve =
+      cpi->oxcf.max_frame_width > 0 || cpi->oxcf.max_frame_height > 0;
+  const YV12_BUFFER_CONFIG *const avg = &denoiser->running_avg_y[INTRA_FRAME];
+
+  if (cpi->oxcf.noise_sensitivity <= 0)
+    return;
+
+  if (!denoiser->frame_buffer_initialized && reserve) {
+    int alloc_width, alloc_height;
+    get_alloc_size(cpi, &alloc_width, &alloc_height);
+    vp9_denoiser_alloc(denoiser, alloc_width, alloc_height,
+                       cm->subsampling_x, cm->subsampling_y,
+#if CONFIG_VP9_HIGHBITDEPTH
+                       cm->use_highbitdepth,
+#endif
+                       VP9_ENC_BORDER_IN_PIXELS);
+  }
+  // With a declared maximum frame size the buffers follow the frame size,
+  // restarting the running averages in the memory already reserved.
+  if (!denoiser->frame_buffer_initialized ||
+      (reserve && (avg->y_crop_width != cm->width ||
+                   avg->y_crop_height != cm->height))) {
+    vp9_denoiser_alloc(denoiser, cm->width, cm->height,
                        cm->subsampling_x, cm->subsampling_y,
 #if CONFIG_VP9_HIGHBITDEPTH
                        cm->use_highbitdepth,
@@ -4051,6 +4384,146 @@ static void adjust_image_stat(double y, double u, double v, double all,
   s->stat[ALL] += all;
   s->worst = MIN(s->worst, all);
 }
+
+// Frame quality metrics that are independent of each other, so they can be
+// run as separate jobs on the encoder's worker threads.
+typedef enum {
+  METRIC_PSNRHVS,
+  METRIC_FASTSSIM,
+  METRIC_SSIM_Y,
+  METRIC_SSIM_U,
+  METRIC_SSIM_V,
+  METRIC_SSIMP_Y,
+  METRIC_SSIMP_U,
+  METRIC_SSIMP_V,
+  METRIC_CONSISTENCY,
+  METRIC_BLOCKINESS,
+  METRIC_TYPES
+} METRIC_TYPE;
+
+typedef struct {
+  VP9_COMP *cpi;
+  YV12_BUFFER_CONFIG *orig;
+  YV12_BUFFER_CONFIG *recon;
+  YV12_BUFFER_CONFIG *pp;
+  METRIC_TYPE jobs[METRIC_TYPES];
+  int num_jobs;
+  double ssim[3];         // y/u/v of the reconstruction
+  double ssimp[3];        // y/u/v of the post processed frame
+  double fastssim[4];     // all/y/u/v
+  double psnrhvs[4];      // all/y/u/v
+  double inconsistency;
+  double blockiness;
+} FRAME_METRICS;
+
+static double plane_ssim(const VP9_COMMON *cm, const YV12_BUFFER_CONFIG *a,
+                         const YV12_BUFFER_CONFIG *b, int plane) {
+  uint8_t *const a_planes[3] = {a->y_buffer, a->u_buffer, a->v_buffer};
+  uint8_t *const b_planes[3] = {b->y_buffer, b->u_buffer, b->v_buffer};
+  const int a_stride = plane ? a->uv_stride : a->y_stride;
+  const int b_stride = plane ? b->uv_stride : b->y_stride;
+  const int w = plane ? a->uv_crop_width : a->y_crop_width;
+  const int h = plane ? a->uv_crop_height : a->y_crop_height;
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (cm->use_highbitdepth)
+    return vp9_highbd_ssim2(a_planes[plane], b_planes[plane], a_stride,
+                            b_stride, w, h, (int)cm->bit_depth);
+#else
+  (void)cm;
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  return vp9_ssim2(a_planes[plane], b_planes[plane], a_stride, b_stride, w, h);
+}
+
+static void frame_metric_job(void *data, int job) {
+  FRAME_METRICS *const m = (FRAME_METRICS *)data;
+  VP9_COMP *const cpi = m->cpi;
+  const VP9_COMMON *const cm = &cpi->common;
+  const METRIC_TYPE type = m->jobs[job];
+
+  switch (type) {
+    case METRIC_PSNRHVS:
+      m->psnrhvs[0] = vp9_psnrhvs(m->orig, m->recon, &m->psnrhvs[1],
+                                  &m->psnrhvs[2], &m->psnrhvs[3]);
+      break;
+    case METRIC_FASTSSIM:
+      m->fastssim[0] = vp9_calc_fastssim(m->orig, m->recon, &m->fastssim[1],
+                                         &m->fastssim[2], &m->fastssim[3]);
+      break;
+    case METRIC_SSIM_Y:
+    case METRIC_SSIM_U:
+    case METRIC_SSIM_V:
+      m->ssim[type - METRIC_SSIM_Y] =
+          plane_ssim(cm, m->orig, m->recon, type - METRIC_SSIM_Y);
+      break;
+    case METRIC_SSIMP_Y:
+    case METRIC_SSIMP_U:
+    case METRIC_SSIMP_V:
+      m->ssimp[type - METRIC_SSIMP_Y] =
+          plane_ssim(cm, m->orig, m->pp, type - METRIC_SSIMP_Y);
+      break;
+    case METRIC_CONSISTENCY:
+      m->inconsistency = vp9_get_ssim_metrics(
+          m->orig->y_buffer, m->orig->y_stride,
+          m->recon->y_buffer, m->recon->y_stride,
+          m->orig->y_width, m->orig->y_height, cpi->ssim_vars,
+          &cpi->metrics, 1);
+      break;
+    case METRIC_BLOCKINESS:
+      m->blockiness = vp9_get_blockiness(
+          m->orig->y_buffer, m->orig->y_stride,
+          m->recon->y_buffer, m->recon->y_stride,
+          m->orig->y_width, m->orig->y_height);
+      break;
+    default:
+      break;
+  }
+}
+
+static void add_metric_job(FRAME_METRICS *m, METRIC_TYPE type) {
+  m->jobs[m->num_jobs++] = type;
+}
+
+// Computes the enabled metrics for the shown frame. The jobs are listed
+// roughly from the most to the least expensive to balance the workers.
+static void calc_frame_metrics(VP9_COMP *cpi, FRAME_METRICS *m) {
+  VP9_COMMON *const cm = &cpi->common;
+#if CONFIG_VP9_HIGHBITDEPTH
+  const int lowbd = !cm->use_highbitdepth;
+#else
+  const int lowbd = 1;
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
+  m->cpi = cpi;
+  m->orig = cpi->Source;
+  m->recon = cm->frame_to_show;
+  m->pp = &cm->post_proc_buffer;
+  m->num_jobs = 0;
+
+  if (lowbd) {
+    add_metric_job(m, METRIC_PSNRHVS);
+    add_metric_job(m, METRIC_FASTSSIM);
+  }
+  if (cpi->b_calculate_psnr || cpi->b_calculate_ssimg)
+    add_metric_job(m, METRIC_SSIM_Y);
+  if (cpi->b_calculate_psnr)
+    add_metric_job(m, METRIC_SSIMP_Y);
+  if (cpi->b_calculate_consistency && lowbd)
+    add_metric_job(m, METRIC_CONSISTENCY);
+  if (cpi->b_calculate_blockiness && lowbd)
+    add_metric_job(m, METRIC_BLOCKINESS);
+  if (cpi->b_calculate_psnr || cpi->b_calculate_ssimg) {
+    add_metric_job(m, METRIC_SSIM_U);
+    add_metric_job(m, METRIC_SSIM_V);
+  }
+  if (cpi->b_calculate_psnr) {
+    add_metric_job(m, METRIC_SSIMP_U);
+    add_metric_job(m, METRIC_SSIMP_V);
+  }
+
+  vp9_clear_system_state();
+  vp9_run_jobs_mt(cpi, frame_metric_job, m, m->num_jobs);
+  vp9_clear_system_state();
+}
 #endif  // CONFIG_INTERNAL_STATS
 
 int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
@@ -4065,6 +4538,7 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
   struct lookahead_entry *last_source = NULL;
   struct lookahead_entry *source = NULL;
   int arf_src_index;
+  PSNR_STATS psnr;
   int i;
 
   if (is_two_pass_svc(cpi)) {
@@ -4132,7 +4606,7 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
       if (oxcf->arnr_max_frames > 0) {
         // Produce the filtered ARF frame.
         vp9_temporal_filter(cpi, arf_src_index);
-        vp9_extend_frame_borders(&cpi->alt_ref_buffer);
+        extend_frame_borders_mt(cpi, &cpi->alt_ref_buffer, 0);
         force_src_buffer = &cpi->alt_ref_buffer;
       }
 
@@ -4302,7 +4776,7 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
   cpi->time_compress_data += vpx_usec_timer_elapsed(&cmptimer);
 
   if (cpi->b_calculate_psnr && oxcf->pass != 1 && cm->show_frame)
-    generate_psnr_packet(cpi);
+    generate_psnr_packet(cpi, &psnr);
 
 #if CONFIG_INTERNAL_STATS
 
@@ -4311,19 +4785,14 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
     cpi->bytes += (int)(*size);
 
     if (cm->show_frame) {
+      FRAME_METRICS metrics;
       cpi->count++;
 
       if (cpi->b_calculate_psnr) {
         YV12_BUFFER_CONFIG *orig = cpi->Source;
         YV12_BUFFER_CONFIG *recon = cpi->common.frame_to_show;
         YV12_BUFFER_CONFIG *pp = &cm->post_proc_buffer;
-        PSNR_STATS psnr;
-#if CONFIG_VP9_HIGHBITDEPTH
-        calc_highbd_psnr(orig, recon, &psnr, cpi->td.mb.e_mbd.bd,
-                         cpi->oxcf.input_bit_depth);
-#else
-        calc_psnr(orig, recon, &psnr);
-#endif  // CONFIG_VP9_HIGHBITDEPTH
+        PSNR_STATS psnr2;
 
         adjust_image_stat(psnr.psnr[1], psnr.psnr[2], psnr.psnr[3],
                           psnr.psnr[0], &cpi->psnr);
@@ -4331,89 +4800,63 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
         cpi->total_samples += psnr.samples[0];
         samples = psnr.samples[0];
 
-        {
-          PSNR_STATS psnr2;
-          double frame_ssim2 = 0, weight = 0;
 #if CONFIG_VP9_POSTPROC
-          if (vp9_alloc_frame_buffer(&cm->post_proc_buffer,
-                                     recon->y_crop_width, recon->y_crop_height,
-                                     cm->subsampling_x, cm->subsampling_y,
+        if (vp9_alloc_frame_buffer(&cm->post_proc_buffer,
+                                   recon->y_crop_width, recon->y_crop_height,
+                                   cm->subsampling_x, cm->subsampling_y,
 #if CONFIG_VP9_HIGHBITDEPTH
-                                     cm->use_highbitdepth,
+                                   cm->use_highbitdepth,
 #endif
-                                     VP9_ENC_BORDER_IN_PIXELS,
-                                     cm->byte_alignment) < 0) {
-            vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
-                               "Failed to allocate post processing buffer");
-          }
+                                   VP9_ENC_BORDER_IN_PIXELS,
+                                   cm->byte_alignment) < 0) {
+          vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                             "Failed to allocate post processing buffer");
+        }
 
-          vp9_deblock(cm->frame_to_show, &cm->post_proc_buffer,
-                      cm->lf.filter_level * 10 / 6);
+        vp9_deblock(cm->frame_to_show, &cm->post_proc_buffer,
+                    cm->lf.filter_level * 10 / 6);
 #endif
-          vp9_clear_system_state();
-
-#if CONFIG_VP9_HIGHBITDEPTH
-          calc_highbd_psnr(orig, pp, &psnr2, cpi->td.mb.e_mbd.bd,
-                           cpi->oxcf.input_bit_depth);
-#else
-          calc_psnr(orig, pp, &psnr2);
-#endif  // CONFIG_VP9_HIGHBITDEPTH
-
-          cpi->totalp_sq_error += psnr2.sse[0];
-          cpi->totalp_samples += psnr2.samples[0];
-          adjust_image_stat(psnr2.psnr[1], psnr2.psnr[2], psnr2.psnr[3],
-                            psnr2.psnr[0], &cpi->psnrp);
+        vp9_clear_system_state();
 
 #if CONFIG_VP9_HIGHBITDEPTH
-          if (cm->use_highbitdepth) {
-            frame_ssim2 = vp9_highbd_calc_ssim(orig, recon, &weight,
-                                               (int)cm->bit_depth);
-          } else {
-            frame_ssim2 = vp9_calc_ssim(orig, recon, &weight);
-          }
+        calc_highbd_psnr(cpi, orig, pp, &psnr2, cpi->td.mb.e_mbd.bd,
+                         cpi->oxcf.input_bit_depth);
 #else
-          frame_ssim2 = vp9_calc_ssim(orig, recon, &weight);
+        calc_psnr(cpi, orig, pp, &psnr2);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
-          cpi->worst_ssim= MIN(cpi->worst_ssim, frame_ssim2);
-          cpi->summed_quality += frame_ssim2 * weight;
-          cpi->summed_weights += weight;
+        cpi->totalp_sq_error += psnr2.sse[0];
+        cpi->totalp_samples += psnr2.samples[0];
+        adjust_image_stat(psnr2.psnr[1], psnr2.psnr[2], psnr2.psnr[3],
+                          psnr2.psnr[0], &cpi->psnrp);
+      }
 
-#if CONFIG_VP9_HIGHBITDEPTH
-          if (cm->use_highbitdepth) {
-            frame_ssim2 = vp9_highbd_calc_ssim(
-                orig, &cm->post_proc_buffer, &weight, (int)cm->bit_depth);
-          } else {
-            frame_ssim2 = vp9_calc_ssim(orig, &cm->post_proc_buffer, &weight);
-          }
-#else
-          frame_ssim2 = vp9_calc_ssim(orig, &cm->post_proc_buffer, &weight);
-#endif  // CONFIG_VP9_HIGHBITDEPTH
+      // The remaining metrics only read the source and the shown frame, and
+      // run together on the worker threads.
+      calc_frame_metrics(cpi, &metrics);
 
-          cpi->summedp_quality += frame_ssim2 * weight;
-          cpi->summedp_weights += weight;
-#if 0
-          {
-            FILE *f = fopen("q_used.stt", "a");
-            fprintf(f, "%5d : Y%f7.3:U%f7.3:V%f7.3:F%f7.3:S%7.3f\n",
-                    cpi->common.current_video_frame, y2, u2, v2,
-                    frame_psnr2, frame_ssim2);
-            fclose(f);
-          }
-#endif
-        }
+      if (cpi->b_calculate_psnr) {
+        const double weight = 1;
+        double frame_ssim2 = metrics.ssim[0] * .8 +
+                             .1 * (metrics.ssim[1] + metrics.ssim[2]);
+
+        cpi->worst_ssim= MIN(cpi->worst_ssim, frame_ssim2);
+        cpi->summed_quality += frame_ssim2 * weight;
+        cpi->summed_weights += weight;
+
+        frame_ssim2 = metrics.ssimp[0] * .8 +
+                      .1 * (metrics.ssimp[1] + metrics.ssimp[2]);
+        cpi->summedp_quality += frame_ssim2 * weight;
+        cpi->summedp_weights += weight;
       }
       if (cpi->b_calculate_blockiness) {
 #if CONFIG_VP9_HIGHBITDEPTH
         if (!cm->use_highbitdepth)
 #endif
         {
-          double frame_blockiness = vp9_get_blockiness(
-              cpi->Source->y_buffer, cpi->Source->y_stride,
-              cm->frame_to_show->y_buffer, cm->frame_to_show->y_stride,
-              cpi->Source->y_width, cpi->Source->y_height);
-          cpi->worst_blockiness = MAX(cpi->worst_blockiness, frame_blockiness);
-          cpi->total_blockiness += frame_blockiness;
+          cpi->worst_blockiness = MAX(cpi->worst_blockiness,
+                                      metrics.blockiness);
+          cpi->total_blockiness += metrics.blockiness;
         }
       }
 
@@ -4422,54 +4865,38 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
         if (!cm->use_highbitdepth)
 #endif
         {
-          double this_inconsistency = vp9_get_ssim_metrics(
-              cpi->Source->y_buffer, cpi->Source->y_stride,
-              cm->frame_to_show->y_buffer, cm->frame_to_show->y_stride,
-              cpi->Source->y_width, cpi->Source->y_height, cpi->ssim_vars,
-              &cpi->metrics, 1);
-
           const double peak = (double)((1 << cpi->oxcf.input_bit_depth) - 1);
           double consistency = vpx_sse_to_psnr(samples, peak,
                                              (double)cpi->total_inconsistency);
           if (consistency > 0.0)
             cpi->worst_consistency = MIN(cpi->worst_consistency,
                                          consistency);
-          cpi->total_inconsistency += this_inconsistency;
+          cpi->total_inconsistency += metrics.inconsistency;
         }
       }
 
       if (cpi->b_calculate_ssimg) {
-        double y, u, v, frame_all;
-#if CONFIG_VP9_HIGHBITDEPTH
-        if (cm->use_highbitdepth) {
-          frame_all = vp9_highbd_calc_ssimg(cpi->Source, cm->frame_to_show, &y,
-                                            &u, &v, (int)cm->bit_depth);
-        } else {
-          frame_all = vp9_calc_ssimg(cpi->Source, cm->frame_to_show, &y, &u,
-                                     &v);
-        }
-#else
-        frame_all = vp9_calc_ssimg(cpi->Source, cm->frame_to_show, &y, &u, &v);
-#endif  // CONFIG_VP9_HIGHBITDEPTH
-        adjust_image_stat(y, u, v, frame_all, &cpi->ssimg);
+        const double frame_all = (metrics.ssim[0] * 4 + metrics.ssim[1] +
+                                  metrics.ssim[2]) / 6;
+        adjust_image_stat(metrics.ssim[0], metrics.ssim[1], metrics.ssim[2],
+                          frame_all, &cpi->ssimg);
       }
 #if CONFIG_VP9_HIGHBITDEPTH
       if (!cm->use_highbitdepth)
 #endif
       {
-        double y, u, v, frame_all;
-        frame_all = vp9_calc_fastssim(cpi->Source, cm->frame_to_show, &y, &u,
-                                      &v);
-        adjust_image_stat(y, u, v, frame_all, &cpi->fastssim);
+        adjust_image_stat(metrics.fastssim[1], metrics.fastssim[2],
+                          metrics.fastssim[3], metrics.fastssim[0],
+                          &cpi->fastssim);
         /* TODO(JBB): add 10/12 bit support */
       }
 #if CONFIG_VP9_HIGHBITDEPTH
       if (!cm->use_highbitdepth)
 #endif
       {
-        double y, u, v, frame_all;
-        frame_all = vp9_psnrhvs(cpi->Source, cm->frame_to_show, &y, &u, &v);
-        adjust_image_stat(y, u, v, frame_all, &cpi->psnrhvs);
+        adjust_image_stat(metrics.psnrhvs[1], metrics.psnrhvs[2],
+                          metrics.psnrhvs[3], metrics.psnrhvs[0],
+                          &cpi->psnrhvs);
       }
     }
   }
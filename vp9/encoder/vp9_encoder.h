@@ -16,6 +16,7 @@
 #include "./vpx_config.h"
 #include "vpx/internal/vpx_codec_internal.h"
 #include "vpx/vp8cx.h"
+#include "vpx_mem/vpx_arena.h"
 #include "vpx_util/vpx_thread.h"
 
 #include "vp9/common/vp9_alloccommon.h"
@@ -52,8 +53,6 @@ extern "C" {
 
 typedef struct {
   int nmvjointcost[MV_JOINTS];
-  int nmvcosts[2][MV_VALS];
-  int nmvcosts_hp[2][MV_VALS];
 
   vp9_prob segment_pred_probs[PREDICTION_PROBS];
 
@@ -225,6 +224,14 @@ typedef struct VP9EncoderConfig {
 
   int max_threads;
 
+  // Memory budget in kilobytes, 0 for none.
+  unsigned int mem_budget;
+
+  // Largest frame size to allocate the per-frame state for, 0 for the
+  // frame size.
+  unsigned int max_frame_width;
+  unsigned int max_frame_height;
+
   vpx_fixed_buf_t two_pass_stats_in;
   struct vpx_codec_pkt_list *output_pkt_list;
 
@@ -250,6 +257,7 @@ typedef struct TileDataEnc {
   TileInfo tile_info;
   int thresh_freq_fact[BLOCK_SIZES][MAX_MODES];
   int mode_map[BLOCK_SIZES][MAX_MODES];
+  TokenChunk *tok_chunk;  // The chunk the tile's tokens are written to.
 } TileDataEnc;
 
 typedef struct RD_COUNTS {
@@ -267,6 +275,8 @@ typedef struct ThreadData {
   PICK_MODE_CONTEXT *leaf_tree;
   PC_TREE *pc_tree;
   PC_TREE *pc_root;
+  // Holds the partition tree and its coding contexts.
+  vpx_arena_t *pc_arena;
 } ThreadData;
 
 struct EncWorkerData;
@@ -289,12 +299,25 @@ typedef struct IMAGE_STAT {
   double worst;
 } ImageStat;
 
+// A scaled copy of a reference buffer, kept so that later frames and spatial
+// layers using the same buffer at the same size can skip scaling it again.
+// The entry holds a reference on both buffers, so neither can be reused for
+// other content while it is live.
+typedef struct {
+  int src_idx;
+  int scaled_idx;
+} SCALED_REF_CACHE;
+
 typedef struct VP9_COMP {
-  QUANTS quants;
+  // Quantizer tables for the bit depth, shared by all encoders.
+  QUANTS *quants;
   ThreadData td;
+  // Memory that lives as long as the encoder. The encoder itself, its thread
+  // data and its cost tables are taken from it.
+  vpx_arena_t *arena;
   MB_MODE_INFO_EXT *mbmi_ext_base;
-  DECLARE_ALIGNED(16, int16_t, y_dequant[QINDEX_RANGE][8]);
-  DECLARE_ALIGNED(16, int16_t, uv_dequant[QINDEX_RANGE][8]);
+  int16_t (*y_dequant)[8];
+  int16_t (*uv_dequant)[8];
   VP9_COMMON common;
   VP9EncoderConfig oxcf;
   struct lookahead_ctx    *lookahead;
@@ -314,6 +337,7 @@ typedef struct VP9_COMP {
   int partition_search_skippable_frame;
 
   int scaled_ref_idx[MAX_REF_FRAMES];
+  SCALED_REF_CACHE scaled_ref_cache[REFS_PER_FRAME];
   int lst_fb_idx;
   int gld_fb_idx;
   int alt_fb_idx;
@@ -332,8 +356,7 @@ typedef struct VP9_COMP {
 
   YV12_BUFFER_CONFIG last_frame_uf;
 
-  TOKENEXTRA *tile_tok[4][1 << 6];
-  unsigned int tok_count[4][1 << 6];
+  TokenChunk *tile_tok[4][1 << 6];
 
   // Ambient reconstruction err target for force key frames
   int64_t ambient_err;
@@ -344,8 +367,6 @@ typedef struct VP9_COMP {
 
   int *nmvcosts[2];
   int *nmvcosts_hp[2];
-  int *nmvsadcosts[2];
-  int *nmvsadcosts_hp[2];
 
   int64_t last_time_stamp_seen;
   int64_t last_end_time_stamp_seen;
@@ -360,6 +381,7 @@ typedef struct VP9_COMP {
 
   MBGRAPH_FRAME_STATS mbgraph_stats[MAX_LAG_BUFFERS];
   int mbgraph_n_frames;             // number of frames filled in the above
+  int mbgraph_mbs;                  // MBs the above are allocated for
   int static_mb_pct;                // % forced skip mbs by segmentation
   int ref_frame_flags;
 
@@ -444,6 +466,10 @@ typedef struct VP9_COMP {
 
   int droppable;
 
+  // Frame size the context buffers and maps are allocated for.
+  int alloc_width;
+  int alloc_height;
+
   int initial_width;
   int initial_height;
   int initial_mbs;  // Number of MBs in the full-size frame; to be used to
@@ -506,7 +532,8 @@ typedef struct VP9_COMP {
 void vp9_initialize_enc(void);
 
 struct VP9_COMP *vp9_create_compressor(VP9EncoderConfig *oxcf,
-                                       BufferPool *const pool);
+                                       BufferPool *const pool,
+                                       vpx_arena_t *arena);
 void vp9_remove_compressor(VP9_COMP *cpi);
 
 void vp9_change_config(VP9_COMP *cpi, const VP9EncoderConfig *oxcf);
@@ -550,6 +577,13 @@ void vp9_set_svc(VP9_COMP *cpi, int use_svc);
 
 int vp9_get_quantizer(struct VP9_COMP *cpi);
 
+// Fills in the bytes cpi holds, grouped by subsystem.
+void vp9_get_mem_footprint(const VP9_COMP *cpi, vp9_mem_footprint_t *fp);
+
+// Sets the VPX_MEM_* placement flags of the reference and scratch frames.
+// They apply from the next time each frame is allocated.
+void vp9_set_frame_placement(VP9_COMP *cpi, int placement);
+
 static INLINE int frame_is_kf_gf_arf(const VP9_COMP *cpi) {
   return frame_is_intra_only(&cpi->common) ||
          cpi->refresh_alt_ref_frame ||
@@ -582,24 +616,6 @@ static INLINE YV12_BUFFER_CONFIG *get_ref_frame_buffer(
       buf_idx != INVALID_IDX ? &cm->buffer_pool->frame_bufs[buf_idx].buf : NULL;
 }
 
-static INLINE int get_token_alloc(int mb_rows, int mb_cols) {
-  // TODO(JBB): double check we can't exceed this token count if we have a
-  // 32x32 transform crossing a boundary at a multiple of 16.
-  // mb_rows, cols are in units of 16 pixels. We assume 3 planes all at full
-  // resolution. We assume up to 1 token per pixel, and then allow
-  // a head room of 4.
-  return mb_rows * mb_cols * (16 * 16 * 3 + 4);
-}
-
-// Get the allocated token size for a tile. It does the same calculation as in
-// the frame token allocation.
-static INLINE int allocated_tokens(TileInfo tile) {
-  int tile_mb_rows = (tile.mi_row_end - tile.mi_row_start + 1) >> 1;
-  int tile_mb_cols = (tile.mi_col_end - tile.mi_col_start + 1) >> 1;
-
-  return get_token_alloc(tile_mb_rows, tile_mb_cols);
-}
-
 int64_t vp9_get_y_sse(const YV12_BUFFER_CONFIG *a, const YV12_BUFFER_CONFIG *b);
 #if CONFIG_VP9_HIGHBITDEPTH
 int64_t vp9_highbd_get_y_sse(const YV12_BUFFER_CONFIG *a,
@@ -614,11 +630,11 @@ void vp9_update_reference_frames(VP9_COMP *cpi);
 
 void vp9_set_high_precision_mv(VP9_COMP *cpi, int allow_high_precision_mv);
 
-YV12_BUFFER_CONFIG *vp9_scale_if_required_fast(VP9_COMMON *cm,
+YV12_BUFFER_CONFIG *vp9_scale_if_required_fast(VP9_COMP *cpi,
                                                YV12_BUFFER_CONFIG *unscaled,
                                                YV12_BUFFER_CONFIG *scaled);
 
-YV12_BUFFER_CONFIG *vp9_scale_if_required(VP9_COMMON *cm,
+YV12_BUFFER_CONFIG *vp9_scale_if_required(VP9_COMP *cpi,
                                           YV12_BUFFER_CONFIG *unscaled,
                                           YV12_BUFFER_CONFIG *scaled);
 
@@ -48,10 +48,11 @@ static int enc_worker_hook(EncWorkerData *const thread_data, void *unused) {
     int tile_row = t / tile_cols;
     int tile_col = t % tile_cols;
 
-    vp9_encode_tile(cpi, thread_data->td, tile_row, tile_col);
+    if (!vp9_encode_tile(cpi, thread_data->td, tile_row, tile_col))
+      return 0;
   }
 
-  return 0;
+  return 1;
 }
 
 static int get_max_tile_cols(VP9_COMP *cpi) {
@@ -72,6 +73,7 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
   const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
   const int num_workers = MIN(cpi->oxcf.max_threads, tile_cols);
   int i;
+  int had_error = 0;
 
   vp9_init_tile_data(cpi);
 
@@ -87,11 +89,12 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
     }
 
     CHECK_MEM_ERROR(cm, cpi->workers,
-                    vpx_malloc(allocated_workers * sizeof(*cpi->workers)));
+                    vpx_arena_calloc(cpi->arena, allocated_workers,
+                                     sizeof(*cpi->workers)));
 
     CHECK_MEM_ERROR(cm, cpi->tile_thr_data,
-                    vpx_calloc(allocated_workers,
-                    sizeof(*cpi->tile_thr_data)));
+                    vpx_arena_calloc(cpi->arena, allocated_workers,
+                                     sizeof(*cpi->tile_thr_data)));
 
     for (i = 0; i < allocated_workers; i++) {
       VPxWorker *const worker = &cpi->workers[i];
@@ -105,17 +108,17 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
 
         // Allocate thread data.
         CHECK_MEM_ERROR(cm, thread_data->td,
-                        vpx_memalign(32, sizeof(*thread_data->td)));
+                        vpx_arena_memalign(cpi->arena, 32,
+                                           sizeof(*thread_data->td)));
         vp9_zero(*thread_data->td);
 
         // Set up pc_tree.
-        thread_data->td->leaf_tree = NULL;
-        thread_data->td->pc_tree = NULL;
-        vp9_setup_pc_tree(cm, thread_data->td);
+        vp9_setup_pc_tree(cpi, thread_data->td);
 
         // Allocate frame counters in thread data.
         CHECK_MEM_ERROR(cm, thread_data->td->counts,
-                        vpx_calloc(1, sizeof(*thread_data->td->counts)));
+                        vpx_arena_calloc(cpi->arena, 1,
+                                         sizeof(*thread_data->td->counts)));
 
         // Create threads
         if (!winterface->reset(worker))
@@ -175,6 +178,7 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
 
     // Set the starting tile for each thread.
     thread_data->start = i;
+    worker->had_error = 0;
 
     if (i == cpi->num_workers - 1)
       winterface->execute(worker);
@@ -185,9 +189,15 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
   // Encoding ends.
   for (i = 0; i < num_workers; i++) {
     VPxWorker *const worker = &cpi->workers[i];
-    winterface->sync(worker);
+    had_error |= !winterface->sync(worker);
   }
 
+  // The workers can't report errors themselves, as cm->error's jmp_buf
+  // belongs to this thread.
+  if (had_error)
+    vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                       "Failed to allocate token chunk");
+
   for (i = 0; i < num_workers; i++) {
     VPxWorker *const worker = &cpi->workers[i];
     EncWorkerData *const thread_data = (EncWorkerData*)worker->data1;
@@ -199,3 +209,61 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
     }
   }
 }
+
+typedef struct {
+  VP9_JOB_FN fn;
+  void *data;
+  int num_jobs;
+  int num_workers;
+} EncJobs;
+
+static int job_worker_hook(EncWorkerData *const thread_data,
+                           EncJobs *const jobs) {
+  int job;
+
+  for (job = thread_data->start; job < jobs->num_jobs;
+       job += jobs->num_workers)
+    jobs->fn(jobs->data, job);
+
+  return 0;
+}
+
+void vp9_run_jobs_mt(VP9_COMP *cpi, VP9_JOB_FN fn, void *data, int num_jobs) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  const int num_workers = MIN(cpi->num_workers, num_jobs);
+  EncJobs jobs;
+  int i;
+
+  if (num_workers <= 1) {
+    for (i = 0; i < num_jobs; ++i)
+      fn(data, i);
+    return;
+  }
+
+  jobs.fn = fn;
+  jobs.data = data;
+  jobs.num_jobs = num_jobs;
+  jobs.num_workers = num_workers;
+
+  // The last worker runs on the calling thread, as in vp9_encode_tiles_mt().
+  for (i = 0; i < num_workers; i++) {
+    VPxWorker *const worker = &cpi->workers[cpi->num_workers - num_workers + i];
+    EncWorkerData *const thread_data =
+        &cpi->tile_thr_data[cpi->num_workers - num_workers + i];
+
+    worker->hook = (VPxWorkerHook)job_worker_hook;
+    worker->data1 = thread_data;
+    worker->data2 = &jobs;
+    thread_data->start = i;
+
+    if (i == num_workers - 1)
+      winterface->execute(worker);
+    else
+      winterface->launch(worker);
+  }
+
+  for (i = 0; i < num_workers; i++) {
+    VPxWorker *const worker = &cpi->workers[cpi->num_workers - num_workers + i];
+    winterface->sync(worker);
+  }
+}
@@ -22,4 +22,11 @@ typedef struct EncWorkerData {
 
 void vp9_encode_tiles_mt(struct VP9_COMP *cpi);
 
+// Runs fn(data, job) for each job in [0, num_jobs). Jobs are spread over the
+// encoder's worker threads when they exist, and must not depend on each
+// other.
+typedef void (*VP9_JOB_FN)(void *data, int job);
+void vp9_run_jobs_mt(struct VP9_COMP *cpi, VP9_JOB_FN fn, void *data,
+                     int num_jobs);
+
 #endif  // VP9_ENCODER_VP9_ETHREAD_H_
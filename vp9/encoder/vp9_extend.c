@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include "./vpx_scale_rtcd.h"
 #include "vpx_mem/vpx_mem.h"
 #include "vpx_ports/mem.h"
 
@@ -21,21 +22,18 @@ static void copy_and_extend_plane(const uint8_t *src, int src_pitch,
                                   int extend_bottom, int extend_right) {
   int i, linesize;
 
-  // copy the left and right most columns out
+  // copy the rows and extend them to the left and right
   const uint8_t *src_ptr1 = src;
-  const uint8_t *src_ptr2 = src + w - 1;
-  uint8_t *dst_ptr1 = dst - extend_left;
-  uint8_t *dst_ptr2 = dst + w;
+  const uint8_t *src_ptr2;
+  uint8_t *dst_ptr1 = dst;
+  uint8_t *dst_ptr2;
 
   for (i = 0; i < h; i++) {
-    memset(dst_ptr1, src_ptr1[0], extend_left);
-    memcpy(dst_ptr1 + extend_left, src_ptr1, w);
-    memset(dst_ptr2, src_ptr2[0], extend_right);
+    memcpy(dst_ptr1, src_ptr1, w);
     src_ptr1 += src_pitch;
-    src_ptr2 += src_pitch;
     dst_ptr1 += dst_pitch;
-    dst_ptr2 += dst_pitch;
   }
+  vp9_extend_plane_rows(dst, dst_pitch, w, h, extend_left, extend_right);
 
   // Now copy the top and bottom lines into each line of the respective
   // borders
@@ -66,21 +64,19 @@ static void highbd_copy_and_extend_plane(const uint8_t *src8, int src_pitch,
   uint16_t *src = CONVERT_TO_SHORTPTR(src8);
   uint16_t *dst = CONVERT_TO_SHORTPTR(dst8);
 
-  // copy the left and right most columns out
+  // copy the rows and extend them to the left and right
   const uint16_t *src_ptr1 = src;
-  const uint16_t *src_ptr2 = src + w - 1;
-  uint16_t *dst_ptr1 = dst - extend_left;
-  uint16_t *dst_ptr2 = dst + w;
+  const uint16_t *src_ptr2;
+  uint16_t *dst_ptr1 = dst;
+  uint16_t *dst_ptr2;
 
   for (i = 0; i < h; i++) {
-    vpx_memset16(dst_ptr1, src_ptr1[0], extend_left);
-    memcpy(dst_ptr1 + extend_left, src_ptr1, w * sizeof(uint16_t));
-    vpx_memset16(dst_ptr2, src_ptr2[0], extend_right);
+    memcpy(dst_ptr1, src_ptr1, w * sizeof(uint16_t));
     src_ptr1 += src_pitch;
-    src_ptr2 += src_pitch;
     dst_ptr1 += dst_pitch;
-    dst_ptr2 += dst_pitch;
   }
+  vp9_highbd_extend_plane_rows(dst, dst_pitch, w, h, extend_left,
+                               extend_right);
 
   // Now copy the top and bottom lines into each line of the respective
   // borders
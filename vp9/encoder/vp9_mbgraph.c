@@ -389,6 +389,19 @@ void vp9_update_mbgraph_stats(VP9_COMP *cpi) {
   if (n_frames > MAX_LAG_BUFFERS)
     n_frames = MAX_LAG_BUFFERS;
 
+  // Only static segmentation uses the stats, so they are allocated on first
+  // use rather than with the encoder.
+  if (cpi->mbgraph_mbs < cm->MBs) {
+    cpi->mbgraph_mbs = 0;
+    for (i = 0; i < MAX_LAG_BUFFERS; i++) {
+      vpx_free(cpi->mbgraph_stats[i].mb_stats);
+      CHECK_MEM_ERROR(cm, cpi->mbgraph_stats[i].mb_stats,
+                      vpx_malloc(cm->MBs *
+                                 sizeof(*cpi->mbgraph_stats[i].mb_stats)));
+    }
+    cpi->mbgraph_mbs = cm->MBs;
+  }
+
   cpi->mbgraph_n_frames = n_frames;
   for (i = 0; i < n_frames; i++) {
     MBGRAPH_FRAME_STATS *frame_stats = &cpi->mbgraph_stats[i];
@@ -781,6 +781,56 @@ static INLINE int is_mv_in(const MACROBLOCK *x, const MV *mv) {
          (mv->row >= x->mv_row_min) && (mv->row <= x->mv_row_max);
 }
 
+#define MAX_PATTERN_SCALES         11
+#define MAX_PATTERN_CANDIDATES      8  // max number of canddiates per scale
+#define PATTERN_CANDIDATES_REF      3  // number of refinement candidates
+
+// Computes the sad of each of the num reference blocks in addrs against the
+// source block. Full groups of four go through the x4d kernel; a trailing
+// group of three is padded to four, smaller remainders use the single sad.
+static INLINE void calc_sads(const vp9_variance_fn_ptr_t *fn_ptr,
+                             const uint8_t *src, int src_stride,
+                             const uint8_t *const addrs[], int ref_stride,
+                             int num, unsigned int *sads) {
+  int i = 0;
+
+  for (; i + 4 <= num; i += 4)
+    fn_ptr->sdx4df(src, src_stride, &addrs[i], ref_stride, &sads[i]);
+
+  if (num - i == 3) {
+    const uint8_t *const last[4] = {
+      addrs[i], addrs[i + 1], addrs[i + 2], addrs[i + 2]
+    };
+    unsigned int last_sads[4];
+    fn_ptr->sdx4df(src, src_stride, last, ref_stride, last_sads);
+    sads[i] = last_sads[0];
+    sads[i + 1] = last_sads[1];
+    sads[i + 2] = last_sads[2];
+  } else {
+    for (; i < num; ++i)
+      sads[i] = fn_ptr->sdf(src, src_stride, addrs[i], ref_stride);
+  }
+}
+
+// Computes the sads of num candidate offsets around (br, bc), all of which
+// must be within the search range.
+static INLINE void calc_pattern_sads(const MACROBLOCK *x,
+                                     const vp9_variance_fn_ptr_t *fn_ptr,
+                                     int br, int bc, const MV *candidates,
+                                     int num, unsigned int *sads) {
+  const struct buf_2d *const what = &x->plane[0].src;
+  const struct buf_2d *const in_what = &x->e_mbd.plane[0].pre[0];
+  const uint8_t *addrs[MAX_PATTERN_CANDIDATES];
+  int i;
+
+  for (i = 0; i < num; ++i) {
+    const MV this_mv = {br + candidates[i].row, bc + candidates[i].col};
+    addrs[i] = get_buf_from_mv(in_what, &this_mv);
+  }
+  calc_sads(fn_ptr, what->buf, what->stride, addrs, in_what->stride, num,
+            sads);
+}
+
 #define CHECK_BETTER \
   {\
     if (thissad < bestsad) {\
@@ -793,10 +843,6 @@ static INLINE int is_mv_in(const MACROBLOCK *x, const MV *mv) {
     }\
   }
 
-#define MAX_PATTERN_SCALES         11
-#define MAX_PATTERN_CANDIDATES      8  // max number of canddiates per scale
-#define PATTERN_CANDIDATES_REF      3  // number of refinement candidates
-
 // Calculate and return a sad+mvcost list around an integer best pel.
 static INLINE void calc_int_cost_list(const MACROBLOCK *x,
                                       const MV *ref_mv,
@@ -898,12 +944,13 @@ static int vp9_pattern_search(const MACROBLOCK *x,
     for (t = 0; t <= s; ++t) {
       int best_site = -1;
       if (check_bounds(x, br, bc, 1 << t)) {
+        unsigned int sads[MAX_PATTERN_CANDIDATES];
+        calc_pattern_sads(x, vfp, br, bc, candidates[t], num_candidates[t],
+                          sads);
         for (i = 0; i < num_candidates[t]; i++) {
           const MV this_mv = {br + candidates[t][i].row,
                               bc + candidates[t][i].col};
-          thissad = vfp->sdf(what->buf, what->stride,
-                             get_buf_from_mv(in_what, &this_mv),
-                             in_what->stride);
+          thissad = sads[i];
           CHECK_BETTER
         }
       } else {
@@ -941,12 +988,13 @@ static int vp9_pattern_search(const MACROBLOCK *x,
       // No need to search all 6 points the 1st time if initial search was used
       if (!do_init_search || s != best_init_s) {
         if (check_bounds(x, br, bc, 1 << s)) {
+          unsigned int sads[MAX_PATTERN_CANDIDATES];
+          calc_pattern_sads(x, vfp, br, bc, candidates[s], num_candidates[s],
+                            sads);
           for (i = 0; i < num_candidates[s]; i++) {
             const MV this_mv = {br + candidates[s][i].row,
                                 bc + candidates[s][i].col};
-            thissad = vfp->sdf(what->buf, what->stride,
-                               get_buf_from_mv(in_what, &this_mv),
-                               in_what->stride);
+            thissad = sads[i];
             CHECK_BETTER
           }
         } else {
@@ -979,12 +1027,18 @@ static int vp9_pattern_search(const MACROBLOCK *x,
         next_chkpts_indices[2] = (k == num_candidates[s] - 1) ? 0 : k + 1;
 
         if (check_bounds(x, br, bc, 1 << s)) {
+          const MV next_chkpts[PATTERN_CANDIDATES_REF] = {
+            candidates[s][next_chkpts_indices[0]],
+            candidates[s][next_chkpts_indices[1]],
+            candidates[s][next_chkpts_indices[2]]
+          };
+          unsigned int sads[PATTERN_CANDIDATES_REF];
+          calc_pattern_sads(x, vfp, br, bc, next_chkpts,
+                            PATTERN_CANDIDATES_REF, sads);
           for (i = 0; i < PATTERN_CANDIDATES_REF; i++) {
             const MV this_mv = {br + candidates[s][next_chkpts_indices[i]].row,
                                 bc + candidates[s][next_chkpts_indices[i]].col};
-            thissad = vfp->sdf(what->buf, what->stride,
-                               get_buf_from_mv(in_what, &this_mv),
-                               in_what->stride);
+            thissad = sads[i];
             CHECK_BETTER
           }
         } else {
@@ -1077,12 +1131,13 @@ static int vp9_pattern_search_sad(const MACROBLOCK *x,
     for (t = 0; t <= s; ++t) {
       int best_site = -1;
       if (check_bounds(x, br, bc, 1 << t)) {
+        unsigned int sads[MAX_PATTERN_CANDIDATES];
+        calc_pattern_sads(x, vfp, br, bc, candidates[t], num_candidates[t],
+                          sads);
         for (i = 0; i < num_candidates[t]; i++) {
           const MV this_mv = {br + candidates[t][i].row,
                               bc + candidates[t][i].col};
-          thissad = vfp->sdf(what->buf, what->stride,
-                             get_buf_from_mv(in_what, &this_mv),
-                             in_what->stride);
+          thissad = sads[i];
           CHECK_BETTER
         }
       } else {
@@ -1120,12 +1175,13 @@ static int vp9_pattern_search_sad(const MACROBLOCK *x,
     for (; s >= do_sad; s--) {
       if (!do_init_search || s != best_init_s) {
         if (check_bounds(x, br, bc, 1 << s)) {
+          unsigned int sads[MAX_PATTERN_CANDIDATES];
+          calc_pattern_sads(x, vfp, br, bc, candidates[s], num_candidates[s],
+                            sads);
           for (i = 0; i < num_candidates[s]; i++) {
             const MV this_mv = {br + candidates[s][i].row,
                                 bc + candidates[s][i].col};
-            thissad = vfp->sdf(what->buf, what->stride,
-                               get_buf_from_mv(in_what, &this_mv),
-                               in_what->stride);
+            thissad = sads[i];
             CHECK_BETTER
           }
         } else {
@@ -1158,12 +1214,18 @@ static int vp9_pattern_search_sad(const MACROBLOCK *x,
         next_chkpts_indices[2] = (k == num_candidates[s] - 1) ? 0 : k + 1;
 
         if (check_bounds(x, br, bc, 1 << s)) {
+          const MV next_chkpts[PATTERN_CANDIDATES_REF] = {
+            candidates[s][next_chkpts_indices[0]],
+            candidates[s][next_chkpts_indices[1]],
+            candidates[s][next_chkpts_indices[2]]
+          };
+          unsigned int sads[PATTERN_CANDIDATES_REF];
+          calc_pattern_sads(x, vfp, br, bc, next_chkpts,
+                            PATTERN_CANDIDATES_REF, sads);
           for (i = 0; i < PATTERN_CANDIDATES_REF; i++) {
             const MV this_mv = {br + candidates[s][next_chkpts_indices[i]].row,
                                 bc + candidates[s][next_chkpts_indices[i]].col};
-            thissad = vfp->sdf(what->buf, what->stride,
-                               get_buf_from_mv(in_what, &this_mv),
-                               in_what->stride);
+            thissad = sads[i];
             CHECK_BETTER
           }
         } else {
@@ -1192,13 +1254,14 @@ static int vp9_pattern_search_sad(const MACROBLOCK *x,
       cost_list[0] = bestsad;
       if (!do_init_search || s != best_init_s) {
         if (check_bounds(x, br, bc, 1 << s)) {
+          unsigned int sads[MAX_PATTERN_CANDIDATES];
+          calc_pattern_sads(x, vfp, br, bc, candidates[s], num_candidates[s],
+                            sads);
           for (i = 0; i < num_candidates[s]; i++) {
             const MV this_mv = {br + candidates[s][i].row,
                                 bc + candidates[s][i].col};
             cost_list[i + 1] =
-            thissad = vfp->sdf(what->buf, what->stride,
-                               get_buf_from_mv(in_what, &this_mv),
-                               in_what->stride);
+            thissad = sads[i];
             CHECK_BETTER
           }
         } else {
@@ -1232,13 +1295,19 @@ static int vp9_pattern_search_sad(const MACROBLOCK *x,
         cost_list[0] = bestsad;
 
         if (check_bounds(x, br, bc, 1 << s)) {
+          const MV next_chkpts[PATTERN_CANDIDATES_REF] = {
+            candidates[s][next_chkpts_indices[0]],
+            candidates[s][next_chkpts_indices[1]],
+            candidates[s][next_chkpts_indices[2]]
+          };
+          unsigned int sads[PATTERN_CANDIDATES_REF];
+          calc_pattern_sads(x, vfp, br, bc, next_chkpts,
+                            PATTERN_CANDIDATES_REF, sads);
           for (i = 0; i < PATTERN_CANDIDATES_REF; i++) {
             const MV this_mv = {br + candidates[s][next_chkpts_indices[i]].row,
                                 bc + candidates[s][next_chkpts_indices[i]].col};
             cost_list[next_chkpts_indices[i] + 1] =
-            thissad = vfp->sdf(what->buf, what->stride,
-                               get_buf_from_mv(in_what, &this_mv),
-                               in_what->stride);
+            thissad = sads[i];
             CHECK_BETTER
           }
         } else {
@@ -1277,13 +1346,10 @@ static int vp9_pattern_search_sad(const MACROBLOCK *x,
     if (cost_list[0] == INT_MAX) {
       cost_list[0] = bestsad;
       if (check_bounds(x, br, bc, 1)) {
-        for (i = 0; i < 4; i++) {
-          const MV this_mv = { br + neighbors[i].row,
-                               bc + neighbors[i].col };
-          cost_list[i + 1] = vfp->sdf(what->buf, what->stride,
-                                     get_buf_from_mv(in_what, &this_mv),
-                                     in_what->stride);
-        }
+        unsigned int sads[4];
+        calc_pattern_sads(x, vfp, br, bc, neighbors, 4, sads);
+        for (i = 0; i < 4; i++)
+          cost_list[i + 1] = sads[i];
       } else {
         for (i = 0; i < 4; i++) {
           const MV this_mv = {br + neighbors[i].row,
@@ -1530,38 +1596,26 @@ int vp9_full_range_search_c(const MACROBLOCK *x,
 
   for (r = start_row; r <= end_row; ++r) {
     for (c = start_col; c <= end_col; c += 4) {
-      if (c + 3 <= end_col) {
-        unsigned int sads[4];
-        const uint8_t *addrs[4];
-        for (i = 0; i < 4; ++i) {
-          const MV mv = {ref_mv->row + r, ref_mv->col + c + i};
-          addrs[i] = get_buf_from_mv(in_what, &mv);
-        }
+      const int num = (c + 3 <= end_col) ? 4 : end_col - c;
+      unsigned int sads[4];
+      const uint8_t *addrs[4];
 
-        fn_ptr->sdx4df(what->buf, what->stride, addrs, in_what->stride, sads);
+      for (i = 0; i < num; ++i) {
+        const MV mv = {ref_mv->row + r, ref_mv->col + c + i};
+        addrs[i] = get_buf_from_mv(in_what, &mv);
+      }
 
-        for (i = 0; i < 4; ++i) {
-          if (sads[i] < best_sad) {
-            const MV mv = {ref_mv->row + r, ref_mv->col + c + i};
-            const unsigned int sad = sads[i] +
-                mvsad_err_cost(x, &mv, &fcenter_mv, sad_per_bit);
-            if (sad < best_sad) {
-              best_sad = sad;
-              *best_mv = mv;
-            }
-          }
-        }
-      } else {
-        for (i = 0; i < end_col - c; ++i) {
+      calc_sads(fn_ptr, what->buf, what->stride, addrs, in_what->stride, num,
+                sads);
+
+      for (i = 0; i < num; ++i) {
+        if (sads[i] < best_sad) {
           const MV mv = {ref_mv->row + r, ref_mv->col + c + i};
-          unsigned int sad = fn_ptr->sdf(what->buf, what->stride,
-              get_buf_from_mv(in_what, &mv), in_what->stride);
+          const unsigned int sad = sads[i] +
+              mvsad_err_cost(x, &mv, &fcenter_mv, sad_per_bit);
           if (sad < best_sad) {
-            sad += mvsad_err_cost(x, &mv, &fcenter_mv, sad_per_bit);
-            if (sad < best_sad) {
-              best_sad = sad;
-              *best_mv = mv;
-            }
+            best_sad = sad;
+            *best_mv = mv;
           }
         }
       }
@@ -1658,25 +1712,35 @@ int vp9_diamond_search_sad_c(const MACROBLOCK *x,
         }
       }
     } else {
-      for (j = 0; j < cfg->searches_per_step; j++) {
-        // Trap illegal vectors
+      const uint8_t *block_offset[8];
+      unsigned int sad_array[8];
+      int sites[8];
+      int num_sites = 0;
+
+      // Trap illegal vectors, then evaluate the remaining points together.
+      for (j = 0; j < cfg->searches_per_step; j++, i++) {
         const MV this_mv = {best_mv->row + ss[i].mv.row,
                             best_mv->col + ss[i].mv.col};
-
         if (is_mv_in(x, &this_mv)) {
-          const uint8_t *const check_here = ss[i].offset + best_address;
-          unsigned int thissad = fn_ptr->sdf(what, what_stride, check_here,
-                                             in_what_stride);
+          block_offset[num_sites] = ss[i].offset + best_address;
+          sites[num_sites++] = i;
+        }
+      }
 
-          if (thissad < bestsad) {
-            thissad += mvsad_err_cost(x, &this_mv, &fcenter_mv, sad_per_bit);
-            if (thissad < bestsad) {
-              bestsad = thissad;
-              best_site = i;
-            }
+      calc_sads(fn_ptr, what, what_stride, block_offset, in_what_stride,
+                num_sites, sad_array);
+
+      for (t = 0; t < num_sites; t++) {
+        if (sad_array[t] < bestsad) {
+          const MV this_mv = {best_mv->row + ss[sites[t]].mv.row,
+                              best_mv->col + ss[sites[t]].mv.col};
+          sad_array[t] += mvsad_err_cost(x, &this_mv, &fcenter_mv,
+                                         sad_per_bit);
+          if (sad_array[t] < bestsad) {
+            bestsad = sad_array[t];
+            best_site = sites[t];
           }
         }
-        i++;
       }
     }
     if (best_site != last_site) {
@@ -2176,6 +2240,85 @@ int vp9_full_search_sadx8(const MACROBLOCK *x, const MV *ref_mv,
   return best_sad;
 }
 
+// Same as vp9_full_search_sadx8(), but columns the x8 kernel cannot cover
+// are evaluated four at a time with the x4d kernel, which is available for
+// every block size.
+int vp9_full_search_sadx4(const MACROBLOCK *x, const MV *ref_mv,
+                          int sad_per_bit, int distance,
+                          const vp9_variance_fn_ptr_t *fn_ptr,
+                          const MV *center_mv, MV *best_mv) {
+  int r;
+  const MACROBLOCKD *const xd = &x->e_mbd;
+  const struct buf_2d *const what = &x->plane[0].src;
+  const struct buf_2d *const in_what = &xd->plane[0].pre[0];
+  const int row_min = MAX(ref_mv->row - distance, x->mv_row_min);
+  const int row_max = MIN(ref_mv->row + distance, x->mv_row_max);
+  const int col_min = MAX(ref_mv->col - distance, x->mv_col_min);
+  const int col_max = MIN(ref_mv->col + distance, x->mv_col_max);
+  const MV fcenter_mv = {center_mv->row >> 3, center_mv->col >> 3};
+  unsigned int best_sad = fn_ptr->sdf(what->buf, what->stride,
+      get_buf_from_mv(in_what, ref_mv), in_what->stride) +
+      mvsad_err_cost(x, ref_mv, &fcenter_mv, sad_per_bit);
+  *best_mv = *ref_mv;
+
+  for (r = row_min; r < row_max; ++r) {
+    int c = col_min;
+    const uint8_t *check_here = &in_what->buf[r * in_what->stride + c];
+
+    if (fn_ptr->sdx8f != NULL) {
+      while ((c + 7) < col_max) {
+        int i;
+        DECLARE_ALIGNED(16, uint32_t, sads[8]);
+
+        fn_ptr->sdx8f(what->buf, what->stride, check_here, in_what->stride,
+                      sads);
+
+        for (i = 0; i < 8; ++i) {
+          unsigned int sad = sads[i];
+          if (sad < best_sad) {
+            const MV mv = {r, c};
+            sad += mvsad_err_cost(x, &mv, &fcenter_mv, sad_per_bit);
+            if (sad < best_sad) {
+              best_sad = sad;
+              *best_mv = mv;
+            }
+          }
+          ++check_here;
+          ++c;
+        }
+      }
+    }
+
+    while (c < col_max) {
+      const int num = MIN(4, col_max - c);
+      const uint8_t *const addrs[4] = {
+        check_here, check_here + 1, check_here + 2, check_here + 3
+      };
+      unsigned int sads[4];
+      int i;
+
+      calc_sads(fn_ptr, what->buf, what->stride, addrs, in_what->stride, num,
+                sads);
+
+      for (i = 0; i < num; ++i) {
+        unsigned int sad = sads[i];
+        if (sad < best_sad) {
+          const MV mv = {r, c};
+          sad += mvsad_err_cost(x, &mv, &fcenter_mv, sad_per_bit);
+          if (sad < best_sad) {
+            best_sad = sad;
+            *best_mv = mv;
+          }
+        }
+        ++check_here;
+        ++c;
+      }
+    }
+  }
+
+  return best_sad;
+}
+
 int vp9_refining_search_sad(const MACROBLOCK *x,
                             MV *ref_mv, int error_per_bit,
                             int search_range,
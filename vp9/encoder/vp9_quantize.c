@@ -573,13 +573,27 @@ static int get_qzbin_factor(int q, vpx_bit_depth_t bit_depth) {
 #endif
 }
 
-void vp9_init_quantizer(VP9_COMP *cpi) {
-  VP9_COMMON *const cm = &cpi->common;
-  QUANTS *const quants = &cpi->quants;
+// The quantizer tables only depend on the bit depth, since the encoder never
+// codes delta q values, so one set per bit depth serves every encoder.
+#if CONFIG_VP9_HIGHBITDEPTH
+#define QUANT_TABLE_SETS 3
+#else
+#define QUANT_TABLE_SETS 1
+#endif
+
+static QUANTS quant_tables[QUANT_TABLE_SETS];
+static DECLARE_ALIGNED(16, int16_t,
+                       y_dequant_tables[QUANT_TABLE_SETS][QINDEX_RANGE][8]);
+static DECLARE_ALIGNED(16, int16_t,
+                       uv_dequant_tables[QUANT_TABLE_SETS][QINDEX_RANGE][8]);
+
+static void init_quant_tables(QUANTS *quants, int16_t (*y_dequant)[8],
+                              int16_t (*uv_dequant)[8],
+                              vpx_bit_depth_t bit_depth) {
   int i, q, quant;
 
   for (q = 0; q < QINDEX_RANGE; q++) {
-    const int qzbin_factor = get_qzbin_factor(q, cm->bit_depth);
+    const int qzbin_factor = get_qzbin_factor(q, bit_depth);
     const int qrounding_factor = q == 0 ? 64 : 48;
 
     for (i = 0; i < 2; ++i) {
@@ -588,25 +602,25 @@ void vp9_init_quantizer(VP9_COMP *cpi) {
         qrounding_factor_fp = 64;
 
       // y
-      quant = i == 0 ? vp9_dc_quant(q, cm->y_dc_delta_q, cm->bit_depth)
-                     : vp9_ac_quant(q, 0, cm->bit_depth);
+      quant = i == 0 ? vp9_dc_quant(q, 0, bit_depth)
+                     : vp9_ac_quant(q, 0, bit_depth);
       invert_quant(&quants->y_quant[q][i], &quants->y_quant_shift[q][i], quant);
       quants->y_quant_fp[q][i] = (1 << 16) / quant;
       quants->y_round_fp[q][i] = (qrounding_factor_fp * quant) >> 7;
       quants->y_zbin[q][i] = ROUND_POWER_OF_TWO(qzbin_factor * quant, 7);
       quants->y_round[q][i] = (qrounding_factor * quant) >> 7;
-      cpi->y_dequant[q][i] = quant;
+      y_dequant[q][i] = quant;
 
       // uv
-      quant = i == 0 ? vp9_dc_quant(q, cm->uv_dc_delta_q, cm->bit_depth)
-                     : vp9_ac_quant(q, cm->uv_ac_delta_q, cm->bit_depth);
+      quant = i == 0 ? vp9_dc_quant(q, 0, bit_depth)
+                     : vp9_ac_quant(q, 0, bit_depth);
       invert_quant(&quants->uv_quant[q][i],
                    &quants->uv_quant_shift[q][i], quant);
       quants->uv_quant_fp[q][i] = (1 << 16) / quant;
       quants->uv_round_fp[q][i] = (qrounding_factor_fp * quant) >> 7;
       quants->uv_zbin[q][i] = ROUND_POWER_OF_TWO(qzbin_factor * quant, 7);
       quants->uv_round[q][i] = (qrounding_factor * quant) >> 7;
-      cpi->uv_dequant[q][i] = quant;
+      uv_dequant[q][i] = quant;
     }
 
     for (i = 2; i < 8; i++) {
@@ -616,7 +630,7 @@ void vp9_init_quantizer(VP9_COMP *cpi) {
       quants->y_quant_shift[q][i] = quants->y_quant_shift[q][1];
       quants->y_zbin[q][i] = quants->y_zbin[q][1];
       quants->y_round[q][i] = quants->y_round[q][1];
-      cpi->y_dequant[q][i] = cpi->y_dequant[q][1];
+      y_dequant[q][i] = y_dequant[q][1];
 
       quants->uv_quant[q][i] = quants->uv_quant[q][1];
       quants->uv_quant_fp[q][i] = quants->uv_quant_fp[q][1];
@@ -624,15 +638,33 @@ void vp9_init_quantizer(VP9_COMP *cpi) {
       quants->uv_quant_shift[q][i] = quants->uv_quant_shift[q][1];
       quants->uv_zbin[q][i] = quants->uv_zbin[q][1];
       quants->uv_round[q][i] = quants->uv_round[q][1];
-      cpi->uv_dequant[q][i] = cpi->uv_dequant[q][1];
+      uv_dequant[q][i] = uv_dequant[q][1];
     }
   }
 }
 
+void vp9_init_quant_tables(void) {
+  int i;
+
+  for (i = 0; i < QUANT_TABLE_SETS; ++i)
+    init_quant_tables(&quant_tables[i], y_dequant_tables[i],
+                      uv_dequant_tables[i], (vpx_bit_depth_t)(8 + 2 * i));
+}
+
+void vp9_init_quantizer(VP9_COMP *cpi) {
+  const VP9_COMMON *const cm = &cpi->common;
+  const int i = (cm->bit_depth - VPX_BITS_8) >> 1;
+
+  assert(i >= 0 && i < QUANT_TABLE_SETS);
+  cpi->quants = &quant_tables[i];
+  cpi->y_dequant = y_dequant_tables[i];
+  cpi->uv_dequant = uv_dequant_tables[i];
+}
+
 void vp9_init_plane_quantizers(VP9_COMP *cpi, MACROBLOCK *x) {
   const VP9_COMMON *const cm = &cpi->common;
   MACROBLOCKD *const xd = &x->e_mbd;
-  QUANTS *const quants = &cpi->quants;
+  QUANTS *const quants = cpi->quants;
   const int segment_id = xd->mi[0]->mbmi.segment_id;
   const int qindex = vp9_get_qindex(&cm->seg, segment_id, cm->base_qindex);
   const int rdmult = vp9_compute_rd_mult(cpi, qindex + cm->y_dc_delta_q);
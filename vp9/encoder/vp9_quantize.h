@@ -72,6 +72,11 @@ void vp9_frame_init_quantizer(struct VP9_COMP *cpi);
 
 void vp9_init_plane_quantizers(struct VP9_COMP *cpi, MACROBLOCK *x);
 
+// Builds the quantizer tables shared by all encoders. Called once by
+// vp9_initialize_enc().
+void vp9_init_quant_tables(void);
+
+// Points the encoder at the quantizer tables for its bit depth.
 void vp9_init_quantizer(struct VP9_COMP *cpi);
 
 void vp9_set_quantizer(struct VP9Common *cm, int q);
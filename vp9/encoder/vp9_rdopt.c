@@ -359,6 +359,7 @@ static int cost_coeffs(MACROBLOCK *x,
   unsigned int (*token_costs)[2][COEFF_CONTEXTS][ENTROPY_TOKENS] =
                    x->token_costs[tx_size][type][is_inter_block(mbmi)];
   uint8_t token_cache[32 * 32];
+  uint8_t tokens[32 * 32];
   int pt = combine_entropy_contexts(*A, *L);
   int c, cost;
 #if CONFIG_VP9_HIGHBITDEPTH
@@ -377,33 +378,29 @@ static int cost_coeffs(MACROBLOCK *x,
     c = 0;
   } else {
     int band_left = *band_count++;
+    int prev_t;
+
+    // The extra bit costs do not depend on the context, so they are summed
+    // for the whole run up front.
+    cost = vp9_coeff_run_cost(qcoeff, scan, eob, tokens, cat6_high_cost);
 
     // dc token
-    int v = qcoeff[0];
-    int16_t prev_t;
-    EXTRABIT e;
-    vp9_get_token_extra(v, &prev_t, &e);
-    cost = (*token_costs)[0][pt][prev_t] +
-        vp9_get_cost(prev_t, e, cat6_high_cost);
+    prev_t = tokens[0];
+    cost += (*token_costs)[0][pt][prev_t];
 
     token_cache[0] = vp9_pt_energy_class[prev_t];
     ++token_costs;
 
     // ac tokens
     for (c = 1; c < eob; c++) {
-      const int rc = scan[c];
-      int16_t t;
+      const int t = tokens[c];
 
-      v = qcoeff[rc];
-      vp9_get_token_extra(v, &t, &e);
       if (use_fast_coef_costing) {
-        cost += (*token_costs)[!prev_t][!prev_t][t] +
-            vp9_get_cost(t, e, cat6_high_cost);
+        cost += (*token_costs)[!prev_t][!prev_t][t];
       } else {
         pt = get_coef_context(nb, token_cache, c);
-        cost += (*token_costs)[!prev_t][pt][t] +
-            vp9_get_cost(t, e, cat6_high_cost);
-        token_cache[rc] = vp9_pt_energy_class[t];
+        cost += (*token_costs)[!prev_t][pt][t];
+        token_cache[scan[c]] = vp9_pt_energy_class[t];
       }
       prev_t = t;
       if (!--band_left) {
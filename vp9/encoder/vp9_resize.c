@@ -15,6 +15,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "./vp9_rtcd.h"
+#include "vpx_mem/vpx_mem.h"
 #include "vpx_ports/mem.h"
 #include "vp9/common/vp9_common.h"
 #include "vp9/encoder/vp9_resize.h"
@@ -208,9 +210,36 @@ static const interp_kernel filteredinterp_filters1000[(1 << SUBPEL_BITS)] = {
   {0,   0,  -1,   3, 128,  -3,   1, 0}
 };
 
-// Filters for factor of 2 downsampling.
-static const int16_t vp9_down2_symeven_half_filter[] = {56, 12, -3, -1};
-static const int16_t vp9_down2_symodd_half_filter[] = {64, 35, 0, -3};
+// Filters for factor of 2 downsampling, written out as INTERP_TAPS taps so
+// that they run through the same kernels as the interpolation filters. The
+// even filter is centered between taps 3 and 4, the odd filter on tap 3.
+static const int16_t vp9_down2_symeven_filter[INTERP_TAPS] = {
+  -1, -3, 12, 56, 56, 12, -3, -1
+};
+static const int16_t vp9_down2_symodd_filter[INTERP_TAPS] = {
+  -3, 0, 35, 64, 35, 0, -3, 0
+};
+
+// Samples replicated past either end of a line, enough to cover the taps of
+// the first and last outputs of any pass.
+#define RESIZE_BORDER             INTERP_TAPS
+
+// One filtering pass along a line: output x is filters[x] applied to the
+// input samples offsets[x] to offsets[x] + INTERP_TAPS - 1, where positions
+// outside the line take the value of the nearest end sample.
+typedef struct {
+  int inlength;
+  int outlength;
+  int *offsets;
+  const int16_t **filters;
+} RESIZE_PASS;
+
+// The passes taking a line to its output length: one factor of 2
+// downsampling per halving, then an interpolation if still needed.
+typedef struct {
+  int num_passes;
+  RESIZE_PASS passes[sizeof(int) * CHAR_BIT + 1];
+} RESIZE_PLAN;
 
 static const interp_kernel *choose_interp_filter(int inlength, int outlength) {
   int outlength16 = outlength * 16;
@@ -226,282 +255,215 @@ static const interp_kernel *choose_interp_filter(int inlength, int outlength) {
     return filteredinterp_filters500;
 }
 
-static void interpolate(const uint8_t *const input, int inlength,
-                        uint8_t *output, int outlength) {
+static int get_down2_length(int length, int steps) {
+  int s;
+  for (s = 0; s < steps; ++s)
+    length = (length + 1) >> 1;
+  return length;
+}
+
+static void alloc_pass(RESIZE_PASS *pass, int inlength, int outlength) {
+  pass->inlength = inlength;
+  pass->outlength = outlength;
+  pass->offsets = (int *)malloc(sizeof(*pass->offsets) * outlength);
+  pass->filters =
+      (const int16_t **)malloc(sizeof(*pass->filters) * outlength);
+}
+
+static void setup_down2_pass(RESIZE_PASS *pass, int length) {
+  const int16_t *const filter = (length & 1) ? vp9_down2_symodd_filter :
+                                               vp9_down2_symeven_filter;
+  int x;
+  alloc_pass(pass, length, get_down2_length(length, 1));
+  for (x = 0; x < pass->outlength; ++x) {
+    pass->offsets[x] = 2 * x - INTERP_TAPS / 2 + 1;
+    pass->filters[x] = filter;
+  }
+}
+
+static void setup_interp_pass(RESIZE_PASS *pass, int inlength,
+                              int outlength) {
   const int64_t delta = (((uint64_t)inlength << 32) + outlength / 2) /
       outlength;
   const int64_t offset = inlength > outlength ?
       (((int64_t)(inlength - outlength) << 31) + outlength / 2) / outlength :
       -(((int64_t)(outlength - inlength) << 31) + outlength / 2) / outlength;
-  uint8_t *optr = output;
-  int x, x1, x2, sum, k, int_pel, sub_pel;
-  int64_t y;
-
   const interp_kernel *interp_filters =
       choose_interp_filter(inlength, outlength);
+  int x;
+  int64_t y;
 
-  x = 0;
-  y = offset;
-  while ((y >> INTERP_PRECISION_BITS) < (INTERP_TAPS / 2 - 1)) {
-    x++;
-    y += delta;
+  alloc_pass(pass, inlength, outlength);
+  for (x = 0, y = offset; x < outlength; ++x, y += delta) {
+    const int int_pel = (int)(y >> INTERP_PRECISION_BITS);
+    const int sub_pel =
+        (int)((y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK);
+    pass->offsets[x] = int_pel - INTERP_TAPS / 2 + 1;
+    pass->filters[x] = interp_filters[sub_pel];
   }
-  x1 = x;
-  x = outlength - 1;
-  y = delta * x + offset;
-  while ((y >> INTERP_PRECISION_BITS) +
-         (int64_t)(INTERP_TAPS / 2) >= inlength) {
-    x--;
-    y -= delta;
+}
+
+static void init_plan(RESIZE_PLAN *plan, int length, int olength) {
+  plan->num_passes = 0;
+  if (length == olength)
+    return;
+  while (length > olength && get_down2_length(length, 1) >= olength) {
+    setup_down2_pass(&plan->passes[plan->num_passes++], length);
+    length = get_down2_length(length, 1);
   }
-  x2 = x;
-  if (x1 > x2) {
-    for (x = 0, y = offset; x < outlength; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k) {
-        const int pk = int_pel - INTERP_TAPS / 2 + 1 + k;
-        sum += filter[k] * input[(pk < 0 ? 0 :
-                                  (pk >= inlength ? inlength - 1 : pk))];
-      }
-      *optr++ = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
-    }
-  } else {
-    // Initial part.
-    for (x = 0, y = offset; x < x1; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k)
-        sum += filter[k] * input[(int_pel - INTERP_TAPS / 2 + 1 + k < 0 ?
-                                  0 :
-                                  int_pel - INTERP_TAPS / 2 + 1 + k)];
-      *optr++ = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
-    }
-    // Middle part.
-    for (; x <= x2; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k)
-        sum += filter[k] * input[int_pel - INTERP_TAPS / 2 + 1 + k];
-      *optr++ = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
-    }
-    // End part.
-    for (; x < outlength; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k)
-        sum += filter[k] * input[(int_pel - INTERP_TAPS / 2 + 1 + k >=
-                                  inlength ?  inlength - 1 :
-                                  int_pel - INTERP_TAPS / 2 + 1 + k)];
-      *optr++ = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
-    }
+  if (length != olength)
+    setup_interp_pass(&plan->passes[plan->num_passes++], length, olength);
+}
+
+static void free_plan(RESIZE_PLAN *plan) {
+  int p;
+  for (p = 0; p < plan->num_passes; ++p) {
+    free(plan->passes[p].offsets);
+    free(plan->passes[p].filters);
   }
+  plan->num_passes = 0;
 }
 
-static void down2_symeven(const uint8_t *const input, int length,
-                          uint8_t *output) {
-  // Actual filter len = 2 * filter_len_half.
-  const int16_t *filter = vp9_down2_symeven_half_filter;
-  const int filter_len_half = sizeof(vp9_down2_symeven_half_filter) / 2;
-  int i, j;
-  uint8_t *optr = output;
-  int l1 = filter_len_half;
-  int l2 = (length - filter_len_half);
-  l1 += (l1 & 1);
-  l2 += (l2 & 1);
-  if (l1 > l2) {
-    // Short input length.
-    for (i = 0; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] +
-                input[(i + 1 + j >= length ? length - 1 : i + 1 + j)]) *
-            filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-  } else {
-    // Initial part.
-    for (i = 0; i < l1; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] + input[i + 1 + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-    // Middle part.
-    for (; i < l2; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[i + 1 + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-    // End part.
-    for (; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[i - j] +
-                input[(i + 1 + j >= length ? length - 1 : i + 1 + j)]) *
-            filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
+// Size of the intermediate planes of a vertical plan over height rows. The
+// down2 passes alternate between two planes of the first two pass heights.
+static size_t get_cols_buf_size(int width, int height) {
+  return (size_t)width *
+      (get_down2_length(height, 1) + get_down2_length(height, 2));
+}
+
+// Points rows[] at the input rows under the taps of output y of a pass.
+static void setup_tap_rows(const RESIZE_PASS *pass, int y, const uint8_t *src,
+                           int src_stride, const uint8_t *rows[INTERP_TAPS]) {
+  int k;
+  for (k = 0; k < INTERP_TAPS; ++k)
+    rows[k] = src + (size_t)src_stride *
+        clamp(pass->offsets[y] + k, 0, pass->inlength - 1);
+}
+
+void vp9_resize_filter_horz_c(const uint8_t *src, uint8_t *dst, int w,
+                              const int *offsets,
+                              const int16_t *const *filters) {
+  int x, k;
+  for (x = 0; x < w; ++x) {
+    const uint8_t *const s = src + offsets[x];
+    const int16_t *const filter = filters[x];
+    int sum = 0;
+    for (k = 0; k < INTERP_TAPS; ++k)
+      sum += filter[k] * s[k];
+    dst[x] = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
   }
 }
 
-static void down2_symodd(const uint8_t *const input, int length,
-                         uint8_t *output) {
-  // Actual filter len = 2 * filter_len_half - 1.
-  const int16_t *filter = vp9_down2_symodd_half_filter;
-  const int filter_len_half = sizeof(vp9_down2_symodd_half_filter) / 2;
-  int i, j;
-  uint8_t *optr = output;
-  int l1 = filter_len_half - 1;
-  int l2 = (length - filter_len_half + 1);
-  l1 += (l1 & 1);
-  l2 += (l2 & 1);
-  if (l1 > l2) {
-    // Short input length.
-    for (i = 0; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] +
-                input[(i + j >= length ? length - 1 : i + j)]) *
-            filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-  } else {
-    // Initial part.
-    for (i = 0; i < l1; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] + input[i + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-    // Middle part.
-    for (; i < l2; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[i + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-    // End part.
-    for (; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[(i + j >= length ? length - 1 : i + j)]) *
-            filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
+void vp9_resize_filter_vert_c(const uint8_t *const *src, uint8_t *dst, int w,
+                              const int16_t *filter) {
+  int x, k;
+  for (x = 0; x < w; ++x) {
+    int sum = 0;
+    for (k = 0; k < INTERP_TAPS; ++k)
+      sum += filter[k] * src[k][x];
+    dst[x] = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
   }
 }
 
-static int get_down2_length(int length, int steps) {
-  int s;
-  for (s = 0; s < steps; ++s)
-    length = (length + 1) >> 1;
-  return length;
+static void extend_line(uint8_t *line, int length) {
+  memset(line - RESIZE_BORDER, line[0], RESIZE_BORDER);
+  memset(line + length, line[length - 1], RESIZE_BORDER);
 }
 
-static int get_down2_steps(int in_length, int out_length) {
-  int steps = 0;
-  int proj_in_length;
-  while ((proj_in_length = get_down2_length(in_length, 1)) >= out_length) {
-    ++steps;
-    in_length = proj_in_length;
+// Resizes one row, ping-ponging between two bordered line buffers.
+static void resize_row(const RESIZE_PLAN *plan, const uint8_t *input,
+                       int length, uint8_t *output, uint8_t *lines[2]) {
+  int p;
+  if (plan->num_passes == 0) {
+    memcpy(output, input, sizeof(*output) * length);
+    return;
+  }
+  memcpy(lines[0], input, sizeof(*input) * length);
+  extend_line(lines[0], length);
+  for (p = 0; p < plan->num_passes; ++p) {
+    const RESIZE_PASS *const pass = &plan->passes[p];
+    uint8_t *const out =
+        p == plan->num_passes - 1 ? output : lines[(p + 1) & 1];
+    vp9_resize_filter_horz(lines[p & 1], out, pass->outlength, pass->offsets,
+                           pass->filters);
+    if (out != output)
+      extend_line(out, pass->outlength);
   }
-  return steps;
 }
 
-static void resize_multistep(const uint8_t *const input,
-                             int length,
-                             uint8_t *output,
-                             int olength,
-                             uint8_t *buf) {
-  int steps;
-  if (length == olength) {
-    memcpy(output, input, sizeof(uint8_t) * length);
+// Resizes the columns of a plane a whole row at a time, so the filters work
+// along contiguous memory instead of on gathered copies of each column.
+static void resize_cols(const RESIZE_PLAN *plan, const uint8_t *input,
+                        int in_stride, int height, uint8_t *output,
+                        int out_stride, int width, uint8_t *buf) {
+  const uint8_t *src = input;
+  int src_stride = in_stride;
+  uint8_t *const tmp[2] = {
+    buf, buf + (size_t)width * get_down2_length(height, 1)
+  };
+  int p, y;
+
+  if (plan->num_passes == 0) {
+    for (y = 0; y < height; ++y)
+      memcpy(output + (size_t)out_stride * y, input + (size_t)in_stride * y,
+             sizeof(*output) * width);
     return;
   }
-  steps = get_down2_steps(length, olength);
-
-  if (steps > 0) {
-    int s;
-    uint8_t *out = NULL;
-    uint8_t *tmpbuf = NULL;
-    uint8_t *otmp, *otmp2;
-    int filteredlength = length;
-    if (!tmpbuf) {
-      tmpbuf = (uint8_t *)malloc(sizeof(uint8_t) * length);
-      otmp = tmpbuf;
-    } else {
-      otmp = buf;
+  for (p = 0; p < plan->num_passes; ++p) {
+    const RESIZE_PASS *const pass = &plan->passes[p];
+    const int last = p == plan->num_passes - 1;
+    uint8_t *const dst = last ? output : tmp[p & 1];
+    const int dst_stride = last ? out_stride : width;
+    for (y = 0; y < pass->outlength; ++y) {
+      const uint8_t *rows[INTERP_TAPS];
+      setup_tap_rows(pass, y, src, src_stride, rows);
+      vp9_resize_filter_vert(rows, dst + (size_t)dst_stride * y, width,
+                             pass->filters[y]);
     }
-    otmp2 = otmp + get_down2_length(length, 1);
-    for (s = 0; s < steps; ++s) {
-      const int proj_filteredlength = get_down2_length(filteredlength, 1);
-      const uint8_t *const in = (s == 0 ? input : out);
-      if (s == steps - 1 && proj_filteredlength == olength)
-        out = output;
-      else
-        out = (s & 1 ? otmp2 : otmp);
-      if (filteredlength & 1)
-        down2_symodd(in, filteredlength, out);
-      else
-        down2_symeven(in, filteredlength, out);
-      filteredlength = proj_filteredlength;
-    }
-    if (filteredlength != olength) {
-      interpolate(out, filteredlength, output, olength);
-    }
-    if (tmpbuf)
-      free(tmpbuf);
-  } else {
-    interpolate(input, length, output, olength);
+    src = dst;
+    src_stride = dst_stride;
   }
 }
 
-static void fill_col_to_arr(uint8_t *img, int stride, int len, uint8_t *arr) {
+void vp9_resize_plane_rows(const uint8_t *const input,
+                           int width,
+                           int in_stride,
+                           uint8_t *intbuf,
+                           int width2,
+                           int row_start,
+                           int row_end) {
   int i;
-  uint8_t *iptr = img;
-  uint8_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *aptr++ = *iptr;
-  }
+  RESIZE_PLAN horz;
+  uint8_t *linebuf = (uint8_t *)malloc(sizeof(uint8_t) * 2 *
+                                       (width + 2 * RESIZE_BORDER));
+  uint8_t *lines[2];
+  lines[0] = linebuf + RESIZE_BORDER;
+  lines[1] = lines[0] + width + 2 * RESIZE_BORDER;
+  init_plan(&horz, width, width2);
+  for (i = row_start; i < row_end; ++i)
+    resize_row(&horz, input + in_stride * i, width, intbuf + width2 * i,
+               lines);
+  free_plan(&horz);
+  free(linebuf);
 }
 
-static void fill_arr_to_col(uint8_t *img, int stride, int len, uint8_t *arr) {
-  int i;
-  uint8_t *iptr = img;
-  uint8_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *iptr = *aptr++;
-  }
+void vp9_resize_plane_cols(const uint8_t *const intbuf,
+                           int height,
+                           int width2,
+                           uint8_t *output,
+                           int height2,
+                           int out_stride,
+                           int col_start,
+                           int col_end) {
+  const int width = col_end - col_start;
+  RESIZE_PLAN vert;
+  uint8_t *colbuf = (uint8_t *)malloc(sizeof(uint8_t) *
+                                      get_cols_buf_size(width, height));
+  init_plan(&vert, height, height2);
+  resize_cols(&vert, intbuf + col_start, width2, height, output + col_start,
+              out_stride, width, colbuf);
+  free_plan(&vert);
+  free(colbuf);
 }
 
 void vp9_resize_plane(const uint8_t *const input,
@@ -512,291 +474,155 @@ void vp9_resize_plane(const uint8_t *const input,
                       int height2,
                       int width2,
                       int out_stride) {
-  int i;
   uint8_t *intbuf = (uint8_t *)malloc(sizeof(uint8_t) * width2 * height);
-  uint8_t *tmpbuf = (uint8_t *)malloc(sizeof(uint8_t) *
-                                      (width < height ? height : width));
-  uint8_t *arrbuf = (uint8_t *)malloc(sizeof(uint8_t) * (height + height2));
   assert(width > 0);
   assert(height > 0);
   assert(width2 > 0);
   assert(height2 > 0);
-  for (i = 0; i < height; ++i)
-    resize_multistep(input + in_stride * i, width,
-                        intbuf + width2 * i, width2, tmpbuf);
-  for (i = 0; i < width2; ++i) {
-    fill_col_to_arr(intbuf + i, width2, height, arrbuf);
-    resize_multistep(arrbuf, height, arrbuf + height, height2, tmpbuf);
-    fill_arr_to_col(output + i, out_stride, height2, arrbuf + height);
-  }
+  vp9_resize_plane_rows(input, width, in_stride, intbuf, width2, 0, height);
+  vp9_resize_plane_cols(intbuf, height, width2, output, height2, out_stride,
+                        0, width2);
   free(intbuf);
-  free(tmpbuf);
-  free(arrbuf);
 }
 
 #if CONFIG_VP9_HIGHBITDEPTH
-static void highbd_interpolate(const uint16_t *const input, int inlength,
-                               uint16_t *output, int outlength, int bd) {
-  const int64_t delta =
-      (((uint64_t)inlength << 32) + outlength / 2) / outlength;
-  const int64_t offset = inlength > outlength ?
-      (((int64_t)(inlength - outlength) << 31) + outlength / 2) / outlength :
-      -(((int64_t)(outlength - inlength) << 31) + outlength / 2) / outlength;
-  uint16_t *optr = output;
-  int x, x1, x2, sum, k, int_pel, sub_pel;
-  int64_t y;
-
-  const interp_kernel *interp_filters =
-      choose_interp_filter(inlength, outlength);
+static void highbd_setup_tap_rows(const RESIZE_PASS *pass, int y,
+                                  const uint16_t *src, int src_stride,
+                                  const uint16_t *rows[INTERP_TAPS]) {
+  int k;
+  for (k = 0; k < INTERP_TAPS; ++k)
+    rows[k] = src + (size_t)src_stride *
+        clamp(pass->offsets[y] + k, 0, pass->inlength - 1);
+}
 
-  x = 0;
-  y = offset;
-  while ((y >> INTERP_PRECISION_BITS) < (INTERP_TAPS / 2 - 1)) {
-    x++;
-    y += delta;
-  }
-  x1 = x;
-  x = outlength - 1;
-  y = delta * x + offset;
-  while ((y >> INTERP_PRECISION_BITS) +
-         (int64_t)(INTERP_TAPS / 2) >= inlength) {
-    x--;
-    y -= delta;
-  }
-  x2 = x;
-  if (x1 > x2) {
-    for (x = 0, y = offset; x < outlength; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k) {
-        const int pk = int_pel - INTERP_TAPS / 2 + 1 + k;
-        sum += filter[k] *
-            input[(pk < 0 ? 0 : (pk >= inlength ? inlength - 1 : pk))];
-      }
-      *optr++ = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
-    }
-  } else {
-    // Initial part.
-    for (x = 0, y = offset; x < x1; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k)
-        sum += filter[k] *
-            input[(int_pel - INTERP_TAPS / 2 + 1 + k < 0 ?
-                   0 : int_pel - INTERP_TAPS / 2 + 1 + k)];
-      *optr++ = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
-    }
-    // Middle part.
-    for (; x <= x2; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k)
-        sum += filter[k] * input[int_pel - INTERP_TAPS / 2 + 1 + k];
-      *optr++ = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
-    }
-    // End part.
-    for (; x < outlength; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k)
-        sum += filter[k] * input[(int_pel - INTERP_TAPS / 2 + 1 + k >=
-                                  inlength ?  inlength - 1 :
-                                  int_pel - INTERP_TAPS / 2 + 1 + k)];
-      *optr++ = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
-    }
+void vp9_highbd_resize_filter_horz_c(const uint16_t *src, uint16_t *dst,
+                                     int w, const int *offsets,
+                                     const int16_t *const *filters, int bd) {
+  int x, k;
+  for (x = 0; x < w; ++x) {
+    const uint16_t *const s = src + offsets[x];
+    const int16_t *const filter = filters[x];
+    int sum = 0;
+    for (k = 0; k < INTERP_TAPS; ++k)
+      sum += filter[k] * s[k];
+    dst[x] = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
   }
 }
 
-static void highbd_down2_symeven(const uint16_t *const input, int length,
-                                 uint16_t *output, int bd) {
-  // Actual filter len = 2 * filter_len_half.
-  static const int16_t *filter = vp9_down2_symeven_half_filter;
-  const int filter_len_half = sizeof(vp9_down2_symeven_half_filter) / 2;
-  int i, j;
-  uint16_t *optr = output;
-  int l1 = filter_len_half;
-  int l2 = (length - filter_len_half);
-  l1 += (l1 & 1);
-  l2 += (l2 & 1);
-  if (l1 > l2) {
-    // Short input length.
-    for (i = 0; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] +
-                input[(i + 1 + j >= length ? length - 1 : i + 1 + j)]) *
-            filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
-  } else {
-    // Initial part.
-    for (i = 0; i < l1; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] + input[i + 1 + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
-    // Middle part.
-    for (; i < l2; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[i + 1 + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
-    // End part.
-    for (; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[i - j] +
-                input[(i + 1 + j >= length ? length - 1 : i + 1 + j)]) *
-            filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
+void vp9_highbd_resize_filter_vert_c(const uint16_t *const *src,
+                                     uint16_t *dst, int w,
+                                     const int16_t *filter, int bd) {
+  int x, k;
+  for (x = 0; x < w; ++x) {
+    int sum = 0;
+    for (k = 0; k < INTERP_TAPS; ++k)
+      sum += filter[k] * src[k][x];
+    dst[x] = clip_pixel_highbd(ROUND_POWER_OF_TWO(sum, FILTER_BITS), bd);
   }
 }
 
-static void highbd_down2_symodd(const uint16_t *const input, int length,
-                              uint16_t *output, int bd) {
-  // Actual filter len = 2 * filter_len_half - 1.
-  static const int16_t *filter = vp9_down2_symodd_half_filter;
-  const int filter_len_half = sizeof(vp9_down2_symodd_half_filter) / 2;
-  int i, j;
-  uint16_t *optr = output;
-  int l1 = filter_len_half - 1;
-  int l2 = (length - filter_len_half + 1);
-  l1 += (l1 & 1);
-  l2 += (l2 & 1);
-  if (l1 > l2) {
-    // Short input length.
-    for (i = 0; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] +
-                input[(i + j >= length ? length - 1 : i + j)]) *
-            filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
-  } else {
-    // Initial part.
-    for (i = 0; i < l1; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] + input[i + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
-    // Middle part.
-    for (; i < l2; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[i + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
-    // End part.
-    for (; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[(i + j >= length ? length - 1 : i + j)]) *
-            filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel_highbd(sum, bd);
-    }
+static void highbd_extend_line(uint16_t *line, int length) {
+  vpx_memset16(line - RESIZE_BORDER, line[0], RESIZE_BORDER);
+  vpx_memset16(line + length, line[length - 1], RESIZE_BORDER);
+}
+
+static void highbd_resize_row(const RESIZE_PLAN *plan, const uint16_t *input,
+                              int length, uint16_t *output, uint16_t *lines[2],
+                              int bd) {
+  int p;
+  if (plan->num_passes == 0) {
+    memcpy(output, input, sizeof(*output) * length);
+    return;
+  }
+  memcpy(lines[0], input, sizeof(*input) * length);
+  highbd_extend_line(lines[0], length);
+  for (p = 0; p < plan->num_passes; ++p) {
+    const RESIZE_PASS *const pass = &plan->passes[p];
+    uint16_t *const out =
+        p == plan->num_passes - 1 ? output : lines[(p + 1) & 1];
+    vp9_highbd_resize_filter_horz(lines[p & 1], out, pass->outlength,
+                                  pass->offsets, pass->filters, bd);
+    if (out != output)
+      highbd_extend_line(out, pass->outlength);
   }
 }
 
-static void highbd_resize_multistep(const uint16_t *const input,
-                                    int length,
-                                    uint16_t *output,
-                                    int olength,
-                                    uint16_t *buf,
-                                    int bd) {
-  int steps;
-  if (length == olength) {
-    memcpy(output, input, sizeof(uint16_t) * length);
+static void highbd_resize_cols(const RESIZE_PLAN *plan, const uint16_t *input,
+                               int in_stride, int height, uint16_t *output,
+                               int out_stride, int width, uint16_t *buf,
+                               int bd) {
+  const uint16_t *src = input;
+  int src_stride = in_stride;
+  uint16_t *const tmp[2] = {
+    buf, buf + (size_t)width * get_down2_length(height, 1)
+  };
+  int p, y;
+
+  if (plan->num_passes == 0) {
+    for (y = 0; y < height; ++y)
+      memcpy(output + (size_t)out_stride * y, input + (size_t)in_stride * y,
+             sizeof(*output) * width);
     return;
   }
-  steps = get_down2_steps(length, olength);
-
-  if (steps > 0) {
-    int s;
-    uint16_t *out = NULL;
-    uint16_t *tmpbuf = NULL;
-    uint16_t *otmp, *otmp2;
-    int filteredlength = length;
-    if (!tmpbuf) {
-      tmpbuf = (uint16_t *)malloc(sizeof(uint16_t) * length);
-      otmp = tmpbuf;
-    } else {
-      otmp = buf;
-    }
-    otmp2 = otmp + get_down2_length(length, 1);
-    for (s = 0; s < steps; ++s) {
-      const int proj_filteredlength = get_down2_length(filteredlength, 1);
-      const uint16_t *const in = (s == 0 ? input : out);
-      if (s == steps - 1 && proj_filteredlength == olength)
-        out = output;
-      else
-        out = (s & 1 ? otmp2 : otmp);
-      if (filteredlength & 1)
-        highbd_down2_symodd(in, filteredlength, out, bd);
-      else
-        highbd_down2_symeven(in, filteredlength, out, bd);
-      filteredlength = proj_filteredlength;
-    }
-    if (filteredlength != olength) {
-      highbd_interpolate(out, filteredlength, output, olength, bd);
+  for (p = 0; p < plan->num_passes; ++p) {
+    const RESIZE_PASS *const pass = &plan->passes[p];
+    const int last = p == plan->num_passes - 1;
+    uint16_t *const dst = last ? output : tmp[p & 1];
+    const int dst_stride = last ? out_stride : width;
+    for (y = 0; y < pass->outlength; ++y) {
+      const uint16_t *rows[INTERP_TAPS];
+      highbd_setup_tap_rows(pass, y, src, src_stride, rows);
+      vp9_highbd_resize_filter_vert(rows, dst + (size_t)dst_stride * y, width,
+                                    pass->filters[y], bd);
     }
-    if (tmpbuf)
-      free(tmpbuf);
-  } else {
-    highbd_interpolate(input, length, output, olength, bd);
+    src = dst;
+    src_stride = dst_stride;
   }
 }
 
-static void highbd_fill_col_to_arr(uint16_t *img, int stride, int len,
-                                   uint16_t *arr) {
+void vp9_highbd_resize_plane_rows(const uint8_t *const input,
+                                  int width,
+                                  int in_stride,
+                                  uint16_t *intbuf,
+                                  int width2,
+                                  int row_start,
+                                  int row_end,
+                                  int bd) {
   int i;
-  uint16_t *iptr = img;
-  uint16_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *aptr++ = *iptr;
+  RESIZE_PLAN horz;
+  uint16_t *linebuf = (uint16_t *)malloc(sizeof(uint16_t) * 2 *
+                                         (width + 2 * RESIZE_BORDER));
+  uint16_t *lines[2];
+  lines[0] = linebuf + RESIZE_BORDER;
+  lines[1] = lines[0] + width + 2 * RESIZE_BORDER;
+  init_plan(&horz, width, width2);
+  for (i = row_start; i < row_end; ++i) {
+    highbd_resize_row(&horz, CONVERT_TO_SHORTPTR(input + in_stride * i), width,
+                      intbuf + width2 * i, lines, bd);
   }
+  free_plan(&horz);
+  free(linebuf);
 }
 
-static void highbd_fill_arr_to_col(uint16_t *img, int stride, int len,
-                                   uint16_t *arr) {
-  int i;
-  uint16_t *iptr = img;
-  uint16_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *iptr = *aptr++;
-  }
+void vp9_highbd_resize_plane_cols(const uint16_t *const intbuf,
+                                  int height,
+                                  int width2,
+                                  uint8_t *output,
+                                  int height2,
+                                  int out_stride,
+                                  int col_start,
+                                  int col_end,
+                                  int bd) {
+  const int width = col_end - col_start;
+  RESIZE_PLAN vert;
+  uint16_t *colbuf = (uint16_t *)malloc(sizeof(uint16_t) *
+                                        get_cols_buf_size(width, height));
+  init_plan(&vert, height, height2);
+  highbd_resize_cols(&vert, intbuf + col_start, width2, height,
+                     CONVERT_TO_SHORTPTR(output) + col_start, out_stride,
+                     width, colbuf, bd);
+  free_plan(&vert);
+  free(colbuf);
 }
 
 void vp9_highbd_resize_plane(const uint8_t *const input,
@@ -808,25 +634,12 @@ void vp9_highbd_resize_plane(const uint8_t *const input,
                              int width2,
                              int out_stride,
                              int bd) {
-  int i;
   uint16_t *intbuf = (uint16_t *)malloc(sizeof(uint16_t) * width2 * height);
-  uint16_t *tmpbuf = (uint16_t *)malloc(sizeof(uint16_t) *
-                                        (width < height ? height : width));
-  uint16_t *arrbuf = (uint16_t *)malloc(sizeof(uint16_t) * (height + height2));
-  for (i = 0; i < height; ++i) {
-    highbd_resize_multistep(CONVERT_TO_SHORTPTR(input + in_stride * i), width,
-                            intbuf + width2 * i, width2, tmpbuf, bd);
-  }
-  for (i = 0; i < width2; ++i) {
-    highbd_fill_col_to_arr(intbuf + i, width2, height, arrbuf);
-    highbd_resize_multistep(arrbuf, height, arrbuf + height, height2, tmpbuf,
-                            bd);
-    highbd_fill_arr_to_col(CONVERT_TO_SHORTPTR(output + i), out_stride, height2,
-                           arrbuf + height);
-  }
+  vp9_highbd_resize_plane_rows(input, width, in_stride, intbuf, width2, 0,
+                               height, bd);
+  vp9_highbd_resize_plane_cols(intbuf, height, width2, output, height2,
+                               out_stride, 0, width2, bd);
   free(intbuf);
-  free(tmpbuf);
-  free(arrbuf);
 }
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
@@ -22,6 +22,25 @@ void vp9_resize_plane(const uint8_t *const input,
                       int height2,
                       int width2,
                       int out_stride);
+// vp9_resize_plane() in two phases that can each be split into independent
+// jobs. The rows phase filters input rows [row_start, row_end) into intbuf,
+// which holds width2 samples per row. Once all rows are done, the cols phase
+// filters output columns [col_start, col_end) from intbuf.
+void vp9_resize_plane_rows(const uint8_t *const input,
+                           int width,
+                           int in_stride,
+                           uint8_t *intbuf,
+                           int width2,
+                           int row_start,
+                           int row_end);
+void vp9_resize_plane_cols(const uint8_t *const intbuf,
+                           int height,
+                           int width2,
+                           uint8_t *output,
+                           int height2,
+                           int out_stride,
+                           int col_start,
+                           int col_end);
 void vp9_resize_frame420(const uint8_t *const y,
                          int y_stride,
                          const uint8_t *const u,
@@ -75,6 +94,23 @@ void vp9_highbd_resize_plane(const uint8_t *const input,
                              int width2,
                              int out_stride,
                              int bd);
+void vp9_highbd_resize_plane_rows(const uint8_t *const input,
+                                  int width,
+                                  int in_stride,
+                                  uint16_t *intbuf,
+                                  int width2,
+                                  int row_start,
+                                  int row_end,
+                                  int bd);
+void vp9_highbd_resize_plane_cols(const uint16_t *const intbuf,
+                                  int height,
+                                  int width2,
+                                  uint8_t *output,
+                                  int height2,
+                                  int out_stride,
+                                  int col_start,
+                                  int col_end,
+                                  int bd);
 void vp9_highbd_resize_frame420(const uint8_t *const y,
                                 int y_stride,
                                 const uint8_t *const u,
@@ -11,6 +11,7 @@
 #include <math.h>
 #include "./vp9_rtcd.h"
 #include "vpx_ports/mem.h"
+#include "vp9/common/vp9_common.h"
 #include "vp9/encoder/vp9_ssim.h"
 
 void vp9_ssim_parms_16x16_c(uint8_t *s, int sp, uint8_t *r,
@@ -62,6 +63,64 @@ void vp9_highbd_ssim_parms_8x8_c(uint16_t *s, int sp, uint16_t *r, int rp,
 }
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
+// Sums for a row of horizontally adjacent 4x4 blocks. Each overlapping 8x8
+// window is the sum of four of these, so every pixel is loaded once per
+// window row instead of once per window.
+void vp9_ssim_parms_4x4_row_c(const uint8_t *s, int sp, const uint8_t *r,
+                              int rp, int blocks, uint32_t *sum_s,
+                              uint32_t *sum_r, uint32_t *sum_sq_s,
+                              uint32_t *sum_sq_r, uint32_t *sum_sxr) {
+  int b, i, j;
+  for (b = 0; b < blocks; ++b, s += 4, r += 4) {
+    uint32_t ss = 0, sr = 0, ssq_s = 0, ssq_r = 0, ssxr = 0;
+    for (i = 0; i < 4; ++i) {
+      for (j = 0; j < 4; ++j) {
+        const int a = s[i * sp + j];
+        const int c = r[i * rp + j];
+        ss += a;
+        sr += c;
+        ssq_s += a * a;
+        ssq_r += c * c;
+        ssxr += a * c;
+      }
+    }
+    sum_s[b] = ss;
+    sum_r[b] = sr;
+    sum_sq_s[b] = ssq_s;
+    sum_sq_r[b] = ssq_r;
+    sum_sxr[b] = ssxr;
+  }
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+void vp9_highbd_ssim_parms_4x4_row_c(const uint16_t *s, int sp,
+                                     const uint16_t *r, int rp, int blocks,
+                                     uint32_t *sum_s, uint32_t *sum_r,
+                                     uint32_t *sum_sq_s, uint32_t *sum_sq_r,
+                                     uint32_t *sum_sxr) {
+  int b, i, j;
+  for (b = 0; b < blocks; ++b, s += 4, r += 4) {
+    uint32_t ss = 0, sr = 0, ssq_s = 0, ssq_r = 0, ssxr = 0;
+    for (i = 0; i < 4; ++i) {
+      for (j = 0; j < 4; ++j) {
+        const uint32_t a = s[i * sp + j];
+        const uint32_t c = r[i * rp + j];
+        ss += a;
+        sr += c;
+        ssq_s += a * a;
+        ssq_r += c * c;
+        ssxr += a * c;
+      }
+    }
+    sum_s[b] = ss;
+    sum_r[b] = sr;
+    sum_sq_s[b] = ssq_s;
+    sum_sq_r[b] = ssq_r;
+    sum_sxr[b] = ssxr;
+  }
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
 static const int64_t cc1 =  26634;  // (64^2*(.01*255)^2
 static const int64_t cc2 = 239708;  // (64^2*(.03*255)^2
 
@@ -85,45 +144,72 @@ static double similarity(unsigned long sum_s, unsigned long sum_r,
   return ssim_n * 1.0 / ssim_d;
 }
 
-static double ssim_8x8(uint8_t *s, int sp, uint8_t *r, int rp) {
-  unsigned long sum_s = 0, sum_r = 0, sum_sq_s = 0, sum_sq_r = 0, sum_sxr = 0;
-  vp9_ssim_parms_8x8(s, sp, r, rp, &sum_s, &sum_r, &sum_sq_s, &sum_sq_r,
-                     &sum_sxr);
-  return similarity(sum_s, sum_r, sum_sq_s, sum_sq_r, sum_sxr, 64);
+// Windows are summed a strip at a time so the block sums fit on the stack.
+#define SSIM_STRIP_WINDOWS 64
+
+typedef struct {
+  uint32_t sum_s[SSIM_STRIP_WINDOWS + 1];
+  uint32_t sum_r[SSIM_STRIP_WINDOWS + 1];
+  uint32_t sum_sq_s[SSIM_STRIP_WINDOWS + 1];
+  uint32_t sum_sq_r[SSIM_STRIP_WINDOWS + 1];
+  uint32_t sum_sxr[SSIM_STRIP_WINDOWS + 1];
+} SSIM_BLOCK_SUMS;
+
+// Adds the similarity of the 8x8 windows built from two rows of 4x4 block
+// sums to ssim_total, in left to right order. Sums at a high bitdepth are
+// brought back to 8 bits with oshift.
+static double add_window_row(const SSIM_BLOCK_SUMS *top,
+                             const SSIM_BLOCK_SUMS *bottom, int windows,
+                             int oshift, double ssim_total) {
+  int j;
+  for (j = 0; j < windows; ++j) {
+    const uint32_t sum_s = top->sum_s[j] + top->sum_s[j + 1] +
+                           bottom->sum_s[j] + bottom->sum_s[j + 1];
+    const uint32_t sum_r = top->sum_r[j] + top->sum_r[j + 1] +
+                           bottom->sum_r[j] + bottom->sum_r[j + 1];
+    const uint32_t sum_sq_s = top->sum_sq_s[j] + top->sum_sq_s[j + 1] +
+                              bottom->sum_sq_s[j] + bottom->sum_sq_s[j + 1];
+    const uint32_t sum_sq_r = top->sum_sq_r[j] + top->sum_sq_r[j + 1] +
+                              bottom->sum_sq_r[j] + bottom->sum_sq_r[j + 1];
+    const uint32_t sum_sxr = top->sum_sxr[j] + top->sum_sxr[j + 1] +
+                             bottom->sum_sxr[j] + bottom->sum_sxr[j + 1];
+    ssim_total += similarity(sum_s >> oshift, sum_r >> oshift,
+                             sum_sq_s >> (2 * oshift),
+                             sum_sq_r >> (2 * oshift),
+                             sum_sxr >> (2 * oshift), 64);
+  }
+  return ssim_total;
 }
 
-#if CONFIG_VP9_HIGHBITDEPTH
-static double highbd_ssim_8x8(uint16_t *s, int sp, uint16_t *r, int rp,
-                              unsigned int bd) {
-  uint32_t sum_s = 0, sum_r = 0, sum_sq_s = 0, sum_sq_r = 0, sum_sxr = 0;
-  const int oshift = bd - 8;
-  vp9_highbd_ssim_parms_8x8(s, sp, r, rp, &sum_s, &sum_r, &sum_sq_s, &sum_sq_r,
-                            &sum_sxr);
-  return similarity(sum_s >> oshift,
-                    sum_r >> oshift,
-                    sum_sq_s >> (2 * oshift),
-                    sum_sq_r >> (2 * oshift),
-                    sum_sxr >> (2 * oshift),
-                    64);
+static void ssim_block_sums(const uint8_t *s, int sp, const uint8_t *r,
+                            int rp, int blocks, SSIM_BLOCK_SUMS *sums) {
+  vp9_ssim_parms_4x4_row(s, sp, r, rp, blocks, sums->sum_s, sums->sum_r,
+                         sums->sum_sq_s, sums->sum_sq_r, sums->sum_sxr);
 }
-#endif  // CONFIG_VP9_HIGHBITDEPTH
 
 // We are using a 8x8 moving window with starting location of each 8x8 window
 // on the 4x4 pixel grid. Such arrangement allows the windows to overlap
 // block boundaries to penalize blocking artifacts.
 double vp9_ssim2(uint8_t *img1, uint8_t *img2, int stride_img1,
                  int stride_img2, int width, int height) {
+  const int windows = width / 4 - 1;
   int i, j;
   int samples = 0;
   double ssim_total = 0;
+  SSIM_BLOCK_SUMS top, bottom;
 
   // sample point start with each 4x4 location
   for (i = 0; i <= height - 8;
        i += 4, img1 += stride_img1 * 4, img2 += stride_img2 * 4) {
-    for (j = 0; j <= width - 8; j += 4) {
-      double v = ssim_8x8(img1 + j, stride_img1, img2 + j, stride_img2);
-      ssim_total += v;
-      samples++;
+    for (j = 0; j < windows; j += SSIM_STRIP_WINDOWS) {
+      const int n = MIN(windows - j, SSIM_STRIP_WINDOWS);
+      ssim_block_sums(img1 + 4 * j, stride_img1, img2 + 4 * j, stride_img2,
+                      n + 1, &top);
+      ssim_block_sums(img1 + 4 * (stride_img1 + j), stride_img1,
+                      img2 + 4 * (stride_img2 + j), stride_img2, n + 1,
+                      &bottom);
+      ssim_total = add_window_row(&top, &bottom, n, 0, ssim_total);
+      samples += n;
     }
   }
   ssim_total /= samples;
@@ -131,22 +217,38 @@ double vp9_ssim2(uint8_t *img1, uint8_t *img2, int stride_img1,
 }
 
 #if CONFIG_VP9_HIGHBITDEPTH
+static void highbd_ssim_block_sums(const uint16_t *s, int sp,
+                                   const uint16_t *r, int rp, int blocks,
+                                   SSIM_BLOCK_SUMS *sums) {
+  vp9_highbd_ssim_parms_4x4_row(s, sp, r, rp, blocks, sums->sum_s,
+                                sums->sum_r, sums->sum_sq_s, sums->sum_sq_r,
+                                sums->sum_sxr);
+}
+
 double vp9_highbd_ssim2(uint8_t *img1, uint8_t *img2, int stride_img1,
                         int stride_img2, int width, int height,
                         unsigned int bd) {
+  const uint16_t *s = CONVERT_TO_SHORTPTR(img1);
+  const uint16_t *r = CONVERT_TO_SHORTPTR(img2);
+  const int windows = width / 4 - 1;
+  const int oshift = bd - 8;
   int i, j;
   int samples = 0;
   double ssim_total = 0;
+  SSIM_BLOCK_SUMS top, bottom;
 
   // sample point start with each 4x4 location
   for (i = 0; i <= height - 8;
-       i += 4, img1 += stride_img1 * 4, img2 += stride_img2 * 4) {
-    for (j = 0; j <= width - 8; j += 4) {
-      double v = highbd_ssim_8x8(CONVERT_TO_SHORTPTR(img1 + j), stride_img1,
-                                 CONVERT_TO_SHORTPTR(img2 + j), stride_img2,
-                                 bd);
-      ssim_total += v;
-      samples++;
+       i += 4, s += stride_img1 * 4, r += stride_img2 * 4) {
+    for (j = 0; j < windows; j += SSIM_STRIP_WINDOWS) {
+      const int n = MIN(windows - j, SSIM_STRIP_WINDOWS);
+      highbd_ssim_block_sums(s + 4 * j, stride_img1, r + 4 * j, stride_img2,
+                             n + 1, &top);
+      highbd_ssim_block_sums(s + 4 * (stride_img1 + j), stride_img1,
+                             r + 4 * (stride_img2 + j), stride_img2, n + 1,
+                             &bottom);
+      ssim_total = add_window_row(&top, &bottom, n, oshift, ssim_total);
+      samples += n;
     }
   }
   ssim_total /= samples;
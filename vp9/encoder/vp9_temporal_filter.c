@@ -211,6 +211,45 @@ void vp9_highbd_temporal_filter_apply_c(uint8_t *frame1_8,
 }
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
+void vp9_temporal_filter_normalize_c(const unsigned int *accumulator,
+                                     const uint16_t *count,
+                                     unsigned int block_width,
+                                     unsigned int block_height,
+                                     uint8_t *dst, int stride) {
+  unsigned int i, j, k;
+
+  for (i = 0, k = 0; i < block_height; i++) {
+    for (j = 0; j < block_width; j++, k++) {
+      unsigned int pval = accumulator[k] + (count[k] >> 1);
+      pval *= fixed_divide[count[k]];
+      pval >>= 19;
+      dst[j] = (uint8_t)pval;
+    }
+    dst += stride;
+  }
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+void vp9_highbd_temporal_filter_normalize_c(const unsigned int *accumulator,
+                                            const uint16_t *count,
+                                            unsigned int block_width,
+                                            unsigned int block_height,
+                                            uint8_t *dst8, int stride) {
+  uint16_t *dst = CONVERT_TO_SHORTPTR(dst8);
+  unsigned int i, j, k;
+
+  for (i = 0, k = 0; i < block_height; i++) {
+    for (j = 0; j < block_width; j++, k++) {
+      unsigned int pval = accumulator[k] + (count[k] >> 1);
+      pval *= fixed_divide[count[k]];
+      pval >>= 19;
+      dst[j] = (uint16_t)pval;
+    }
+    dst += stride;
+  }
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
 static int temporal_filter_find_matching_mb_c(VP9_COMP *cpi,
                                               uint8_t *arf_frame_buf,
                                               uint8_t *frame_ptr_buf,
@@ -274,7 +313,6 @@ static void temporal_filter_iterate_c(VP9_COMP *cpi,
                                       int alt_ref_index,
                                       int strength,
                                       struct scale_factors *scale) {
-  int byte;
   int frame;
   int mb_col, mb_row;
   unsigned int filter_weight;
@@ -286,7 +324,6 @@ static void temporal_filter_iterate_c(VP9_COMP *cpi,
   DECLARE_ALIGNED(16, uint16_t, count[16 * 16 * 3]);
   MACROBLOCKD *mbd = &cpi->td.mb.e_mbd;
   YV12_BUFFER_CONFIG *f = frames[alt_ref_index];
-  uint8_t *dst1, *dst2;
 #if CONFIG_VP9_HIGHBITDEPTH
   DECLARE_ALIGNED(16, uint16_t,  predictor16[16 * 16 * 3]);
   DECLARE_ALIGNED(16, uint8_t,  predictor8[16 * 16 * 3]);
@@ -328,9 +365,6 @@ static void temporal_filter_iterate_c(VP9_COMP *cpi,
                          + (17 - 2 * VP9_INTERP_EXTEND);
 
     for (mb_col = 0; mb_col < mb_cols; mb_col++) {
-      int i, j, k;
-      int stride;
-
       memset(accumulator, 0, 16 * 16 * 3 * sizeof(accumulator[0]));
       memset(count, 0, 16 * 16 * 3 * sizeof(count[0]));
 
@@ -434,147 +468,48 @@ static void temporal_filter_iterate_c(VP9_COMP *cpi,
         }
       }
 
+      // Normalize filter output to produce AltRef frame
 #if CONFIG_VP9_HIGHBITDEPTH
       if (mbd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
-        uint16_t *dst1_16;
-        uint16_t *dst2_16;
-        // Normalize filter output to produce AltRef frame
-        dst1 = cpi->alt_ref_buffer.y_buffer;
-        dst1_16 = CONVERT_TO_SHORTPTR(dst1);
-        stride = cpi->alt_ref_buffer.y_stride;
-        byte = mb_y_offset;
-        for (i = 0, k = 0; i < 16; i++) {
-          for (j = 0; j < 16; j++, k++) {
-            unsigned int pval = accumulator[k] + (count[k] >> 1);
-            pval *= fixed_divide[count[k]];
-            pval >>= 19;
-
-            dst1_16[byte] = (uint16_t)pval;
-
-            // move to next pixel
-            byte++;
-          }
-
-          byte += stride - 16;
-        }
-
-        dst1 = cpi->alt_ref_buffer.u_buffer;
-        dst2 = cpi->alt_ref_buffer.v_buffer;
-        dst1_16 = CONVERT_TO_SHORTPTR(dst1);
-        dst2_16 = CONVERT_TO_SHORTPTR(dst2);
-        stride = cpi->alt_ref_buffer.uv_stride;
-        byte = mb_uv_offset;
-        for (i = 0, k = 256; i < mb_uv_height; i++) {
-          for (j = 0; j < mb_uv_width; j++, k++) {
-            int m = k + 256;
-
-            // U
-            unsigned int pval = accumulator[k] + (count[k] >> 1);
-            pval *= fixed_divide[count[k]];
-            pval >>= 19;
-            dst1_16[byte] = (uint16_t)pval;
-
-            // V
-            pval = accumulator[m] + (count[m] >> 1);
-            pval *= fixed_divide[count[m]];
-            pval >>= 19;
-            dst2_16[byte] = (uint16_t)pval;
-
-            // move to next pixel
-            byte++;
-          }
-
-          byte += stride - mb_uv_width;
-        }
+        vp9_highbd_temporal_filter_normalize(
+            accumulator, count, 16, 16,
+            cpi->alt_ref_buffer.y_buffer + mb_y_offset,
+            cpi->alt_ref_buffer.y_stride);
+        vp9_highbd_temporal_filter_normalize(
+            accumulator + 256, count + 256, mb_uv_width, mb_uv_height,
+            cpi->alt_ref_buffer.u_buffer + mb_uv_offset,
+            cpi->alt_ref_buffer.uv_stride);
+        vp9_highbd_temporal_filter_normalize(
+            accumulator + 512, count + 512, mb_uv_width, mb_uv_height,
+            cpi->alt_ref_buffer.v_buffer + mb_uv_offset,
+            cpi->alt_ref_buffer.uv_stride);
       } else {
-        // Normalize filter output to produce AltRef frame
-        dst1 = cpi->alt_ref_buffer.y_buffer;
-        stride = cpi->alt_ref_buffer.y_stride;
-        byte = mb_y_offset;
-        for (i = 0, k = 0; i < 16; i++) {
-          for (j = 0; j < 16; j++, k++) {
-            unsigned int pval = accumulator[k] + (count[k] >> 1);
-            pval *= fixed_divide[count[k]];
-            pval >>= 19;
-
-            dst1[byte] = (uint8_t)pval;
-
-            // move to next pixel
-            byte++;
-          }
-          byte += stride - 16;
-        }
-
-        dst1 = cpi->alt_ref_buffer.u_buffer;
-        dst2 = cpi->alt_ref_buffer.v_buffer;
-        stride = cpi->alt_ref_buffer.uv_stride;
-        byte = mb_uv_offset;
-        for (i = 0, k = 256; i < mb_uv_height; i++) {
-          for (j = 0; j < mb_uv_width; j++, k++) {
-            int m = k + 256;
-
-            // U
-            unsigned int pval = accumulator[k] + (count[k] >> 1);
-            pval *= fixed_divide[count[k]];
-            pval >>= 19;
-            dst1[byte] = (uint8_t)pval;
-
-            // V
-            pval = accumulator[m] + (count[m] >> 1);
-            pval *= fixed_divide[count[m]];
-            pval >>= 19;
-            dst2[byte] = (uint8_t)pval;
-
-            // move to next pixel
-            byte++;
-          }
-          byte += stride - mb_uv_width;
-        }
+        vp9_temporal_filter_normalize(
+            accumulator, count, 16, 16,
+            cpi->alt_ref_buffer.y_buffer + mb_y_offset,
+            cpi->alt_ref_buffer.y_stride);
+        vp9_temporal_filter_normalize(
+            accumulator + 256, count + 256, mb_uv_width, mb_uv_height,
+            cpi->alt_ref_buffer.u_buffer + mb_uv_offset,
+            cpi->alt_ref_buffer.uv_stride);
+        vp9_temporal_filter_normalize(
+            accumulator + 512, count + 512, mb_uv_width, mb_uv_height,
+            cpi->alt_ref_buffer.v_buffer + mb_uv_offset,
+            cpi->alt_ref_buffer.uv_stride);
       }
 #else
-      // Normalize filter output to produce AltRef frame
-      dst1 = cpi->alt_ref_buffer.y_buffer;
-      stride = cpi->alt_ref_buffer.y_stride;
-      byte = mb_y_offset;
-      for (i = 0, k = 0; i < 16; i++) {
-        for (j = 0; j < 16; j++, k++) {
-          unsigned int pval = accumulator[k] + (count[k] >> 1);
-          pval *= fixed_divide[count[k]];
-          pval >>= 19;
-
-          dst1[byte] = (uint8_t)pval;
-
-          // move to next pixel
-          byte++;
-        }
-        byte += stride - 16;
-      }
-
-      dst1 = cpi->alt_ref_buffer.u_buffer;
-      dst2 = cpi->alt_ref_buffer.v_buffer;
-      stride = cpi->alt_ref_buffer.uv_stride;
-      byte = mb_uv_offset;
-      for (i = 0, k = 256; i < mb_uv_height; i++) {
-        for (j = 0; j < mb_uv_width; j++, k++) {
-          int m = k + 256;
-
-          // U
-          unsigned int pval = accumulator[k] + (count[k] >> 1);
-          pval *= fixed_divide[count[k]];
-          pval >>= 19;
-          dst1[byte] = (uint8_t)pval;
-
-          // V
-          pval = accumulator[m] + (count[m] >> 1);
-          pval *= fixed_divide[count[m]];
-          pval >>= 19;
-          dst2[byte] = (uint8_t)pval;
-
-          // move to next pixel
-          byte++;
-        }
-        byte += stride - mb_uv_width;
-      }
+      vp9_temporal_filter_normalize(
+          accumulator, count, 16, 16,
+          cpi->alt_ref_buffer.y_buffer + mb_y_offset,
+          cpi->alt_ref_buffer.y_stride);
+      vp9_temporal_filter_normalize(
+          accumulator + 256, count + 256, mb_uv_width, mb_uv_height,
+          cpi->alt_ref_buffer.u_buffer + mb_uv_offset,
+          cpi->alt_ref_buffer.uv_stride);
+      vp9_temporal_filter_normalize(
+          accumulator + 512, count + 512, mb_uv_width, mb_uv_height,
+          cpi->alt_ref_buffer.v_buffer + mb_uv_offset,
+          cpi->alt_ref_buffer.uv_stride);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
       mb_y_offset += 16;
       mb_uv_offset += mb_uv_width;
@@ -719,7 +654,7 @@ void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
                                "Failed to reallocate alt_ref_buffer");
           }
           frames[frame] = vp9_scale_if_required(
-              cm, frames[frame], &cpi->svc.scaled_frames[frame_used]);
+              cpi, frames[frame], &cpi->svc.scaled_frames[frame_used]);
           ++frame_used;
         }
       }
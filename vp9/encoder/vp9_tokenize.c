@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "./vp9_rtcd.h"
 #include "vpx_mem/vpx_mem.h"
 
 #include "vp9/common/vp9_entropy.h"
@@ -436,6 +437,37 @@ const struct vp9_token vp9_coef_encodings[ENTROPY_TOKENS] = {
   {125, 7}, {126, 7}, {127, 7}, {0, 1}
 };
 
+// Indexed by values in [-CAT6_MIN_VAL, CAT6_MIN_VAL]. The two end entries
+// stand for every CATEGORY6_TOKEN value and carry no extra bit cost.
+static int32_t dct_value_token_cost[2 * CAT6_MIN_VAL + 1];
+const int32_t *const vp9_dct_value_token_cost =
+    dct_value_token_cost + CAT6_MIN_VAL;
+
+void vp9_tokenize_initialize(void) {
+  int v;
+  for (v = -CAT6_MIN_VAL + 1; v < CAT6_MIN_VAL; ++v) {
+    const TOKENVALUE *const tv = &vp9_dct_cat_lt_10_value_tokens[v];
+    const int16_t cost = vp9_extra_bits[tv->token].cost[tv->extra];
+    dct_value_token_cost[v + CAT6_MIN_VAL] =
+        VP9_PACK_TOKEN_COST(tv->token, cost);
+  }
+  dct_value_token_cost[0] = VP9_PACK_TOKEN_COST(CATEGORY6_TOKEN, 0);
+  dct_value_token_cost[2 * CAT6_MIN_VAL] =
+      VP9_PACK_TOKEN_COST(CATEGORY6_TOKEN, 0);
+}
+
+int vp9_coeff_run_cost_c(const tran_low_t *qcoeff, const int16_t *scan,
+                         int eob, uint8_t *tokens,
+                         const int16_t *cat6_high_cost) {
+  int c, cost = 0;
+  for (c = 0; c < eob; ++c) {
+    int16_t token;
+    cost += vp9_get_token_cost(qcoeff[scan[c]], &token, cat6_high_cost);
+    tokens[c] = (uint8_t)token;
+  }
+  return cost;
+}
+
 
 struct tokenize_b_args {
   VP9_COMP *cpi;
@@ -457,26 +489,19 @@ static void set_entropy_context_b(int plane, int block, BLOCK_SIZE plane_bsize,
                    aoff, loff);
 }
 
-static INLINE void add_token(TOKENEXTRA **t, const vp9_prob *context_tree,
-                             int32_t extra, uint8_t token,
-                             uint8_t skip_eob_node,
+static INLINE void add_token(TOKENEXTRA **t, int ctx, int32_t extra,
+                             uint8_t token, uint8_t skip_eob_node,
                              unsigned int *counts) {
-  (*t)->token = token;
+  (*t)->packed = VP9_PACK_TOKEN(token, skip_eob_node, ctx);
   (*t)->extra = extra;
-  (*t)->context_tree = context_tree;
-  (*t)->skip_eob_node = skip_eob_node;
   (*t)++;
   ++counts[token];
 }
 
-static INLINE void add_token_no_extra(TOKENEXTRA **t,
-                                      const vp9_prob *context_tree,
-                                      uint8_t token,
+static INLINE void add_token_no_extra(TOKENEXTRA **t, int ctx, uint8_t token,
                                       uint8_t skip_eob_node,
                                       unsigned int *counts) {
-  (*t)->token = token;
-  (*t)->context_tree = context_tree;
-  (*t)->skip_eob_node = skip_eob_node;
+  (*t)->packed = VP9_PACK_TOKEN(token, skip_eob_node, ctx);
   (*t)++;
   ++counts[token];
 }
@@ -511,8 +536,11 @@ static void tokenize_b(int plane, int block, BLOCK_SIZE plane_bsize,
   const int ref = is_inter_block(mbmi);
   unsigned int (*const counts)[COEFF_CONTEXTS][ENTROPY_TOKENS] =
       td->rd_counts.coef_counts[tx_size][type][ref];
-  vp9_prob (*const coef_probs)[COEFF_CONTEXTS][UNCONSTRAINED_NODES] =
-      cpi->common.fc->coef_probs[tx_size][type][ref];
+  // Index of the first context of this tx_size, type and ref in the flat
+  // order of cm->fc->coef_probs.
+  const int ctx_base =
+      ((tx_size * PLANE_TYPES + type) * REF_TYPES + ref) * COEF_BANDS *
+      COEFF_CONTEXTS;
   unsigned int (*const eob_branch)[COEFF_CONTEXTS] =
       td->counts->eob_branch[tx_size][type][ref];
   const uint8_t *const band = get_band_translate(tx_size);
@@ -535,8 +563,8 @@ static void tokenize_b(int plane, int block, BLOCK_SIZE plane_bsize,
     v = qcoeff[scan[c]];
 
     while (!v) {
-      add_token_no_extra(&t, coef_probs[band[c]][pt], ZERO_TOKEN, skip_eob,
-                         counts[band[c]][pt]);
+      add_token_no_extra(&t, ctx_base + band[c] * COEFF_CONTEXTS + pt,
+                         ZERO_TOKEN, skip_eob, counts[band[c]][pt]);
       eob_branch[band[c]][pt] += !skip_eob;
 
       skip_eob = 1;
@@ -548,8 +576,8 @@ static void tokenize_b(int plane, int block, BLOCK_SIZE plane_bsize,
 
     vp9_get_token_extra(v, &token, &extra);
 
-    add_token(&t, coef_probs[band[c]][pt], extra, (uint8_t)token,
-              (uint8_t)skip_eob, counts[band[c]][pt]);
+    add_token(&t, ctx_base + band[c] * COEFF_CONTEXTS + pt, extra,
+              (uint8_t)token, (uint8_t)skip_eob, counts[band[c]][pt]);
     eob_branch[band[c]][pt] += !skip_eob;
 
     token_cache[scan[c]] = vp9_pt_energy_class[token];
@@ -557,8 +585,8 @@ static void tokenize_b(int plane, int block, BLOCK_SIZE plane_bsize,
     pt = get_coef_context(nb, token_cache, c);
   }
   if (c < seg_eob) {
-    add_token_no_extra(&t, coef_probs[band[c]][pt], EOB_TOKEN, 0,
-                       counts[band[c]][pt]);
+    add_token_no_extra(&t, ctx_base + band[c] * COEFF_CONTEXTS + pt,
+                       EOB_TOKEN, 0, counts[band[c]][pt]);
     ++eob_branch[band[c]][pt];
   }
 
@@ -632,3 +660,37 @@ void vp9_tokenize_sb(VP9_COMP *cpi, ThreadData *td, TOKENEXTRA **t,
     vp9_foreach_transformed_block(xd, bsize, set_entropy_context_b, &arg);
   }
 }
+
+int vp9_reserve_sb_tokens(TokenChunk **chunk, TOKENEXTRA **t) {
+  TokenChunk *const c = *chunk;
+  if (*t + MAX_SB_TOKENS <= c->tokens + TOKEN_CHUNK_SIZE)
+    return 1;
+
+  c->stop = *t;
+  if (c->next == NULL) {
+    c->next = (TokenChunk *)vpx_malloc(sizeof(*c->next));
+    if (c->next == NULL)
+      return 0;
+    c->next->next = NULL;
+  }
+  *chunk = c->next;
+  *t = c->next->tokens;
+  return 1;
+}
+
+void vp9_free_token_chunks(TokenChunk **head) {
+  TokenChunk *c = *head;
+  while (c != NULL) {
+    TokenChunk *const next = c->next;
+    vpx_free(c);
+    c = next;
+  }
+  *head = NULL;
+}
+
+size_t vp9_token_chunks_footprint(const TokenChunk *head) {
+  size_t size = 0;
+  for (; head != NULL; head = head->next)
+    size += sizeof(*head);
+  return size;
+}
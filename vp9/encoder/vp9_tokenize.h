@@ -20,7 +20,7 @@
 extern "C" {
 #endif
 
-#define EOSB_TOKEN 127     // Not signalled, encoder only
+#define EOSB_TOKEN 15      // Not signalled, encoder only
 
 #if CONFIG_VP9_HIGHBITDEPTH
   typedef int32_t EXTRABIT;
@@ -34,13 +34,38 @@ typedef struct {
   EXTRABIT extra;
 } TOKENVALUE;
 
+// A token as stored for the bitstream writer. The token, whether its EOB
+// check is skipped and the index of its coefficient context share 16 bits.
+// The context indexes cm->fc->coef_probs as a flat array of
+// UNCONSTRAINED_NODES probabilities, in [tx_size][type][ref][band][ctx]
+// order, so the writer picks up the probabilities of the frame being coded.
 typedef struct {
-  const vp9_prob *context_tree;
   EXTRABIT extra;
-  uint8_t token;
-  uint8_t skip_eob_node;
+  uint16_t packed;
 } TOKENEXTRA;
 
+#define VP9_PACK_TOKEN(token, skip_eob_node, ctx) \
+    ((uint16_t)(((ctx) << 5) | ((skip_eob_node) << 4) | (token)))
+#define VP9_TOKEN(packed) ((packed) & 0xf)
+#define VP9_TOKEN_SKIP_EOB_NODE(packed) (((packed) >> 4) & 1)
+#define VP9_TOKEN_CTX(packed) ((packed) >> 5)
+
+// The most tokens a 64x64 superblock can produce: one per pixel in each of
+// three full resolution planes, and an EOSB_TOKEN per 8x8 block.
+#define MAX_SB_TOKENS (64 * 64 * 3 + 64)
+
+// Each tile keeps its tokens in a list of chunks that grows with the tokens
+// the frames actually produce. A chunk is only started on when it has room
+// for a whole superblock, so a superblock's tokens are never split and the
+// writer moves on to the next chunk between superblocks.
+#define TOKEN_CHUNK_SIZE (4 * MAX_SB_TOKENS)
+
+typedef struct TokenChunk {
+  struct TokenChunk *next;
+  TOKENEXTRA *stop;  // One past the last token written to this chunk.
+  TOKENEXTRA tokens[TOKEN_CHUNK_SIZE];
+} TokenChunk;
+
 extern const vp9_tree_index vp9_coef_tree[];
 extern const vp9_tree_index vp9_coef_con_tree[];
 extern const struct vp9_token vp9_coef_encodings[];
@@ -54,13 +79,34 @@ struct ThreadData;
 void vp9_tokenize_sb(struct VP9_COMP *cpi, struct ThreadData *td,
                      TOKENEXTRA **t, int dry_run, BLOCK_SIZE bsize);
 
-extern const int16_t *vp9_dct_value_cost_ptr;
+// Makes sure *t, the write position in *chunk, has room for another
+// superblock's tokens. If it does not, the chunk is closed and *chunk and *t
+// move on to the next one, which is allocated on first use. Returns 0 if that
+// allocation fails. Runs on the encoder's worker threads, so the caller
+// reports the error.
+int vp9_reserve_sb_tokens(TokenChunk **chunk, TOKENEXTRA **t);
+
+void vp9_free_token_chunks(TokenChunk **head);
+
+// Returns the bytes held by the chunks of the list at head.
+size_t vp9_token_chunks_footprint(const TokenChunk *head);
+
 /* TODO: The Token field should be broken out into a separate char array to
  *  improve cache locality, since it's needed for costing when the rest of the
  *  fields are not.
  */
 extern const TOKENVALUE *vp9_dct_value_tokens_ptr;
 extern const TOKENVALUE *vp9_dct_cat_lt_10_value_tokens;
+
+// Token and extra bit cost of each value below CAT6_MIN_VAL in magnitude,
+// packed into one 32-bit word so that both come from a single (or gathered)
+// load. Filled in by vp9_tokenize_initialize().
+#define VP9_PACK_TOKEN_COST(token, cost) (((cost) << 4) | (token))
+#define VP9_TOKEN_COST_TOKEN(packed) ((packed) & 0xf)
+#define VP9_TOKEN_COST_COST(packed) ((packed) >> 4)
+extern const int32_t *const vp9_dct_value_token_cost;
+
+void vp9_tokenize_initialize(void);
 extern const int16_t vp9_cat6_low_cost[256];
 extern const int16_t vp9_cat6_high_cost[128];
 extern const int16_t vp9_cat6_high10_high_cost[512];
@@ -98,6 +144,22 @@ static INLINE void vp9_get_token_extra(int v, int16_t *token, EXTRABIT *extra) {
   *token = vp9_dct_cat_lt_10_value_tokens[v].token;
   *extra = vp9_dct_cat_lt_10_value_tokens[v].extra;
 }
+// Returns the extra bit cost of v and sets *token, like vp9_get_token_extra()
+// followed by vp9_get_cost().
+static INLINE int vp9_get_token_cost(int v, int16_t *token,
+                                     const int16_t *cat6_high_table) {
+  if (v >= CAT6_MIN_VAL || v <= -CAT6_MIN_VAL) {
+    const EXTRABIT extrabits = v >= CAT6_MIN_VAL ?
+        2 * v - 2 * CAT6_MIN_VAL : -2 * v - 2 * CAT6_MIN_VAL + 1;
+    *token = CATEGORY6_TOKEN;
+    return vp9_cat6_low_cost[extrabits & 0xff] +
+        cat6_high_table[extrabits >> 8];
+  } else {
+    const int32_t packed = vp9_dct_value_token_cost[v];
+    *token = VP9_TOKEN_COST_TOKEN(packed);
+    return VP9_TOKEN_COST_COST(packed);
+  }
+}
 static INLINE int16_t vp9_get_token(int v) {
   if (v >= CAT6_MIN_VAL || v <= -CAT6_MIN_VAL)
     return 10;
@@ -15,7 +15,7 @@
 void vp9_start_encode(vp9_writer *br, uint8_t *source) {
   br->lowvalue = 0;
   br->range    = 255;
-  br->count    = -24;
+  br->count    = 0;
   br->buffer   = source;
   br->pos      = 0;
   vp9_write_bit(br, 0);
@@ -27,6 +27,17 @@ void vp9_stop_encode(vp9_writer *br) {
   for (i = 0; i < 32; i++)
     vp9_write_bit(br, 0);
 
+  // Flush all but the last 16 to 23 pending bits, which only hold padding.
+  while (br->count >= 24) {
+    if (br->lowvalue >> (br->count + 8)) {
+      vp9_writer_carry(br);
+      br->lowvalue &= ((uint64_t)1 << (br->count + 8)) - 1;
+    }
+    br->buffer[br->pos++] = (uint8_t)(br->lowvalue >> br->count);
+    br->count -= 8;
+    br->lowvalue &= ((uint64_t)1 << (br->count + 8)) - 1;
+  }
+
   // Ensure there's no ambigous collision with any index marker bytes
   if ((br->buffer[br->pos - 1] & 0xe0) == 0xc0)
     br->buffer[br->pos++] = 0;
@@ -12,6 +12,7 @@
 #define VP9_ENCODER_VP9_WRITER_H_
 
 #include "vpx_ports/mem.h"
+#include "vpx_ports/mem_ops.h"
 
 #include "vp9/common/vp9_prob.h"
 
@@ -19,8 +20,14 @@
 extern "C" {
 #endif
 
+// The coded bits not yet written to the buffer are held in a 64-bit
+// lowvalue, and flushed a word at a time. count is the number of bits below
+// the top pending byte; any carry out of that byte is propagated into the
+// buffer when it is flushed.
+#define VP9_WRITER_FLUSH_BITS 48
+
 typedef struct vp9_writer {
-  unsigned int lowvalue;
+  uint64_t lowvalue;
   unsigned int range;
   int count;
   unsigned int pos;
@@ -30,12 +37,23 @@ typedef struct vp9_writer {
 void vp9_start_encode(vp9_writer *bc, uint8_t *buffer);
 void vp9_stop_encode(vp9_writer *bc);
 
+static INLINE void vp9_writer_carry(vp9_writer *br) {
+  int x = br->pos - 1;
+
+  while (x >= 0 && br->buffer[x] == 0xff) {
+    br->buffer[x] = 0;
+    x--;
+  }
+
+  br->buffer[x] += 1;
+}
+
 static INLINE void vp9_write(vp9_writer *br, int bit, int probability) {
   unsigned int split;
   int count = br->count;
   unsigned int range = br->range;
-  unsigned int lowvalue = br->lowvalue;
-  register unsigned int shift;
+  uint64_t lowvalue = br->lowvalue;
+  unsigned int shift;
 
   split = 1 + (((range - 1) * probability) >> 8);
 
@@ -49,30 +67,20 @@ static INLINE void vp9_write(vp9_writer *br, int bit, int probability) {
   shift = vp9_norm[range];
 
   range <<= shift;
+  lowvalue <<= shift;
   count += shift;
 
-  if (count >= 0) {
-    int offset = shift - count;
-
-    if ((lowvalue << (offset - 1)) & 0x80000000) {
-      int x = br->pos - 1;
-
-      while (x >= 0 && br->buffer[x] == 0xff) {
-        br->buffer[x] = 0;
-        x--;
-      }
-
-      br->buffer[x] += 1;
+  if (count >= VP9_WRITER_FLUSH_BITS) {
+    if (lowvalue >> (count + 8)) {
+      vp9_writer_carry(br);
+      lowvalue &= ((uint64_t)1 << (count + 8)) - 1;
     }
-
-    br->buffer[br->pos++] = (lowvalue >> (24 - offset));
-    lowvalue <<= offset;
-    shift = count;
-    lowvalue &= 0xffffff;
-    count -= 8;
+    mem_put_be32(br->buffer + br->pos, (int)(lowvalue >> (count - 24)));
+    br->pos += 4;
+    count -= 32;
+    lowvalue &= ((uint64_t)1 << (count + 8)) - 1;
   }
 
-  lowvalue <<= shift;
   br->count = count;
   br->lowvalue = lowvalue;
   br->range = range;
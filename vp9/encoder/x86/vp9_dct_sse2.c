@@ -2366,6 +2366,90 @@ void vp9_highbd_fht16x16_sse2(const int16_t *input, tran_low_t *output,
     }
   }
 }
+
+/* The DC-only transforms can overflow 16 bits at high bit depth, so the block
+ * is summed with 32-bit accumulators.
+ */
+static INLINE void highbd_fdct_1(const int16_t *input, tran_low_t *output,
+                                 int stride, int size, int shift) {
+  const __m128i one = _mm_set1_epi16(1);
+  __m128i sum = _mm_setzero_si128();
+  int r, c;
+
+  for (r = 0; r < size; ++r) {
+    for (c = 0; c < size; c += 8) {
+      const __m128i in = _mm_load_si128((const __m128i *)(input + c));
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(in, one));
+    }
+    input += stride;
+  }
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 4));
+  output[0] = _mm_cvtsi128_si32(sum) >> shift;
+  output[1] = 0;
+}
+
+void vp9_highbd_fdct8x8_1_sse2(const int16_t *input, tran_low_t *output,
+                               int stride) {
+  highbd_fdct_1(input, output, stride, 8, 0);
+}
+
+void vp9_highbd_fdct16x16_1_sse2(const int16_t *input, tran_low_t *output,
+                                 int stride) {
+  highbd_fdct_1(input, output, stride, 16, 1);
+}
+
+void vp9_highbd_fdct32x32_1_sse2(const int16_t *input, tran_low_t *output,
+                                 int stride) {
+  highbd_fdct_1(input, output, stride, 32, 3);
+}
+
+static INLINE void transpose_4x4_epi32(__m128i *in) {
+  const __m128i tr0_0 = _mm_unpacklo_epi32(in[0], in[1]);
+  const __m128i tr0_1 = _mm_unpacklo_epi32(in[2], in[3]);
+  const __m128i tr0_2 = _mm_unpackhi_epi32(in[0], in[1]);
+  const __m128i tr0_3 = _mm_unpackhi_epi32(in[2], in[3]);
+  in[0] = _mm_unpacklo_epi64(tr0_0, tr0_1);
+  in[1] = _mm_unpackhi_epi64(tr0_0, tr0_1);
+  in[2] = _mm_unpacklo_epi64(tr0_2, tr0_3);
+  in[3] = _mm_unpackhi_epi64(tr0_2, tr0_3);
+}
+
+// One pass of the Walsh-Hadamard transform on 4 columns. The outputs are
+// returned in row order, ready to be transposed.
+static INLINE void fwht4_sse2(__m128i *in) {
+  __m128i a1 = in[0], b1 = in[1], c1 = in[2], d1 = in[3], e1;
+  a1 = _mm_add_epi32(a1, b1);
+  d1 = _mm_sub_epi32(d1, c1);
+  e1 = _mm_srai_epi32(_mm_sub_epi32(a1, d1), 1);
+  b1 = _mm_sub_epi32(e1, b1);
+  c1 = _mm_sub_epi32(e1, c1);
+  a1 = _mm_sub_epi32(a1, c1);
+  d1 = _mm_add_epi32(d1, b1);
+  in[0] = a1;
+  in[1] = c1;
+  in[2] = d1;
+  in[3] = b1;
+}
+
+void vp9_highbd_fwht4x4_sse2(const int16_t *input, tran_low_t *output,
+                             int stride) {
+  __m128i in[4];
+  int i;
+
+  for (i = 0; i < 4; ++i) {
+    const __m128i row = _mm_loadl_epi64((const __m128i *)(input + i * stride));
+    in[i] = _mm_srai_epi32(_mm_unpacklo_epi16(row, row), 16);
+  }
+  fwht4_sse2(in);
+  transpose_4x4_epi32(in);
+  fwht4_sse2(in);
+  transpose_4x4_epi32(in);
+  for (i = 0; i < 4; ++i) {
+    in[i] = _mm_slli_epi32(in[i], UNIT_QUANT_SHIFT);
+    _mm_store_si128((__m128i *)(output + i * 4), in[i]);
+  }
+}
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
 /*
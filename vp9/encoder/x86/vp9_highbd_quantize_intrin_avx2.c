@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vp9_rtcd.h"
+#include "vpx_ports/mem.h"
+#include "vp9/common/vp9_common.h"
+
+#if CONFIG_VP9_HIGHBITDEPTH
+// Returns the low 32 bits of (a * b) >> shift for each signed 32-bit lane,
+// with the product evaluated at 64-bit precision.
+static INLINE __m256i highbd_mul_shift_epi32(__m256i a, __m256i b,
+                                             int shift) {
+  const __m128i count = _mm_cvtsi32_si128(shift);
+  __m256i prod_even = _mm256_mul_epi32(a, b);
+  __m256i prod_odd = _mm256_mul_epi32(_mm256_srli_epi64(a, 32),
+                                      _mm256_srli_epi64(b, 32));
+  // A logical shift is sufficient: only bits below 48 are kept.
+  prod_even = _mm256_srl_epi64(prod_even, count);
+  prod_odd = _mm256_sll_epi64(_mm256_srl_epi64(prod_odd, count),
+                              _mm_cvtsi32_si128(32));
+  return _mm256_blend_epi32(prod_even, prod_odd, 0xaa);
+}
+
+// Quantizes 8 coefficients and returns a mask of the zero outputs.
+static INLINE __m256i highbd_quantize_fp_8(const tran_low_t *coeff_ptr,
+                                           tran_low_t *qcoeff_ptr,
+                                           tran_low_t *dqcoeff_ptr,
+                                           __m256i round, __m256i quant,
+                                           __m256i dequant, __m256i thr,
+                                           int log_scale) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i coeff = _mm256_loadu_si256((const __m256i *)coeff_ptr);
+  const __m256i coeff_sign = _mm256_srai_epi32(coeff, 31);
+  const __m256i abs_coeff = _mm256_abs_epi32(coeff);
+  __m256i abs_qcoeff, qcoeff, dqcoeff;
+
+  abs_qcoeff = highbd_mul_shift_epi32(_mm256_add_epi32(abs_coeff, round),
+                                      quant, 16 - log_scale);
+  abs_qcoeff = _mm256_andnot_si256(_mm256_cmpgt_epi32(thr, abs_coeff),
+                                   abs_qcoeff);
+  qcoeff = _mm256_sub_epi32(_mm256_xor_si256(abs_qcoeff, coeff_sign),
+                            coeff_sign);
+  dqcoeff = _mm256_mullo_epi32(qcoeff, dequant);
+  if (log_scale) {
+    // Signed division by 2, rounding towards zero.
+    dqcoeff = _mm256_add_epi32(dqcoeff, _mm256_srli_epi32(dqcoeff, 31));
+    dqcoeff = _mm256_srai_epi32(dqcoeff, 1);
+  }
+  _mm256_storeu_si256((__m256i *)qcoeff_ptr, qcoeff);
+  _mm256_storeu_si256((__m256i *)dqcoeff_ptr, dqcoeff);
+  return _mm256_cmpeq_epi32(abs_qcoeff, zero);
+}
+
+static INLINE void highbd_quantize_fp(const tran_low_t *coeff_ptr,
+                                      intptr_t n_coeffs, int skip_block,
+                                      const int16_t *round_ptr,
+                                      const int16_t *quant_ptr,
+                                      tran_low_t *qcoeff_ptr,
+                                      tran_low_t *dqcoeff_ptr,
+                                      const int16_t *dequant_ptr,
+                                      uint16_t *eob_ptr,
+                                      const int16_t *iscan,
+                                      int log_scale) {
+  const __m256i zero = _mm256_setzero_si256();
+  const int round0 = log_scale ? ROUND_POWER_OF_TWO(round_ptr[0], 1)
+                               : round_ptr[0];
+  const int round1 = log_scale ? ROUND_POWER_OF_TWO(round_ptr[1], 1)
+                               : round_ptr[1];
+  // The 32x32 quantizer zeroes coefficients below a quarter of the step.
+  const int thr0 = log_scale ? dequant_ptr[0] >> 2 : 0;
+  const int thr1 = log_scale ? dequant_ptr[1] >> 2 : 0;
+  __m256i round = _mm256_setr_epi32(round0, round1, round1, round1,
+                                    round1, round1, round1, round1);
+  __m256i quant = _mm256_setr_epi32(quant_ptr[0], quant_ptr[1], quant_ptr[1],
+                                    quant_ptr[1], quant_ptr[1], quant_ptr[1],
+                                    quant_ptr[1], quant_ptr[1]);
+  __m256i dequant = _mm256_setr_epi32(dequant_ptr[0], dequant_ptr[1],
+                                      dequant_ptr[1], dequant_ptr[1],
+                                      dequant_ptr[1], dequant_ptr[1],
+                                      dequant_ptr[1], dequant_ptr[1]);
+  __m256i thr = _mm256_setr_epi32(thr0, thr1, thr1, thr1,
+                                  thr1, thr1, thr1, thr1);
+  __m256i eob = zero;
+  __m128i eob128;
+  intptr_t i;
+
+  if (skip_block) {
+    memset(qcoeff_ptr, 0, n_coeffs * sizeof(*qcoeff_ptr));
+    memset(dqcoeff_ptr, 0, n_coeffs * sizeof(*dqcoeff_ptr));
+    *eob_ptr = 0;
+    return;
+  }
+
+  for (i = 0; i < n_coeffs; i += 16) {
+    __m256i zero_coeff0, zero_coeff1, nzero_coeff, iscan16;
+    zero_coeff0 = highbd_quantize_fp_8(coeff_ptr + i, qcoeff_ptr + i,
+                                       dqcoeff_ptr + i, round, quant, dequant,
+                                       thr, log_scale);
+    // Switch DC to AC.
+    round = _mm256_set1_epi32(round1);
+    quant = _mm256_set1_epi32(quant_ptr[1]);
+    dequant = _mm256_set1_epi32(dequant_ptr[1]);
+    thr = _mm256_set1_epi32(thr1);
+    zero_coeff1 = highbd_quantize_fp_8(coeff_ptr + i + 8, qcoeff_ptr + i + 8,
+                                       dqcoeff_ptr + i + 8, round, quant,
+                                       dequant, thr, log_scale);
+
+    // Scan for eob. The pack works within 128-bit lanes, so restore the
+    // coefficient order before matching the masks against iscan.
+    nzero_coeff = _mm256_packs_epi32(zero_coeff0, zero_coeff1);
+    nzero_coeff = _mm256_permute4x64_epi64(nzero_coeff, 0xd8);
+    nzero_coeff = _mm256_cmpeq_epi16(nzero_coeff, zero);
+    iscan16 = _mm256_loadu_si256((const __m256i *)(iscan + i));
+    // Add one to convert from indices to counts
+    iscan16 = _mm256_sub_epi16(iscan16, nzero_coeff);
+    eob = _mm256_max_epi16(eob, _mm256_and_si256(iscan16, nzero_coeff));
+  }
+
+  // Accumulate EOB
+  eob128 = _mm_max_epi16(_mm256_castsi256_si128(eob),
+                         _mm256_extracti128_si256(eob, 1));
+  eob128 = _mm_max_epi16(eob128, _mm_shuffle_epi32(eob128, 0xe));
+  eob128 = _mm_max_epi16(eob128, _mm_shufflelo_epi16(eob128, 0xe));
+  eob128 = _mm_max_epi16(eob128, _mm_shufflelo_epi16(eob128, 0x1));
+  *eob_ptr = _mm_extract_epi16(eob128, 0);
+}
+
+void vp9_highbd_quantize_fp_avx2(const tran_low_t *coeff_ptr,
+                                 intptr_t count,
+                                 int skip_block,
+                                 const int16_t *zbin_ptr,
+                                 const int16_t *round_ptr,
+                                 const int16_t *quant_ptr,
+                                 const int16_t *quant_shift_ptr,
+                                 tran_low_t *qcoeff_ptr,
+                                 tran_low_t *dqcoeff_ptr,
+                                 const int16_t *dequant_ptr,
+                                 uint16_t *eob_ptr,
+                                 const int16_t *scan,
+                                 const int16_t *iscan) {
+  (void)zbin_ptr;
+  (void)quant_shift_ptr;
+  (void)scan;
+  highbd_quantize_fp(coeff_ptr, count, skip_block, round_ptr, quant_ptr,
+                     qcoeff_ptr, dqcoeff_ptr, dequant_ptr, eob_ptr, iscan, 0);
+}
+
+void vp9_highbd_quantize_fp_32x32_avx2(const tran_low_t *coeff_ptr,
+                                       intptr_t n_coeffs,
+                                       int skip_block,
+                                       const int16_t *zbin_ptr,
+                                       const int16_t *round_ptr,
+                                       const int16_t *quant_ptr,
+                                       const int16_t *quant_shift_ptr,
+                                       tran_low_t *qcoeff_ptr,
+                                       tran_low_t *dqcoeff_ptr,
+                                       const int16_t *dequant_ptr,
+                                       uint16_t *eob_ptr,
+                                       const int16_t *scan,
+                                       const int16_t *iscan) {
+  (void)zbin_ptr;
+  (void)quant_shift_ptr;
+  (void)scan;
+  highbd_quantize_fp(coeff_ptr, n_coeffs, skip_block, round_ptr, quant_ptr,
+                     qcoeff_ptr, dqcoeff_ptr, dequant_ptr, eob_ptr, iscan, 1);
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
@@ -14,6 +14,176 @@
 #include "vp9/common/vp9_common.h"
 
 #if CONFIG_VP9_HIGHBITDEPTH
+// Returns the low 32 bits of (a * b) >> shift for each signed 32-bit lane,
+// with the product evaluated at 64-bit precision.
+static INLINE __m128i highbd_mul_shift_epi32(__m128i a, __m128i b,
+                                             int shift) {
+  const __m128i sign_a = _mm_srai_epi32(a, 31);
+  const __m128i sign_b = _mm_srai_epi32(b, 31);
+  const __m128i sign = _mm_xor_si128(sign_a, sign_b);
+  const __m128i sign_even = _mm_shuffle_epi32(sign, _MM_SHUFFLE(2, 2, 0, 0));
+  const __m128i sign_odd = _mm_shuffle_epi32(sign, _MM_SHUFFLE(3, 3, 1, 1));
+  const __m128i count = _mm_cvtsi32_si128(shift);
+  __m128i prod_even, prod_odd;
+
+  a = _mm_sub_epi32(_mm_xor_si128(a, sign_a), sign_a);
+  b = _mm_sub_epi32(_mm_xor_si128(b, sign_b), sign_b);
+  prod_even = _mm_mul_epu32(a, b);
+  prod_odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+  prod_even = _mm_sub_epi64(_mm_xor_si128(prod_even, sign_even), sign_even);
+  prod_odd = _mm_sub_epi64(_mm_xor_si128(prod_odd, sign_odd), sign_odd);
+  // A logical shift is sufficient: only bits below 48 are kept.
+  prod_even = _mm_srl_epi64(prod_even, count);
+  prod_odd = _mm_srl_epi64(prod_odd, count);
+  prod_even = _mm_shuffle_epi32(prod_even, _MM_SHUFFLE(3, 1, 2, 0));
+  prod_odd = _mm_shuffle_epi32(prod_odd, _MM_SHUFFLE(3, 1, 2, 0));
+  return _mm_unpacklo_epi32(prod_even, prod_odd);
+}
+
+// SSE2 has no _mm_mullo_epi32(); the low halves of the unsigned products are
+// identical to the signed ones.
+static INLINE __m128i highbd_mullo_epi32(__m128i a, __m128i b) {
+  __m128i prod_even = _mm_mul_epu32(a, b);
+  __m128i prod_odd = _mm_mul_epu32(_mm_srli_epi64(a, 32),
+                                   _mm_srli_epi64(b, 32));
+  prod_even = _mm_shuffle_epi32(prod_even, _MM_SHUFFLE(3, 1, 2, 0));
+  prod_odd = _mm_shuffle_epi32(prod_odd, _MM_SHUFFLE(3, 1, 2, 0));
+  return _mm_unpacklo_epi32(prod_even, prod_odd);
+}
+
+// Quantizes 4 coefficients and returns a mask of the nonzero outputs.
+static INLINE __m128i highbd_quantize_fp_4(const tran_low_t *coeff_ptr,
+                                           tran_low_t *qcoeff_ptr,
+                                           tran_low_t *dqcoeff_ptr,
+                                           __m128i round, __m128i quant,
+                                           __m128i dequant, __m128i thr,
+                                           int log_scale) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i coeff = _mm_load_si128((const __m128i *)coeff_ptr);
+  const __m128i coeff_sign = _mm_srai_epi32(coeff, 31);
+  const __m128i abs_coeff = _mm_sub_epi32(_mm_xor_si128(coeff, coeff_sign),
+                                          coeff_sign);
+  __m128i abs_qcoeff, qcoeff, dqcoeff;
+
+  abs_qcoeff = highbd_mul_shift_epi32(_mm_add_epi32(abs_coeff, round), quant,
+                                      16 - log_scale);
+  abs_qcoeff = _mm_andnot_si128(_mm_cmplt_epi32(abs_coeff, thr), abs_qcoeff);
+  qcoeff = _mm_sub_epi32(_mm_xor_si128(abs_qcoeff, coeff_sign), coeff_sign);
+  dqcoeff = highbd_mullo_epi32(qcoeff, dequant);
+  if (log_scale) {
+    // Signed division by 2, rounding towards zero.
+    dqcoeff = _mm_add_epi32(dqcoeff, _mm_srli_epi32(dqcoeff, 31));
+    dqcoeff = _mm_srai_epi32(dqcoeff, 1);
+  }
+  _mm_store_si128((__m128i *)qcoeff_ptr, qcoeff);
+  _mm_store_si128((__m128i *)dqcoeff_ptr, dqcoeff);
+  return _mm_cmpeq_epi32(abs_qcoeff, zero);
+}
+
+static INLINE void highbd_quantize_fp(const tran_low_t *coeff_ptr,
+                                      intptr_t n_coeffs, int skip_block,
+                                      const int16_t *round_ptr,
+                                      const int16_t *quant_ptr,
+                                      tran_low_t *qcoeff_ptr,
+                                      tran_low_t *dqcoeff_ptr,
+                                      const int16_t *dequant_ptr,
+                                      uint16_t *eob_ptr,
+                                      const int16_t *iscan,
+                                      int log_scale) {
+  const __m128i zero = _mm_setzero_si128();
+  const int round0 = log_scale ? ROUND_POWER_OF_TWO(round_ptr[0], 1)
+                               : round_ptr[0];
+  const int round1 = log_scale ? ROUND_POWER_OF_TWO(round_ptr[1], 1)
+                               : round_ptr[1];
+  // The 32x32 quantizer zeroes coefficients below a quarter of the step.
+  const int thr0 = log_scale ? dequant_ptr[0] >> 2 : 0;
+  const int thr1 = log_scale ? dequant_ptr[1] >> 2 : 0;
+  __m128i round = _mm_set_epi32(round1, round1, round1, round0);
+  __m128i quant = _mm_set_epi32(quant_ptr[1], quant_ptr[1], quant_ptr[1],
+                                quant_ptr[0]);
+  __m128i dequant = _mm_set_epi32(dequant_ptr[1], dequant_ptr[1],
+                                  dequant_ptr[1], dequant_ptr[0]);
+  __m128i thr = _mm_set_epi32(thr1, thr1, thr1, thr0);
+  __m128i eob = zero;
+  intptr_t i;
+
+  if (skip_block) {
+    memset(qcoeff_ptr, 0, n_coeffs * sizeof(*qcoeff_ptr));
+    memset(dqcoeff_ptr, 0, n_coeffs * sizeof(*dqcoeff_ptr));
+    *eob_ptr = 0;
+    return;
+  }
+
+  for (i = 0; i < n_coeffs; i += 8) {
+    __m128i zero_coeff0, zero_coeff1, nzero_coeff, iscan8;
+    zero_coeff0 = highbd_quantize_fp_4(coeff_ptr + i, qcoeff_ptr + i,
+                                       dqcoeff_ptr + i, round, quant, dequant,
+                                       thr, log_scale);
+    // Switch DC to AC.
+    round = _mm_unpackhi_epi64(round, round);
+    quant = _mm_unpackhi_epi64(quant, quant);
+    dequant = _mm_unpackhi_epi64(dequant, dequant);
+    thr = _mm_unpackhi_epi64(thr, thr);
+    zero_coeff1 = highbd_quantize_fp_4(coeff_ptr + i + 4, qcoeff_ptr + i + 4,
+                                       dqcoeff_ptr + i + 4, round, quant,
+                                       dequant, thr, log_scale);
+
+    // Scan for eob
+    nzero_coeff = _mm_cmpeq_epi16(_mm_packs_epi32(zero_coeff0, zero_coeff1),
+                                  zero);
+    iscan8 = _mm_load_si128((const __m128i *)(iscan + i));
+    // Add one to convert from indices to counts
+    iscan8 = _mm_sub_epi16(iscan8, nzero_coeff);
+    eob = _mm_max_epi16(eob, _mm_and_si128(iscan8, nzero_coeff));
+  }
+
+  // Accumulate EOB
+  eob = _mm_max_epi16(eob, _mm_shuffle_epi32(eob, 0xe));
+  eob = _mm_max_epi16(eob, _mm_shufflelo_epi16(eob, 0xe));
+  eob = _mm_max_epi16(eob, _mm_shufflelo_epi16(eob, 0x1));
+  *eob_ptr = _mm_extract_epi16(eob, 0);
+}
+
+void vp9_highbd_quantize_fp_sse2(const tran_low_t *coeff_ptr,
+                                 intptr_t count,
+                                 int skip_block,
+                                 const int16_t *zbin_ptr,
+                                 const int16_t *round_ptr,
+                                 const int16_t *quant_ptr,
+                                 const int16_t *quant_shift_ptr,
+                                 tran_low_t *qcoeff_ptr,
+                                 tran_low_t *dqcoeff_ptr,
+                                 const int16_t *dequant_ptr,
+                                 uint16_t *eob_ptr,
+                                 const int16_t *scan,
+                                 const int16_t *iscan) {
+  (void)zbin_ptr;
+  (void)quant_shift_ptr;
+  (void)scan;
+  highbd_quantize_fp(coeff_ptr, count, skip_block, round_ptr, quant_ptr,
+                     qcoeff_ptr, dqcoeff_ptr, dequant_ptr, eob_ptr, iscan, 0);
+}
+
+void vp9_highbd_quantize_fp_32x32_sse2(const tran_low_t *coeff_ptr,
+                                       intptr_t n_coeffs,
+                                       int skip_block,
+                                       const int16_t *zbin_ptr,
+                                       const int16_t *round_ptr,
+                                       const int16_t *quant_ptr,
+                                       const int16_t *quant_shift_ptr,
+                                       tran_low_t *qcoeff_ptr,
+                                       tran_low_t *dqcoeff_ptr,
+                                       const int16_t *dequant_ptr,
+                                       uint16_t *eob_ptr,
+                                       const int16_t *scan,
+                                       const int16_t *iscan) {
+  (void)zbin_ptr;
+  (void)quant_shift_ptr;
+  (void)scan;
+  highbd_quantize_fp(coeff_ptr, n_coeffs, skip_block, round_ptr, quant_ptr,
+                     qcoeff_ptr, dqcoeff_ptr, dequant_ptr, eob_ptr, iscan, 1);
+}
+
 // from vp9_idct.h: typedef int32_t tran_low_t;
 void vp9_highbd_quantize_b_sse2(const tran_low_t *coeff_ptr,
                                 intptr_t count,
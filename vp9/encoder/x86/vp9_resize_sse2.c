@@ -0,0 +1,163 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>  // SSE2
+
+#include "./vp9_rtcd.h"
+#include "./vpx_config.h"
+#include "vp9/common/vp9_filter.h"
+
+// Adds the four 32-bit lanes of each of a, b, c and d, returning the totals
+// in lanes 0 to 3 respectively.
+static INLINE __m128i sum_lanes_4(__m128i a, __m128i b, __m128i c,
+                                  __m128i d) {
+  const __m128i ab = _mm_add_epi32(_mm_unpacklo_epi32(a, b),
+                                   _mm_unpackhi_epi32(a, b));
+  const __m128i cd = _mm_add_epi32(_mm_unpacklo_epi32(c, d),
+                                   _mm_unpackhi_epi32(c, d));
+  return _mm_add_epi32(_mm_unpacklo_epi64(ab, cd), _mm_unpackhi_epi64(ab, cd));
+}
+
+static INLINE __m128i round_shift(__m128i sum) {
+  const __m128i rounding = _mm_set1_epi32(1 << (FILTER_BITS - 1));
+  return _mm_srai_epi32(_mm_add_epi32(sum, rounding), FILTER_BITS);
+}
+
+// Taps of 8 pixels held as 16-bit values, paired up in 32-bit lanes.
+static INLINE __m128i filter_taps(__m128i px, const int16_t *filter) {
+  return _mm_madd_epi16(px, _mm_loadu_si128((const __m128i *)filter));
+}
+
+// Broadcasts filter taps 2 * i and 2 * i + 1 to every pair of 16-bit lanes.
+static INLINE void load_tap_pairs(const int16_t *filter, __m128i pairs[4]) {
+  int i;
+  for (i = 0; i < 4; ++i)
+    pairs[i] = _mm_set1_epi32((int)((uint16_t)filter[2 * i] |
+                                    ((uint32_t)(uint16_t)filter[2 * i + 1]
+                                     << 16)));
+}
+
+// Filters 8 columns down the 8 rows in rows[], returning the unclipped
+// results of columns 0 to 3 in lo and 4 to 7 in hi.
+static INLINE void filter_cols(const __m128i rows[8], const __m128i pairs[4],
+                               __m128i *lo, __m128i *hi) {
+  __m128i sum_lo = _mm_setzero_si128();
+  __m128i sum_hi = _mm_setzero_si128();
+  int i;
+  for (i = 0; i < 4; ++i) {
+    const __m128i a = rows[2 * i];
+    const __m128i b = rows[2 * i + 1];
+    sum_lo = _mm_add_epi32(sum_lo,
+                           _mm_madd_epi16(_mm_unpacklo_epi16(a, b), pairs[i]));
+    sum_hi = _mm_add_epi32(sum_hi,
+                           _mm_madd_epi16(_mm_unpackhi_epi16(a, b), pairs[i]));
+  }
+  *lo = round_shift(sum_lo);
+  *hi = round_shift(sum_hi);
+}
+
+void vp9_resize_filter_horz_sse2(const uint8_t *src, uint8_t *dst, int w,
+                                 const int *offsets,
+                                 const int16_t *const *filters) {
+  const __m128i zero = _mm_setzero_si128();
+  int x, i;
+
+  for (x = 0; x + 4 <= w; x += 4) {
+    __m128i sums[4], res;
+    for (i = 0; i < 4; ++i) {
+      const __m128i px = _mm_loadl_epi64((const __m128i *)(src +
+                                                           offsets[x + i]));
+      sums[i] = filter_taps(_mm_unpacklo_epi8(px, zero), filters[x + i]);
+    }
+    res = round_shift(sum_lanes_4(sums[0], sums[1], sums[2], sums[3]));
+    res = _mm_packs_epi32(res, res);
+    *(int *)(dst + x) = _mm_cvtsi128_si32(_mm_packus_epi16(res, res));
+  }
+
+  vp9_resize_filter_horz_c(src, dst + x, w - x, offsets + x, filters + x);
+}
+
+void vp9_resize_filter_vert_sse2(const uint8_t *const *src, uint8_t *dst,
+                                 int w, const int16_t *filter) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i pairs[4];
+  int x, k;
+
+  load_tap_pairs(filter, pairs);
+  for (x = 0; x + 8 <= w; x += 8) {
+    __m128i rows[8], lo, hi;
+    for (k = 0; k < 8; ++k)
+      rows[k] = _mm_unpacklo_epi8(
+          _mm_loadl_epi64((const __m128i *)(src[k] + x)), zero);
+    filter_cols(rows, pairs, &lo, &hi);
+    lo = _mm_packs_epi32(lo, hi);
+    _mm_storel_epi64((__m128i *)(dst + x), _mm_packus_epi16(lo, lo));
+  }
+
+  if (x < w) {
+    const uint8_t *tail[8];
+    for (k = 0; k < 8; ++k)
+      tail[k] = src[k] + x;
+    vp9_resize_filter_vert_c(tail, dst + x, w - x, filter);
+  }
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+static INLINE __m128i clip_highbd(__m128i val, int bd) {
+  const __m128i max = _mm_set1_epi16((1 << bd) - 1);
+  return _mm_min_epi16(_mm_max_epi16(val, _mm_setzero_si128()), max);
+}
+
+void vp9_highbd_resize_filter_horz_sse2(const uint16_t *src, uint16_t *dst,
+                                        int w, const int *offsets,
+                                        const int16_t *const *filters,
+                                        int bd) {
+  int x, i;
+
+  for (x = 0; x + 4 <= w; x += 4) {
+    __m128i sums[4], res;
+    for (i = 0; i < 4; ++i) {
+      const __m128i px = _mm_loadu_si128((const __m128i *)(src +
+                                                           offsets[x + i]));
+      sums[i] = filter_taps(px, filters[x + i]);
+    }
+    res = round_shift(sum_lanes_4(sums[0], sums[1], sums[2], sums[3]));
+    res = clip_highbd(_mm_packs_epi32(res, res), bd);
+    _mm_storel_epi64((__m128i *)(dst + x), res);
+  }
+
+  vp9_highbd_resize_filter_horz_c(src, dst + x, w - x, offsets + x,
+                                  filters + x, bd);
+}
+
+void vp9_highbd_resize_filter_vert_sse2(const uint16_t *const *src,
+                                        uint16_t *dst, int w,
+                                        const int16_t *filter, int bd) {
+  __m128i pairs[4];
+  int x, k;
+
+  load_tap_pairs(filter, pairs);
+  for (x = 0; x + 8 <= w; x += 8) {
+    __m128i rows[8], lo, hi;
+    for (k = 0; k < 8; ++k)
+      rows[k] = _mm_loadu_si128((const __m128i *)(src[k] + x));
+    filter_cols(rows, pairs, &lo, &hi);
+    _mm_storeu_si128((__m128i *)(dst + x),
+                     clip_highbd(_mm_packs_epi32(lo, hi), bd));
+  }
+
+  if (x < w) {
+    const uint16_t *tail[8];
+    for (k = 0; k < 8; ++k)
+      tail[k] = src[k] + x;
+    vp9_highbd_resize_filter_vert_c(tail, dst + x, w - x, filter, bd);
+  }
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>  // SSE2
+
+#include "./vp9_rtcd.h"
+#include "./vpx_config.h"
+
+// Running sums for four 4x4 blocks. Each 32-bit lane holds the sum of a
+// horizontal pixel pair; lo covers blocks 0 and 1, hi blocks 2 and 3.
+typedef struct {
+  __m128i s[2], r[2], sq_s[2], sq_r[2], sxr[2];
+} SsimSums;
+
+static INLINE void init_sums(SsimSums *sums) {
+  int i;
+  for (i = 0; i < 2; ++i) {
+    sums->s[i] = _mm_setzero_si128();
+    sums->r[i] = _mm_setzero_si128();
+    sums->sq_s[i] = _mm_setzero_si128();
+    sums->sq_r[i] = _mm_setzero_si128();
+    sums->sxr[i] = _mm_setzero_si128();
+  }
+}
+
+// Adds 8 pixels of a row, held as 16-bit values no larger than 12 bits.
+static INLINE void accumulate_row(SsimSums *sums, int i, __m128i s,
+                                  __m128i r) {
+  const __m128i one = _mm_set1_epi16(1);
+  sums->s[i] = _mm_add_epi32(sums->s[i], _mm_madd_epi16(s, one));
+  sums->r[i] = _mm_add_epi32(sums->r[i], _mm_madd_epi16(r, one));
+  sums->sq_s[i] = _mm_add_epi32(sums->sq_s[i], _mm_madd_epi16(s, s));
+  sums->sq_r[i] = _mm_add_epi32(sums->sq_r[i], _mm_madd_epi16(r, r));
+  sums->sxr[i] = _mm_add_epi32(sums->sxr[i], _mm_madd_epi16(s, r));
+}
+
+// Adds the pixel pairs of each block and stores the four block sums.
+static INLINE void store_sums(__m128i lo, __m128i hi, uint32_t *dst) {
+  const __m128i a = _mm_shuffle_epi32(lo, _MM_SHUFFLE(3, 1, 2, 0));
+  const __m128i b = _mm_shuffle_epi32(hi, _MM_SHUFFLE(3, 1, 2, 0));
+  _mm_storeu_si128((__m128i *)dst, _mm_add_epi32(_mm_unpacklo_epi64(a, b),
+                                                 _mm_unpackhi_epi64(a, b)));
+}
+
+static INLINE void store_all_sums(const SsimSums *sums, int b,
+                                  uint32_t *sum_s, uint32_t *sum_r,
+                                  uint32_t *sum_sq_s, uint32_t *sum_sq_r,
+                                  uint32_t *sum_sxr) {
+  store_sums(sums->s[0], sums->s[1], sum_s + b);
+  store_sums(sums->r[0], sums->r[1], sum_r + b);
+  store_sums(sums->sq_s[0], sums->sq_s[1], sum_sq_s + b);
+  store_sums(sums->sq_r[0], sums->sq_r[1], sum_sq_r + b);
+  store_sums(sums->sxr[0], sums->sxr[1], sum_sxr + b);
+}
+
+void vp9_ssim_parms_4x4_row_sse2(const uint8_t *s, int sp, const uint8_t *r,
+                                 int rp, int blocks, uint32_t *sum_s,
+                                 uint32_t *sum_r, uint32_t *sum_sq_s,
+                                 uint32_t *sum_sq_r, uint32_t *sum_sxr) {
+  const __m128i zero = _mm_setzero_si128();
+  int b, i;
+
+  for (b = 0; b + 4 <= blocks; b += 4) {
+    SsimSums sums;
+    init_sums(&sums);
+    for (i = 0; i < 4; ++i) {
+      const __m128i s8 = _mm_loadu_si128((const __m128i *)(s + i * sp + 4 * b));
+      const __m128i r8 = _mm_loadu_si128((const __m128i *)(r + i * rp + 4 * b));
+      accumulate_row(&sums, 0, _mm_unpacklo_epi8(s8, zero),
+                     _mm_unpacklo_epi8(r8, zero));
+      accumulate_row(&sums, 1, _mm_unpackhi_epi8(s8, zero),
+                     _mm_unpackhi_epi8(r8, zero));
+    }
+    store_all_sums(&sums, b, sum_s, sum_r, sum_sq_s, sum_sq_r, sum_sxr);
+  }
+
+  vp9_ssim_parms_4x4_row_c(s + 4 * b, sp, r + 4 * b, rp, blocks - b,
+                           sum_s + b, sum_r + b, sum_sq_s + b, sum_sq_r + b,
+                           sum_sxr + b);
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+void vp9_highbd_ssim_parms_4x4_row_sse2(const uint16_t *s, int sp,
+                                        const uint16_t *r, int rp, int blocks,
+                                        uint32_t *sum_s, uint32_t *sum_r,
+                                        uint32_t *sum_sq_s, uint32_t *sum_sq_r,
+                                        uint32_t *sum_sxr) {
+  int b, i, j;
+
+  for (b = 0; b + 4 <= blocks; b += 4) {
+    SsimSums sums;
+    init_sums(&sums);
+    for (i = 0; i < 4; ++i) {
+      for (j = 0; j < 2; ++j) {
+        const __m128i s16 =
+            _mm_loadu_si128((const __m128i *)(s + i * sp + 4 * b + 8 * j));
+        const __m128i r16 =
+            _mm_loadu_si128((const __m128i *)(r + i * rp + 4 * b + 8 * j));
+        accumulate_row(&sums, j, s16, r16);
+      }
+    }
+    store_all_sums(&sums, b, sum_s, sum_r, sum_sq_s, sum_sq_r, sum_sxr);
+  }
+
+  vp9_highbd_ssim_parms_4x4_row_c(s + 4 * b, sp, r + 4 * b, rp, blocks - b,
+                                  sum_s + b, sum_r + b, sum_sq_s + b,
+                                  sum_sq_r + b, sum_sxr + b);
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
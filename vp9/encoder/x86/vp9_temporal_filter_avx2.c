@@ -0,0 +1,180 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vp9_rtcd.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+
+// Filters 8 pixels held as 32-bit lanes and updates the matching accumulator
+// and count entries. Mirrors vp9_temporal_filter_apply_c():
+//   modifier = 16 - min(16, (3 * diff * diff + rounding) >> strength)
+static INLINE void apply_8(__m256i src, __m256i pixel, __m128i strength,
+                           __m256i rounding, __m256i filter_weight,
+                           unsigned int *accumulator, uint16_t *count) {
+  const __m256i sixteen = _mm256_set1_epi32(16);
+  const __m256i diff = _mm256_sub_epi32(src, pixel);
+  __m256i modifier = _mm256_mullo_epi32(diff, diff);
+  __m256i acc, modifier16;
+  __m128i cnt;
+
+  modifier = _mm256_add_epi32(modifier, _mm256_add_epi32(modifier, modifier));
+  modifier = _mm256_add_epi32(modifier, rounding);
+  modifier = _mm256_srl_epi32(modifier, strength);
+  modifier = _mm256_min_epu32(modifier, sixteen);
+  modifier = _mm256_sub_epi32(sixteen, modifier);
+  modifier = _mm256_mullo_epi32(modifier, filter_weight);
+
+  // The modifier is at most 32, so it packs losslessly into 16 bits.
+  modifier16 = _mm256_packus_epi32(modifier, modifier);
+  modifier16 = _mm256_permute4x64_epi64(modifier16, 0x08);
+  cnt = _mm_loadu_si128((const __m128i *)count);
+  cnt = _mm_add_epi16(cnt, _mm256_castsi256_si128(modifier16));
+  _mm_storeu_si128((__m128i *)count, cnt);
+
+  acc = _mm256_loadu_si256((const __m256i *)accumulator);
+  acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(modifier, pixel));
+  _mm256_storeu_si256((__m256i *)accumulator, acc);
+}
+
+void vp9_temporal_filter_apply_avx2(uint8_t *frame1,
+                                    unsigned int stride,
+                                    uint8_t *frame2,
+                                    unsigned int block_width,
+                                    unsigned int block_height,
+                                    int strength,
+                                    int filter_weight,
+                                    unsigned int *accumulator,
+                                    uint16_t *count) {
+  const __m128i shift = _mm_cvtsi32_si128(strength);
+  const __m256i rounding =
+      _mm256_set1_epi32(strength > 0 ? 1 << (strength - 1) : 0);
+  const __m256i weight = _mm256_set1_epi32(filter_weight);
+  unsigned int i, j;
+
+  for (i = 0; i < block_height; i++) {
+    for (j = 0; j < block_width; j += 8) {
+      const __m256i src = _mm256_cvtepu8_epi32(
+          _mm_loadl_epi64((const __m128i *)(frame1 + j)));
+      const __m256i pixel = _mm256_cvtepu8_epi32(
+          _mm_loadl_epi64((const __m128i *)(frame2 + j)));
+      apply_8(src, pixel, shift, rounding, weight, accumulator + j,
+              count + j);
+    }
+    frame1 += stride;
+    frame2 += block_width;
+    accumulator += block_width;
+    count += block_width;
+  }
+}
+
+// Computes (accumulator + count / 2) * (0x80000 / count) >> 19 for 8 pixels,
+// matching the fixed_divide[] lookup in vp9_temporal_filter.c. The quotient is
+// formed in double precision, which is exact for counts below 512.
+static INLINE __m256i normalize_8(const unsigned int *accumulator,
+                                  const uint16_t *count) {
+  const __m256d numerator = _mm256_set1_pd((double)0x80000);
+  const __m256i cnt = _mm256_cvtepu16_epi32(
+      _mm_loadu_si128((const __m128i *)count));
+  const __m256i acc = _mm256_loadu_si256((const __m256i *)accumulator);
+  const __m256i nonzero = _mm256_xor_si256(
+      _mm256_cmpeq_epi32(cnt, _mm256_setzero_si256()),
+      _mm256_set1_epi32(-1));
+  const __m128i div_lo = _mm256_cvttpd_epi32(_mm256_div_pd(
+      numerator, _mm256_cvtepi32_pd(_mm256_castsi256_si128(cnt))));
+  const __m128i div_hi = _mm256_cvttpd_epi32(_mm256_div_pd(
+      numerator, _mm256_cvtepi32_pd(_mm256_extracti128_si256(cnt, 1))));
+  __m256i divisor = _mm256_inserti128_si256(_mm256_castsi128_si256(div_lo),
+                                            div_hi, 1);
+  __m256i pval;
+
+  divisor = _mm256_and_si256(divisor, nonzero);
+  pval = _mm256_add_epi32(acc, _mm256_srli_epi32(cnt, 1));
+  pval = _mm256_mullo_epi32(pval, divisor);
+  return _mm256_srli_epi32(pval, 19);
+}
+
+void vp9_temporal_filter_normalize_avx2(const unsigned int *accumulator,
+                                        const uint16_t *count,
+                                        unsigned int block_width,
+                                        unsigned int block_height,
+                                        uint8_t *dst, int stride) {
+  unsigned int i, j;
+
+  for (i = 0; i < block_height; i++) {
+    for (j = 0; j < block_width; j += 8) {
+      const __m256i pval = normalize_8(accumulator + j, count + j);
+      // Results are at most 255, so the saturating packs are lossless.
+      __m128i out = _mm_packus_epi32(_mm256_castsi256_si128(pval),
+                                     _mm256_extracti128_si256(pval, 1));
+      out = _mm_packus_epi16(out, out);
+      _mm_storel_epi64((__m128i *)(dst + j), out);
+    }
+    dst += stride;
+    accumulator += block_width;
+    count += block_width;
+  }
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+void vp9_highbd_temporal_filter_apply_avx2(uint8_t *frame1_8,
+                                           unsigned int stride,
+                                           uint8_t *frame2_8,
+                                           unsigned int block_width,
+                                           unsigned int block_height,
+                                           int strength,
+                                           int filter_weight,
+                                           unsigned int *accumulator,
+                                           uint16_t *count) {
+  const uint16_t *frame1 = CONVERT_TO_SHORTPTR(frame1_8);
+  const uint16_t *frame2 = CONVERT_TO_SHORTPTR(frame2_8);
+  const __m128i shift = _mm_cvtsi32_si128(strength);
+  const __m256i rounding =
+      _mm256_set1_epi32(strength > 0 ? 1 << (strength - 1) : 0);
+  const __m256i weight = _mm256_set1_epi32(filter_weight);
+  unsigned int i, j;
+
+  for (i = 0; i < block_height; i++) {
+    for (j = 0; j < block_width; j += 8) {
+      const __m256i src = _mm256_cvtepu16_epi32(
+          _mm_loadu_si128((const __m128i *)(frame1 + j)));
+      const __m256i pixel = _mm256_cvtepu16_epi32(
+          _mm_loadu_si128((const __m128i *)(frame2 + j)));
+      apply_8(src, pixel, shift, rounding, weight, accumulator + j,
+              count + j);
+    }
+    frame1 += stride;
+    frame2 += block_width;
+    accumulator += block_width;
+    count += block_width;
+  }
+}
+
+void vp9_highbd_temporal_filter_normalize_avx2(
+    const unsigned int *accumulator, const uint16_t *count,
+    unsigned int block_width, unsigned int block_height,
+    uint8_t *dst8, int stride) {
+  uint16_t *dst = CONVERT_TO_SHORTPTR(dst8);
+  unsigned int i, j;
+
+  for (i = 0; i < block_height; i++) {
+    for (j = 0; j < block_width; j += 8) {
+      const __m256i pval = normalize_8(accumulator + j, count + j);
+      _mm_storeu_si128((__m128i *)(dst + j),
+                       _mm_packus_epi32(_mm256_castsi256_si128(pval),
+                                        _mm256_extracti128_si256(pval, 1)));
+    }
+    dst += stride;
+    accumulator += block_width;
+    count += block_width;
+  }
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vp9_rtcd.h"
+#include "vpx_ports/mem.h"
+#include "vp9/encoder/vp9_tokenize.h"
+
+int vp9_coeff_run_cost_avx2(const tran_low_t *qcoeff, const int16_t *scan,
+                            int eob, uint8_t *tokens,
+                            const int16_t *cat6_high_cost) {
+  const __m256i cat6_min = _mm256_set1_epi32(CAT6_MIN_VAL);
+  const __m256i cat6_min_neg = _mm256_set1_epi32(-CAT6_MIN_VAL);
+  const __m256i token_mask = _mm256_set1_epi32(0xf);
+  __m256i sum = _mm256_setzero_si256();
+  __m128i sum128;
+  int cost = 0;
+  int c;
+
+  for (c = 0; c + 8 <= eob; c += 8) {
+    DECLARE_ALIGNED(32, int32_t, v[8]);
+    __m256i values, packed, token16;
+    __m128i token8;
+    int i, cat6;
+
+    // The scan makes the coefficient loads scattered; everything after them
+    // works on 8 coefficients at a time.
+    for (i = 0; i < 8; ++i)
+      v[i] = qcoeff[scan[c + i]];
+    values = _mm256_load_si256((const __m256i *)v);
+
+    // Values of CAT6_MIN_VAL and above in magnitude hit the table's end
+    // entries, which hold CATEGORY6_TOKEN and no cost.
+    values = _mm256_min_epi32(_mm256_max_epi32(values, cat6_min_neg),
+                              cat6_min);
+    packed = _mm256_i32gather_epi32((const int *)vp9_dct_value_token_cost,
+                                    values, 4);
+    sum = _mm256_add_epi32(sum, _mm256_srai_epi32(packed, 4));
+
+    token16 = _mm256_packs_epi32(_mm256_and_si256(packed, token_mask),
+                                 _mm256_setzero_si256());
+    token16 = _mm256_permute4x64_epi64(token16, 0xd8);
+    token8 = _mm_packus_epi16(_mm256_castsi256_si128(token16),
+                              _mm_setzero_si128());
+    _mm_storel_epi64((__m128i *)(tokens + c), token8);
+
+    cat6 = _mm256_movemask_ps(_mm256_castsi256_ps(
+        _mm256_cmpeq_epi32(_mm256_abs_epi32(values), cat6_min)));
+    for (i = 0; cat6; ++i, cat6 >>= 1) {
+      if (cat6 & 1) {
+        int16_t token;
+        cost += vp9_get_token_cost(v[i], &token, cat6_high_cost);
+      }
+    }
+  }
+
+  sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                         _mm256_extracti128_si256(sum, 1));
+  sum128 = _mm_add_epi32(sum128, _mm_srli_si128(sum128, 8));
+  sum128 = _mm_add_epi32(sum128, _mm_srli_si128(sum128, 4));
+  cost += _mm_cvtsi128_si32(sum128);
+
+  return cost + vp9_coeff_run_cost_c(qcoeff, scan + c, eob - c, tokens + c,
+                                     cat6_high_cost);
+}
@@ -82,6 +82,8 @@ VP9_COMMON_SRCS-$(HAVE_SSSE3) += common/x86/vp9_subpixel_8t_intrin_ssse3.c
 ifeq ($(CONFIG_VP9_POSTPROC),yes)
 VP9_COMMON_SRCS-$(HAVE_SSE2) += common/x86/vp9_mfqe_sse2.asm
 VP9_COMMON_SRCS-$(HAVE_SSE2) += common/x86/vp9_postproc_sse2.asm
+VP9_COMMON_SRCS-$(HAVE_AVX2) += common/x86/vp9_mfqe_avx2.c
+VP9_COMMON_SRCS-$(HAVE_AVX2) += common/x86/vp9_postproc_avx2.c
 endif
 
 ifeq ($(CONFIG_USE_X86INC),yes)
@@ -142,6 +144,7 @@ endif
 
 VP9_COMMON_SRCS-$(HAVE_SSE2) += common/x86/vp9_idct_intrin_sse2.c
 VP9_COMMON_SRCS-$(HAVE_SSE2) += common/x86/vp9_idct_intrin_sse2.h
+VP9_COMMON_SRCS-$(HAVE_SSE2) += common/x86/vp9_prob_sse2.c
 
 ifeq ($(ARCH_X86_64), yes)
 ifeq ($(CONFIG_USE_X86INC),yes)
@@ -13,6 +13,7 @@
 
 #include "./vpx_config.h"
 #include "vpx/vpx_encoder.h"
+#include "vpx_mem/vpx_arena.h"
 #include "vpx_ports/vpx_once.h"
 #include "vpx/internal/vpx_codec_internal.h"
 #include "./vpx_version.h"
@@ -45,6 +46,9 @@ struct vp9_extracfg {
   vpx_bit_depth_t             bit_depth;
   vp9e_tune_content           content;
   vpx_color_space_t           color_space;
+  unsigned int                mem_budget;  // In kilobytes.
+  unsigned int                max_frame_width;
+  unsigned int                max_frame_height;
 };
 
 static struct vp9_extracfg default_extra_cfg = {
@@ -71,8 +75,15 @@ static struct vp9_extracfg default_extra_cfg = {
   VPX_BITS_8,                 // Bit depth
   VP9E_CONTENT_DEFAULT,       // content
   VPX_CS_UNKNOWN,             // color space
+  0,                          // mem_budget
+  0,                          // max_frame_width
+  0,                          // max_frame_height
 };
 
+// Size of the slabs the encoder's long lived state is built from. The
+// VP9_COMP structure takes most of the first one.
+#define ENCODER_ARENA_SLAB_SIZE (1 << 20)
+
 struct vpx_codec_alg_priv {
   vpx_codec_priv_t        base;
   vpx_codec_enc_cfg_t     cfg;
@@ -94,6 +105,8 @@ struct vpx_codec_alg_priv {
   vpx_codec_priv_output_cx_pkt_cb_pair_t output_cx_pkt_cb;
   // BufferPool that holds all reference frames.
   BufferPool              *buffer_pool;
+  // Holds this structure, the buffer pool and the encoder.
+  vpx_arena_t             *arena;
 };
 
 static VP9_REFFRAME ref_frame_to_vp9_reframe(vpx_ref_frame_type_t frame) {
@@ -243,6 +256,8 @@ static vpx_codec_err_t validate_config(vpx_codec_alg_priv_t *ctx,
   RANGE_CHECK(extra_cfg, arnr_max_frames, 0, 15);
   RANGE_CHECK_HI(extra_cfg, arnr_strength, 6);
   RANGE_CHECK(extra_cfg, cq_level, 0, 63);
+  RANGE_CHECK_HI(extra_cfg, max_frame_width, 65535);
+  RANGE_CHECK_HI(extra_cfg, max_frame_height, 65535);
   RANGE_CHECK(cfg, g_bit_depth, VPX_BITS_8, VPX_BITS_12);
   RANGE_CHECK(cfg, g_input_bit_depth, 8, 12);
   RANGE_CHECK(extra_cfg, content,
@@ -384,6 +399,9 @@ static vpx_codec_err_t set_encoder_config(
   int sl, tl;
   oxcf->profile = cfg->g_profile;
   oxcf->max_threads = (int)cfg->g_threads;
+  oxcf->mem_budget = extra_cfg->mem_budget;
+  oxcf->max_frame_width = extra_cfg->max_frame_width;
+  oxcf->max_frame_height = extra_cfg->max_frame_height;
   oxcf->width   = cfg->g_w;
   oxcf->height  = cfg->g_h;
   oxcf->bit_depth = cfg->g_bit_depth;
@@ -756,6 +774,25 @@ static vpx_codec_err_t ctrl_set_max_gf_interval(vpx_codec_alg_priv_t *ctx,
   return update_extra_cfg(ctx, &extra_cfg);
 }
 
+static vpx_codec_err_t ctrl_set_mem_budget(vpx_codec_alg_priv_t *ctx,
+                                           va_list args) {
+  struct vp9_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.mem_budget = CAST(VP9E_SET_MEM_BUDGET, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static vpx_codec_err_t ctrl_set_max_frame_size(vpx_codec_alg_priv_t *ctx,
+                                               va_list args) {
+  struct vp9_extracfg extra_cfg = ctx->extra_cfg;
+  const vpx_max_frame_size_t *const size =
+      va_arg(args, const vpx_max_frame_size_t *);
+  if (size == NULL)
+    return VPX_CODEC_INVALID_PARAM;
+  extra_cfg.max_frame_width = size->width;
+  extra_cfg.max_frame_height = size->height;
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
 static vpx_codec_err_t ctrl_set_frame_periodic_boost(vpx_codec_alg_priv_t *ctx,
                                                      va_list args) {
   struct vp9_extracfg extra_cfg = ctx->extra_cfg;
@@ -763,21 +800,28 @@ static vpx_codec_err_t ctrl_set_frame_periodic_boost(vpx_codec_alg_priv_t *ctx,
   return update_extra_cfg(ctx, &extra_cfg);
 }
 
-static vpx_codec_err_t encoder_init(vpx_codec_ctx_t *ctx,
-                                    vpx_codec_priv_enc_mr_cfg_t *data) {
+static vpx_codec_err_t encoder_init(
+    vpx_codec_ctx_t *ctx, vpx_codec_priv_enc_mr_cfg_t *data,
+    const vpx_codec_mem_allocator_t *allocator) {
   vpx_codec_err_t res = VPX_CODEC_OK;
   (void)data;
 
   if (ctx->priv == NULL) {
-    vpx_codec_alg_priv_t *const priv = vpx_calloc(1, sizeof(*priv));
-    if (priv == NULL)
+    vpx_arena_t *const arena = vpx_arena_create(allocator,
+                                                ENCODER_ARENA_SLAB_SIZE);
+    vpx_codec_alg_priv_t *const priv =
+        arena ? vpx_arena_calloc(arena, 1, sizeof(*priv)) : NULL;
+    if (priv == NULL) {
+      vpx_arena_destroy(arena);
       return VPX_CODEC_MEM_ERROR;
+    }
 
     ctx->priv = (vpx_codec_priv_t *)priv;
     ctx->priv->init_flags = ctx->init_flags;
     ctx->priv->enc.total_encoders = 1;
+    priv->arena = arena;
     priv->buffer_pool =
-        (BufferPool *)vpx_calloc(1, sizeof(BufferPool));
+        (BufferPool *)vpx_arena_calloc(arena, 1, sizeof(BufferPool));
     if (priv->buffer_pool == NULL)
       return VPX_CODEC_MEM_ERROR;
 
@@ -804,7 +848,8 @@ static vpx_codec_err_t encoder_init(vpx_codec_ctx_t *ctx,
       priv->oxcf.use_highbitdepth =
           (ctx->init_flags & VPX_CODEC_USE_HIGHBITDEPTH) ? 1 : 0;
 #endif
-      priv->cpi = vp9_create_compressor(&priv->oxcf, priv->buffer_pool);
+      priv->cpi = vp9_create_compressor(&priv->oxcf, priv->buffer_pool,
+                                        arena);
       if (priv->cpi == NULL)
         res = VPX_CODEC_MEM_ERROR;
       else
@@ -819,10 +864,10 @@ static vpx_codec_err_t encoder_destroy(vpx_codec_alg_priv_t *ctx) {
   free(ctx->cx_data);
   vp9_remove_compressor(ctx->cpi);
 #if CONFIG_MULTITHREAD
-  pthread_mutex_destroy(&ctx->buffer_pool->pool_mutex);
+  if (ctx->buffer_pool != NULL)
+    pthread_mutex_destroy(&ctx->buffer_pool->pool_mutex);
 #endif
-  vpx_free(ctx->buffer_pool);
-  vpx_free(ctx);
+  vpx_arena_destroy(ctx->arena);
   return VPX_CODEC_OK;
 }
 
@@ -1320,6 +1365,28 @@ static vpx_codec_err_t ctrl_get_active_map(vpx_codec_alg_priv_t *ctx,
   }
 }
 
+static vpx_codec_err_t ctrl_get_mem_footprint(vpx_codec_alg_priv_t *ctx,
+                                              va_list args) {
+  vp9_mem_footprint_t *const fp = va_arg(args, vp9_mem_footprint_t *);
+
+  if (fp == NULL)
+    return VPX_CODEC_INVALID_PARAM;
+
+  vp9_get_mem_footprint(ctx->cpi, fp);
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_frame_placement(vpx_codec_alg_priv_t *ctx,
+                                                va_list args) {
+  const int placement = frame_placement_to_mem_flags(va_arg(args, int));
+
+  if (placement < 0)
+    return VPX_CODEC_INVALID_PARAM;
+
+  vp9_set_frame_placement(ctx->cpi, placement);
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t ctrl_set_scale_mode(vpx_codec_alg_priv_t *ctx,
                                            va_list args) {
   vpx_scaling_mode_t *const mode = va_arg(args, vpx_scaling_mode_t *);
@@ -1475,6 +1542,8 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   {VP9E_SET_NOISE_SENSITIVITY,        ctrl_set_noise_sensitivity},
   {VP9E_SET_MIN_GF_INTERVAL,          ctrl_set_min_gf_interval},
   {VP9E_SET_MAX_GF_INTERVAL,          ctrl_set_max_gf_interval},
+  {VP9E_SET_MEM_BUDGET,               ctrl_set_mem_budget},
+  {VP9E_SET_MAX_FRAME_SIZE,           ctrl_set_max_frame_size},
 
   // Getters
   {VP8E_GET_LAST_QUANTIZER,           ctrl_get_quantizer},
@@ -1482,6 +1551,8 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   {VP9_GET_REFERENCE,                 ctrl_get_reference},
   {VP9E_GET_SVC_LAYER_ID,             ctrl_get_svc_layer_id},
   {VP9E_GET_ACTIVEMAP,                ctrl_get_active_map},
+  {VP9_GET_MEM_FOOTPRINT,             ctrl_get_mem_footprint},
+  {VP9_SET_FRAME_PLACEMENT,           ctrl_set_frame_placement},
 
   { -1, NULL},
 };
@@ -1559,7 +1630,8 @@ CODEC_INTERFACE(vpx_codec_vp9_cx) = {
 #if CONFIG_VP9_HIGHBITDEPTH
   VPX_CODEC_CAP_HIGHBITDEPTH |
 #endif
-  VPX_CODEC_CAP_ENCODER | VPX_CODEC_CAP_PSNR,  // vpx_codec_caps_t
+  VPX_CODEC_CAP_ENCODER | VPX_CODEC_CAP_PSNR |
+  VPX_CODEC_CAP_MEM_ALLOCATOR,  // vpx_codec_caps_t
   encoder_init,       // vpx_codec_init_fn_t
   encoder_destroy,    // vpx_codec_destroy_fn_t
   encoder_ctrl_maps,  // vpx_codec_ctrl_fn_map_t
@@ -17,6 +17,7 @@
 #include "vpx/internal/vpx_codec_internal.h"
 #include "vpx/vp8dx.h"
 #include "vpx/vpx_decoder.h"
+#include "vpx_mem/vpx_arena.h"
 #include "vpx_util/vpx_thread.h"
 
 #include "vp9/common/vp9_alloccommon.h"
@@ -36,6 +37,10 @@ typedef vpx_codec_stream_info_t vp9_stream_info_t;
 // TODO(hkuang): Remove this limit after implementing ondemand framebuffers.
 #define FRAME_CACHE_SIZE 6   // Cache maximum 6 decoded frames.
 
+// Size of the slabs the decoder's long lived state is built from. One slab
+// holds everything a single threaded decoder needs.
+#define DECODER_ARENA_SLAB_SIZE (64 << 10)
+
 typedef struct cache_frame {
   int fb_idx;
   vpx_image_t img;
@@ -56,6 +61,8 @@ struct vpx_codec_alg_priv {
   int                     last_show_frame;  // Index of last output frame.
   int                     byte_alignment;
   int                     skip_loop_filter;
+  int                     frame_pool;  // VP9D_FRAME_POOL_* flags.
+  int                     frame_placement;  // VPX_MEM_* flags.
 
   // Frame parallel related.
   int                     frame_parallel_decode;  // frame-based threading.
@@ -72,6 +79,8 @@ struct vpx_codec_alg_priv {
   int                     need_resync;      // wait for key/intra-only frame
   // BufferPool that holds all reference frames. Shared by all the FrameWorkers.
   BufferPool              *buffer_pool;
+  // Holds this structure, the buffer pool and the frame workers' decoders.
+  vpx_arena_t             *arena;
 
   // External frame buffer info to save for VP9 common.
   void *ext_priv;  // Private data associated with the external frame buffers.
@@ -79,20 +88,27 @@ struct vpx_codec_alg_priv {
   vpx_release_frame_buffer_cb_fn_t release_ext_fb_cb;
 };
 
-static vpx_codec_err_t decoder_init(vpx_codec_ctx_t *ctx,
-                                    vpx_codec_priv_enc_mr_cfg_t *data) {
+static vpx_codec_err_t decoder_init(
+    vpx_codec_ctx_t *ctx, vpx_codec_priv_enc_mr_cfg_t *data,
+    const vpx_codec_mem_allocator_t *allocator) {
   // This function only allocates space for the vpx_codec_alg_priv_t
   // structure. More memory may be required at the time the stream
   // information becomes known.
   (void)data;
 
   if (!ctx->priv) {
-    vpx_codec_alg_priv_t *const priv = vpx_calloc(1, sizeof(*priv));
-    if (priv == NULL)
+    vpx_arena_t *const arena = vpx_arena_create(allocator,
+                                                DECODER_ARENA_SLAB_SIZE);
+    vpx_codec_alg_priv_t *const priv =
+        arena ? vpx_arena_calloc(arena, 1, sizeof(*priv)) : NULL;
+    if (priv == NULL) {
+      vpx_arena_destroy(arena);
       return VPX_CODEC_MEM_ERROR;
+    }
 
     ctx->priv = (vpx_codec_priv_t *)priv;
     ctx->priv->init_flags = ctx->init_flags;
+    priv->arena = arena;
     priv->si.sz = sizeof(priv->si);
     priv->flushed = 0;
     // Only do frame parallel decode when threads > 1.
@@ -126,7 +142,6 @@ static vpx_codec_err_t decoder_destroy(vpx_codec_alg_priv_t *ctx) {
       pthread_mutex_destroy(&frame_worker_data->stats_mutex);
       pthread_cond_destroy(&frame_worker_data->stats_cond);
 #endif
-      vpx_free(frame_worker_data);
     }
 #if CONFIG_MULTITHREAD
     pthread_mutex_destroy(&ctx->buffer_pool->pool_mutex);
@@ -138,9 +153,7 @@ static vpx_codec_err_t decoder_destroy(vpx_codec_alg_priv_t *ctx) {
     vp9_free_internal_frame_buffers(&ctx->buffer_pool->int_frame_buffers);
   }
 
-  vpx_free(ctx->frame_workers);
-  vpx_free(ctx->buffer_pool);
-  vpx_free(ctx);
+  vpx_arena_destroy(ctx->arena);
   return VPX_CODEC_OK;
 }
 
@@ -299,6 +312,8 @@ static void init_buffer_callbacks(vpx_codec_alg_priv_t *ctx) {
       if (vp9_alloc_internal_frame_buffers(&pool->int_frame_buffers))
         vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                            "Failed to initialize internal frame buffers");
+      pool->int_frame_buffers.frame_pool = ctx->frame_pool;
+      pool->int_frame_buffers.placement = ctx->frame_placement;
 
       pool->cb_priv = &pool->int_frame_buffers;
     }
@@ -376,7 +391,8 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
   ctx->available_threads = ctx->num_frame_workers;
   ctx->flushed = 0;
 
-  ctx->buffer_pool = (BufferPool *)vpx_calloc(1, sizeof(BufferPool));
+  ctx->buffer_pool = (BufferPool *)vpx_arena_calloc(ctx->arena, 1,
+                                                    sizeof(BufferPool));
   if (ctx->buffer_pool == NULL)
     return VPX_CODEC_MEM_ERROR;
 
@@ -388,7 +404,8 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
 #endif
 
   ctx->frame_workers = (VPxWorker *)
-      vpx_malloc(ctx->num_frame_workers * sizeof(*ctx->frame_workers));
+      vpx_arena_calloc(ctx->arena, ctx->num_frame_workers,
+                       sizeof(*ctx->frame_workers));
   if (ctx->frame_workers == NULL) {
     set_error_detail(ctx, "Failed to allocate frame_workers");
     return VPX_CODEC_MEM_ERROR;
@@ -398,13 +415,15 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
     VPxWorker *const worker = &ctx->frame_workers[i];
     FrameWorkerData *frame_worker_data = NULL;
     winterface->init(worker);
-    worker->data1 = vpx_memalign(32, sizeof(FrameWorkerData));
+    worker->data1 = vpx_arena_memalign(ctx->arena, 32,
+                                       sizeof(FrameWorkerData));
     if (worker->data1 == NULL) {
       set_error_detail(ctx, "Failed to allocate frame_worker_data");
       return VPX_CODEC_MEM_ERROR;
     }
     frame_worker_data = (FrameWorkerData *)worker->data1;
-    frame_worker_data->pbi = vp9_decoder_create(ctx->buffer_pool);
+    frame_worker_data->pbi = vp9_decoder_create(ctx->buffer_pool,
+                                                ctx->arena);
     if (frame_worker_data->pbi == NULL) {
       set_error_detail(ctx, "Failed to allocate frame_worker_data");
       return VPX_CODEC_MEM_ERROR;
@@ -436,7 +455,9 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
     frame_worker_data->pbi->common.frame_parallel_decode =
         ctx->frame_parallel_decode;
     worker->hook = (VPxWorkerHook)frame_worker_hook;
-    if (!winterface->reset(worker)) {
+    // A serial decoder executes its frame worker in the calling thread, so
+    // the worker's thread is only started for frame parallel decode.
+    if (ctx->frame_parallel_decode && !winterface->reset(worker)) {
       set_error_detail(ctx, "Frame Worker thread creation failed");
       return VPX_CODEC_MEM_ERROR;
     }
@@ -1024,6 +1045,37 @@ static vpx_codec_err_t ctrl_get_bit_depth(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_INVALID_PARAM;
 }
 
+static vpx_codec_err_t ctrl_get_mem_footprint(vpx_codec_alg_priv_t *ctx,
+                                              va_list args) {
+  vp9_mem_footprint_t *const fp = va_arg(args, vp9_mem_footprint_t *);
+  int i;
+
+  if (fp == NULL)
+    return VPX_CODEC_INVALID_PARAM;
+
+  memset(fp, 0, sizeof(*fp));
+  if (ctx->buffer_pool != NULL)
+    fp->frame_buffers = vp9_frame_buffers_footprint(ctx->buffer_pool);
+  for (i = 0; i < ctx->num_frame_workers; ++i) {
+    const FrameWorkerData *const frame_worker_data =
+        (const FrameWorkerData *)ctx->frame_workers[i].data1;
+    const VP9Decoder *const pbi = frame_worker_data->pbi;
+#if CONFIG_VP9_POSTPROC
+    fp->frame_buffers += pbi->common.post_proc_buffer.buffer_alloc_sz +
+                         pbi->common.post_proc_buffer_int.buffer_alloc_sz;
+    if (pbi->common.postproc_state.prev_mi_alloc_size > 0)
+      fp->context += MI_ARENA_FIRST * MI_UNIT +
+                     pbi->common.postproc_state.prev_mi_alloc_size *
+                         (MI_UNITS_SUB8X8 * MI_UNIT + sizeof(MI_INDEX));
+#endif
+    fp->context += frame_worker_data->scratch_buffer_size;
+    vp9_decoder_mem_footprint(pbi, fp);
+  }
+  fp->context += vpx_arena_footprint(ctx->arena);
+  fp->total = fp->frame_buffers + fp->thread_data + fp->context;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t ctrl_set_invert_tile_order(vpx_codec_alg_priv_t *ctx,
                                                   va_list args) {
   ctx->invert_tile_order = va_arg(args, int);
@@ -1061,6 +1113,61 @@ static vpx_codec_err_t ctrl_set_byte_alignment(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_frame_pool(vpx_codec_alg_priv_t *ctx,
+                                           va_list args) {
+  const int frame_pool = va_arg(args, int);
+
+  if (frame_pool & ~VP9D_FRAME_POOL_SHARED)
+    return VPX_CODEC_INVALID_PARAM;
+  // The buffers are set up with the first frame.
+  if (ctx->frame_workers != NULL)
+    return VPX_CODEC_ERROR;
+
+  ctx->frame_pool = frame_pool;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_reset(vpx_codec_alg_priv_t *ctx, va_list args) {
+  VPxWorker *const worker = ctx->frame_workers;
+  FrameWorkerData *frame_worker_data;
+  (void)args;
+
+  if (ctx->frame_parallel_decode) {
+    set_error_detail(ctx, "Not supported in frame parallel decode");
+    return VPX_CODEC_INCAPABLE;
+  }
+
+  // Nothing has been set up before the first frame.
+  if (worker == NULL)
+    return VPX_CODEC_OK;
+
+  frame_worker_data = (FrameWorkerData *)worker->data1;
+  vpx_get_worker_interface()->sync(worker);
+  vp9_decoder_reset(frame_worker_data->pbi);
+  frame_worker_data->received_frame = 0;
+
+  memset(&ctx->si, 0, sizeof(ctx->si));
+  ctx->si.sz = sizeof(ctx->si);
+  ctx->img_avail = 0;
+  ctx->flushed = 0;
+  ctx->last_show_frame = -1;
+  ctx->need_resync = 1;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_frame_placement(vpx_codec_alg_priv_t *ctx,
+                                                va_list args) {
+  const int placement = frame_placement_to_mem_flags(va_arg(args, int));
+
+  if (placement < 0)
+    return VPX_CODEC_INVALID_PARAM;
+
+  ctx->frame_placement = placement;
+  if (ctx->buffer_pool != NULL)
+    ctx->buffer_pool->int_frame_buffers.placement = placement;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t ctrl_set_skip_loop_filter(vpx_codec_alg_priv_t *ctx,
                                                  va_list args) {
   ctx->skip_loop_filter = va_arg(args, int);
@@ -1088,6 +1195,8 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   {VPXD_SET_DECRYPTOR,            ctrl_set_decryptor},
   {VP9_SET_BYTE_ALIGNMENT,        ctrl_set_byte_alignment},
   {VP9_SET_SKIP_LOOP_FILTER,      ctrl_set_skip_loop_filter},
+  {VP9D_SET_FRAME_POOL,           ctrl_set_frame_pool},
+  {VP9D_RESET,                    ctrl_reset},
 
   // Getters
   {VP8D_GET_LAST_REF_UPDATES,     ctrl_get_last_ref_updates},
@@ -1096,6 +1205,8 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   {VP9D_GET_DISPLAY_SIZE,         ctrl_get_display_size},
   {VP9D_GET_BIT_DEPTH,            ctrl_get_bit_depth},
   {VP9D_GET_FRAME_SIZE,           ctrl_get_frame_size},
+  {VP9_GET_MEM_FOOTPRINT,         ctrl_get_mem_footprint},
+  {VP9_SET_FRAME_PLACEMENT,       ctrl_set_frame_placement},
 
   { -1, NULL},
 };
@@ -1107,7 +1218,8 @@ CODEC_INTERFACE(vpx_codec_vp9_dx) = {
   "WebM Project VP9 Decoder" VERSION_STRING,
   VPX_CODEC_INTERNAL_ABI_VERSION,
   VPX_CODEC_CAP_DECODER | VP9_CAP_POSTPROC |
-      VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER,  // vpx_codec_caps_t
+      VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER |
+      VPX_CODEC_CAP_MEM_ALLOCATOR,  // vpx_codec_caps_t
   decoder_init,       // vpx_codec_init_fn_t
   decoder_destroy,    // vpx_codec_destroy_fn_t
   decoder_ctrl_maps,  // vpx_codec_ctrl_fn_map_t
@@ -10,6 +10,8 @@
 #ifndef VP9_VP9_IFACE_COMMON_H_
 #define VP9_VP9_IFACE_COMMON_H_
 
+#include "vpx/vp8.h"
+#include "vpx_mem/vpx_mem.h"
 #include "vpx_ports/mem.h"
 
 static void yuvconfig2image(vpx_image_t *img, const YV12_BUFFER_CONFIG  *yv12,
@@ -127,4 +129,13 @@ static vpx_codec_err_t image2yuvconfig(const vpx_image_t *img,
   return VPX_CODEC_OK;
 }
 
+// Converts VP9_FRAME_* placement flags to VPX_MEM_* ones, or returns -1 for
+// unknown flags.
+static int frame_placement_to_mem_flags(int placement) {
+  if (placement & ~(VP9_FRAME_HUGE_PAGES | VP9_FRAME_NUMA_LOCAL))
+    return -1;
+  return ((placement & VP9_FRAME_HUGE_PAGES) ? VPX_MEM_HUGE_PAGES : 0) |
+         ((placement & VP9_FRAME_NUMA_LOCAL) ? VPX_MEM_NUMA_LOCAL : 0);
+}
+
 #endif  // VP9_VP9_IFACE_COMMON_H_
@@ -59,7 +59,7 @@ extern "C" {
  * types, removing or reassigning enums, adding/removing/rearranging
  * fields to structures
  */
-#define VPX_CODEC_INTERNAL_ABI_VERSION (5) /**<\hideinitializer*/
+#define VPX_CODEC_INTERNAL_ABI_VERSION (6) /**<\hideinitializer*/
 
 typedef struct vpx_codec_alg_priv  vpx_codec_alg_priv_t;
 typedef struct vpx_codec_priv_enc_mr_cfg vpx_codec_priv_enc_mr_cfg_t;
@@ -71,14 +71,18 @@ typedef struct vpx_codec_priv_enc_mr_cfg vpx_codec_priv_enc_mr_cfg_t;
  * plugins implementing this interface may trust the input parameters to be
  * properly initialized.
  *
- * \param[in] ctx   Pointer to this instance's context
+ * \param[in] ctx       Pointer to this instance's context
+ * \param[in] data      Multi-resolution encoder setup, or NULL
+ * \param[in] allocator Application allocator, or NULL. Only passed to
+ *                      algorithms with VPX_CODEC_CAP_MEM_ALLOCATOR.
  * \retval #VPX_CODEC_OK
  *     The input stream was recognized and decoder initialized.
  * \retval #VPX_CODEC_MEM_ERROR
  *     Memory operation failed.
  */
-typedef vpx_codec_err_t (*vpx_codec_init_fn_t)(vpx_codec_ctx_t *ctx,
-                                               vpx_codec_priv_enc_mr_cfg_t *data);
+typedef vpx_codec_err_t (*vpx_codec_init_fn_t)(
+    vpx_codec_ctx_t *ctx, vpx_codec_priv_enc_mr_cfg_t *data,
+    const vpx_codec_mem_allocator_t *allocator);
 
 /*!\brief destroy function pointer prototype
  *
@@ -27,12 +27,21 @@ vpx_codec_err_t vpx_codec_dec_init_ver(vpx_codec_ctx_t      *ctx,
                                        const vpx_codec_dec_cfg_t *cfg,
                                        vpx_codec_flags_t     flags,
                                        int                   ver) {
+  return vpx_codec_dec_init_mem_ver(ctx, iface, cfg, flags, NULL, ver);
+}
+
+vpx_codec_err_t vpx_codec_dec_init_mem_ver(
+    vpx_codec_ctx_t *ctx, vpx_codec_iface_t *iface,
+    const vpx_codec_dec_cfg_t *cfg, vpx_codec_flags_t flags,
+    const vpx_codec_mem_allocator_t *allocator, int ver) {
   vpx_codec_err_t res;
 
   if (ver != VPX_DECODER_ABI_VERSION)
     res = VPX_CODEC_ABI_MISMATCH;
   else if (!ctx || !iface)
     res = VPX_CODEC_INVALID_PARAM;
+  else if (allocator && (!allocator->alloc || !allocator->free))
+    res = VPX_CODEC_INVALID_PARAM;
   else if (iface->abi_version != VPX_CODEC_INTERNAL_ABI_VERSION)
     res = VPX_CODEC_ABI_MISMATCH;
   else if ((flags & VPX_CODEC_USE_POSTPROC) && !(iface->caps & VPX_CODEC_CAP_POSTPROC))
@@ -45,6 +54,8 @@ vpx_codec_err_t vpx_codec_dec_init_ver(vpx_codec_ctx_t      *ctx,
     res = VPX_CODEC_INCAPABLE;
   else if (!(iface->caps & VPX_CODEC_CAP_DECODER))
     res = VPX_CODEC_INCAPABLE;
+  else if (allocator && !(iface->caps & VPX_CODEC_CAP_MEM_ALLOCATOR))
+    res = VPX_CODEC_INCAPABLE;
   else {
     memset(ctx, 0, sizeof(*ctx));
     ctx->iface = iface;
@@ -53,7 +64,7 @@ vpx_codec_err_t vpx_codec_dec_init_ver(vpx_codec_ctx_t      *ctx,
     ctx->init_flags = flags;
     ctx->config.dec = cfg;
 
-    res = ctx->iface->init(ctx, NULL);
+    res = ctx->iface->init(ctx, NULL, allocator);
     if (res) {
       ctx->err_detail = ctx->priv ? ctx->priv->err_detail : NULL;
       vpx_codec_destroy(ctx);
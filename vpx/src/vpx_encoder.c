@@ -29,12 +29,21 @@ vpx_codec_err_t vpx_codec_enc_init_ver(vpx_codec_ctx_t      *ctx,
                                        const vpx_codec_enc_cfg_t *cfg,
                                        vpx_codec_flags_t     flags,
                                        int                   ver) {
+  return vpx_codec_enc_init_mem_ver(ctx, iface, cfg, flags, NULL, ver);
+}
+
+vpx_codec_err_t vpx_codec_enc_init_mem_ver(
+    vpx_codec_ctx_t *ctx, vpx_codec_iface_t *iface,
+    const vpx_codec_enc_cfg_t *cfg, vpx_codec_flags_t flags,
+    const vpx_codec_mem_allocator_t *allocator, int ver) {
   vpx_codec_err_t res;
 
   if (ver != VPX_ENCODER_ABI_VERSION)
     res = VPX_CODEC_ABI_MISMATCH;
   else if (!ctx || !iface || !cfg)
     res = VPX_CODEC_INVALID_PARAM;
+  else if (allocator && (!allocator->alloc || !allocator->free))
+    res = VPX_CODEC_INVALID_PARAM;
   else if (iface->abi_version != VPX_CODEC_INTERNAL_ABI_VERSION)
     res = VPX_CODEC_ABI_MISMATCH;
   else if (!(iface->caps & VPX_CODEC_CAP_ENCODER))
@@ -45,13 +54,15 @@ vpx_codec_err_t vpx_codec_enc_init_ver(vpx_codec_ctx_t      *ctx,
   else if ((flags & VPX_CODEC_USE_OUTPUT_PARTITION)
            && !(iface->caps & VPX_CODEC_CAP_OUTPUT_PARTITION))
     res = VPX_CODEC_INCAPABLE;
+  else if (allocator && !(iface->caps & VPX_CODEC_CAP_MEM_ALLOCATOR))
+    res = VPX_CODEC_INCAPABLE;
   else {
     ctx->iface = iface;
     ctx->name = iface->name;
     ctx->priv = NULL;
     ctx->init_flags = flags;
     ctx->config.enc = cfg;
-    res = ctx->iface->init(ctx, NULL);
+    res = ctx->iface->init(ctx, NULL, allocator);
 
     if (res) {
       ctx->err_detail = ctx->priv ? ctx->priv->err_detail : NULL;
@@ -118,7 +129,7 @@ vpx_codec_err_t vpx_codec_enc_init_multi_ver(vpx_codec_ctx_t      *ctx,
         ctx->priv = NULL;
         ctx->init_flags = flags;
         ctx->config.enc = cfg;
-        res = ctx->iface->init(ctx, &mr_cfg);
+        res = ctx->iface->init(ctx, &mr_cfg, NULL);
 
         if (res) {
           const char *error_detail =
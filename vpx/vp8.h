@@ -55,6 +55,8 @@ enum vp8_com_control_id {
    * VP8_DECODER_CTRL_ID_START range next time we're ready to break the ABI.
    */
   VP9_GET_REFERENCE           = 128,  /**< get a pointer to a reference frame */
+  VP9_GET_MEM_FOOTPRINT       = 129,  /**< get the memory held by the codec instance */
+  VP9_SET_FRAME_PLACEMENT     = 130,  /**< set where frame buffers are placed in memory */
   VP8_COMMON_CTRL_ID_MAX,
   VP8_DECODER_CTRL_ID_START   = 256
 };
@@ -116,6 +118,39 @@ typedef struct vp9_ref_frame {
   vpx_image_t  img; /**< img structure to populate (output) */
 } vp9_ref_frame_t;
 
+/*!\brief VP9 memory footprint
+ *
+ * Bytes held by a VP9 encoder or decoder instance, grouped by subsystem.
+ * Memory supplied by the application through frame buffer callbacks is not
+ * counted.
+ */
+typedef struct vp9_mem_footprint {
+  size_t frame_buffers; /**< reference, scaled and scratch frame buffers */
+  size_t lookahead;     /**< queue of source frames (encoder only) */
+  size_t tokens;        /**< token buffers (encoder only) */
+  size_t thread_data;   /**< per thread state, such as partition trees */
+  size_t context;       /**< mode info, entropy contexts and other state */
+  size_t total;         /**< sum of the above */
+} vp9_mem_footprint_t;
+
+/*!\brief VP9 frame buffer placement flags
+ *
+ * Flags for VP9_SET_FRAME_PLACEMENT. They apply to the frame buffers the
+ * codec instance allocates after the call, so they are best set before the
+ * first frame. Buffers from frame buffer callbacks are not affected, and
+ * buffers the decoder's shared frame pool hands out again keep the placement
+ * they were allocated with. Platforms without the support ignore them.
+ */
+enum vp9_frame_placement_flags {
+  /*!\brief Align frame buffers of 2MB or more to 2MB and ask for
+   * transparent huge pages, so that motion compensation takes fewer TLB
+   * misses (Linux). Smaller buffers could not fill a huge page. */
+  VP9_FRAME_HUGE_PAGES        = 1 << 0,
+  /*!\brief Place frame buffers on the NUMA node of the thread that
+   * allocates them, the one calling the codec (Linux). */
+  VP9_FRAME_NUMA_LOCAL        = 1 << 1
+};
+
 /*!\brief vp8 decoder control function parameter type
  *
  * defines the data type for each of VP8 decoder control function requires
@@ -128,6 +163,8 @@ VPX_CTRL_USE_TYPE(VP8_SET_DBG_COLOR_MB_MODES,  int)
 VPX_CTRL_USE_TYPE(VP8_SET_DBG_COLOR_B_MODES,   int)
 VPX_CTRL_USE_TYPE(VP8_SET_DBG_DISPLAY_MV,      int)
 VPX_CTRL_USE_TYPE(VP9_GET_REFERENCE,           vp9_ref_frame_t *)
+VPX_CTRL_USE_TYPE(VP9_GET_MEM_FOOTPRINT,       vp9_mem_footprint_t *)
+VPX_CTRL_USE_TYPE(VP9_SET_FRAME_PLACEMENT,     int)
 
 /*! @} - end defgroup vp8 */
 
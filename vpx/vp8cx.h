@@ -539,6 +539,30 @@ enum vp8e_enc_control_id {
    * Supported in codecs: VP9
    */
   VP9E_GET_ACTIVEMAP,
+
+  /*!\brief Codec control function to set a memory budget in kilobytes.
+   *
+   * When the encoder's projected footprint is over the budget, it uses fewer
+   * threads and then fewer lag frames until it fits. Only buffers that are not
+   * allocated yet can be reduced, so the budget should be set before the
+   * first frame is encoded. The frame buffers themselves are not reduced.
+   * 0 means no budget, which is the default.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_MEM_BUDGET,
+
+  /*!\brief Codec control function to set the largest frame size to expect.
+   *
+   * The encoder then allocates its per-frame state for this size once and
+   * reuses it for any frame size up to it, so that resizing, internally or
+   * through a new configuration, does not reallocate. Larger frames are
+   * still accepted and grow the state as before. A size of 0x0, the
+   * default, allocates for the configured size only.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_MAX_FRAME_SIZE,
 };
 
 /*!\brief vpx 1-D scaling mode
@@ -622,6 +646,16 @@ typedef struct vpx_scaling_mode {
   VPX_SCALING_MODE    v_scaling_mode;  /**< vertical scaling mode   */
 } vpx_scaling_mode_t;
 
+/*!\brief  vpx maximum frame size
+ *
+ * This defines the data structure for #VP9E_SET_MAX_FRAME_SIZE
+ *
+ */
+typedef struct vpx_max_frame_size {
+  unsigned int width;   /**< largest frame width, in pixels */
+  unsigned int height;  /**< largest frame height, in pixels */
+} vpx_max_frame_size_t;
+
 /*!\brief VP8 token partition mode
  *
  * This defines VP8 partitioning mode for compressed data, i.e., the number of
@@ -739,6 +773,13 @@ VPX_CTRL_USE_TYPE(VP9E_SET_MAX_GF_INTERVAL,  unsigned int)
 #define VPX_CTRL_VP9E_SET_MAX_GF_INTERVAL
 
 VPX_CTRL_USE_TYPE(VP9E_GET_ACTIVEMAP, vpx_active_map_t *)
+
+VPX_CTRL_USE_TYPE(VP9E_SET_MEM_BUDGET, unsigned int)
+#define VPX_CTRL_VP9E_SET_MEM_BUDGET
+
+VPX_CTRL_USE_TYPE(VP9E_SET_MAX_FRAME_SIZE, vpx_max_frame_size_t *)
+#define VPX_CTRL_VP9E_SET_MAX_FRAME_SIZE
+
 /*! @} - end defgroup vp8_encoder */
 #ifdef __cplusplus
 }  // extern "C"
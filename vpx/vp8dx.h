@@ -113,9 +113,33 @@ enum vp8_dec_control_id {
    */
   VP9_SET_SKIP_LOOP_FILTER,
 
+  /** control function to take the internal frame buffers from a pool shared
+   * by all the decoders in the process, see vp9d_frame_pool_flags. Buffers
+   * are returned to the pool when no longer referenced and reused by size,
+   * so resolution changes and new decoders avoid allocating buffers. New
+   * buffers are placed as VP9_SET_FRAME_PLACEMENT asks. Must be set before
+   * the first frame is decoded and has no effect with external frame
+   * buffers. The default value is 0, private buffers.
+   */
+  VP9D_SET_FRAME_POOL,
+
+  /** control function to return the decoder to the state it was created in,
+   * ready for a new stream that starts with a key frame. The frame buffers,
+   * context buffers and threads are kept, so decoding the next stream skips
+   * their setup. Images returned before the reset are no longer valid. The
+   * argument is ignored. Not supported with frame parallel decode.
+   */
+  VP9D_RESET,
+
   VP8_DECODER_CTRL_ID_MAX
 };
 
+/*!\brief Flags for VP9D_SET_FRAME_POOL. */
+enum vp9d_frame_pool_flags {
+  /*!\brief Lease frame buffers from the shared pool. */
+  VP9D_FRAME_POOL_SHARED = 1 << 0
+};
+
 /** Decrypt n bytes of data from input -> output, using the decrypt_state
  *  passed in VPXD_SET_DECRYPTOR.
  */
@@ -156,6 +180,8 @@ VPX_CTRL_USE_TYPE(VP9D_GET_DISPLAY_SIZE,        int *)
 VPX_CTRL_USE_TYPE(VP9D_GET_BIT_DEPTH,           unsigned int *)
 VPX_CTRL_USE_TYPE(VP9D_GET_FRAME_SIZE,          int *)
 VPX_CTRL_USE_TYPE(VP9_INVERT_TILE_DECODE_ORDER, int)
+VPX_CTRL_USE_TYPE(VP9D_SET_FRAME_POOL,          int)
+VPX_CTRL_USE_TYPE(VP9D_RESET,                   int)
 
 /*! @} - end defgroup vp8_decoder */
 
@@ -153,6 +153,8 @@ extern "C" {
   typedef long vpx_codec_caps_t;
 #define VPX_CODEC_CAP_DECODER 0x1 /**< Is a decoder */
 #define VPX_CODEC_CAP_ENCODER 0x2 /**< Is an encoder */
+#define VPX_CODEC_CAP_MEM_ALLOCATOR 0x4 /**< Can allocate through an
+                                              application allocator */
 
 
   /*! \brief Initialization-time Feature Enabling
@@ -222,6 +224,43 @@ extern "C" {
     VPX_BITS_12 = 12,  /**< 12 bits */
   } vpx_bit_depth_t;
 
+  /*!\brief Memory allocation callback prototype
+   *
+   * Returns a block of at least size bytes, aligned to align bytes, or NULL
+   * if the allocation fails. The alignment is always a power of two.
+   *
+   * \param[in] priv      Callback's private data
+   * \param[in] align     Required alignment, in bytes
+   * \param[in] size      Size of the block, in bytes
+   */
+  typedef void *(*vpx_codec_mem_alloc_cb_fn_t)(void *priv, size_t align,
+                                               size_t size);
+
+  /*!\brief Memory release callback prototype
+   *
+   * Releases a block returned by the matching allocation callback.
+   *
+   * \param[in] priv      Callback's private data
+   * \param[in] mem       Block to release
+   */
+  typedef void (*vpx_codec_mem_free_cb_fn_t)(void *priv, void *mem);
+
+  /*!\brief Application memory allocator
+   *
+   * Codecs that advertise #VPX_CODEC_CAP_MEM_ALLOCATOR can be given an
+   * allocator when they are initialized. The state the instance sets up for
+   * its lifetime, rather than for a frame size, then comes from a few large
+   * slabs taken from this allocator, for example to place it on a given NUMA
+   * node. Frame buffers are not affected. The callbacks are called from the
+   * thread that calls into the codec, and must stay valid until the instance
+   * is destroyed.
+   */
+  typedef struct vpx_codec_mem_allocator {
+    vpx_codec_mem_alloc_cb_fn_t alloc;  /**< Allocates a block */
+    vpx_codec_mem_free_cb_fn_t  free;   /**< Releases a block */
+    void                       *priv;   /**< Private data for the callbacks */
+  } vpx_codec_mem_allocator_t;
+
   /*
    * Library Version Number Interface
    *
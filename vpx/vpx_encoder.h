@@ -801,6 +801,42 @@ extern "C" {
   vpx_codec_enc_init_ver(ctx, iface, cfg, flags, VPX_ENCODER_ABI_VERSION)
 
 
+  /*!\brief Initialize an encoder instance with an application allocator
+   *
+   * As vpx_codec_enc_init_ver(), but the instance allocates its long lived
+   * state through the given allocator. Applications should call the
+   * vpx_codec_enc_init_mem convenience macro instead of this function
+   * directly.
+   *
+   * \param[in]    ctx       Pointer to this instance's context.
+   * \param[in]    iface     Pointer to the algorithm interface to use.
+   * \param[in]    cfg       Configuration to use, if known. May be NULL.
+   * \param[in]    flags     Bitfield of VPX_CODEC_USE_* flags
+   * \param[in]    allocator Allocator to use. May be NULL for the default.
+   * \param[in]    ver       ABI version number. Must be set to
+   *                         VPX_ENCODER_ABI_VERSION
+   * \retval #VPX_CODEC_OK
+   *     The encoder algorithm initialized.
+   * \retval #VPX_CODEC_INCAPABLE
+   *     An allocator was given and the algorithm does not support one.
+   * \retval #VPX_CODEC_MEM_ERROR
+   *     Memory allocation failed.
+   */
+  vpx_codec_err_t vpx_codec_enc_init_mem_ver(
+      vpx_codec_ctx_t *ctx, vpx_codec_iface_t *iface,
+      const vpx_codec_enc_cfg_t *cfg, vpx_codec_flags_t flags,
+      const vpx_codec_mem_allocator_t *allocator, int ver);
+
+
+  /*!\brief Convenience macro for vpx_codec_enc_init_mem_ver()
+   *
+   * Ensures the ABI version parameter is properly set.
+   */
+#define vpx_codec_enc_init_mem(ctx, iface, cfg, flags, allocator) \
+  vpx_codec_enc_init_mem_ver(ctx, iface, cfg, flags, allocator, \
+                             VPX_ENCODER_ABI_VERSION)
+
+
   /*!\brief Initialize multi-encoder instance
    *
    * Initializes multi-encoder context using the given interface.
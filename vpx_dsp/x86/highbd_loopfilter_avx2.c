@@ -0,0 +1,156 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_dsp/x86/loopfilter_avx2.h"
+
+static INLINE void highbd_lpf_horizontal(uint16_t *s, int p, int length,
+                                         __m256i blimit, __m256i limit,
+                                         __m256i thresh, int bd) {
+  // Rows touched by each filter length: p1 .. q1, p2 .. q2, p6 .. q6.
+  const int first = length == 4 ? 6 : length == 8 ? 5 : 1;
+  const int start = length == 16 ? 0 : 4;
+  __m256i v[16];
+  int i;
+
+  for (i = start; i < 16 - start; ++i)
+    v[i] = _mm256_loadu_si256((const __m256i *)(s + (i - 8) * p));
+
+  lpf_filter_avx2(v, length, blimit, limit, thresh, bd);
+
+  for (i = first; i < 16 - first; ++i)
+    _mm256_storeu_si256((__m256i *)(s + (i - 8) * p), v[i]);
+}
+
+void vpx_highbd_lpf_horizontal_4_dual_avx2(uint16_t *s, int p,
+                                           const uint8_t *blimit0,
+                                           const uint8_t *limit0,
+                                           const uint8_t *thresh0,
+                                           const uint8_t *blimit1,
+                                           const uint8_t *limit1,
+                                           const uint8_t *thresh1,
+                                           int bd) {
+  const int shift = bd - 8;
+  highbd_lpf_horizontal(s, p, 4, lpf_thresh_avx2(blimit0, blimit1, shift),
+                        lpf_thresh_avx2(limit0, limit1, shift),
+                        lpf_thresh_avx2(thresh0, thresh1, shift), bd);
+}
+
+void vpx_highbd_lpf_horizontal_8_dual_avx2(uint16_t *s, int p,
+                                           const uint8_t *blimit0,
+                                           const uint8_t *limit0,
+                                           const uint8_t *thresh0,
+                                           const uint8_t *blimit1,
+                                           const uint8_t *limit1,
+                                           const uint8_t *thresh1,
+                                           int bd) {
+  const int shift = bd - 8;
+  highbd_lpf_horizontal(s, p, 8, lpf_thresh_avx2(blimit0, blimit1, shift),
+                        lpf_thresh_avx2(limit0, limit1, shift),
+                        lpf_thresh_avx2(thresh0, thresh1, shift), bd);
+}
+
+void vpx_highbd_lpf_horizontal_16_avx2(uint16_t *s, int p,
+                                       const uint8_t *blimit,
+                                       const uint8_t *limit,
+                                       const uint8_t *thresh,
+                                       int count, int bd) {
+  const int shift = bd - 8;
+  if (count == 1) {
+    // A single 8-pixel edge only fills half a register.
+    vpx_highbd_lpf_horizontal_16_sse2(s, p, blimit, limit, thresh, 1, bd);
+    return;
+  }
+  highbd_lpf_horizontal(s, p, 16, lpf_thresh_avx2(blimit, blimit, shift),
+                        lpf_thresh_avx2(limit, limit, shift),
+                        lpf_thresh_avx2(thresh, thresh, shift), bd);
+}
+
+// Loads the 8 columns starting at s for 16 rows, and returns them as
+// columns: v[i] holds column i, rows 0-7 in the low lane, 8-15 in the high.
+static INLINE void load_transpose(const uint16_t *s, int p, __m256i *v) {
+  __m256i rows[8];
+  int i;
+
+  for (i = 0; i < 8; ++i) {
+    const __m128i lo = _mm_loadu_si128((const __m128i *)(s + i * p));
+    const __m128i hi = _mm_loadu_si128((const __m128i *)(s + (i + 8) * p));
+    rows[i] = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+  }
+  lpf_transpose8x8_x2_avx2(rows, v);
+}
+
+// Inverse of load_transpose().
+static INLINE void transpose_store(const __m256i *v, uint16_t *s, int p) {
+  __m256i rows[8];
+  int i;
+
+  lpf_transpose8x8_x2_avx2(v, rows);
+  for (i = 0; i < 8; ++i) {
+    _mm_storeu_si128((__m128i *)(s + i * p), _mm256_castsi256_si128(rows[i]));
+    _mm_storeu_si128((__m128i *)(s + (i + 8) * p),
+                     _mm256_extracti128_si256(rows[i], 1));
+  }
+}
+
+static INLINE void highbd_lpf_vertical(uint16_t *s, int p, int length,
+                                       __m256i blimit, __m256i limit,
+                                       __m256i thresh, int bd) {
+  __m256i v[16];
+
+  if (length == 16)
+    load_transpose(s - 8, p, v);
+  load_transpose(s - 4 * (length != 16), p, v + (length == 16 ? 8 : 4));
+
+  lpf_filter_avx2(v, length, blimit, limit, thresh, bd);
+
+  if (length == 16)
+    transpose_store(v, s - 8, p);
+  transpose_store(v + (length == 16 ? 8 : 4), s - 4 * (length != 16), p);
+}
+
+void vpx_highbd_lpf_vertical_4_dual_avx2(uint16_t *s, int p,
+                                         const uint8_t *blimit0,
+                                         const uint8_t *limit0,
+                                         const uint8_t *thresh0,
+                                         const uint8_t *blimit1,
+                                         const uint8_t *limit1,
+                                         const uint8_t *thresh1,
+                                         int bd) {
+  const int shift = bd - 8;
+  highbd_lpf_vertical(s, p, 4, lpf_thresh_avx2(blimit0, blimit1, shift),
+                      lpf_thresh_avx2(limit0, limit1, shift),
+                      lpf_thresh_avx2(thresh0, thresh1, shift), bd);
+}
+
+void vpx_highbd_lpf_vertical_8_dual_avx2(uint16_t *s, int p,
+                                         const uint8_t *blimit0,
+                                         const uint8_t *limit0,
+                                         const uint8_t *thresh0,
+                                         const uint8_t *blimit1,
+                                         const uint8_t *limit1,
+                                         const uint8_t *thresh1,
+                                         int bd) {
+  const int shift = bd - 8;
+  highbd_lpf_vertical(s, p, 8, lpf_thresh_avx2(blimit0, blimit1, shift),
+                      lpf_thresh_avx2(limit0, limit1, shift),
+                      lpf_thresh_avx2(thresh0, thresh1, shift), bd);
+}
+
+void vpx_highbd_lpf_vertical_16_dual_avx2(uint16_t *s, int p,
+                                          const uint8_t *blimit,
+                                          const uint8_t *limit,
+                                          const uint8_t *thresh,
+                                          int bd) {
+  const int shift = bd - 8;
+  highbd_lpf_vertical(s, p, 16, lpf_thresh_avx2(blimit, blimit, shift),
+                      lpf_thresh_avx2(limit, limit, shift),
+                      lpf_thresh_avx2(thresh, thresh, shift), bd);
+}
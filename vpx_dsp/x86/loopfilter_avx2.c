@@ -11,6 +11,7 @@
 #include <immintrin.h>  /* AVX2 */
 
 #include "./vpx_dsp_rtcd.h"
+#include "vpx_dsp/x86/loopfilter_avx2.h"
 #include "vpx_ports/mem.h"
 
 static void mb_lpf_horizontal_edge_w_avx2_8(unsigned char *s, int p,
@@ -984,3 +985,121 @@ void vpx_lpf_horizontal_16_avx2(unsigned char *s, int p,
     else
         mb_lpf_horizontal_edge_w_avx2_16(s, p, _blimit, _limit, _thresh);
 }
+
+/* The remaining filters widen the pixels to 16 bits and share the filter core
+ * in loopfilter_avx2.h with the high bitdepth versions. */
+
+static INLINE __m256i load_16x1(const uint8_t *s) {
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) s));
+}
+
+static INLINE void store_16x1(uint8_t *s, __m256i v) {
+    v = _mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), 0x08);
+    _mm_storeu_si128((__m128i *) s, _mm256_castsi256_si128(v));
+}
+
+static INLINE void lpf_horizontal_dual(uint8_t *s, int p, int length,
+        const uint8_t *blimit0, const uint8_t *limit0, const uint8_t *thresh0,
+        const uint8_t *blimit1, const uint8_t *limit1, const uint8_t *thresh1) {
+    /* Rows p3 .. q3 are read; p1 .. q1 (4 tap) or p2 .. q2 (8 tap) change. */
+    const int first = length == 4 ? 6 : 5;
+    __m256i v[16];
+    int i;
+
+    for (i = 4; i < 12; ++i)
+        v[i] = load_16x1(s + (i - 8) * p);
+
+    lpf_filter_avx2(v, length, lpf_thresh_avx2(blimit0, blimit1, 0),
+                    lpf_thresh_avx2(limit0, limit1, 0),
+                    lpf_thresh_avx2(thresh0, thresh1, 0), 8);
+
+    for (i = first; i < 16 - first; ++i)
+        store_16x1(s + (i - 8) * p, v[i]);
+}
+
+void vpx_lpf_horizontal_4_dual_avx2(uint8_t *s, int p,
+        const uint8_t *blimit0, const uint8_t *limit0, const uint8_t *thresh0,
+        const uint8_t *blimit1, const uint8_t *limit1, const uint8_t *thresh1) {
+    lpf_horizontal_dual(s, p, 4, blimit0, limit0, thresh0,
+                        blimit1, limit1, thresh1);
+}
+
+void vpx_lpf_horizontal_8_dual_avx2(uint8_t *s, int p,
+        const uint8_t *blimit0, const uint8_t *limit0, const uint8_t *thresh0,
+        const uint8_t *blimit1, const uint8_t *limit1, const uint8_t *thresh1) {
+    lpf_horizontal_dual(s, p, 8, blimit0, limit0, thresh0,
+                        blimit1, limit1, thresh1);
+}
+
+/* Loads the 8 columns starting at s for 16 rows, and returns them as columns:
+ * v[i] holds column i, rows 0-7 in the low lane and rows 8-15 in the high. */
+static INLINE void load_transpose_8x16(const uint8_t *s, int p, __m256i *v) {
+    __m256i rows[8];
+    int i;
+
+    for (i = 0; i < 8; ++i) {
+        const __m128i r = _mm_unpacklo_epi64(
+                _mm_loadl_epi64((const __m128i *) (s + i * p)),
+                _mm_loadl_epi64((const __m128i *) (s + (i + 8) * p)));
+        rows[i] = _mm256_cvtepu8_epi16(r);
+    }
+    lpf_transpose8x8_x2_avx2(rows, v);
+}
+
+/* Inverse of load_transpose_8x16(). */
+static INLINE void transpose_store_8x16(const __m256i *v, uint8_t *s, int p) {
+    __m256i rows[8];
+    int i;
+
+    lpf_transpose8x8_x2_avx2(v, rows);
+    for (i = 0; i < 8; ++i) {
+        const __m256i r = _mm256_packus_epi16(rows[i], rows[i]);
+        _mm_storel_epi64((__m128i *) (s + i * p), _mm256_castsi256_si128(r));
+        _mm_storel_epi64((__m128i *) (s + (i + 8) * p),
+                         _mm256_extracti128_si256(r, 1));
+    }
+}
+
+static INLINE void lpf_vertical_dual(uint8_t *s, int p, int length,
+        __m256i blimit, __m256i limit, __m256i thresh) {
+    __m256i v[16];
+
+    if (length == 16) {
+        load_transpose_8x16(s - 8, p, v);
+        load_transpose_8x16(s, p, v + 8);
+    } else {
+        load_transpose_8x16(s - 4, p, v + 4);
+    }
+
+    lpf_filter_avx2(v, length, blimit, limit, thresh, 8);
+
+    if (length == 16) {
+        transpose_store_8x16(v, s - 8, p);
+        transpose_store_8x16(v + 8, s, p);
+    } else {
+        transpose_store_8x16(v + 4, s - 4, p);
+    }
+}
+
+void vpx_lpf_vertical_4_dual_avx2(uint8_t *s, int p,
+        const uint8_t *blimit0, const uint8_t *limit0, const uint8_t *thresh0,
+        const uint8_t *blimit1, const uint8_t *limit1, const uint8_t *thresh1) {
+    lpf_vertical_dual(s, p, 4, lpf_thresh_avx2(blimit0, blimit1, 0),
+                      lpf_thresh_avx2(limit0, limit1, 0),
+                      lpf_thresh_avx2(thresh0, thresh1, 0));
+}
+
+void vpx_lpf_vertical_8_dual_avx2(uint8_t *s, int p,
+        const uint8_t *blimit0, const uint8_t *limit0, const uint8_t *thresh0,
+        const uint8_t *blimit1, const uint8_t *limit1, const uint8_t *thresh1) {
+    lpf_vertical_dual(s, p, 8, lpf_thresh_avx2(blimit0, blimit1, 0),
+                      lpf_thresh_avx2(limit0, limit1, 0),
+                      lpf_thresh_avx2(thresh0, thresh1, 0));
+}
+
+void vpx_lpf_vertical_16_dual_avx2(uint8_t *s, int p, const uint8_t *blimit,
+        const uint8_t *limit, const uint8_t *thresh) {
+    lpf_vertical_dual(s, p, 16, lpf_thresh_avx2(blimit, blimit, 0),
+                      lpf_thresh_avx2(limit, limit, 0),
+                      lpf_thresh_avx2(thresh, thresh, 0));
+}
@@ -0,0 +1,198 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_DSP_X86_LOOPFILTER_AVX2_H_
+#define VPX_DSP_X86_LOOPFILTER_AVX2_H_
+
+#include <immintrin.h>  // AVX2
+
+#include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+
+// Loop filter core shared by the 8-bit and high bitdepth AVX2 filters. It
+// works on 16 pixels at a time held in 16-bit lanes. The low 128-bit lane
+// holds pixels 0-7 and the high lane pixels 8-15, so each half can use its
+// own set of thresholds, as the _dual functions require. With bd == 8 the
+// results match the 8-bit C filters.
+
+static INLINE __m256i abs_diff16(__m256i a, __m256i b) {
+  return _mm256_abs_epi16(_mm256_sub_epi16(a, b));
+}
+
+// Returns a vector of threshold t0 in the low lane and t1 in the high lane,
+// scaled to the bit depth.
+static INLINE __m256i lpf_thresh_avx2(const uint8_t *t0, const uint8_t *t1,
+                                      int shift) {
+  const __m128i lo = _mm_set1_epi16((int16_t)(*t0 << shift));
+  const __m128i hi = _mm_set1_epi16((int16_t)(*t1 << shift));
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+// Computes the flat (averaging) filter outputs of the n rows in[0..n-1],
+// replicating the outermost rows:
+//   out[i - 1] = (in[i] + sum(in[j], |j - i| < n / 2) + n / 2) >> bits
+// for i = 1 .. n - 2. For 12-bit input and n = 16 the sums peak at 65528,
+// so unsigned 16-bit arithmetic is sufficient.
+static INLINE void lpf_flat_filter_avx2(const __m256i *in, int n, int bits,
+                                        __m256i *out) {
+  const int half = n / 2 - 1;
+  __m256i sum = _mm256_set1_epi16(n / 2);
+  int i, j;
+
+  for (j = 1 - half; j <= 1 + half; ++j)
+    sum = _mm256_add_epi16(sum, in[j < 0 ? 0 : j]);
+
+  for (i = 1; i < n - 1; ++i) {
+    out[i - 1] = _mm256_srli_epi16(_mm256_add_epi16(sum, in[i]), bits);
+    sum = _mm256_sub_epi16(sum, in[i - half < 0 ? 0 : i - half]);
+    sum = _mm256_add_epi16(sum,
+                           in[i + half + 1 > n - 1 ? n - 1 : i + half + 1]);
+  }
+}
+
+// Applies the 4, 8 or 16 tap loop filter across an edge. v[0] .. v[15] hold
+// the rows p7 .. q7; the 4 and 8 tap filters only use p3 .. q3 (v[4..11]).
+static INLINE void lpf_filter_avx2(__m256i *v, int length, __m256i blimit,
+                                   __m256i limit, __m256i thresh, int bd) {
+  const int shift = bd - 8;
+  const __m256i ff = _mm256_set1_epi16(-1);
+  const __m256i one = _mm256_set1_epi16(1);
+  const __m256i flat_thresh = _mm256_set1_epi16(1 << shift);
+  const __m256i t80 = _mm256_set1_epi16(0x80 << shift);
+  const __m256i pmax = _mm256_set1_epi16((0x80 << shift) - 1);
+  const __m256i pmin = _mm256_set1_epi16(-(0x80 << shift));
+  const __m256i p3 = v[4], p2 = v[5], p1 = v[6], p0 = v[7];
+  const __m256i q0 = v[8], q1 = v[9], q2 = v[10], q3 = v[11];
+  const __m256i ps1 = _mm256_sub_epi16(p1, t80);
+  const __m256i ps0 = _mm256_sub_epi16(p0, t80);
+  const __m256i qs0 = _mm256_sub_epi16(q0, t80);
+  const __m256i qs1 = _mm256_sub_epi16(q1, t80);
+  __m256i mask, hev, work, filt, filter1, filter2;
+  __m256i f4[4];
+
+#define CLAMP(x) _mm256_min_epi16(_mm256_max_epi16((x), pmin), pmax)
+
+  // filter_mask
+  work = _mm256_max_epi16(abs_diff16(p3, p2), abs_diff16(p2, p1));
+  work = _mm256_max_epi16(work, abs_diff16(p1, p0));
+  work = _mm256_max_epi16(work, abs_diff16(q1, q0));
+  work = _mm256_max_epi16(work, abs_diff16(q2, q1));
+  work = _mm256_max_epi16(work, abs_diff16(q3, q2));
+  mask = _mm256_cmpgt_epi16(work, limit);
+  work = _mm256_add_epi16(_mm256_slli_epi16(abs_diff16(p0, q0), 1),
+                          _mm256_srli_epi16(abs_diff16(p1, q1), 1));
+  mask = _mm256_or_si256(mask, _mm256_cmpgt_epi16(work, blimit));
+  mask = _mm256_xor_si256(mask, ff);
+
+  // hev_mask
+  work = _mm256_max_epi16(abs_diff16(p1, p0), abs_diff16(q1, q0));
+  hev = _mm256_cmpgt_epi16(work, thresh);
+
+  // filter4
+  filt = _mm256_and_si256(CLAMP(_mm256_sub_epi16(ps1, qs1)), hev);
+  work = _mm256_sub_epi16(qs0, ps0);
+  filt = _mm256_add_epi16(filt, _mm256_add_epi16(work,
+                                                 _mm256_add_epi16(work, work)));
+  filt = _mm256_and_si256(CLAMP(filt), mask);
+  filter1 = _mm256_srai_epi16(
+      CLAMP(_mm256_add_epi16(filt, _mm256_set1_epi16(4))), 3);
+  filter2 = _mm256_srai_epi16(
+      CLAMP(_mm256_add_epi16(filt, _mm256_set1_epi16(3))), 3);
+  f4[2] = _mm256_add_epi16(CLAMP(_mm256_sub_epi16(qs0, filter1)), t80);
+  f4[1] = _mm256_add_epi16(CLAMP(_mm256_add_epi16(ps0, filter2)), t80);
+  filt = _mm256_srai_epi16(_mm256_add_epi16(filter1, one), 1);
+  filt = _mm256_andnot_si256(hev, filt);
+  f4[3] = _mm256_add_epi16(CLAMP(_mm256_sub_epi16(qs1, filt)), t80);
+  f4[0] = _mm256_add_epi16(CLAMP(_mm256_add_epi16(ps1, filt)), t80);
+
+#undef CLAMP
+
+  if (length >= 8) {
+    __m256i flat;
+    int i;
+
+    // flat_mask4
+    work = _mm256_max_epi16(abs_diff16(p1, p0), abs_diff16(q1, q0));
+    work = _mm256_max_epi16(work, abs_diff16(p2, p0));
+    work = _mm256_max_epi16(work, abs_diff16(q2, q0));
+    work = _mm256_max_epi16(work, abs_diff16(p3, p0));
+    work = _mm256_max_epi16(work, abs_diff16(q3, q0));
+    flat = _mm256_andnot_si256(_mm256_cmpgt_epi16(work, flat_thresh), mask);
+
+    if (!_mm256_testz_si256(flat, flat)) {
+      __m256i f8[6];
+      lpf_flat_filter_avx2(v + 4, 8, 3, f8);
+
+      if (length == 16) {
+        __m256i flat2;
+
+        // flat_mask5
+        work = _mm256_max_epi16(abs_diff16(v[3], p0), abs_diff16(v[12], q0));
+        work = _mm256_max_epi16(work, abs_diff16(v[2], p0));
+        work = _mm256_max_epi16(work, abs_diff16(v[13], q0));
+        work = _mm256_max_epi16(work, abs_diff16(v[1], p0));
+        work = _mm256_max_epi16(work, abs_diff16(v[14], q0));
+        work = _mm256_max_epi16(work, abs_diff16(v[0], p0));
+        work = _mm256_max_epi16(work, abs_diff16(v[15], q0));
+        flat2 = _mm256_andnot_si256(_mm256_cmpgt_epi16(work, flat_thresh),
+                                    flat);
+
+        if (!_mm256_testz_si256(flat2, flat2)) {
+          __m256i f16[14];
+          lpf_flat_filter_avx2(v, 16, 4, f16);
+          for (i = 0; i < 6; ++i)
+            f8[i] = _mm256_blendv_epi8(f8[i], f16[i + 4], flat2);
+          for (i = 0; i < 4; ++i) {
+            v[1 + i] = _mm256_blendv_epi8(v[1 + i], f16[i], flat2);
+            v[11 + i] = _mm256_blendv_epi8(v[11 + i], f16[i + 10], flat2);
+          }
+        }
+      }
+
+      // Rows p2 and q2 are left alone by filter4.
+      v[5] = _mm256_blendv_epi8(v[5], f8[0], flat);
+      v[10] = _mm256_blendv_epi8(v[10], f8[5], flat);
+      for (i = 0; i < 4; ++i)
+        f4[i] = _mm256_blendv_epi8(f4[i], f8[i + 1], flat);
+    }
+  }
+
+  v[6] = f4[0];
+  v[7] = f4[1];
+  v[8] = f4[2];
+  v[9] = f4[3];
+}
+
+// Transposes two 8x8 blocks of 16-bit values at once, one per 128-bit lane.
+static INLINE void lpf_transpose8x8_x2_avx2(const __m256i *in,
+                                            __m256i *out) {
+  __m256i a[8], b[8];
+  int i;
+
+  for (i = 0; i < 4; ++i) {
+    a[i] = _mm256_unpacklo_epi16(in[2 * i], in[2 * i + 1]);
+    a[i + 4] = _mm256_unpackhi_epi16(in[2 * i], in[2 * i + 1]);
+  }
+  for (i = 0; i < 4; ++i) {
+    b[i] = _mm256_unpacklo_epi32(a[2 * i], a[2 * i + 1]);
+    b[i + 4] = _mm256_unpackhi_epi32(a[2 * i], a[2 * i + 1]);
+  }
+  // b[2k] and b[2k + 1] hold two columns each, of rows 0-3 and 4-7.
+  out[0] = _mm256_unpacklo_epi64(b[0], b[1]);
+  out[1] = _mm256_unpackhi_epi64(b[0], b[1]);
+  out[2] = _mm256_unpacklo_epi64(b[4], b[5]);
+  out[3] = _mm256_unpackhi_epi64(b[4], b[5]);
+  out[4] = _mm256_unpacklo_epi64(b[2], b[3]);
+  out[5] = _mm256_unpackhi_epi64(b[2], b[3]);
+  out[6] = _mm256_unpacklo_epi64(b[6], b[7]);
+  out[7] = _mm256_unpackhi_epi64(b[6], b[7]);
+}
+
+#endif  // VPX_DSP_X86_LOOPFILTER_AVX2_H_
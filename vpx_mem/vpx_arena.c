@@ -0,0 +1,170 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "vpx/vpx_integer.h"
+#include "vpx_mem/include/vpx_mem_intrnl.h"
+#include "vpx_mem/vpx_arena.h"
+#include "vpx_mem/vpx_mem.h"
+
+// Slabs start on a cache line. Blocks get the vpx_malloc() alignment unless
+// they ask for more.
+#define SLAB_ALIGNMENT 64
+
+typedef struct arena_slab {
+  struct arena_slab *next;
+  size_t size;  // Usable bytes after the header.
+} ARENA_SLAB;
+
+#define SLAB_HEADER_SIZE \
+  ((sizeof(ARENA_SLAB) + SLAB_ALIGNMENT - 1) & ~(size_t)(SLAB_ALIGNMENT - 1))
+
+struct vpx_arena {
+  vpx_codec_mem_allocator_t allocator;
+  size_t slab_size;
+  ARENA_SLAB *slabs;
+  ARENA_SLAB *current;  // Slab being filled, NULL before the first block.
+  size_t used;          // Bytes used in the current slab.
+};
+
+void *vpx_mem_alloc(const vpx_codec_mem_allocator_t *allocator,
+                    size_t align, size_t size) {
+  if (allocator != NULL && allocator->alloc != NULL)
+    return allocator->alloc(allocator->priv, align, size);
+  return vpx_memalign(align, size);
+}
+
+void vpx_mem_release(const vpx_codec_mem_allocator_t *allocator, void *mem) {
+  if (mem == NULL)
+    return;
+  if (allocator != NULL && allocator->alloc != NULL)
+    allocator->free(allocator->priv, mem);
+  else
+    vpx_free(mem);
+}
+
+static uint8_t *slab_data(ARENA_SLAB *slab) {
+  return (uint8_t *)slab + SLAB_HEADER_SIZE;
+}
+
+// Returns the offset in slab of a block of size bytes aligned to align placed
+// at or after used, or -1 if the block does not fit.
+static ptrdiff_t fit_block(ARENA_SLAB *slab, size_t used, size_t align,
+                           size_t size) {
+  const size_t start = (size_t)align_addr(slab_data(slab) + used, align) -
+                       (size_t)slab_data(slab);
+  if (start > slab->size || slab->size - start < size)
+    return -1;
+  return (ptrdiff_t)start;
+}
+
+vpx_arena_t *vpx_arena_create(const vpx_codec_mem_allocator_t *allocator,
+                              size_t slab_size) {
+  vpx_arena_t *const arena = (vpx_arena_t *)vpx_mem_alloc(
+      allocator, SLAB_ALIGNMENT, sizeof(*arena));
+  if (arena == NULL)
+    return NULL;
+
+  memset(arena, 0, sizeof(*arena));
+  if (allocator != NULL && allocator->alloc != NULL)
+    arena->allocator = *allocator;
+  arena->slab_size = slab_size;
+  return arena;
+}
+
+void vpx_arena_destroy(vpx_arena_t *arena) {
+  vpx_codec_mem_allocator_t allocator;
+  ARENA_SLAB *slab;
+
+  if (arena == NULL)
+    return;
+
+  allocator = arena->allocator;
+  slab = arena->slabs;
+  while (slab != NULL) {
+    ARENA_SLAB *const next = slab->next;
+    vpx_mem_release(&allocator, slab);
+    slab = next;
+  }
+  vpx_mem_release(&allocator, arena);
+}
+
+void vpx_arena_reset(vpx_arena_t *arena) {
+  arena->current = NULL;
+  arena->used = 0;
+}
+
+void *vpx_arena_memalign(vpx_arena_t *arena, size_t align, size_t size) {
+  ARENA_SLAB *slab = arena->current;
+  ptrdiff_t offset = -1;
+
+  if (align < DEFAULT_ALIGNMENT)
+    align = DEFAULT_ALIGNMENT;
+
+  // A new slab holds the header, the block and its alignment padding.
+  if (size > SIZE_MAX - SLAB_HEADER_SIZE - align)
+    return NULL;
+
+  if (slab != NULL)
+    offset = fit_block(slab, arena->used, align, size);
+
+  // Move on to the slab after the current one, which is left over from
+  // before a reset, or put a new one in its place.
+  if (offset < 0) {
+    ARENA_SLAB *const next = slab ? slab->next : arena->slabs;
+    if (next != NULL && (offset = fit_block(next, 0, align, size)) >= 0) {
+      slab = next;
+    } else {
+      const size_t slab_size = arena->slab_size > size + align ?
+                               arena->slab_size : size + align;
+      ARENA_SLAB *const new_slab = (ARENA_SLAB *)vpx_mem_alloc(
+          &arena->allocator, SLAB_ALIGNMENT, SLAB_HEADER_SIZE + slab_size);
+      if (new_slab == NULL)
+        return NULL;
+      new_slab->size = slab_size;
+      new_slab->next = next;
+      if (slab != NULL)
+        slab->next = new_slab;
+      else
+        arena->slabs = new_slab;
+      slab = new_slab;
+      offset = fit_block(slab, 0, align, size);
+    }
+    arena->current = slab;
+  }
+
+  arena->used = (size_t)offset + size;
+  return slab_data(slab) + offset;
+}
+
+void *vpx_arena_calloc(vpx_arena_t *arena, size_t num, size_t size) {
+  void *mem;
+  if (num != 0 && size > SIZE_MAX / num)
+    return NULL;
+  mem = vpx_arena_memalign(arena, DEFAULT_ALIGNMENT, num * size);
+  if (mem != NULL)
+    memset(mem, 0, num * size);
+  return mem;
+}
+
+const vpx_codec_mem_allocator_t *vpx_arena_allocator(
+    const vpx_arena_t *arena) {
+  return arena->allocator.alloc != NULL ? &arena->allocator : NULL;
+}
+
+size_t vpx_arena_footprint(const vpx_arena_t *arena) {
+  size_t size = sizeof(*arena);
+  const ARENA_SLAB *slab;
+
+  for (slab = arena->slabs; slab != NULL; slab = slab->next)
+    size += SLAB_HEADER_SIZE + slab->size;
+  return size;
+}
@@ -0,0 +1,56 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_MEM_VPX_ARENA_H_
+#define VPX_MEM_VPX_ARENA_H_
+
+#include <stddef.h>
+
+#include "vpx/vpx_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Allocates through the application's allocator when one is given, and
+// through vpx_memalign() otherwise. Blocks must be released with
+// vpx_mem_release() and the same allocator.
+void *vpx_mem_alloc(const vpx_codec_mem_allocator_t *allocator,
+                    size_t align, size_t size);
+void vpx_mem_release(const vpx_codec_mem_allocator_t *allocator, void *mem);
+
+// An arena hands out memory from a list of large slabs and takes it back all
+// at once, for allocations that share the lifetime of some owner. Blocks are
+// never freed on their own. vpx_arena_reset() makes the slabs available for
+// reuse and vpx_arena_destroy() releases them. An arena is not thread safe.
+typedef struct vpx_arena vpx_arena_t;
+
+// Creates an arena that takes slab_size byte slabs from allocator, which may
+// be NULL. The allocator is copied.
+vpx_arena_t *vpx_arena_create(const vpx_codec_mem_allocator_t *allocator,
+                              size_t slab_size);
+void vpx_arena_destroy(vpx_arena_t *arena);
+void vpx_arena_reset(vpx_arena_t *arena);
+
+void *vpx_arena_memalign(vpx_arena_t *arena, size_t align, size_t size);
+void *vpx_arena_calloc(vpx_arena_t *arena, size_t num, size_t size);
+
+// Returns the allocator the arena takes its slabs from, or NULL for the
+// default one, so that related arenas can be created from the same source.
+const vpx_codec_mem_allocator_t *vpx_arena_allocator(const vpx_arena_t *arena);
+
+// Returns the bytes the arena holds from its allocator, in use or not.
+size_t vpx_arena_footprint(const vpx_arena_t *arena);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // VPX_MEM_VPX_ARENA_H_
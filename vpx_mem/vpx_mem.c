@@ -17,6 +17,14 @@
 #include <string.h>
 #include "include/vpx_mem_intrnl.h"
 #include "vpx/vpx_integer.h"
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define HUGE_PAGE_SIZE (2 << 20)
+#define PAGE_SIZE_MIN 4096
 
 void *vpx_memalign(size_t align, size_t size) {
   void *addr,
@@ -91,6 +99,59 @@ void vpx_free(void *memblk) {
   }
 }
 
+#if defined(__linux__) && defined(SYS_mbind) && defined(SYS_getcpu)
+// Prefers the NUMA node the calling thread runs on for the whole pages of
+// [addr, addr + size). Must come before the pages are first touched.
+static void prefer_local_node(void *addr, size_t size) {
+  const int mpol_preferred = 1;  // MPOL_PREFERRED in <linux/mempolicy.h>.
+  const size_t start = ((size_t)addr + PAGE_SIZE_MIN - 1) &
+                       ~(size_t)(PAGE_SIZE_MIN - 1);
+  const size_t end = ((size_t)addr + size) & ~(size_t)(PAGE_SIZE_MIN - 1);
+  unsigned int cpu, node;
+  unsigned long nodemask;
+
+  if (end <= start || syscall(SYS_getcpu, &cpu, &node, NULL) != 0 ||
+      node >= 8 * sizeof(nodemask))
+    return;
+  nodemask = 1ul << node;
+  // Failure leaves the default policy, which is only a missed optimization.
+  (void)syscall(SYS_mbind, start, end - start, mpol_preferred, &nodemask,
+                8 * sizeof(nodemask) + 1, 0);
+}
+#endif
+
+void *vpx_memalign_frame(size_t align, size_t size, int flags) {
+  void *x;
+
+  // A buffer smaller than a huge page cannot fill one, and aligning it to
+  // one would add up to 2MB to it.
+  if ((flags & VPX_MEM_HUGE_PAGES) && size >= HUGE_PAGE_SIZE &&
+      align < HUGE_PAGE_SIZE)
+    align = HUGE_PAGE_SIZE;
+  else if ((flags & VPX_MEM_NUMA_LOCAL) && align < PAGE_SIZE_MIN)
+    align = PAGE_SIZE_MIN;
+
+  x = vpx_memalign(align, size);
+  if (x == NULL)
+    return NULL;
+
+#if defined(__linux__)
+#if defined(MADV_HUGEPAGE)
+  if ((flags & VPX_MEM_HUGE_PAGES) && size >= HUGE_PAGE_SIZE)
+    madvise(x, size, MADV_HUGEPAGE);
+#endif
+#if defined(SYS_mbind) && defined(SYS_getcpu)
+  if (flags & VPX_MEM_NUMA_LOCAL)
+    prefer_local_node(x, size);
+#endif
+#endif  // __linux__
+
+  // Clearing the buffer here also faults its pages in under the policy
+  // above.
+  memset(x, 0, size);
+  return x;
+}
+
 #if CONFIG_VP9 && CONFIG_VP9_HIGHBITDEPTH
 void *vpx_memset16(void *dest, int val, size_t length) {
   int i;
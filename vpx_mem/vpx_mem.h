@@ -30,6 +30,15 @@ extern "C" {
   void *vpx_realloc(void *memblk, size_t size);
   void vpx_free(void *memblk);
 
+  // Placement flags for vpx_memalign_frame().
+#define VPX_MEM_HUGE_PAGES 1  // 2MB aligned from 2MB, for huge pages.
+#define VPX_MEM_NUMA_LOCAL 2  // On the NUMA node of the calling thread.
+
+  // Allocates size cleared bytes aligned to at least align for a large, long
+  // lived buffer such as a frame, placed as flags ask where the platform
+  // supports it. Released with vpx_free().
+  void *vpx_memalign_frame(size_t align, size_t size, int flags);
+
 #if CONFIG_VP9 && CONFIG_VP9_HIGHBITDEPTH
   void *vpx_memset16(void *dest, int val, size_t length);
 #endif
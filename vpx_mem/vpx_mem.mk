@@ -1,4 +1,6 @@
 MEM_SRCS-yes += vpx_mem.mk
 MEM_SRCS-yes += vpx_mem.c
 MEM_SRCS-yes += vpx_mem.h
+MEM_SRCS-yes += vpx_arena.c
+MEM_SRCS-yes += vpx_arena.h
 MEM_SRCS-yes += include/vpx_mem_intrnl.h
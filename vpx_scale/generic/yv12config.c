@@ -119,6 +119,8 @@ int vp8_yv12_alloc_frame_buffer(YV12_BUFFER_CONFIG *ybf,
 
 int vp9_free_frame_buffer(YV12_BUFFER_CONFIG *ybf) {
   if (ybf) {
+    const int placement = ybf->placement;
+
     if (ybf->buffer_alloc_sz > 0) {
       vpx_free(ybf->buffer_alloc);
     }
@@ -127,6 +129,7 @@ int vp9_free_frame_buffer(YV12_BUFFER_CONFIG *ybf) {
       u_buffer and v_buffer point to buffer_alloc and are used.  Clear out
       all of this so that a freed pointer isn't inadvertently used */
     memset(ybf, 0, sizeof(YV12_BUFFER_CONFIG));
+    ybf->placement = placement;
   } else {
     return -1;
   }
@@ -211,16 +214,15 @@ int vp9_realloc_frame_buffer(YV12_BUFFER_CONFIG *ybf,
       if (frame_size != (size_t)frame_size)
         return -1;
 
-      ybf->buffer_alloc = (uint8_t *)vpx_memalign(32, (size_t)frame_size);
+      // The buffer is cleared for the C loop filter, which reads the
+      // uninitialized frame border otherwise. It could be skipped if the
+      // border were removed.
+      ybf->buffer_alloc = (uint8_t *)vpx_memalign_frame(32, (size_t)frame_size,
+                                                        ybf->placement);
       if (!ybf->buffer_alloc)
         return -1;
 
       ybf->buffer_alloc_sz = (int)frame_size;
-
-      // This memset is needed for fixing valgrind error from C loop filter
-      // due to access uninitialized memory in frame border. It could be
-      // removed if border is totally removed.
-      memset(ybf->buffer_alloc, 0, ybf->buffer_alloc_sz);
     }
 
     /* Only support allocating buffers that have a border that's a multiple
@@ -15,7 +15,7 @@
 #include "vpx_mem/vpx_mem.h"
 #include "vpx_ports/mem.h"
 #include "vpx_scale/yv12config.h"
-#if CONFIG_VP9 && CONFIG_VP9_HIGHBITDEPTH
+#if CONFIG_VP9
 #include "vp9/common/vp9_common.h"
 #endif
 
@@ -158,7 +158,99 @@ void vp8_yv12_extend_frame_borders_c(YV12_BUFFER_CONFIG *ybf) {
 }
 
 #if CONFIG_VP9
-static void extend_frame(YV12_BUFFER_CONFIG *const ybf, int ext_size) {
+void vp9_extend_plane_rows_c(uint8_t *src, int src_stride, int width,
+                             int rows, int extend_left, int extend_right) {
+  int i;
+  for (i = 0; i < rows; ++i, src += src_stride) {
+    memset(src - extend_left, src[0], extend_left);
+    memset(src + width, src[width - 1], extend_right);
+  }
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+void vp9_highbd_extend_plane_rows_c(uint16_t *src, int src_stride, int width,
+                                    int rows, int extend_left,
+                                    int extend_right) {
+  int i;
+  for (i = 0; i < rows; ++i, src += src_stride) {
+    vpx_memset16(src - extend_left, src[0], extend_left);
+    vpx_memset16(src + width, src[width - 1], extend_right);
+  }
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
+// Extends rows [start, end) of a plane, where row 0 is the first row of the
+// top border. Border rows are built from the plane's first or last row
+// rather than from already extended rows, so bands of rows do not depend on
+// each other.
+static void extend_plane_band(uint8_t *const src, int src_stride,
+                              int width, int height,
+                              int extend_top, int extend_left,
+                              int extend_bottom, int extend_right,
+                              int band, int num_bands) {
+  const int rows = extend_top + height + extend_bottom;
+  const int start = rows * band / num_bands - extend_top;
+  const int end = rows * (band + 1) / num_bands - extend_top;
+  const int top_end = MIN(end, 0);
+  const int bottom_start = MAX(start, height);
+  const int mid_start = MAX(start, 0);
+  const int mid_end = MIN(end, height);
+  int i;
+
+  for (i = start; i < top_end; ++i)
+    memcpy(src + i * src_stride, src, width);
+  for (i = bottom_start; i < end; ++i)
+    memcpy(src + i * src_stride, src + (height - 1) * src_stride, width);
+
+  if (top_end > start)
+    vp9_extend_plane_rows(src + start * src_stride, src_stride, width,
+                          top_end - start, extend_left, extend_right);
+  if (mid_end > mid_start)
+    vp9_extend_plane_rows(src + mid_start * src_stride, src_stride, width,
+                          mid_end - mid_start, extend_left, extend_right);
+  if (end > bottom_start)
+    vp9_extend_plane_rows(src + bottom_start * src_stride, src_stride, width,
+                          end - bottom_start, extend_left, extend_right);
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+static void extend_plane_band_high(uint8_t *const src8, int src_stride,
+                                   int width, int height,
+                                   int extend_top, int extend_left,
+                                   int extend_bottom, int extend_right,
+                                   int band, int num_bands) {
+  uint16_t *const src = CONVERT_TO_SHORTPTR(src8);
+  const int rows = extend_top + height + extend_bottom;
+  const int start = rows * band / num_bands - extend_top;
+  const int end = rows * (band + 1) / num_bands - extend_top;
+  const int top_end = MIN(end, 0);
+  const int bottom_start = MAX(start, height);
+  const int mid_start = MAX(start, 0);
+  const int mid_end = MIN(end, height);
+  int i;
+
+  for (i = start; i < top_end; ++i)
+    memcpy(src + i * src_stride, src, width * sizeof(uint16_t));
+  for (i = bottom_start; i < end; ++i)
+    memcpy(src + i * src_stride, src + (height - 1) * src_stride,
+           width * sizeof(uint16_t));
+
+  if (top_end > start)
+    vp9_highbd_extend_plane_rows(src + start * src_stride, src_stride, width,
+                                 top_end - start, extend_left, extend_right);
+  if (mid_end > mid_start)
+    vp9_highbd_extend_plane_rows(src + mid_start * src_stride, src_stride,
+                                 width, mid_end - mid_start, extend_left,
+                                 extend_right);
+  if (end > bottom_start)
+    vp9_highbd_extend_plane_rows(src + bottom_start * src_stride, src_stride,
+                                 width, end - bottom_start, extend_left,
+                                 extend_right);
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
+void vp9_extend_frame_borders_band(YV12_BUFFER_CONFIG *const ybf,
+                                   int ext_size, int band, int num_bands) {
   const int c_w = ybf->uv_crop_width;
   const int c_h = ybf->uv_crop_height;
   const int ss_x = ybf->uv_width < ybf->y_width;
@@ -172,42 +264,45 @@ static void extend_frame(YV12_BUFFER_CONFIG *const ybf, int ext_size) {
   assert(ybf->y_width - ybf->y_crop_width < 16);
   assert(ybf->y_height - ybf->y_crop_height >= 0);
   assert(ybf->y_width - ybf->y_crop_width >= 0);
+  assert(band >= 0 && band < num_bands);
 
 #if CONFIG_VP9_HIGHBITDEPTH
   if (ybf->flags & YV12_FLAG_HIGHBITDEPTH) {
-    extend_plane_high(ybf->y_buffer, ybf->y_stride,
-                      ybf->y_crop_width, ybf->y_crop_height,
-                      ext_size, ext_size,
-                      ext_size + ybf->y_height - ybf->y_crop_height,
-                      ext_size + ybf->y_width - ybf->y_crop_width);
-    extend_plane_high(ybf->u_buffer, ybf->uv_stride,
-                      c_w, c_h, c_et, c_el, c_eb, c_er);
-    extend_plane_high(ybf->v_buffer, ybf->uv_stride,
-                      c_w, c_h, c_et, c_el, c_eb, c_er);
+    extend_plane_band_high(ybf->y_buffer, ybf->y_stride,
+                           ybf->y_crop_width, ybf->y_crop_height,
+                           ext_size, ext_size,
+                           ext_size + ybf->y_height - ybf->y_crop_height,
+                           ext_size + ybf->y_width - ybf->y_crop_width,
+                           band, num_bands);
+    extend_plane_band_high(ybf->u_buffer, ybf->uv_stride,
+                           c_w, c_h, c_et, c_el, c_eb, c_er, band, num_bands);
+    extend_plane_band_high(ybf->v_buffer, ybf->uv_stride,
+                           c_w, c_h, c_et, c_el, c_eb, c_er, band, num_bands);
     return;
   }
 #endif
-  extend_plane(ybf->y_buffer, ybf->y_stride,
-               ybf->y_crop_width, ybf->y_crop_height,
-               ext_size, ext_size,
-               ext_size + ybf->y_height - ybf->y_crop_height,
-               ext_size + ybf->y_width - ybf->y_crop_width);
-
-  extend_plane(ybf->u_buffer, ybf->uv_stride,
-               c_w, c_h, c_et, c_el, c_eb, c_er);
-
-  extend_plane(ybf->v_buffer, ybf->uv_stride,
-               c_w, c_h, c_et, c_el, c_eb, c_er);
+  extend_plane_band(ybf->y_buffer, ybf->y_stride,
+                    ybf->y_crop_width, ybf->y_crop_height,
+                    ext_size, ext_size,
+                    ext_size + ybf->y_height - ybf->y_crop_height,
+                    ext_size + ybf->y_width - ybf->y_crop_width,
+                    band, num_bands);
+
+  extend_plane_band(ybf->u_buffer, ybf->uv_stride,
+                    c_w, c_h, c_et, c_el, c_eb, c_er, band, num_bands);
+
+  extend_plane_band(ybf->v_buffer, ybf->uv_stride,
+                    c_w, c_h, c_et, c_el, c_eb, c_er, band, num_bands);
 }
 
 void vp9_extend_frame_borders_c(YV12_BUFFER_CONFIG *ybf) {
-  extend_frame(ybf, ybf->border);
+  vp9_extend_frame_borders_band(ybf, ybf->border, 0, 1);
 }
 
 void vp9_extend_frame_inner_borders_c(YV12_BUFFER_CONFIG *ybf) {
   const int inner_bw = (ybf->border > VP9INNERBORDERINPIXELS) ?
                        VP9INNERBORDERINPIXELS : ybf->border;
-  extend_frame(ybf, inner_bw);
+  vp9_extend_frame_borders_band(ybf, inner_bw, 0, 1);
 }
 
 #if CONFIG_VP9_HIGHBITDEPTH
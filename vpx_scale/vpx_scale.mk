@@ -8,6 +8,11 @@ SCALE_SRCS-$(CONFIG_SPATIAL_RESAMPLING) += generic/gen_scalers.c
 SCALE_SRCS-yes += vpx_scale_rtcd.c
 SCALE_SRCS-yes += vpx_scale_rtcd.pl
 
+#x86
+ifeq ($(CONFIG_VP9),yes)
+SCALE_SRCS-$(HAVE_SSE2)   += x86/yv12extend_sse2.c
+endif
+
 #mips(dspr2)
 SCALE_SRCS-$(HAVE_DSPR2)  += mips/dspr2/yv12extend_dspr2.c
 
@@ -1,5 +1,7 @@
 sub vpx_scale_forward_decls() {
 print <<EOF
+#include "vpx/vpx_integer.h"
+
 struct yv12_buffer_config;
 EOF
 }
@@ -28,5 +30,13 @@ if (vpx_config("CONFIG_VP9") eq "yes") {
 
     add_proto qw/void vp9_extend_frame_inner_borders/, "struct yv12_buffer_config *ybf";
     specialize qw/vp9_extend_frame_inner_borders dspr2/;
+
+    add_proto qw/void vp9_extend_plane_rows/, "uint8_t *src, int src_stride, int width, int rows, int extend_left, int extend_right";
+    specialize qw/vp9_extend_plane_rows sse2/;
+
+    if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") eq "yes") {
+        add_proto qw/void vp9_highbd_extend_plane_rows/, "uint16_t *src, int src_stride, int width, int rows, int extend_left, int extend_right";
+        specialize qw/vp9_highbd_extend_plane_rows sse2/;
+    }
 }
 1;
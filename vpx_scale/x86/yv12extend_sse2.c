@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>  // SSE2
+#include <string.h>
+
+#include "./vpx_config.h"
+#include "./vpx_scale_rtcd.h"
+#include "vpx_mem/vpx_mem.h"
+
+// Fills n bytes with v using 16 byte stores. A short tail is covered by an
+// overlapping store that ends at dst + n.
+static INLINE void fill_16(uint8_t *dst, __m128i v, int n) {
+  int i;
+  if (n < 16) {
+    memset(dst, _mm_cvtsi128_si32(v) & 0xff, n);
+    return;
+  }
+  for (i = 0; i + 16 <= n; i += 16)
+    _mm_storeu_si128((__m128i *)(dst + i), v);
+  if (i < n)
+    _mm_storeu_si128((__m128i *)(dst + n - 16), v);
+}
+
+void vp9_extend_plane_rows_sse2(uint8_t *src, int src_stride, int width,
+                                int rows, int extend_left, int extend_right) {
+  int i;
+  for (i = 0; i < rows; ++i, src += src_stride) {
+    fill_16(src - extend_left, _mm_set1_epi8((char)src[0]), extend_left);
+    fill_16(src + width, _mm_set1_epi8((char)src[width - 1]), extend_right);
+  }
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+// As fill_16(), for n 16-bit pixels.
+static INLINE void fill_8x16(uint16_t *dst, __m128i v, int n) {
+  int i;
+  if (n < 8) {
+    vpx_memset16(dst, _mm_cvtsi128_si32(v) & 0xffff, n);
+    return;
+  }
+  for (i = 0; i + 8 <= n; i += 8)
+    _mm_storeu_si128((__m128i *)(dst + i), v);
+  if (i < n)
+    _mm_storeu_si128((__m128i *)(dst + n - 8), v);
+}
+
+void vp9_highbd_extend_plane_rows_sse2(uint16_t *src, int src_stride,
+                                       int width, int rows, int extend_left,
+                                       int extend_right) {
+  int i;
+  for (i = 0; i < rows; ++i, src += src_stride) {
+    const __m128i left = _mm_set1_epi16((int16_t)src[0]);
+    const __m128i right = _mm_set1_epi16((int16_t)src[width - 1]);
+    fill_8x16(src - extend_left, left, extend_left);
+    fill_8x16(src + width, right, extend_right);
+  }
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
@@ -59,6 +59,9 @@ typedef struct yv12_buffer_config {
 
   int corrupted;
   int flags;
+  // VPX_MEM_* placement flags for the buffers vp9_realloc_frame_buffer()
+  // allocates. They are kept when the buffer is freed.
+  int placement;
 } YV12_BUFFER_CONFIG;
 
 #define YV12_FLAG_HIGHBITDEPTH 8
@@ -95,6 +98,12 @@ int vp9_realloc_frame_buffer(YV12_BUFFER_CONFIG *ybf,
                              void *cb_priv);
 int vp9_free_frame_buffer(YV12_BUFFER_CONFIG *ybf);
 
+// Extends the borders of every plane by ext_size pixels, for one of
+// num_bands bands of rows. Each plane's rows, borders included, are split
+// evenly, and the bands can be extended on separate threads.
+void vp9_extend_frame_borders_band(YV12_BUFFER_CONFIG *ybf, int ext_size,
+                                   int band, int num_bands);
+
 #ifdef __cplusplus
 }
 #endif